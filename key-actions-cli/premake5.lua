@@ -0,0 +1,56 @@
+project "KeyActionsCli"
+   kind "ConsoleApp"
+   language "C++"
+   cppdialect "C++20"
+   targetdir "bin/%{cfg.buildcfg}"
+   staticruntime "off"
+
+   flags { "MultiProcessorCompile" }
+
+   files { "src/**.h", "src/**.cpp" }
+
+   includedirs
+   {
+      "%{wks.location}/key-actions-cli/src",
+
+      "%{wks.location}/key-actions/src",
+
+      "%{wks.location}/lumina/lumina/src",
+
+      "%{wks.location}/lumina/dependencies/imgui",
+      "%{wks.location}/lumina/dependencies/glm",
+      "%{wks.location}/lumina/dependencies/spdlog/include"
+   }
+
+   links
+   {
+      "Lumina",
+      "KeyActionsLib"
+   }
+
+   buildoptions { "/utf-8" }
+
+   targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+   objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+   filter "system:windows"
+      systemversion "latest"
+      defines { "LUMINA_PLATFORM_WINDOWS" }
+
+   filter "configurations:Debug"
+      defines { "LUMINA_DEBUG" }
+      runtime "Debug"
+      symbols "On"
+      optimize "Off"
+
+   filter "configurations:Release"
+      defines { "LUMINA_RELEASE" }
+      runtime "Release"
+      optimize "Speed"
+      symbols "On"
+
+   filter "configurations:Dist"
+      defines { "LUMINA_DIST" }
+      runtime "Release"
+      optimize "Speed"
+      symbols "Off"
\ No newline at end of file
@@ -0,0 +1,779 @@
+#include "KeyActions/Core/Recording.h"
+#include "KeyActions/Core/RecordingLibrary.h"
+#include "KeyActions/Core/RecordingOptimizer.h"
+#include "KeyActions/Core/RecordingStore.h"
+#include "KeyActions/Core/Serialization.h"
+#include "KeyActions/Core/TaskPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace KeyActions
+{
+    namespace Cli
+    {
+        using Arguments = std::vector<std::string_view>;
+
+        void PrintUsage()
+        {
+            std::printf(
+                "Usage: KeyActionsCli <command> [options]\n"
+                "\n"
+                "Commands:\n"
+                "  optimize <inputs...> [-o <output>] [--tolerance <px>] [--max-idle <seconds>]\n"
+                "           [--keep-moves] [--keep-scrolls] [--keep-repeats] [--keep-idle] [--jobs <n>]\n"
+                "      Writes a smaller recording that plays back the same.\n"
+                "      Output defaults to <input>.optimized.rec; with a folder or several inputs,\n"
+                "      -o names the output folder. Folders skip earlier .optimized.rec outputs.\n"
+                "  convert <inputs...> [--to rec|json] [-o <folder>] [--no-entropy] [--jobs <n>]\n"
+                "      Rewrites recordings in the current .rec format, or exports them to JSON.\n"
+                "      Output goes next to each input unless -o is given; .rec files are\n"
+                "      replaced in place, as is any existing file of the output's name.\n"
+                "  validate <inputs...> [--jobs <n>]\n"
+                "      Loads every recording and checks its events are in order.\n"
+                "  reindex <folders...> [--jobs <n>]\n"
+                "      Rebuilds each folder's recording index from the files in it.\n"
+                "  store <store> add <inputs...> | extract <names...> [-o <folder>] |\n"
+                "        remove <names...> | gc | stats\n"
+                "      Keeps recordings in a deduplicating store, where stretches of input that\n"
+                "      several recordings share are stored once. Added recordings are named after\n"
+                "      their file; extract writes them back out as .rec files.\n"
+                "\n"
+                "Inputs may be files or folders; a folder stands for every .rec and .json file\n"
+                "in it. Files are processed in parallel on --jobs threads (default: one per core),\n"
+                "and a file that fails is reported at the end without stopping the rest.\n");
+        }
+
+        // Accepts binary .rec files and JSON exports
+        bool LoadRecordingFile(const std::filesystem::path& path, Recording& recording)
+        {
+            if (Serialization::IsBinaryRecording(path))
+                return Serialization::ReadBinary(recording, path);
+
+            return Serialization::ImportJson(recording, path);
+        }
+
+        bool ParseFloat(std::string_view text, float& value)
+        {
+            std::string buffer(text);
+            char* end = nullptr;
+            value = std::strtof(buffer.c_str(), &end);
+            return end != buffer.c_str() && *end == '\0';
+        }
+
+        bool ParseCount(std::string_view text, size_t& value)
+        {
+            std::string buffer(text);
+            char* end = nullptr;
+            value = std::strtoul(buffer.c_str(), &end, 10);
+            return end != buffer.c_str() && *end == '\0';
+        }
+
+        void PrintUnknownOption(std::string_view arg)
+        {
+            std::fprintf(stderr, "Unknown or incomplete option: %.*s\n", static_cast<int>(arg.size()), arg.data());
+        }
+
+        // What optimize appends to an output's name
+        constexpr std::string_view OptimizedSuffix = ".optimized.rec";
+
+        // Expands folders to the recordings directly inside them, in name order. With
+        // skipOptimized, a folder's earlier optimize outputs are left out so optimizing it again
+        // doesn't optimize those too; files named directly are always kept.
+        std::vector<std::filesystem::path> CollectRecordings(const std::vector<std::filesystem::path>& inputs, bool skipOptimized = false)
+        {
+            std::vector<std::filesystem::path> files;
+
+            for (const auto& input : inputs)
+            {
+                std::error_code error;
+                if (!std::filesystem::is_directory(input, error))
+                {
+                    files.push_back(input);
+                    continue;
+                }
+
+                std::vector<std::filesystem::path> found;
+                for (const auto& entry : std::filesystem::directory_iterator(input, error))
+                {
+                    std::error_code entryError;
+                    const std::filesystem::path& path = entry.path();
+                    std::filesystem::path extension = path.extension();
+
+                    // Skips the library index and other dot files
+                    std::string filename = path.filename().string();
+                    if (!entry.is_regular_file(entryError) || filename.starts_with("."))
+                        continue;
+
+                    if (skipOptimized && filename.ends_with(OptimizedSuffix))
+                        continue;
+
+                    if (extension == ".rec" || extension == ".json")
+                        found.push_back(path);
+                }
+
+                std::sort(found.begin(), found.end());
+                files.insert(files.end(), found.begin(), found.end());
+            }
+
+            return files;
+        }
+
+        // What happened to one file of a bulk command
+        struct FileResult
+        {
+            bool Succeeded = false;
+            uint64_t EventsRead = 0;
+            uint64_t EventsWritten = 0;
+            std::string Error;
+        };
+
+        FileResult Failure(std::string error)
+        {
+            FileResult result;
+            result.Error = std::move(error);
+            return result;
+        }
+
+        // Processes one file. The pool is passed on so a single large file can use it too.
+        using FileTask = std::function<FileResult(const std::filesystem::path& path, TaskPool& pool)>;
+
+        // Runs the task for every file across the pool, then prints throughput and every
+        // file that failed. Fails if any file did.
+        int RunBulk(const char* verb, const std::vector<std::filesystem::path>& files, size_t jobs, const FileTask& task)
+        {
+            if (files.empty())
+            {
+                std::fprintf(stderr, "No recordings found\n");
+                return EXIT_FAILURE;
+            }
+
+            uint64_t inputBytes = 0;
+            for (const auto& file : files)
+            {
+                std::error_code error;
+                uint64_t size = std::filesystem::file_size(file, error);
+                inputBytes += error ? 0 : size;
+            }
+
+            TaskPool pool(jobs);
+            std::vector<FileResult> results(files.size());
+
+            int64_t start = Clock::Now();
+            pool.ParallelFor(files.size(), [&](size_t i) {
+                // One bad file, such as one too large to allocate, fails alone
+                try
+                {
+                    results[i] = task(files[i], pool);
+                }
+                catch (const std::exception& e)
+                {
+                    results[i] = Failure(e.what());
+                }
+                });
+            double seconds = std::max(Clock::ToSeconds(Clock::Now() - start), 1e-9);
+
+            size_t failed = 0;
+            uint64_t eventsRead = 0;
+            uint64_t eventsWritten = 0;
+
+            for (const FileResult& result : results)
+            {
+                failed += result.Succeeded ? 0 : 1;
+                eventsRead += result.EventsRead;
+                eventsWritten += result.EventsWritten;
+            }
+
+            std::printf("%s %zu files on %zu threads in %.2fs\n", verb, files.size(), pool.GetThreadCount(), seconds);
+            std::printf("  Succeeded: %zu, failed: %zu\n", files.size() - failed, failed);
+            std::printf("  Read:      %.1f MB (%.1f MB/s), %llu events (%.2fM events/s)\n",
+                inputBytes / 1e6, inputBytes / 1e6 / seconds,
+                static_cast<unsigned long long>(eventsRead), eventsRead / 1e6 / seconds);
+
+            if (eventsWritten > 0)
+                std::printf("  Written:   %llu events\n", static_cast<unsigned long long>(eventsWritten));
+
+            std::printf("  Tasks stolen between threads: %llu\n", static_cast<unsigned long long>(pool.GetStealCount()));
+
+            if (failed > 0)
+            {
+                std::printf("\nFailed:\n");
+                for (size_t i = 0; i < files.size(); i++)
+                {
+                    if (!results[i].Succeeded)
+                        std::printf("  %s: %s\n", files[i].string().c_str(), results[i].Error.c_str());
+                }
+            }
+
+            return failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+
+        // An empty folder means next to each input, which needs nothing created
+        bool CreateOutputFolder(const std::filesystem::path& folder)
+        {
+            if (folder.empty())
+                return true;
+
+            std::error_code error;
+            std::filesystem::create_directories(folder, error);
+            if (error)
+            {
+                std::fprintf(stderr, "Failed to create output folder %s: %s\n", folder.string().c_str(), error.message().c_str());
+                return false;
+            }
+
+            return true;
+        }
+
+        using OutputPath = std::function<std::filesystem::path(const std::filesystem::path& input)>;
+
+        // Maps each input that would write the same file as another to that other input. Such
+        // inputs are failed rather than left to race on the output. A file rewritten in place
+        // keeps its output, so converting both "a.json" and "a.rec" rewrites "a.rec" from itself.
+        // Only inputs are compared; an existing file that is not among them is replaced.
+        std::map<std::filesystem::path, std::filesystem::path> FindOutputClashes(const std::vector<std::filesystem::path>& files, const OutputPath& output)
+        {
+            auto normalize = [](const std::filesystem::path& path) { return std::filesystem::absolute(path).lexically_normal(); };
+
+            std::vector<std::filesystem::path> ordered = files;
+            std::stable_partition(ordered.begin(), ordered.end(),
+                [&](const std::filesystem::path& file) { return normalize(output(file)) == normalize(file); });
+
+            std::map<std::filesystem::path, std::filesystem::path> owners;
+            std::map<std::filesystem::path, std::filesystem::path> clashes;
+
+            for (const auto& file : ordered)
+            {
+                auto [owner, inserted] = owners.emplace(normalize(output(file)), file);
+                if (!inserted)
+                    clashes.emplace(file, owner->second);
+            }
+
+            return clashes;
+        }
+
+        // Returns an empty string if the events are consistent
+        std::string CheckRecording(const Recording& recording)
+        {
+            int64_t previous = 0;
+
+            for (size_t i = 0; i < recording.Events.Size(); i++)
+            {
+                int64_t timestamp = recording.Events[i].GetTimestamp();
+                if (timestamp < previous)
+                    return "event " + std::to_string(i) + " is earlier than the one before it";
+
+                if (static_cast<uint8_t>(recording.Events[i].GetAction()) > static_cast<uint8_t>(RecordedAction::MouseScrolled))
+                    return "event " + std::to_string(i) + " has an unknown action";
+
+                previous = timestamp;
+            }
+
+            if (recording.Duration < previous)
+                return "events run past the recording's duration";
+
+            return {};
+        }
+
+        int OptimizeAll(const std::vector<std::filesystem::path>& inputs, const std::filesystem::path& outputFolder, const OptimizerSettings& settings, size_t jobs)
+        {
+            if (!CreateOutputFolder(outputFolder))
+                return EXIT_FAILURE;
+
+            auto outputFor = [&outputFolder](const std::filesystem::path& path) {
+                std::filesystem::path output = (outputFolder.empty() ? path.parent_path() : outputFolder) / path.stem();
+                output += OptimizedSuffix;
+                return output;
+            };
+
+            std::vector<std::filesystem::path> files = CollectRecordings(inputs, true);
+            auto clashes = FindOutputClashes(files, outputFor);
+
+            auto optimize = [&](const std::filesystem::path& path, TaskPool& pool) {
+                if (auto clash = clashes.find(path); clash != clashes.end())
+                    return Failure("would overwrite the output of " + clash->second.string());
+
+                Recording recording;
+                if (!LoadRecordingFile(path, recording))
+                    return Failure("could not be loaded");
+
+                RecordingOptimizer optimizer(settings);
+                Recording optimized = optimizer.Optimize(recording);
+
+                std::filesystem::path output = outputFor(path);
+                if (!Serialization::WriteCompressed(optimized, output, {}, true, &pool))
+                    return Failure("could not write " + output.string());
+
+                FileResult result;
+                result.Succeeded = true;
+                result.EventsRead = recording.Events.Size();
+                result.EventsWritten = optimized.Events.Size();
+                return result;
+            };
+
+            return RunBulk("Optimized", files, jobs, optimize);
+        }
+
+        int Optimize(const Arguments& args)
+        {
+            std::vector<std::filesystem::path> inputs;
+            std::filesystem::path output;
+            OptimizerSettings settings;
+            size_t jobs = 0;
+
+            for (size_t i = 0; i < args.size(); i++)
+            {
+                std::string_view arg = args[i];
+                bool hasValue = i + 1 < args.size();
+                float value = 0.0f;
+
+                if (arg == "-o" && hasValue)
+                {
+                    output = args[++i];
+                }
+                else if (arg == "--tolerance" && hasValue && ParseFloat(args[++i], value))
+                {
+                    settings.MouseMoveTolerance = value;
+                }
+                else if (arg == "--max-idle" && hasValue && ParseFloat(args[++i], value))
+                {
+                    settings.MaxIdleGap = Clock::FromSeconds(value);
+                }
+                else if (arg == "--keep-moves")
+                {
+                    settings.MergeMouseMoves = false;
+                }
+                else if (arg == "--keep-scrolls")
+                {
+                    settings.CoalesceScrolls = false;
+                }
+                else if (arg == "--keep-repeats")
+                {
+                    settings.DropKeyRepeats = false;
+                }
+                else if (arg == "--keep-idle")
+                {
+                    settings.TrimIdleGaps = false;
+                }
+                else if (arg == "--jobs" && hasValue && ParseCount(args[++i], jobs))
+                {
+                }
+                else if (!arg.starts_with("-"))
+                {
+                    inputs.emplace_back(arg);
+                }
+                else
+                {
+                    PrintUnknownOption(arg);
+                    return EXIT_FAILURE;
+                }
+            }
+
+            if (inputs.empty())
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+
+            std::error_code error;
+            if (inputs.size() > 1 || std::filesystem::is_directory(inputs.front(), error))
+                return OptimizeAll(inputs, output, settings, jobs);
+
+            const std::filesystem::path& input = inputs.front();
+
+            if (output.empty())
+            {
+                output = input;
+                output.replace_extension(OptimizedSuffix);
+            }
+
+            Recording recording;
+            if (!LoadRecordingFile(input, recording))
+            {
+                std::fprintf(stderr, "Failed to load %s\n", input.string().c_str());
+                return EXIT_FAILURE;
+            }
+
+            RecordingOptimizer optimizer(settings);
+            Recording optimized = optimizer.Optimize(recording);
+            const OptimizerStats& stats = optimizer.GetStats();
+
+            if (!Serialization::WriteCompressed(optimized, output))
+            {
+                std::fprintf(stderr, "Failed to write %s\n", output.string().c_str());
+                return EXIT_FAILURE;
+            }
+
+            double ratio = stats.EventsAfter > 0 ? static_cast<double>(stats.EventsBefore) / stats.EventsAfter : 0.0;
+
+            std::printf("%s -> %s\n", input.string().c_str(), output.string().c_str());
+            std::printf("  Events:   %zu -> %zu (%.1fx)\n", stats.EventsBefore, stats.EventsAfter, ratio);
+            std::printf("  Duration: %.2fs -> %.2fs\n", Clock::ToSeconds(stats.DurationBefore), Clock::ToSeconds(stats.DurationAfter));
+            std::printf("  Mouse moves merged: %zu, scrolls coalesced: %zu, key repeats dropped: %zu, idle gaps trimmed: %zu\n",
+                stats.MouseMovesMerged, stats.ScrollsCoalesced, stats.KeyRepeatsDropped, stats.IdleGapsTrimmed);
+
+            return EXIT_SUCCESS;
+        }
+
+        int Convert(const Arguments& args)
+        {
+            std::vector<std::filesystem::path> inputs;
+            std::filesystem::path outputFolder;
+            bool toJson = false;
+            bool entropy = true;
+            size_t jobs = 0;
+
+            for (size_t i = 0; i < args.size(); i++)
+            {
+                std::string_view arg = args[i];
+                bool hasValue = i + 1 < args.size();
+
+                if (arg == "-o" && hasValue)
+                {
+                    outputFolder = args[++i];
+                }
+                else if (arg == "--to" && hasValue && (args[i + 1] == "rec" || args[i + 1] == "json"))
+                {
+                    toJson = args[++i] == "json";
+                }
+                else if (arg == "--no-entropy")
+                {
+                    entropy = false;
+                }
+                else if (arg == "--jobs" && hasValue && ParseCount(args[++i], jobs))
+                {
+                }
+                else if (!arg.starts_with("-"))
+                {
+                    inputs.emplace_back(arg);
+                }
+                else
+                {
+                    PrintUnknownOption(arg);
+                    return EXIT_FAILURE;
+                }
+            }
+
+            if (inputs.empty())
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+
+            if (!CreateOutputFolder(outputFolder))
+                return EXIT_FAILURE;
+
+            auto outputFor = [&outputFolder, toJson](const std::filesystem::path& path) {
+                std::filesystem::path output = (outputFolder.empty() ? path.parent_path() : outputFolder) / path.stem();
+                output += toJson ? ".json" : ".rec";
+                return output;
+            };
+
+            std::vector<std::filesystem::path> files = CollectRecordings(inputs);
+            auto clashes = FindOutputClashes(files, outputFor);
+
+            auto convert = [&](const std::filesystem::path& path, TaskPool& pool) {
+                if (auto clash = clashes.find(path); clash != clashes.end())
+                    return Failure("would overwrite the output of " + clash->second.string());
+
+                Recording recording;
+                if (!LoadRecordingFile(path, recording))
+                    return Failure("could not be loaded");
+
+                // Rewriting an input in place is safe; both formats only replace it once the new file is complete
+                std::filesystem::path output = outputFor(path);
+                bool written = toJson ?
+                    Serialization::ExportJson(recording, output) :
+                    Serialization::WriteCompressed(recording, output, {}, entropy, &pool);
+
+                if (!written)
+                    return Failure("could not write " + output.string());
+
+                FileResult result;
+                result.Succeeded = true;
+                result.EventsRead = recording.Events.Size();
+                result.EventsWritten = recording.Events.Size();
+                return result;
+            };
+
+            return RunBulk("Converted", files, jobs, convert);
+        }
+
+        int Validate(const Arguments& args)
+        {
+            std::vector<std::filesystem::path> inputs;
+            size_t jobs = 0;
+
+            for (size_t i = 0; i < args.size(); i++)
+            {
+                std::string_view arg = args[i];
+
+                if (arg == "--jobs" && i + 1 < args.size() && ParseCount(args[++i], jobs))
+                {
+                }
+                else if (!arg.starts_with("-"))
+                {
+                    inputs.emplace_back(arg);
+                }
+                else
+                {
+                    PrintUnknownOption(arg);
+                    return EXIT_FAILURE;
+                }
+            }
+
+            if (inputs.empty())
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+
+            auto validate = [](const std::filesystem::path& path, TaskPool&) {
+                Recording recording;
+                if (!LoadRecordingFile(path, recording))
+                    return Failure("could not be loaded");
+
+                std::string problem = CheckRecording(recording);
+                if (!problem.empty())
+                    return Failure(problem);
+
+                FileResult result;
+                result.Succeeded = true;
+                result.EventsRead = recording.Events.Size();
+                return result;
+            };
+
+            return RunBulk("Validated", CollectRecordings(inputs), jobs, validate);
+        }
+
+        int Reindex(const Arguments& args)
+        {
+            std::vector<std::filesystem::path> folders;
+            size_t jobs = 0;
+
+            for (size_t i = 0; i < args.size(); i++)
+            {
+                std::string_view arg = args[i];
+
+                if (arg == "--jobs" && i + 1 < args.size() && ParseCount(args[++i], jobs))
+                {
+                }
+                else if (!arg.starts_with("-"))
+                {
+                    folders.emplace_back(arg);
+                }
+                else
+                {
+                    PrintUnknownOption(arg);
+                    return EXIT_FAILURE;
+                }
+            }
+
+            if (folders.empty())
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+
+            TaskPool pool(jobs);
+            int status = EXIT_SUCCESS;
+
+            for (const auto& folder : folders)
+            {
+                std::error_code error;
+                if (!std::filesystem::is_directory(folder, error))
+                {
+                    std::fprintf(stderr, "Not a folder: %s\n", folder.string().c_str());
+                    status = EXIT_FAILURE;
+                    continue;
+                }
+
+                // Without the old index every recording is read again
+                RecordingLibrary library(folder);
+                std::filesystem::remove(library.GetIndexPath(), error);
+
+                size_t files = 0;
+                uint64_t bytes = 0;
+                for (const auto& entry : std::filesystem::directory_iterator(folder, error))
+                {
+                    std::error_code entryError;
+                    if (entry.is_regular_file(entryError) && entry.path().extension() == ".rec")
+                    {
+                        files++;
+                        bytes += entry.file_size(entryError);
+                    }
+                }
+
+                int64_t start = Clock::Now();
+                size_t indexed = library.Refresh(&pool);
+                double seconds = std::max(Clock::ToSeconds(Clock::Now() - start), 1e-9);
+
+                std::printf("Indexed %zu of %zu recordings in %s on %zu threads in %.2fs (%.1f MB/s, %.0f files/s)\n",
+                    indexed, files, folder.string().c_str(), pool.GetThreadCount(), seconds, bytes / 1e6 / seconds, files / seconds);
+
+                if (indexed < files)
+                {
+                    std::printf("  %zu unreadable recordings were left out of the index\n", files - indexed);
+                    status = EXIT_FAILURE;
+                }
+            }
+
+            return status;
+        }
+
+        int Store(const Arguments& args)
+        {
+            if (args.size() < 2)
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+
+            RecordingStore store{ std::filesystem::path(args[0]) };
+            std::string_view action = args[1];
+
+            std::vector<std::string_view> operands;
+            std::filesystem::path outputFolder = ".";
+
+            for (size_t i = 2; i < args.size(); i++)
+            {
+                std::string_view arg = args[i];
+
+                if (arg == "-o" && action == "extract" && i + 1 < args.size())
+                {
+                    outputFolder = args[++i];
+                }
+                else if (!arg.starts_with("-"))
+                {
+                    operands.push_back(arg);
+                }
+                else
+                {
+                    PrintUnknownOption(arg);
+                    return EXIT_FAILURE;
+                }
+            }
+
+            bool needsOperands = action == "add" || action == "extract" || action == "remove";
+            if (needsOperands == operands.empty() || (action != "gc" && action != "stats" && !needsOperands))
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+
+            if (!store.Open())
+                return EXIT_FAILURE;
+
+            int status = EXIT_SUCCESS;
+
+            if (action == "add")
+            {
+                std::vector<std::filesystem::path> inputs(operands.begin(), operands.end());
+
+                for (const auto& path : CollectRecordings(inputs))
+                {
+                    Recording recording;
+                    if (!LoadRecordingFile(path, recording))
+                    {
+                        std::fprintf(stderr, "Failed to load %s\n", path.string().c_str());
+                        status = EXIT_FAILURE;
+                        continue;
+                    }
+
+                    recording.Name = path.stem().string();
+                    if (!store.Put(recording))
+                    {
+                        std::fprintf(stderr, "Failed to add %s\n", path.string().c_str());
+                        status = EXIT_FAILURE;
+                    }
+                }
+            }
+            else if (action == "extract")
+            {
+                if (!CreateOutputFolder(outputFolder))
+                    return EXIT_FAILURE;
+
+                for (std::string_view operand : operands)
+                {
+                    std::string name(operand);
+                    std::filesystem::path output = outputFolder / (name + ".rec");
+
+                    Recording recording;
+                    if (!store.Get(name, recording) || !Serialization::WriteCompressed(recording, output))
+                    {
+                        std::fprintf(stderr, "Failed to extract %s\n", name.c_str());
+                        status = EXIT_FAILURE;
+                    }
+                }
+            }
+            else if (action == "remove")
+            {
+                for (std::string_view operand : operands)
+                {
+                    std::string name(operand);
+                    if (!store.Remove(name))
+                    {
+                        std::fprintf(stderr, "Failed to remove %s\n", name.c_str());
+                        status = EXIT_FAILURE;
+                    }
+                }
+            }
+            else if (action == "gc")
+            {
+                std::printf("Deleted %zu unused files\n", store.CollectGarbage());
+            }
+
+            StoreStats stats = store.GetStats();
+            uint64_t storedBytes = stats.ChunkBytes + stats.ManifestBytes;
+
+            std::printf("%zu recordings, %llu events in %zu chunks: %.2f MB on disk, %.2f MB without sharing (%.1f%%)\n",
+                stats.Recordings, static_cast<unsigned long long>(stats.Events), stats.Chunks,
+                storedBytes / 1e6, stats.ReferencedBytes / 1e6, 100.0 * storedBytes / std::max<uint64_t>(stats.ReferencedBytes, 1));
+
+            return status;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace KeyActions;
+
+    if (argc < 2)
+    {
+        Cli::PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    std::string_view command = argv[1];
+    Cli::Arguments args(argv + 2, argv + argc);
+
+    if (command == "optimize")
+        return Cli::Optimize(args);
+
+    if (command == "convert")
+        return Cli::Convert(args);
+
+    if (command == "validate")
+        return Cli::Validate(args);
+
+    if (command == "reindex")
+        return Cli::Reindex(args);
+
+    if (command == "store")
+        return Cli::Store(args);
+
+    if (command != "help" && command != "--help" && command != "-h")
+        std::fprintf(stderr, "Unknown command: %s\n\n", argv[1]);
+
+    Cli::PrintUsage();
+    return command == "help" || command == "--help" || command == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,457 @@
+#include "AtomicFile.h"
+
+#include "Lumina/Core/Log.h"
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#else
+    #include <cerrno>
+    #include <csignal>
+    #include <cstdio>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+namespace KeyActions
+{
+    namespace
+    {
+        constexpr const char* TemporaryExtension = ".tmp";
+        constexpr int MaxNameAttempts = 16;
+
+        bool ParseNumber(const std::string& text, uint64_t& value)
+        {
+            if (text.empty() || text.size() > 19)
+                return false;
+
+            value = 0;
+            for (char c : text)
+            {
+                if (c < '0' || c > '9')
+                    return false;
+
+                value = value * 10 + static_cast<uint64_t>(c - '0');
+            }
+
+            return true;
+        }
+
+        bool IsProcessRunning(uint64_t process)
+        {
+#ifdef LUMINA_PLATFORM_WINDOWS
+            if (process > MAXDWORD)
+                return false;
+
+            HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(process));
+            if (handle == nullptr)
+                return GetLastError() == ERROR_ACCESS_DENIED;
+
+            DWORD exitCode = 0;
+            bool running = GetExitCodeProcess(handle, &exitCode) && exitCode == STILL_ACTIVE;
+            CloseHandle(handle);
+            return running;
+#else
+            // Zero and anything past pid_t would make kill() signal a whole group
+            if (process == 0 || process > static_cast<uint64_t>(INT32_MAX))
+                return false;
+
+            return ::kill(static_cast<pid_t>(process), 0) == 0 || errno == EPERM;
+#endif
+        }
+    }
+
+    AtomicFile::~AtomicFile()
+    {
+        Abort();
+    }
+
+    std::filesystem::path AtomicFile::GetTemporaryPath(const std::filesystem::path& targetPath)
+    {
+        static std::atomic<uint64_t> s_Counter{ 0 };
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+        uint64_t process = GetCurrentProcessId();
+#else
+        uint64_t process = static_cast<uint64_t>(getpid());
+#endif
+
+        // Writers of the same target, in this process or another, each get their own temporary
+        std::filesystem::path temporaryPath = targetPath;
+        temporaryPath += "." + std::to_string(process) + "-" + std::to_string(++s_Counter) + TemporaryExtension;
+        return temporaryPath;
+    }
+
+    bool AtomicFile::IsTemporaryPath(const std::filesystem::path& path)
+    {
+        std::filesystem::path targetPath;
+        uint64_t process = 0;
+        return ParseTemporaryPath(path, targetPath, process);
+    }
+
+    bool AtomicFile::ParseTemporaryPath(const std::filesystem::path& path, std::filesystem::path& targetPath, uint64_t& process)
+    {
+        if (path.extension() != TemporaryExtension)
+            return false;
+
+        // "<target>.<process>-<n>", where the target keeps an extension of its own
+        std::string stem = path.stem().string();
+        size_t dot = stem.rfind('.');
+        if (dot == std::string::npos || dot == 0)
+            return false;
+
+        std::string suffix = stem.substr(dot + 1);
+        size_t dash = suffix.find('-');
+        uint64_t counter = 0;
+        if (dash == std::string::npos || !ParseNumber(suffix.substr(0, dash), process) || !ParseNumber(suffix.substr(dash + 1), counter))
+            return false;
+
+        targetPath = path.parent_path() / stem.substr(0, dot);
+        return targetPath.has_extension();
+    }
+
+    bool AtomicFile::IsAbandonedTemporary(const std::filesystem::path& path)
+    {
+        std::filesystem::path targetPath;
+        uint64_t process = 0;
+        return ParseTemporaryPath(path, targetPath, process) && !IsProcessRunning(process);
+    }
+
+    void AtomicFile::Abort()
+    {
+        if (!IsOpen())
+            return;
+
+        Close(false);
+
+        std::error_code errorCode;
+        std::filesystem::remove(m_TemporaryPath, errorCode);
+    }
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+
+    bool AtomicFile::Open(const std::filesystem::path& targetPath)
+    {
+        Abort();
+
+        m_TargetPath = targetPath;
+        m_TemporaryPath = GetTemporaryPath(targetPath);
+        m_Failed = false;
+
+        // Never reuse a file: a crashed process with a recycled id may have left one of this name
+        HANDLE file = INVALID_HANDLE_VALUE;
+        for (int attempt = 0; attempt <= MaxNameAttempts; attempt++)
+        {
+            if (attempt > 0)
+                m_TemporaryPath = GetTemporaryPath(targetPath);
+
+            file = CreateFileW(m_TemporaryPath.c_str(), GENERIC_WRITE, 0, nullptr,
+                CREATE_NEW, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+            if (file != INVALID_HANDLE_VALUE || GetLastError() != ERROR_FILE_EXISTS)
+                break;
+        }
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            LUMINA_LOG_ERROR("Failed to create temporary file: {}", m_TemporaryPath.string());
+            return false;
+        }
+
+        m_Handle = file;
+        return true;
+    }
+
+    bool AtomicFile::Write(const void* data, size_t size)
+    {
+        if (!IsOpen() || m_Failed)
+            return false;
+
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+            DWORD written = 0;
+
+            if (!WriteFile(m_Handle, bytes, chunk, &written, nullptr) || written == 0)
+            {
+                m_Failed = true;
+                return false;
+            }
+
+            bytes += written;
+            size -= written;
+        }
+
+        return true;
+    }
+
+    bool AtomicFile::WriteAt(uint64_t offset, const void* data, size_t size)
+    {
+        if (!IsOpen() || m_Failed)
+            return false;
+
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(offset);
+
+        LARGE_INTEGER previous;
+        LARGE_INTEGER current = {};
+        if (!SetFilePointerEx(m_Handle, current, &previous, FILE_CURRENT) ||
+            !SetFilePointerEx(m_Handle, position, nullptr, FILE_BEGIN))
+        {
+            m_Failed = true;
+            return false;
+        }
+
+        bool written = Write(data, size);
+
+        if (!SetFilePointerEx(m_Handle, previous, nullptr, FILE_BEGIN))
+            m_Failed = true;
+
+        return written && !m_Failed;
+    }
+
+    bool AtomicFile::Close(bool flush)
+    {
+        if (!IsOpen())
+            return false;
+
+        bool flushed = !flush || FlushFileBuffers(m_Handle);
+        bool closed = CloseHandle(m_Handle);
+        m_Handle = nullptr;
+
+        return flushed && closed;
+    }
+
+    bool AtomicFile::Commit()
+    {
+        if (!IsOpen())
+            return false;
+
+        if (m_Failed || !Close(true))
+        {
+            LUMINA_LOG_ERROR("Failed to write {}", m_TemporaryPath.string());
+
+            std::error_code errorCode;
+            std::filesystem::remove(m_TemporaryPath, errorCode);
+            return false;
+        }
+
+        if (!MoveIntoPlace(m_TemporaryPath, m_TargetPath))
+        {
+            std::error_code errorCode;
+            std::filesystem::remove(m_TemporaryPath, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool AtomicFile::Replace(const std::filesystem::path& sourcePath, const std::filesystem::path& targetPath)
+    {
+        HANDLE file = CreateFileW(sourcePath.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            LUMINA_LOG_ERROR("Failed to open {} to flush it", sourcePath.string());
+            return false;
+        }
+
+        bool flushed = FlushFileBuffers(file);
+        CloseHandle(file);
+
+        if (!flushed)
+        {
+            LUMINA_LOG_ERROR("Failed to flush {}", sourcePath.string());
+            return false;
+        }
+
+        return MoveIntoPlace(sourcePath, targetPath);
+    }
+
+    bool AtomicFile::MoveIntoPlace(const std::filesystem::path& sourcePath, const std::filesystem::path& targetPath)
+    {
+        if (!MoveFileExW(sourcePath.c_str(), targetPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+        {
+            LUMINA_LOG_ERROR("Failed to replace {} with {}", targetPath.string(), sourcePath.string());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool AtomicFile::IsOpen() const
+    {
+        return m_Handle != nullptr;
+    }
+
+#else
+
+    bool AtomicFile::Open(const std::filesystem::path& targetPath)
+    {
+        Abort();
+
+        m_TargetPath = targetPath;
+        m_TemporaryPath = GetTemporaryPath(targetPath);
+        m_Failed = false;
+
+        // Never reuse a file: a crashed process with a recycled id may have left one of this name
+        int descriptor = ::open(m_TemporaryPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        for (int attempt = 0; descriptor < 0 && errno == EEXIST && attempt < MaxNameAttempts; attempt++)
+        {
+            m_TemporaryPath = GetTemporaryPath(targetPath);
+            descriptor = ::open(m_TemporaryPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        }
+
+        if (descriptor < 0)
+        {
+            LUMINA_LOG_ERROR("Failed to create temporary file: {}", m_TemporaryPath.string());
+            return false;
+        }
+
+        m_Descriptor = descriptor;
+        return true;
+    }
+
+    bool AtomicFile::Write(const void* data, size_t size)
+    {
+        if (!IsOpen() || m_Failed)
+            return false;
+
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            ssize_t written = ::write(m_Descriptor, bytes, size);
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            if (written <= 0)
+            {
+                m_Failed = true;
+                return false;
+            }
+
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+
+        return true;
+    }
+
+    bool AtomicFile::WriteAt(uint64_t offset, const void* data, size_t size)
+    {
+        if (!IsOpen() || m_Failed)
+            return false;
+
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            ssize_t written = ::pwrite(m_Descriptor, bytes, size, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            if (written <= 0)
+            {
+                m_Failed = true;
+                return false;
+            }
+
+            bytes += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+
+        return true;
+    }
+
+    bool AtomicFile::Close(bool flush)
+    {
+        if (!IsOpen())
+            return false;
+
+        bool flushed = !flush || ::fsync(m_Descriptor) == 0;
+        bool closed = ::close(m_Descriptor) == 0;
+        m_Descriptor = -1;
+
+        return flushed && closed;
+    }
+
+    bool AtomicFile::Commit()
+    {
+        if (!IsOpen())
+            return false;
+
+        if (m_Failed || !Close(true))
+        {
+            LUMINA_LOG_ERROR("Failed to write {}", m_TemporaryPath.string());
+
+            std::error_code errorCode;
+            std::filesystem::remove(m_TemporaryPath, errorCode);
+            return false;
+        }
+
+        if (!MoveIntoPlace(m_TemporaryPath, m_TargetPath))
+        {
+            std::error_code errorCode;
+            std::filesystem::remove(m_TemporaryPath, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool AtomicFile::Replace(const std::filesystem::path& sourcePath, const std::filesystem::path& targetPath)
+    {
+        int descriptor = ::open(sourcePath.c_str(), O_WRONLY | O_CLOEXEC);
+        if (descriptor < 0)
+        {
+            LUMINA_LOG_ERROR("Failed to open {} to flush it", sourcePath.string());
+            return false;
+        }
+
+        bool flushed = ::fsync(descriptor) == 0;
+        bool closed = ::close(descriptor) == 0;
+
+        if (!flushed || !closed)
+        {
+            LUMINA_LOG_ERROR("Failed to flush {}", sourcePath.string());
+            return false;
+        }
+
+        return MoveIntoPlace(sourcePath, targetPath);
+    }
+
+    bool AtomicFile::MoveIntoPlace(const std::filesystem::path& sourcePath, const std::filesystem::path& targetPath)
+    {
+        if (::rename(sourcePath.c_str(), targetPath.c_str()) != 0)
+        {
+            LUMINA_LOG_ERROR("Failed to replace {} with {}", targetPath.string(), sourcePath.string());
+            return false;
+        }
+
+        // The rename itself is only durable once the directory entry is flushed
+        std::filesystem::path folder = targetPath.parent_path();
+        int directory = ::open(folder.empty() ? "." : folder.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (directory >= 0)
+        {
+            ::fsync(directory);
+            ::close(directory);
+        }
+
+        return true;
+    }
+
+    bool AtomicFile::IsOpen() const
+    {
+        return m_Descriptor >= 0;
+    }
+
+#endif
+}
\ No newline at end of file
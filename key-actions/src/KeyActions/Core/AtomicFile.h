@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+
+namespace KeyActions
+{
+    // Writes a file through a temporary next to it. The target is not touched until Commit(),
+    // which flushes the data to disk and renames the temporary over the target, so the target
+    // is always either the complete old file or the complete new one. A crash mid-write leaves
+    // only "<target>.<process>-<n>.tmp" behind.
+    //
+    // Every writer gets a temporary of its own, so concurrent saves of one target (the library
+    // index from two IO workers, say) never share a file; the last to commit wins whole.
+    class AtomicFile
+    {
+    public:
+        AtomicFile() = default;
+
+        // Discards the temporary if Commit() was never reached
+        ~AtomicFile();
+
+        AtomicFile(const AtomicFile&) = delete;
+        AtomicFile& operator=(const AtomicFile&) = delete;
+
+        bool Open(const std::filesystem::path& targetPath);
+
+        // Failures are sticky; Commit() reports them
+        bool Write(const void* data, size_t size);
+        bool WriteAt(uint64_t offset, const void* data, size_t size);
+
+        // Flushes to disk and replaces the target; on failure the target is left as it was
+        bool Commit();
+
+        // Closes and deletes the temporary
+        void Abort();
+
+        // Commit() for a file written some other way, such as a finalized recording stream:
+        // flushes it to disk and renames it over the target. On failure it is left in place.
+        static bool Replace(const std::filesystem::path& sourcePath, const std::filesystem::path& targetPath);
+
+        bool IsOpen() const;
+        const std::filesystem::path& GetTargetPath() const { return m_TargetPath; }
+
+        // A new, unused temporary name for the target on every call
+        static std::filesystem::path GetTemporaryPath(const std::filesystem::path& targetPath);
+
+        // True only for names GetTemporaryPath() makes, "<target>.<process>-<n>.tmp"; any other
+        // ".tmp" file belongs to someone else
+        static bool IsTemporaryPath(const std::filesystem::path& path);
+        static bool ParseTemporaryPath(const std::filesystem::path& path, std::filesystem::path& targetPath, uint64_t& process);
+
+        // A temporary whose writing process has exited, so nothing will ever commit it.
+        // Temporaries of running processes, this one included, may still be in use.
+        static bool IsAbandonedTemporary(const std::filesystem::path& path);
+
+    private:
+        bool Close(bool flush);
+
+        // Renames an already flushed file over the target and makes the rename durable
+        static bool MoveIntoPlace(const std::filesystem::path& sourcePath, const std::filesystem::path& targetPath);
+
+    private:
+        std::filesystem::path m_TargetPath;
+        std::filesystem::path m_TemporaryPath;
+        bool m_Failed = false;
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+        void* m_Handle = nullptr;
+#else
+        int m_Descriptor = -1;
+#endif
+    };
+}
\ No newline at end of file
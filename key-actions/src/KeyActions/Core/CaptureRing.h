@@ -0,0 +1,137 @@
+#pragma once
+
+#include "RecordedEvent.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace KeyActions
+{
+    // One raw input as the hook saw it, stamped before any processing happens
+    struct CapturedInput
+    {
+        RecordedAction Action = RecordedAction::KeyPressed;
+        int Code = 0;           // KeyCode for key actions, MouseCode for button actions
+        int A = 0;              // X, or scroll DX
+        int B = 0;              // Y, or scroll DY
+        int64_t Timestamp = 0;  // Clock::Now() nanoseconds at the hook
+    };
+
+    // Bounded single-producer single-consumer queue. The producer never blocks or
+    // allocates; when the consumer falls a whole ring behind, new items are dropped and
+    // counted instead of stalling the producer. Head and tail live on separate cache
+    // lines, and each side keeps a cached copy of the other's index so the shared line
+    // is only read when the ring looks full or empty.
+    template<typename T>
+    class SpscRing
+    {
+    public:
+        // Capacity is rounded up to a power of two
+        explicit SpscRing(size_t capacity = 8192)
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+
+            m_Buffer.resize(size);
+            m_Mask = size - 1;
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        // Producer side
+        bool TryPush(const T& item)
+        {
+            size_t tail = m_Tail.load(std::memory_order_relaxed);
+
+            if (tail - m_CachedHead > m_Mask)
+            {
+                m_CachedHead = m_Head.load(std::memory_order_acquire);
+                if (tail - m_CachedHead > m_Mask)
+                {
+                    m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            m_Buffer[tail & m_Mask] = item;
+            m_Tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        bool TryPop(T& item)
+        {
+            size_t head = m_Head.load(std::memory_order_relaxed);
+
+            if (head == m_CachedTail)
+            {
+                m_CachedTail = m_Tail.load(std::memory_order_acquire);
+                if (head == m_CachedTail)
+                    return false;
+            }
+
+            item = m_Buffer[head & m_Mask];
+            m_Head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. Calls func on up to maxItems items in order and releases their
+        // slots in one store; returns how many were handled.
+        template<typename Func>
+        size_t Drain(Func&& func, size_t maxItems = std::numeric_limits<size_t>::max())
+        {
+            size_t head = m_Head.load(std::memory_order_relaxed);
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+
+            size_t count = m_CachedTail - head;
+            if (count > maxItems)
+                count = maxItems;
+
+            for (size_t i = 0; i < count; i++)
+                func(static_cast<const T&>(m_Buffer[(head + i) & m_Mask]));
+
+            if (count > 0)
+                m_Head.store(head + count, std::memory_order_release);
+
+            return count;
+        }
+
+        // Approximate when the other side is running
+        size_t Size() const { return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire); }
+        bool IsEmpty() const { return Size() == 0; }
+        size_t GetCapacity() const { return m_Buffer.size(); }
+        uint64_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+        // Only when neither side is running
+        void Reset()
+        {
+            m_Head.store(0, std::memory_order_relaxed);
+            m_Tail.store(0, std::memory_order_relaxed);
+            m_CachedHead = 0;
+            m_CachedTail = 0;
+            m_Dropped.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr size_t CacheLineSize = 64;
+
+        std::vector<T> m_Buffer;
+        size_t m_Mask = 0;
+
+        // Written by the consumer
+        alignas(CacheLineSize) std::atomic<size_t> m_Head{ 0 };
+        size_t m_CachedTail = 0;
+
+        // Written by the producer
+        alignas(CacheLineSize) std::atomic<size_t> m_Tail{ 0 };
+        size_t m_CachedHead = 0;
+        std::atomic<uint64_t> m_Dropped{ 0 };
+    };
+
+    using CaptureRing = SpscRing<CapturedInput>;
+}
\ No newline at end of file
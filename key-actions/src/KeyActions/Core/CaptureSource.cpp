@@ -0,0 +1,50 @@
+#include "CaptureSource.h"
+
+#include "Clock.h"
+
+namespace KeyActions
+{
+    void HookClock::Reset()
+    {
+        m_Calibrated = false;
+        m_LastTick = 0;
+        m_Ticks = 0;
+        m_Offset = 0;
+    }
+
+    void HookClock::Calibrate(uint32_t currentTick, int64_t now)
+    {
+        m_Calibrated = true;
+        m_LastTick = currentTick;
+        m_Ticks = currentTick;
+        m_Offset = now - m_Ticks * Clock::NanosecondsPerMillisecond;
+    }
+
+    int64_t HookClock::ToClock(uint32_t tickMilliseconds)
+    {
+        return ToClock(tickMilliseconds, Clock::Now());
+    }
+
+    int64_t HookClock::ToClock(uint32_t tickMilliseconds, int64_t now)
+    {
+        if (!m_Calibrated)
+        {
+            Calibrate(tickMilliseconds, now);
+            return now;
+        }
+
+        // Signed difference, so wrapping past 2^32 and slightly out of order ticks both work
+        m_Ticks += static_cast<int32_t>(tickMilliseconds - m_LastTick);
+        m_LastTick = tickMilliseconds;
+
+        int64_t time = m_Ticks * Clock::NanosecondsPerMillisecond + m_Offset;
+        if (time > now)
+        {
+            // Less queueing than anything before it; tighten the calibration
+            m_Offset -= time - now;
+            time = now;
+        }
+
+        return time;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CaptureRing.h"
+
+#include <cstdint>
+#include <functional>
+
+namespace KeyActions
+{
+    // Something that observes input where it happens, typically an OS hook on its own
+    // thread, and reports each input stamped with the time the OS saw it. The callback is
+    // called from a single thread, between Start() and the return of Stop().
+    class CaptureSource
+    {
+    public:
+        using InputCallback = std::function<void(const CapturedInput& input)>;
+
+        virtual ~CaptureSource() = default;
+
+        virtual bool Start(InputCallback callback) = 0;
+        virtual void Stop() = 0;
+    };
+
+    // Maps the 32-bit millisecond tick counts input hooks report (KBDLLHOOKSTRUCT::time,
+    // X server time) onto Clock nanoseconds. Ticks are unwrapped into 64 bits, and the
+    // offset to Clock is the smallest (now - tick) seen, i.e. the observation that crossed
+    // the least queueing. Stamps are never later than the moment they were converted.
+    class HookClock
+    {
+    public:
+        // Forgets the calibration; call once per capture so drift can't build up
+        void Reset();
+
+        // Seeds the calibration with the OS tick read right now (GetTickCount() and the like),
+        // so the first stamps don't carry the queueing delay of the first event
+        void Calibrate(uint32_t currentTick, int64_t now);
+
+        int64_t ToClock(uint32_t tickMilliseconds);
+        int64_t ToClock(uint32_t tickMilliseconds, int64_t now);
+
+    private:
+        bool m_Calibrated = false;
+        uint32_t m_LastTick = 0;
+        int64_t m_Ticks = 0;        // Unwrapped tick of m_LastTick
+        int64_t m_Offset = 0;       // Clock nanoseconds at tick 0
+    };
+}
\ No newline at end of file
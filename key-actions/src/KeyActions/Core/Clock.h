@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace KeyActions
+{
+    // Monotonic nanosecond clock used to stamp recorded events. Timestamps are
+    // int64 nanoseconds, which stay exact for centuries of recording time.
+    namespace Clock
+    {
+        inline constexpr int64_t NanosecondsPerSecond = 1000000000;
+        inline constexpr int64_t NanosecondsPerMillisecond = 1000000;
+
+        inline int64_t Now()
+        {
+            auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count();
+        }
+
+        inline constexpr double ToSeconds(int64_t nanoseconds)
+        {
+            return static_cast<double>(nanoseconds) / NanosecondsPerSecond;
+        }
+
+        inline int64_t FromSeconds(double seconds)
+        {
+            return static_cast<int64_t>(std::llround(seconds * NanosecondsPerSecond));
+        }
+    }
+}
\ No newline at end of file
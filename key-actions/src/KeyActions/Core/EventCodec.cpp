@@ -0,0 +1,475 @@
+#include "EventCodec.h"
+
+namespace KeyActions
+{
+    namespace
+    {
+        enum Column
+        {
+            ColumnActions,
+            ColumnTimes,
+            ColumnCodes,
+            ColumnModifiers,
+            ColumnX,
+            ColumnY,
+            ColumnScrolls,
+            ColumnCount
+        };
+
+        enum class ColumnMode : uint8_t
+        {
+            Raw,
+            Rans
+        };
+
+        // rANS with 12-bit probabilities and a 32-bit state renormalized a byte at a time
+        constexpr uint32_t ProbabilityBits = 12;
+        constexpr uint32_t ProbabilityScale = 1u << ProbabilityBits;
+        constexpr uint32_t StateLow = 1u << 23;
+
+        // Smaller columns are never worth their frequency table
+        constexpr size_t MinEntropySize = 64;
+
+        // Longest column an event can produce: two 10-byte varints for a scroll
+        constexpr size_t MaxColumnBytesPerEvent = 20;
+
+        uint64_t ZigZag(int64_t value)
+        {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        int64_t UnZigZag(uint64_t value)
+        {
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        void WriteVarint(std::vector<uint8_t>& output, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                output.push_back(static_cast<uint8_t>(value) | 0x80);
+                value >>= 7;
+            }
+
+            output.push_back(static_cast<uint8_t>(value));
+        }
+
+        // Bounds-checked cursor; a failed read returns 0 and marks the reader failed
+        class ByteReader
+        {
+        public:
+            ByteReader() = default;
+            ByteReader(const uint8_t* data, size_t size) : m_Position(data), m_End(data + size) {}
+
+            uint8_t ReadByte()
+            {
+                if (m_Position == m_End)
+                {
+                    m_Failed = true;
+                    return 0;
+                }
+
+                return *m_Position++;
+            }
+
+            uint64_t ReadVarint()
+            {
+                uint64_t value = 0;
+                for (int shift = 0; shift < 64 && m_Position != m_End; shift += 7)
+                {
+                    uint8_t byte = *m_Position++;
+                    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+                    if ((byte & 0x80) == 0)
+                        return value;
+                }
+
+                m_Failed = true;
+                return 0;
+            }
+
+            int64_t ReadSigned()
+            {
+                return UnZigZag(ReadVarint());
+            }
+
+            // Returns the next size bytes, or nullptr if there are not that many
+            const uint8_t* Take(uint64_t size)
+            {
+                if (size > static_cast<uint64_t>(m_End - m_Position))
+                {
+                    m_Failed = true;
+                    return nullptr;
+                }
+
+                const uint8_t* bytes = m_Position;
+                m_Position += size;
+                return bytes;
+            }
+
+            size_t GetRemaining() const { return static_cast<size_t>(m_End - m_Position); }
+            bool IsFailed() const { return m_Failed; }
+            bool IsDone() const { return !m_Failed && m_Position == m_End; }
+
+        private:
+            const uint8_t* m_Position = nullptr;
+            const uint8_t* m_End = nullptr;
+            bool m_Failed = false;
+        };
+
+        // Scales byte counts to frequencies summing to ProbabilityScale, keeping every
+        // present symbol at least 1
+        bool NormalizeFrequencies(const uint32_t counts[256], size_t total, uint32_t frequencies[256])
+        {
+            uint32_t sum = 0;
+            int largest = -1;
+
+            for (int symbol = 0; symbol < 256; symbol++)
+            {
+                frequencies[symbol] = 0;
+                if (counts[symbol] == 0)
+                    continue;
+
+                uint32_t frequency = static_cast<uint32_t>(static_cast<uint64_t>(counts[symbol]) * ProbabilityScale / total);
+                frequencies[symbol] = frequency > 0 ? frequency : 1;
+                sum += frequencies[symbol];
+
+                if (largest < 0 || counts[symbol] > counts[largest])
+                    largest = symbol;
+            }
+
+            if (largest < 0)
+                return false;
+
+            // Rounding leaves the total slightly off; the most common symbol absorbs the difference
+            int64_t adjusted = static_cast<int64_t>(frequencies[largest]) + ProbabilityScale - sum;
+            if (adjusted < 1)
+                return false;
+
+            frequencies[largest] = static_cast<uint32_t>(adjusted);
+            return true;
+        }
+
+        // Appends the frequency table and coded bytes; returns false if the result would
+        // not be smaller than the input
+        bool EncodeRans(const std::vector<uint8_t>& input, std::vector<uint8_t>& output)
+        {
+            uint32_t counts[256] = {};
+            for (uint8_t byte : input)
+                counts[byte]++;
+
+            uint32_t frequencies[256];
+            if (!NormalizeFrequencies(counts, input.size(), frequencies))
+                return false;
+
+            uint32_t starts[256];
+            uint32_t start = 0;
+            int symbolCount = 0;
+            for (int symbol = 0; symbol < 256; symbol++)
+            {
+                starts[symbol] = start;
+                start += frequencies[symbol];
+                symbolCount += frequencies[symbol] != 0;
+            }
+
+            // Table: symbol count - 1, then each present symbol with its frequency
+            output.push_back(static_cast<uint8_t>(symbolCount - 1));
+            for (int symbol = 0; symbol < 256; symbol++)
+            {
+                if (frequencies[symbol] == 0)
+                    continue;
+
+                output.push_back(static_cast<uint8_t>(symbol));
+                WriteVarint(output, frequencies[symbol]);
+            }
+
+            // The encoder runs backwards so the decoder can read forwards; giving up once the
+            // payload reaches the input size also bounds the buffer
+            std::vector<uint8_t> payload(input.size() + sizeof(uint32_t));
+            uint8_t* const begin = payload.data();
+            uint8_t* const end = begin + payload.size();
+            uint8_t* pointer = end;
+
+            uint32_t state = StateLow;
+            for (size_t i = input.size(); i-- > 0;)
+            {
+                uint32_t frequency = frequencies[input[i]];
+                uint32_t maxState = ((StateLow >> ProbabilityBits) << 8) * frequency;
+
+                while (state >= maxState)
+                {
+                    if (pointer - begin <= static_cast<ptrdiff_t>(sizeof(uint32_t)))
+                        return false;
+
+                    *--pointer = static_cast<uint8_t>(state);
+                    state >>= 8;
+                }
+
+                state = ((state / frequency) << ProbabilityBits) + (state % frequency) + starts[input[i]];
+            }
+
+            pointer -= sizeof(uint32_t);
+            for (size_t i = 0; i < sizeof(uint32_t); i++)
+                pointer[i] = static_cast<uint8_t>(state >> (8 * i));
+
+            output.insert(output.end(), pointer, end);
+            return true;
+        }
+
+        // Everything the decoder needs for one probability slot, so each symbol is one lookup
+        struct RansSlot
+        {
+            uint16_t Frequency;
+            uint16_t Offset;        // Slot minus the symbol's start
+            uint8_t Symbol;
+        };
+
+        bool DecodeRans(const uint8_t* data, size_t size, uint8_t* output, size_t count)
+        {
+            ByteReader reader(data, size);
+
+            RansSlot slots[ProbabilityScale];
+            bool seen[256] = {};
+
+            size_t symbolCount = static_cast<size_t>(reader.ReadByte()) + 1;
+            uint32_t start = 0;
+            for (size_t i = 0; i < symbolCount; i++)
+            {
+                uint8_t symbol = reader.ReadByte();
+                uint64_t frequency = reader.ReadVarint();
+
+                if (reader.IsFailed() || frequency == 0 || seen[symbol] || start + frequency > ProbabilityScale)
+                    return false;
+
+                seen[symbol] = true;
+                for (uint32_t offset = 0; offset < frequency; offset++)
+                    slots[start + offset] = { static_cast<uint16_t>(frequency), static_cast<uint16_t>(offset), symbol };
+
+                start += static_cast<uint32_t>(frequency);
+            }
+
+            if (start != ProbabilityScale || reader.GetRemaining() < sizeof(uint32_t))
+                return false;
+
+            size_t payloadSize = reader.GetRemaining();
+            const uint8_t* pointer = reader.Take(payloadSize);
+            const uint8_t* end = pointer + payloadSize;
+
+            uint32_t state = 0;
+            for (size_t i = 0; i < sizeof(uint32_t); i++)
+                state |= static_cast<uint32_t>(*pointer++) << (8 * i);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                const RansSlot& slot = slots[state & (ProbabilityScale - 1)];
+                output[i] = slot.Symbol;
+
+                state = slot.Frequency * (state >> ProbabilityBits) + slot.Offset;
+
+                while (state < StateLow)
+                {
+                    if (pointer == end)
+                        return false;
+
+                    state = (state << 8) | *pointer++;
+                }
+            }
+
+            // Decoding ends exactly where encoding started
+            return pointer == end && state == StateLow;
+        }
+
+        void WriteColumn(const std::vector<uint8_t>& column, bool entropy, std::vector<uint8_t>& scratch, std::vector<uint8_t>& output)
+        {
+            if (entropy && column.size() >= MinEntropySize)
+            {
+                scratch.clear();
+
+                // Worth a column header and table only if it saves a few percent
+                if (EncodeRans(column, scratch) && scratch.size() < column.size() - column.size() / 32)
+                {
+                    output.push_back(static_cast<uint8_t>(ColumnMode::Rans));
+                    WriteVarint(output, column.size());
+                    WriteVarint(output, scratch.size());
+                    output.insert(output.end(), scratch.begin(), scratch.end());
+                    return;
+                }
+            }
+
+            output.push_back(static_cast<uint8_t>(ColumnMode::Raw));
+            WriteVarint(output, column.size());
+            output.insert(output.end(), column.begin(), column.end());
+        }
+
+        // Raw columns are read in place; coded ones are decoded into storage
+        bool ReadColumn(ByteReader& reader, size_t maxSize, std::vector<uint8_t>& storage, ByteReader& column)
+        {
+            ColumnMode mode = static_cast<ColumnMode>(reader.ReadByte());
+            uint64_t rawSize = reader.ReadVarint();
+
+            if (reader.IsFailed() || rawSize > maxSize)
+                return false;
+
+            if (mode == ColumnMode::Raw)
+            {
+                const uint8_t* bytes = reader.Take(rawSize);
+                if (!bytes)
+                    return false;
+
+                column = ByteReader(bytes, rawSize);
+                return true;
+            }
+
+            if (mode == ColumnMode::Rans)
+            {
+                uint64_t storedSize = reader.ReadVarint();
+                const uint8_t* bytes = reader.Take(storedSize);
+                if (!bytes)
+                    return false;
+
+                storage.resize(rawSize);
+                if (!DecodeRans(bytes, storedSize, storage.data(), rawSize))
+                    return false;
+
+                column = ByteReader(storage.data(), rawSize);
+                return true;
+            }
+
+            return false;
+        }
+    }
+
+    void EventCodec::EncodeBlock(const EventStore& events, size_t first, size_t count, bool entropy, std::vector<uint8_t>& output)
+    {
+        std::vector<uint8_t> columns[ColumnCount];
+        columns[ColumnActions].reserve(count);
+        columns[ColumnTimes].reserve(count * 2);
+        columns[ColumnX].reserve(count);
+        columns[ColumnY].reserve(count);
+
+        const auto& timestamps = events.GetTimestamps();
+        const auto& actions = events.GetActions();
+
+        int64_t previousTime = count > 0 ? timestamps[first] : 0;
+        int64_t previousX = 0;
+        int64_t previousY = 0;
+
+        auto writePosition = [&](const EventView& event) {
+            WriteVarint(columns[ColumnX], ZigZag(event.GetX() - previousX));
+            WriteVarint(columns[ColumnY], ZigZag(event.GetY() - previousY));
+            previousX = event.GetX();
+            previousY = event.GetY();
+        };
+
+        for (size_t i = first; i < first + count; i++)
+        {
+            const EventView event = events[i];
+            const RecordedAction action = actions[i];
+
+            columns[ColumnActions].push_back(static_cast<uint8_t>(action));
+            WriteVarint(columns[ColumnTimes], ZigZag(timestamps[i] - previousTime));
+            previousTime = timestamps[i];
+
+            switch (action)
+            {
+            case RecordedAction::KeyPressed:
+            case RecordedAction::KeyReleased:
+                WriteVarint(columns[ColumnCodes], ZigZag(static_cast<int64_t>(event.GetKey())));
+                columns[ColumnModifiers].push_back(event.GetModifiers());
+                break;
+            case RecordedAction::MousePressed:
+            case RecordedAction::MouseReleased:
+                WriteVarint(columns[ColumnCodes], ZigZag(static_cast<int64_t>(event.GetButton())));
+                writePosition(event);
+                break;
+            case RecordedAction::MouseMoved:
+                writePosition(event);
+                break;
+            case RecordedAction::MouseScrolled:
+                WriteVarint(columns[ColumnScrolls], ZigZag(event.GetScrollDX()));
+                WriteVarint(columns[ColumnScrolls], ZigZag(event.GetScrollDY()));
+                break;
+            }
+        }
+
+        std::vector<uint8_t> scratch;
+        for (const auto& column : columns)
+        {
+            WriteColumn(column, entropy, scratch, output);
+        }
+    }
+
+    bool EventCodec::DecodeBlock(const uint8_t* data, size_t size, int64_t firstTimestamp, size_t eventCount, EventStore& events)
+    {
+        ByteReader reader(data, size);
+
+        std::vector<uint8_t> storage[ColumnCount];
+        ByteReader columns[ColumnCount];
+
+        for (int column = 0; column < ColumnCount; column++)
+        {
+            if (!ReadColumn(reader, eventCount * MaxColumnBytesPerEvent, storage[column], columns[column]))
+                return false;
+        }
+
+        if (!reader.IsDone() || columns[ColumnActions].GetRemaining() != eventCount)
+            return false;
+
+        ByteReader& actions = columns[ColumnActions];
+        ByteReader& times = columns[ColumnTimes];
+        ByteReader& codes = columns[ColumnCodes];
+        ByteReader& modifiers = columns[ColumnModifiers];
+        ByteReader& xs = columns[ColumnX];
+        ByteReader& ys = columns[ColumnY];
+        ByteReader& scrolls = columns[ColumnScrolls];
+
+        int64_t time = firstTimestamp;
+        int64_t x = 0;
+        int64_t y = 0;
+
+        for (size_t i = 0; i < eventCount; i++)
+        {
+            RecordedEvent event;
+            event.Action = static_cast<RecordedAction>(actions.ReadByte());
+
+            time += times.ReadSigned();
+            event.Timestamp = time;
+
+            switch (event.Action)
+            {
+            case RecordedAction::KeyPressed:
+            case RecordedAction::KeyReleased:
+                event.Key = static_cast<Lumina::KeyCode>(codes.ReadSigned());
+                event.Modifiers = modifiers.ReadByte();
+                break;
+            case RecordedAction::MousePressed:
+            case RecordedAction::MouseReleased:
+                event.Button = static_cast<Lumina::MouseCode>(codes.ReadSigned());
+                [[fallthrough]];
+            case RecordedAction::MouseMoved:
+                x += xs.ReadSigned();
+                y += ys.ReadSigned();
+                event.MouseX = static_cast<int>(x);
+                event.MouseY = static_cast<int>(y);
+                break;
+            case RecordedAction::MouseScrolled:
+                event.ScrollDX = static_cast<int>(scrolls.ReadSigned());
+                event.ScrollDY = static_cast<int>(scrolls.ReadSigned());
+                break;
+            default:
+                return false;
+            }
+
+            events.Add(event);
+        }
+
+        // Every column must be used up exactly
+        for (const ByteReader& column : columns)
+        {
+            if (!column.IsDone())
+                return false;
+        }
+
+        return true;
+    }
+}
\ No newline at end of file
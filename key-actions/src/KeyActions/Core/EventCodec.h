@@ -0,0 +1,30 @@
+#pragma once
+
+#include "EventStore.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace KeyActions
+{
+    // Codec for the event blocks of compressed recordings (RecordingFormat::CompressedVersion).
+    //
+    // A block splits its events into per-field columns: actions, time deltas, key and button
+    // codes, modifiers, X and Y deltas from the previous cursor position, and scroll amounts.
+    // Numeric columns are zigzag varints, so the small deltas that make up mouse movement take
+    // a byte each. Each column is then optionally entropy coded with an order-0 rANS coder,
+    // and kept raw wherever that does not make it smaller.
+    //
+    // Blocks only depend on their own first timestamp, so any block can be decoded on its own.
+    namespace EventCodec
+    {
+        // Appends the encoding of events [first, first + count) to output. Timestamps are
+        // stored relative to the block's first event, which the caller keeps in the block table.
+        void EncodeBlock(const EventStore& events, size_t first, size_t count, bool entropy, std::vector<uint8_t>& output);
+
+        // Appends the block's events to the store. Returns false if the data is corrupt, in
+        // which case some of the block's events may already have been added.
+        bool DecodeBlock(const uint8_t* data, size_t size, int64_t firstTimestamp, size_t eventCount, EventStore& events);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "EventStore.h"
+
+#include <algorithm>
+
+namespace KeyActions
+{
+    namespace
+    {
+        enum class PayloadKind
+        {
+            Key,
+            Button,
+            Move,
+            Scroll
+        };
+
+        PayloadKind GetPayloadKind(RecordedAction action)
+        {
+            switch (action)
+            {
+            case RecordedAction::KeyPressed:
+            case RecordedAction::KeyReleased:
+                return PayloadKind::Key;
+            case RecordedAction::MousePressed:
+            case RecordedAction::MouseReleased:
+                return PayloadKind::Button;
+            case RecordedAction::MouseMoved:
+                return PayloadKind::Move;
+            case RecordedAction::MouseScrolled:
+            default:
+                return PayloadKind::Scroll;
+            }
+        }
+    }
+
+    RecordedAction EventView::GetAction() const
+    {
+        return m_Store->m_Actions[m_Index];
+    }
+
+    int64_t EventView::GetTimestamp() const
+    {
+        return m_Store->m_Timestamps[m_Index];
+    }
+
+    EventView::KeyCode EventView::GetKey() const
+    {
+        if (!IsKeyEvent())
+            return KeyCode::Unknown;
+
+        return static_cast<KeyCode>(m_Store->m_Keys[m_Store->m_PayloadIndices[m_Index]].Key);
+    }
+
+    uint8_t EventView::GetModifiers() const
+    {
+        if (!IsKeyEvent())
+            return 0;
+
+        return m_Store->m_Keys[m_Store->m_PayloadIndices[m_Index]].Modifiers;
+    }
+
+    EventView::MouseCode EventView::GetButton() const
+    {
+        if (!IsMouseButtonEvent())
+            return MouseCode::Button0;
+
+        return static_cast<MouseCode>(m_Store->m_Buttons[m_Store->m_PayloadIndices[m_Index]].Button);
+    }
+
+    int EventView::GetX() const
+    {
+        switch (GetAction())
+        {
+        case RecordedAction::MousePressed:
+        case RecordedAction::MouseReleased:
+            return m_Store->m_Buttons[m_Store->m_PayloadIndices[m_Index]].X;
+        case RecordedAction::MouseMoved:
+            return m_Store->m_Moves[m_Store->m_PayloadIndices[m_Index]].X;
+        default:
+            return 0;
+        }
+    }
+
+    int EventView::GetY() const
+    {
+        switch (GetAction())
+        {
+        case RecordedAction::MousePressed:
+        case RecordedAction::MouseReleased:
+            return m_Store->m_Buttons[m_Store->m_PayloadIndices[m_Index]].Y;
+        case RecordedAction::MouseMoved:
+            return m_Store->m_Moves[m_Store->m_PayloadIndices[m_Index]].Y;
+        default:
+            return 0;
+        }
+    }
+
+    int EventView::GetScrollDX() const
+    {
+        if (GetAction() != RecordedAction::MouseScrolled)
+            return 0;
+
+        return m_Store->m_Scrolls[m_Store->m_PayloadIndices[m_Index]].X;
+    }
+
+    int EventView::GetScrollDY() const
+    {
+        if (GetAction() != RecordedAction::MouseScrolled)
+            return 0;
+
+        return m_Store->m_Scrolls[m_Store->m_PayloadIndices[m_Index]].Y;
+    }
+
+    bool EventView::IsKeyEvent() const
+    {
+        RecordedAction action = GetAction();
+        return action == RecordedAction::KeyPressed || action == RecordedAction::KeyReleased;
+    }
+
+    bool EventView::IsMouseButtonEvent() const
+    {
+        RecordedAction action = GetAction();
+        return action == RecordedAction::MousePressed || action == RecordedAction::MouseReleased;
+    }
+
+    RecordedEvent EventView::ToEvent() const
+    {
+        RecordedEvent event;
+        event.Action = GetAction();
+        event.Timestamp = GetTimestamp();
+
+        switch (GetPayloadKind(event.Action))
+        {
+        case PayloadKind::Key:
+            event.Key = GetKey();
+            event.Modifiers = GetModifiers();
+            break;
+        case PayloadKind::Button:
+            event.Button = GetButton();
+            event.MouseX = GetX();
+            event.MouseY = GetY();
+            break;
+        case PayloadKind::Move:
+            event.MouseX = GetX();
+            event.MouseY = GetY();
+            break;
+        case PayloadKind::Scroll:
+            event.ScrollDX = GetScrollDX();
+            event.ScrollDY = GetScrollDY();
+            break;
+        }
+
+        return event;
+    }
+
+    void EventStore::Add(const RecordedEvent& event)
+    {
+        m_Timestamps.push_back(event.Timestamp);
+        m_Actions.push_back(event.Action);
+
+        switch (GetPayloadKind(event.Action))
+        {
+        case PayloadKind::Key:
+            m_PayloadIndices.push_back(static_cast<uint32_t>(m_Keys.size()));
+            m_Keys.push_back({ static_cast<int16_t>(event.Key), event.Modifiers });
+            break;
+        case PayloadKind::Button:
+            m_PayloadIndices.push_back(static_cast<uint32_t>(m_Buttons.size()));
+            m_Buttons.push_back({ event.MouseX, event.MouseY, static_cast<int16_t>(event.Button) });
+            break;
+        case PayloadKind::Move:
+            m_PayloadIndices.push_back(static_cast<uint32_t>(m_Moves.size()));
+            m_Moves.push_back({ event.MouseX, event.MouseY });
+            break;
+        case PayloadKind::Scroll:
+            m_PayloadIndices.push_back(static_cast<uint32_t>(m_Scrolls.size()));
+            m_Scrolls.push_back({ event.ScrollDX, event.ScrollDY });
+            break;
+        }
+    }
+
+    void EventStore::Add(const EventView& event)
+    {
+        const EventStore& source = *event.m_Store;
+        size_t index = event.m_Index;
+        uint32_t payload = source.m_PayloadIndices[index];
+
+        m_Timestamps.push_back(source.m_Timestamps[index]);
+        m_Actions.push_back(source.m_Actions[index]);
+
+        switch (GetPayloadKind(source.m_Actions[index]))
+        {
+        case PayloadKind::Key:
+            m_PayloadIndices.push_back(static_cast<uint32_t>(m_Keys.size()));
+            m_Keys.push_back(source.m_Keys[payload]);
+            break;
+        case PayloadKind::Button:
+            m_PayloadIndices.push_back(static_cast<uint32_t>(m_Buttons.size()));
+            m_Buttons.push_back(source.m_Buttons[payload]);
+            break;
+        case PayloadKind::Move:
+            m_PayloadIndices.push_back(static_cast<uint32_t>(m_Moves.size()));
+            m_Moves.push_back(source.m_Moves[payload]);
+            break;
+        case PayloadKind::Scroll:
+            m_PayloadIndices.push_back(static_cast<uint32_t>(m_Scrolls.size()));
+            m_Scrolls.push_back(source.m_Scrolls[payload]);
+            break;
+        }
+    }
+
+    void EventStore::Append(const EventStore& other)
+    {
+        Reserve(Size() + other.Size());
+
+        for (const auto& event : other)
+        {
+            Add(event);
+        }
+    }
+
+    void EventStore::Reserve(size_t count)
+    {
+        m_Timestamps.reserve(count);
+        m_Actions.reserve(count);
+        m_PayloadIndices.reserve(count);
+    }
+
+    void EventStore::Clear()
+    {
+        m_Timestamps.clear();
+        m_Actions.clear();
+        m_PayloadIndices.clear();
+        m_Keys.clear();
+        m_Buttons.clear();
+        m_Moves.clear();
+        m_Scrolls.clear();
+    }
+
+    void EventStore::EraseFront(size_t count)
+    {
+        count = std::min(count, Size());
+        if (count == 0)
+            return;
+
+        // Payloads are appended in event order, so the erased events own a prefix of each payload array
+        size_t keys = 0, buttons = 0, moves = 0, scrolls = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            switch (GetPayloadKind(m_Actions[i]))
+            {
+            case PayloadKind::Key:    keys++; break;
+            case PayloadKind::Button: buttons++; break;
+            case PayloadKind::Move:   moves++; break;
+            case PayloadKind::Scroll: scrolls++; break;
+            }
+        }
+
+        m_Timestamps.erase_front(count);
+        m_Actions.erase_front(count);
+        m_PayloadIndices.erase_front(count);
+
+        m_Keys.erase_front(keys);
+        m_Buttons.erase_front(buttons);
+        m_Moves.erase_front(moves);
+        m_Scrolls.erase_front(scrolls);
+
+        for (size_t i = 0; i < m_PayloadIndices.size(); i++)
+        {
+            switch (GetPayloadKind(m_Actions[i]))
+            {
+            case PayloadKind::Key:    m_PayloadIndices[i] -= static_cast<uint32_t>(keys); break;
+            case PayloadKind::Button: m_PayloadIndices[i] -= static_cast<uint32_t>(buttons); break;
+            case PayloadKind::Move:   m_PayloadIndices[i] -= static_cast<uint32_t>(moves); break;
+            case PayloadKind::Scroll: m_PayloadIndices[i] -= static_cast<uint32_t>(scrolls); break;
+            }
+        }
+    }
+
+    EventStore EventStore::Slice(size_t first, size_t count) const
+    {
+        EventStore slice;
+
+        size_t last = std::min(first + count, Size());
+        if (first >= last)
+            return slice;
+
+        slice.Reserve(last - first);
+        for (size_t i = first; i < last; i++)
+        {
+            slice.Add(EventView(this, i));
+        }
+
+        return slice;
+    }
+
+    size_t EventStore::GetMemoryUsage() const
+    {
+        return m_Timestamps.capacity() * sizeof(int64_t) +
+            m_Actions.capacity() * sizeof(RecordedAction) +
+            m_PayloadIndices.capacity() * sizeof(uint32_t) +
+            m_Keys.capacity() * sizeof(KeyPayload) +
+            m_Buttons.capacity() * sizeof(ButtonPayload) +
+            m_Moves.capacity() * sizeof(PointPayload) +
+            m_Scrolls.capacity() * sizeof(PointPayload);
+    }
+}
\ No newline at end of file
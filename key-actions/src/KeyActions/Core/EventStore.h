@@ -0,0 +1,130 @@
+#pragma once
+
+#include "RecordedEvent.h"
+#include "SegmentedArray.h"
+
+#include <cstdint>
+
+namespace KeyActions
+{
+    class EventStore;
+
+    // Non-owning handle to one event in an EventStore. Payload getters return
+    // defaults when they do not apply to the event's action.
+    class EventView
+    {
+    public:
+        using KeyCode = Lumina::KeyCode;
+        using MouseCode = Lumina::MouseCode;
+
+        EventView(const EventStore* store, size_t index) : m_Store(store), m_Index(index) {}
+
+        RecordedAction GetAction() const;
+        int64_t GetTimestamp() const;
+
+        KeyCode GetKey() const;
+        uint8_t GetModifiers() const;
+
+        MouseCode GetButton() const;
+        int GetX() const;
+        int GetY() const;
+        int GetScrollDX() const;
+        int GetScrollDY() const;
+
+        bool IsKeyEvent() const;
+        bool IsMouseButtonEvent() const;
+
+        size_t GetIndex() const { return m_Index; }
+        RecordedEvent ToEvent() const;
+
+    private:
+        friend class EventStore;
+
+        const EventStore* m_Store;
+        size_t m_Index;
+    };
+
+    // Structure-of-arrays storage for recorded events. Nanosecond timestamps and action tags are
+    // dense columns; each action's payload lives in its own array, referenced by index.
+    // Columns are segmented, so adding an event never copies the ones already stored.
+    class EventStore
+    {
+    public:
+        struct KeyPayload
+        {
+            int16_t Key;
+            uint8_t Modifiers;
+        };
+
+        struct ButtonPayload
+        {
+            int32_t X;
+            int32_t Y;
+            int16_t Button;
+        };
+
+        struct PointPayload
+        {
+            int32_t X;
+            int32_t Y;
+        };
+
+        class Iterator
+        {
+        public:
+            Iterator(const EventStore* store, size_t index) : m_Store(store), m_Index(index) {}
+
+            EventView operator*() const { return EventView(m_Store, m_Index); }
+            Iterator& operator++() { ++m_Index; return *this; }
+            bool operator==(const Iterator& other) const { return m_Index == other.m_Index; }
+            bool operator!=(const Iterator& other) const { return m_Index != other.m_Index; }
+
+        private:
+            const EventStore* m_Store;
+            size_t m_Index;
+        };
+
+        EventStore() = default;
+
+        void Add(const RecordedEvent& event);
+        void Add(const EventView& event);
+        void Append(const EventStore& other);
+
+        void Reserve(size_t count);
+        void Clear();
+
+        // Drops the oldest events without touching the rest of the timeline
+        void EraseFront(size_t count);
+
+        // Copies events [first, first + count) into a new store
+        EventStore Slice(size_t first, size_t count) const;
+
+        size_t Size() const { return m_Timestamps.size(); }
+        bool IsEmpty() const { return m_Timestamps.empty(); }
+
+        EventView operator[](size_t index) const { return EventView(this, index); }
+        EventView Back() const { return EventView(this, m_Timestamps.size() - 1); }
+
+        Iterator begin() const { return Iterator(this, 0); }
+        Iterator end() const { return Iterator(this, m_Timestamps.size()); }
+
+        // Direct column access for hot loops
+        const SegmentedArray<int64_t>& GetTimestamps() const { return m_Timestamps; }
+        const SegmentedArray<RecordedAction>& GetActions() const { return m_Actions; }
+
+        // Bytes reserved by all columns
+        size_t GetMemoryUsage() const;
+
+    private:
+        friend class EventView;
+
+        SegmentedArray<int64_t> m_Timestamps;
+        SegmentedArray<RecordedAction> m_Actions;
+        SegmentedArray<uint32_t> m_PayloadIndices;
+
+        SegmentedArray<KeyPayload> m_Keys;
+        SegmentedArray<ButtonPayload> m_Buttons;
+        SegmentedArray<PointPayload> m_Moves;
+        SegmentedArray<PointPayload> m_Scrolls;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "HookCaptureSource.h"
+
+#include "Clock.h"
+
+#include "Lumina/Core/Log.h"
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#endif
+
+namespace KeyActions
+{
+#ifdef LUMINA_PLATFORM_WINDOWS
+    namespace
+    {
+        // Low-level hook procedures get no user pointer, but run on the thread that installed them
+        struct HookTarget
+        {
+            const CaptureSource::InputCallback* Callback = nullptr;
+            HookClock* Clock = nullptr;
+        };
+
+        thread_local HookTarget t_Target;
+
+        void Deliver(CapturedInput& input, DWORD tick)
+        {
+            input.Timestamp = t_Target.Clock->ToClock(static_cast<uint32_t>(tick));
+            (*t_Target.Callback)(input);
+        }
+
+        // Letters, digits and space share their codes with KeyCode; the rest are looked up
+        Lumina::KeyCode TranslateVirtualKey(DWORD key)
+        {
+            using Lumina::KeyCode;
+
+            if ((key >= 'A' && key <= 'Z') || (key >= '0' && key <= '9') || key == VK_SPACE)
+                return static_cast<KeyCode>(key);
+
+            if (key >= VK_F1 && key <= VK_F24)
+                return static_cast<KeyCode>(static_cast<int>(KeyCode::F1) + static_cast<int>(key - VK_F1));
+
+            if (key >= VK_NUMPAD0 && key <= VK_NUMPAD9)
+                return static_cast<KeyCode>(static_cast<int>(KeyCode::KP0) + static_cast<int>(key - VK_NUMPAD0));
+
+            switch (key)
+            {
+            case VK_ESCAPE: return KeyCode::Escape;
+            case VK_RETURN: return KeyCode::Enter;
+            case VK_TAB: return KeyCode::Tab;
+            case VK_BACK: return KeyCode::Backspace;
+            case VK_INSERT: return KeyCode::Insert;
+            case VK_DELETE: return KeyCode::Delete;
+            case VK_RIGHT: return KeyCode::Right;
+            case VK_LEFT: return KeyCode::Left;
+            case VK_DOWN: return KeyCode::Down;
+            case VK_UP: return KeyCode::Up;
+            case VK_PRIOR: return KeyCode::PageUp;
+            case VK_NEXT: return KeyCode::PageDown;
+            case VK_HOME: return KeyCode::Home;
+            case VK_END: return KeyCode::End;
+            case VK_CAPITAL: return KeyCode::CapsLock;
+            case VK_SCROLL: return KeyCode::ScrollLock;
+            case VK_NUMLOCK: return KeyCode::NumLock;
+            case VK_SNAPSHOT: return KeyCode::PrintScreen;
+            case VK_PAUSE: return KeyCode::Pause;
+            case VK_DECIMAL: return KeyCode::KPDecimal;
+            case VK_DIVIDE: return KeyCode::KPDivide;
+            case VK_MULTIPLY: return KeyCode::KPMultiply;
+            case VK_SUBTRACT: return KeyCode::KPSubtract;
+            case VK_ADD: return KeyCode::KPAdd;
+            case VK_OEM_1: return KeyCode::Semicolon;
+            case VK_OEM_PLUS: return KeyCode::Equal;
+            case VK_OEM_COMMA: return KeyCode::Comma;
+            case VK_OEM_MINUS: return KeyCode::Minus;
+            case VK_OEM_PERIOD: return KeyCode::Period;
+            case VK_OEM_2: return KeyCode::Slash;
+            case VK_OEM_3: return KeyCode::GraveAccent;
+            case VK_OEM_4: return KeyCode::LeftBracket;
+            case VK_OEM_5: return KeyCode::Backslash;
+            case VK_OEM_6: return KeyCode::RightBracket;
+            case VK_OEM_7: return KeyCode::Apostrophe;
+            case VK_LSHIFT: return KeyCode::LeftShift;
+            case VK_RSHIFT: return KeyCode::RightShift;
+            case VK_LCONTROL: return KeyCode::LeftControl;
+            case VK_RCONTROL: return KeyCode::RightControl;
+            case VK_LMENU: return KeyCode::LeftAlt;
+            case VK_RMENU: return KeyCode::RightAlt;
+            case VK_LWIN: return KeyCode::LeftSuper;
+            case VK_RWIN: return KeyCode::RightSuper;
+            case VK_APPS: return KeyCode::Menu;
+            default: return KeyCode::Unknown;
+            }
+        }
+
+        LRESULT CALLBACK KeyboardProc(int code, WPARAM message, LPARAM data)
+        {
+            const KBDLLHOOKSTRUCT* key = code == HC_ACTION ? reinterpret_cast<const KBDLLHOOKSTRUCT*>(data) : nullptr;
+
+            if (key && (key->flags & LLKHF_INJECTED) == 0)
+            {
+                Lumina::KeyCode keyCode = TranslateVirtualKey(key->vkCode);
+                if (keyCode != Lumina::KeyCode::Unknown)
+                {
+                    bool pressed = message == WM_KEYDOWN || message == WM_SYSKEYDOWN;
+
+                    CapturedInput input;
+                    input.Action = pressed ? RecordedAction::KeyPressed : RecordedAction::KeyReleased;
+                    input.Code = static_cast<int>(keyCode);
+                    Deliver(input, key->time);
+                }
+            }
+
+            return CallNextHookEx(nullptr, code, message, data);
+        }
+
+        LRESULT CALLBACK MouseProc(int code, WPARAM message, LPARAM data)
+        {
+            const MSLLHOOKSTRUCT* hook = code == HC_ACTION ? reinterpret_cast<const MSLLHOOKSTRUCT*>(data) : nullptr;
+
+            if (hook && (hook->flags & LLMHF_INJECTED) == 0)
+            {
+                const MSLLHOOKSTRUCT& mouse = *hook;
+
+                CapturedInput input;
+                input.A = mouse.pt.x;
+                input.B = mouse.pt.y;
+
+                bool known = true;
+                switch (message)
+                {
+                case WM_MOUSEMOVE:
+                    input.Action = RecordedAction::MouseMoved;
+                    break;
+                case WM_LBUTTONDOWN:
+                case WM_RBUTTONDOWN:
+                case WM_MBUTTONDOWN:
+                case WM_XBUTTONDOWN:
+                    input.Action = RecordedAction::MousePressed;
+                    break;
+                case WM_LBUTTONUP:
+                case WM_RBUTTONUP:
+                case WM_MBUTTONUP:
+                case WM_XBUTTONUP:
+                    input.Action = RecordedAction::MouseReleased;
+                    break;
+                case WM_MOUSEWHEEL:
+                case WM_MOUSEHWHEEL:
+                {
+                    // In notches, like the application's scroll events
+                    int notches = static_cast<short>(HIWORD(mouse.mouseData)) / WHEEL_DELTA;
+                    input.Action = RecordedAction::MouseScrolled;
+                    input.A = message == WM_MOUSEHWHEEL ? notches : 0;
+                    input.B = message == WM_MOUSEWHEEL ? notches : 0;
+                    break;
+                }
+                default:
+                    known = false;
+                    break;
+                }
+
+                switch (message)
+                {
+                case WM_LBUTTONDOWN: case WM_LBUTTONUP: input.Code = static_cast<int>(Lumina::MouseCode::Button0); break;
+                case WM_RBUTTONDOWN: case WM_RBUTTONUP: input.Code = static_cast<int>(Lumina::MouseCode::Button1); break;
+                case WM_MBUTTONDOWN: case WM_MBUTTONUP: input.Code = static_cast<int>(Lumina::MouseCode::Button2); break;
+                case WM_XBUTTONDOWN: case WM_XBUTTONUP:
+                    input.Code = static_cast<int>(HIWORD(mouse.mouseData) == XBUTTON1 ? Lumina::MouseCode::Button3 : Lumina::MouseCode::Button4);
+                    break;
+                }
+
+                if (known)
+                    Deliver(input, mouse.time);
+            }
+
+            return CallNextHookEx(nullptr, code, message, data);
+        }
+    }
+#endif
+
+    HookCaptureSource::~HookCaptureSource()
+    {
+        Stop();
+    }
+
+    bool HookCaptureSource::Start(InputCallback callback)
+    {
+        if (m_Thread.joinable())
+            return false;
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+        m_Callback = std::move(callback);
+        m_Clock.Reset();
+
+        std::promise<bool> installed;
+        std::future<bool> result = installed.get_future();
+
+        m_Thread = std::thread(&HookCaptureSource::HookThread, this, std::ref(installed));
+
+        if (!result.get())
+        {
+            m_Thread.join();
+            LUMINA_LOG_ERROR("Failed to install input hooks");
+            return false;
+        }
+
+        return true;
+#else
+        (void)callback;
+        return false;
+#endif
+    }
+
+    void HookCaptureSource::Stop()
+    {
+        if (!m_Thread.joinable())
+            return;
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+        PostThreadMessageW(m_ThreadId, WM_QUIT, 0, 0);
+#endif
+
+        m_Thread.join();
+        m_ThreadId = 0;
+    }
+
+    void HookCaptureSource::HookThread(std::promise<bool>& installed)
+    {
+#ifdef LUMINA_PLATFORM_WINDOWS
+        t_Target = { &m_Callback, &m_Clock };
+        m_Clock.Calibrate(static_cast<uint32_t>(GetTickCount()), Clock::Now());
+
+        HINSTANCE module = GetModuleHandleW(nullptr);
+        HHOOK keyboard = SetWindowsHookExW(WH_KEYBOARD_LL, KeyboardProc, module, 0);
+        HHOOK mouse = SetWindowsHookExW(WH_MOUSE_LL, MouseProc, module, 0);
+
+        if (!keyboard || !mouse)
+        {
+            if (keyboard)
+                UnhookWindowsHookEx(keyboard);
+            if (mouse)
+                UnhookWindowsHookEx(mouse);
+
+            installed.set_value(false);
+            return;
+        }
+
+        MSG message;
+        PeekMessageW(&message, nullptr, WM_USER, WM_USER, PM_NOREMOVE); // Creates the queue Stop() posts to
+
+        m_ThreadId = GetCurrentThreadId();
+        installed.set_value(true);
+
+        while (GetMessageW(&message, nullptr, 0, 0) > 0)
+        {
+            TranslateMessage(&message);
+            DispatchMessageW(&message);
+        }
+
+        UnhookWindowsHookEx(mouse);
+        UnhookWindowsHookEx(keyboard);
+#else
+        installed.set_value(false);
+#endif
+    }
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CaptureSource.h"
+
+#include <cstdint>
+#include <future>
+#include <thread>
+
+namespace KeyActions
+{
+    // CaptureSource backed by the OS low-level input hooks. On Windows, WH_KEYBOARD_LL and
+    // WH_MOUSE_LL are installed on a thread of their own and every input is stamped with
+    // KBDLLHOOKSTRUCT::time or MSLLHOOKSTRUCT::time through a HookClock, so queueing between
+    // the hook and the application doesn't show up in the recording. Injected input, such as
+    // our own playback, is left out.
+    //
+    // Other platforms have no hook here yet; Start() fails and RecordingSession keeps
+    // recording application events.
+    class HookCaptureSource : public CaptureSource
+    {
+    public:
+        HookCaptureSource() = default;
+        ~HookCaptureSource() override;
+
+        HookCaptureSource(const HookCaptureSource&) = delete;
+        HookCaptureSource& operator=(const HookCaptureSource&) = delete;
+
+        // Returns once the hooks are installed, or false if they could not be
+        bool Start(InputCallback callback) override;
+        void Stop() override;
+
+    private:
+        void HookThread(std::promise<bool>& installed);
+
+    private:
+        InputCallback m_Callback;
+        HookClock m_Clock;
+        std::thread m_Thread;
+        uint32_t m_ThreadId = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "HotkeyFilter.h"
+
+#include <algorithm>
+
+namespace KeyActions
+{
+    namespace
+    {
+        bool IsTracked(int code)
+        {
+            return code >= 0 && code < HotkeyFilter::MaxKeyCode;
+        }
+    }
+
+    void HotkeyFilter::Reset(const std::vector<KeyCode>& heldKeys, const std::vector<KeyCode>& stopKeys)
+    {
+        m_StopKeys = stopKeys;
+        m_Held.reset();
+        m_HeldByStart.reset();
+
+        for (KeyCode key : heldKeys)
+        {
+            int code = static_cast<int>(key);
+            if (IsTracked(code))
+            {
+                m_Held.set(code);
+                m_HeldByStart.set(code);
+            }
+        }
+    }
+
+    bool HotkeyFilter::Apply(RecordedAction action, KeyCode key)
+    {
+        int code = static_cast<int>(key);
+        if (!IsTracked(code))
+            return true;
+
+        if (action == RecordedAction::KeyReleased)
+        {
+            m_Held.reset(code);
+
+            bool wasStartKey = m_HeldByStart.test(code);
+            m_HeldByStart.reset(code);
+            return !wasStartKey;
+        }
+
+        if (action != RecordedAction::KeyPressed)
+            return true;
+
+        // Auto-repeat of a start key still held from the combo
+        if (m_HeldByStart.test(code))
+            return false;
+
+        bool wasHeld = m_Held.test(code);
+        m_Held.set(code);
+
+        if (wasHeld || m_StopKeys.empty() || std::find(m_StopKeys.begin(), m_StopKeys.end(), key) == m_StopKeys.end())
+            return true;
+
+        bool completesStop = std::all_of(m_StopKeys.begin(), m_StopKeys.end(), [this](KeyCode stopKey) {
+            int stopCode = static_cast<int>(stopKey);
+            return IsTracked(stopCode) && m_Held.test(stopCode);
+            });
+
+        return !completesStop;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "RecordedEvent.h"
+
+#include <bitset>
+#include <vector>
+
+namespace KeyActions
+{
+    // Keeps the hotkeys that start and stop a recording out of it. Recording starts with the
+    // start combo still held, so releases of keys held at the start are dropped until each is
+    // pressed again; the press that completes the stop combo is dropped too. Held keys are tracked
+    // from the captured key stream, so an OS hook and application events are filtered alike.
+    class HotkeyFilter
+    {
+    public:
+        using KeyCode = Lumina::KeyCode;
+
+        static constexpr int MaxKeyCode = 512;
+
+        void Reset(const std::vector<KeyCode>& heldKeys = {}, const std::vector<KeyCode>& stopKeys = {});
+
+        // Applies a key transition and returns false if it belongs to a hotkey
+        bool Apply(RecordedAction action, KeyCode key);
+
+    private:
+        std::vector<KeyCode> m_StopKeys;
+        std::bitset<MaxKeyCode> m_Held;
+        std::bitset<MaxKeyCode> m_HeldByStart;    // Pressed before recording started
+    };
+}
@@ -0,0 +1,90 @@
+#include "InputBatch.h"
+
+namespace KeyActions
+{
+    InputCommand InputCommand::FromEvent(const EventView& event)
+    {
+        InputCommand command;
+        command.Action = event.GetAction();
+
+        switch (command.Action)
+        {
+        case RecordedAction::KeyPressed:
+        case RecordedAction::KeyReleased:
+            command.Code = static_cast<int>(event.GetKey());
+            break;
+
+        case RecordedAction::MousePressed:
+        case RecordedAction::MouseReleased:
+            command.Code = static_cast<int>(event.GetButton());
+            command.A = event.GetX();
+            command.B = event.GetY();
+            break;
+
+        case RecordedAction::MouseMoved:
+            command.A = event.GetX();
+            command.B = event.GetY();
+            break;
+
+        case RecordedAction::MouseScrolled:
+            command.A = event.GetScrollDX();
+            command.B = event.GetScrollDY();
+            break;
+        }
+
+        return command;
+    }
+
+    InputBatch::InputBatch(Lumina::GlobalInputPlayback& playback)
+        : m_Playback(playback), m_BatchPlayback(dynamic_cast<BatchInputPlayback*>(&playback))
+    {
+    }
+
+    void InputBatch::Submit()
+    {
+        if (m_Commands.empty())
+            return;
+
+        if (m_BatchPlayback)
+        {
+            m_BatchPlayback->SimulateBatch(m_Commands.data(), m_Commands.size());
+        }
+        else
+        {
+            for (const InputCommand& command : m_Commands)
+                Simulate(m_Playback, command);
+        }
+
+        m_Commands.clear();
+    }
+
+    void InputBatch::Simulate(Lumina::GlobalInputPlayback& playback, const InputCommand& command)
+    {
+        switch (command.Action)
+        {
+        case RecordedAction::KeyPressed:
+            playback.SimulateKeyPress(static_cast<Lumina::KeyCode>(command.Code));
+            break;
+
+        case RecordedAction::KeyReleased:
+            playback.SimulateKeyRelease(static_cast<Lumina::KeyCode>(command.Code));
+            break;
+
+        case RecordedAction::MousePressed:
+            playback.SimulateMouseButtonPress(static_cast<Lumina::MouseCode>(command.Code), command.A, command.B);
+            break;
+
+        case RecordedAction::MouseReleased:
+            playback.SimulateMouseButtonRelease(static_cast<Lumina::MouseCode>(command.Code), command.A, command.B);
+            break;
+
+        case RecordedAction::MouseMoved:
+            playback.SimulateMouseMove(command.A, command.B);
+            break;
+
+        case RecordedAction::MouseScrolled:
+            playback.SimulateMouseScroll(command.A, command.B);
+            break;
+        }
+    }
+}
\ No newline at end of file
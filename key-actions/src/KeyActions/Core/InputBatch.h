@@ -0,0 +1,60 @@
+#pragma once
+
+#include "RecordedEvent.h"
+#include "EventStore.h"
+
+#include "Lumina/Input/GlobalInputPlayback.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace KeyActions
+{
+    // One input to inject, independent of where it came from
+    struct InputCommand
+    {
+        RecordedAction Action = RecordedAction::KeyPressed;
+        int Code = 0;   // KeyCode for key actions, MouseCode for button actions
+        int A = 0;      // X, or scroll DX
+        int B = 0;      // Y, or scroll DY
+
+        static InputCommand FromEvent(const EventView& event);
+    };
+
+    // Implemented next to GlobalInputPlayback by backends that can hand several inputs
+    // to the OS in a single call (SendInput takes an array, XTest can flush once).
+    // GlobalInputPlayback has no batch entry point of its own.
+    class BatchInputPlayback
+    {
+    public:
+        virtual ~BatchInputPlayback() = default;
+
+        virtual void SimulateBatch(const InputCommand* commands, size_t count) = 0;
+    };
+
+    // Collects the inputs due in one scheduling pass and submits them together. Uses the
+    // backend's BatchInputPlayback when it has one, otherwise one Simulate* call per input.
+    class InputBatch
+    {
+    public:
+        explicit InputBatch(Lumina::GlobalInputPlayback& playback);
+
+        void Add(const InputCommand& command) { m_Commands.push_back(command); }
+        void Add(const EventView& event) { m_Commands.push_back(InputCommand::FromEvent(event)); }
+
+        // Injects everything collected, in order, then clears the batch
+        void Submit();
+
+        size_t Size() const { return m_Commands.size(); }
+        bool IsEmpty() const { return m_Commands.empty(); }
+        bool IsBatched() const { return m_BatchPlayback != nullptr; }
+
+        // Unbatched path, one virtual call per input
+        static void Simulate(Lumina::GlobalInputPlayback& playback, const InputCommand& command);
+
+    private:
+        Lumina::GlobalInputPlayback& m_Playback;
+        BatchInputPlayback* m_BatchPlayback;
+        std::vector<InputCommand> m_Commands;
+    };
+}
\ No newline at end of file
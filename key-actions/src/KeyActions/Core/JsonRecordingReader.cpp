@@ -0,0 +1,614 @@
+#include "JsonRecordingReader.h"
+
+#include "Clock.h"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #include <emmintrin.h>
+    #define KEYACTIONS_JSON_SSE2
+#endif
+
+namespace KeyActions
+{
+    namespace
+    {
+        // Events between progress reports
+        constexpr uint64_t ProgressInterval = 65536;
+
+        // Nesting allowed inside values of unknown fields
+        constexpr int MaxSkipDepth = 64;
+
+        enum EventField
+        {
+            FieldAction,
+            FieldTimestamp,
+            FieldTime,
+            FieldKey,
+            FieldButton,
+            FieldX,
+            FieldY,
+            FieldDX,
+            FieldDY,
+            FieldCount
+        };
+
+        struct EventFields
+        {
+            uint32_t Present = 0;
+            int64_t Values[FieldCount] = {};
+            double Time = 0.0;
+
+            bool Has(EventField field) const { return (Present & (1u << field)) != 0; }
+            bool HasAll(uint32_t fields) const { return (Present & fields) == fields; }
+        };
+
+        constexpr uint32_t FieldBit(EventField field)
+        {
+            return 1u << field;
+        }
+
+        int FindEventField(std::string_view key)
+        {
+            switch (key.size())
+            {
+            case 1:
+                if (key[0] == 'x') return FieldX;
+                if (key[0] == 'y') return FieldY;
+                break;
+            case 2:
+                if (key == "dx") return FieldDX;
+                if (key == "dy") return FieldDY;
+                break;
+            case 3:
+                if (key == "key") return FieldKey;
+                break;
+            case 4:
+                if (key == "time") return FieldTime;
+                break;
+            case 6:
+                if (key == "action") return FieldAction;
+                if (key == "button") return FieldButton;
+                break;
+            case 9:
+                if (key == "timestamp") return FieldTimestamp;
+                break;
+            }
+
+            return -1;
+        }
+
+        // The fields ImportJsonDocument reads for each action, besides action and time
+        uint32_t GetRequiredFields(RecordedAction action)
+        {
+            switch (action)
+            {
+            case RecordedAction::KeyPressed:
+            case RecordedAction::KeyReleased:
+                return FieldBit(FieldKey);
+            case RecordedAction::MousePressed:
+            case RecordedAction::MouseReleased:
+                return FieldBit(FieldButton) | FieldBit(FieldX) | FieldBit(FieldY);
+            case RecordedAction::MouseMoved:
+                return FieldBit(FieldX) | FieldBit(FieldY);
+            case RecordedAction::MouseScrolled:
+                return FieldBit(FieldDX) | FieldBit(FieldDY);
+            }
+
+            return 0;
+        }
+
+        bool IsWhitespace(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        // First byte at or after position that is not whitespace
+        const char* SkipWhitespace(const char* position, const char* end)
+        {
+            if (position < end && !IsWhitespace(*position))
+                return position;
+
+#ifdef KEYACTIONS_JSON_SSE2
+            // Exported files are mostly indentation, which this skips a whole run of per load
+            const __m128i space = _mm_set1_epi8(' ');
+            const __m128i newline = _mm_set1_epi8('\n');
+            const __m128i carriageReturn = _mm_set1_epi8('\r');
+            const __m128i tab = _mm_set1_epi8('\t');
+
+            while (end - position >= 16)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+                __m128i whitespace = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newline)),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, carriageReturn), _mm_cmpeq_epi8(chunk, tab)));
+
+                uint32_t other = ~static_cast<uint32_t>(_mm_movemask_epi8(whitespace)) & 0xFFFF;
+                if (other != 0)
+                    return position + std::countr_zero(other);
+
+                position += 16;
+            }
+#endif
+
+            while (position < end && IsWhitespace(*position))
+                position++;
+
+            return position;
+        }
+
+        // First quote, backslash or control character at or after position
+        const char* ScanString(const char* position, const char* end)
+        {
+#ifdef KEYACTIONS_JSON_SSE2
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i lastControl = _mm_set1_epi8(0x1F);
+
+            while (end - position >= 16)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+                __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, lastControl), chunk);
+                __m128i special = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), control);
+
+                uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+                if (mask != 0)
+                    return position + std::countr_zero(mask);
+
+                position += 16;
+            }
+#endif
+
+            while (position < end)
+            {
+                unsigned char c = static_cast<unsigned char>(*position);
+                if (c == '"' || c == '\\' || c < 0x20)
+                    break;
+
+                position++;
+            }
+
+            return position;
+        }
+
+        class Parser
+        {
+        public:
+            Parser(const char* text, size_t size, const Serialization::ProgressCallback& progress)
+                : m_Begin(text), m_Position(text), m_End(text + size), m_Progress(progress)
+            {
+            }
+
+            JsonRecordingReader::Result Parse(Recording& recording)
+            {
+                // A byte order mark is allowed, as the general parser skips it too
+                if (m_End - m_Position >= 3 && std::memcmp(m_Position, "\xEF\xBB\xBF", 3) == 0)
+                    m_Position += 3;
+
+                bool parsed = ParseRecording(recording);
+
+                if (m_Cancelled)
+                    return JsonRecordingReader::Result::Cancelled;
+
+                return parsed ? JsonRecordingReader::Result::Loaded : JsonRecordingReader::Result::Unrecognized;
+            }
+
+        private:
+            bool ParseRecording(Recording& recording)
+            {
+                bool hasName = false;
+                bool hasRecordsMouse = false;
+                bool hasDuration = false;
+                bool hasTotalDuration = false;
+
+                int64_t duration = 0;
+                double totalDuration = 0.0;
+
+                // Like the general parser, a file without an events array is an empty recording
+                recording.Events.Clear();
+
+                if (!Consume('{'))
+                    return false;
+
+                if (!Consume('}'))
+                {
+                    do
+                    {
+                        std::string_view key;
+                        if (!ParseKey(key))
+                            return false;
+
+                        bool parsed;
+                        if (key == "events")
+                        {
+                            parsed = ParseEvents(recording);
+                        }
+                        else if (key == "name")
+                        {
+                            std::string_view name;
+                            parsed = ParseString(name);
+                            recording.Name = name;
+                            hasName = true;
+                        }
+                        else if (key == "recordsMouse")
+                        {
+                            parsed = ParseBool(recording.RecordsMouse);
+                            hasRecordsMouse = true;
+                        }
+                        else if (key == "duration")
+                        {
+                            parsed = ParseInteger(duration);
+                            hasDuration = true;
+                        }
+                        else if (key == "totalDuration")
+                        {
+                            parsed = ParseDouble(totalDuration);
+                            hasTotalDuration = true;
+                        }
+                        else
+                        {
+                            parsed = SkipValue(0);
+                        }
+
+                        if (!parsed)
+                            return false;
+                    } while (Consume(','));
+
+                    if (!Consume('}'))
+                        return false;
+                }
+
+                // ImportJsonDocument reads float seconds throughout when there is no integer duration
+                bool legacyTimes = !hasDuration;
+                if (!hasName || !hasRecordsMouse || (legacyTimes && !hasTotalDuration))
+                    return false;
+
+                // Exports carry both times, and the integer one is read unless the file has no duration
+                if (legacyTimes ? m_SawTimestamps : m_SawTimeOnly)
+                    return false;
+
+                recording.Duration = legacyTimes ? Clock::FromSeconds(totalDuration) : duration;
+                return true;
+            }
+
+            bool ParseEvents(Recording& recording)
+            {
+                recording.Events.Clear();
+
+                if (!Consume('['))
+                    return false;
+
+                if (Consume(']'))
+                    return true;
+
+                uint64_t count = 0;
+                do
+                {
+                    RecordedEvent event;
+                    if (!ParseEvent(event))
+                        return false;
+
+                    recording.Events.Add(event);
+
+                    if (++count % ProgressInterval == 0 && m_Progress &&
+                        !m_Progress(static_cast<float>(m_Position - m_Begin) / static_cast<float>(m_End - m_Begin)))
+                    {
+                        m_Cancelled = true;
+                        return false;
+                    }
+                } while (Consume(','));
+
+                return Consume(']');
+            }
+
+            bool ParseEvent(RecordedEvent& event)
+            {
+                EventFields fields;
+
+                if (!Consume('{'))
+                    return false;
+
+                if (!Consume('}'))
+                {
+                    do
+                    {
+                        std::string_view key;
+                        if (!ParseKey(key))
+                            return false;
+
+                        int field = FindEventField(key);
+
+                        bool parsed;
+                        if (field == FieldTime)
+                            parsed = ParseDouble(fields.Time);
+                        else if (field >= 0)
+                            parsed = ParseInteger(fields.Values[field]);
+                        else
+                            parsed = SkipValue(0);
+
+                        if (!parsed)
+                            return false;
+
+                        if (field >= 0)
+                            fields.Present |= FieldBit(static_cast<EventField>(field));
+                    } while (Consume(','));
+
+                    if (!Consume('}'))
+                        return false;
+                }
+
+                // The file-wide choice of time is only known at the end, so it is checked there
+                bool hasTimestamp = fields.Has(FieldTimestamp);
+                bool hasTime = fields.Has(FieldTime);
+                if (!fields.Has(FieldAction) || (!hasTimestamp && !hasTime))
+                    return false;
+
+                m_SawTimestamps |= hasTimestamp;
+                m_SawTimeOnly |= !hasTimestamp;
+
+                event.Action = static_cast<RecordedAction>(fields.Values[FieldAction]);
+                event.Timestamp = hasTimestamp ? fields.Values[FieldTimestamp] : Clock::FromSeconds(fields.Time);
+
+                if (!fields.HasAll(GetRequiredFields(event.Action)))
+                    return false;
+
+                // Only the fields ImportJsonDocument reads for the action are kept
+                switch (event.Action)
+                {
+                case RecordedAction::KeyPressed:
+                case RecordedAction::KeyReleased:
+                    event.Key = static_cast<Lumina::KeyCode>(fields.Values[FieldKey]);
+                    break;
+                case RecordedAction::MousePressed:
+                case RecordedAction::MouseReleased:
+                    event.Button = static_cast<Lumina::MouseCode>(fields.Values[FieldButton]);
+                    event.MouseX = static_cast<int>(fields.Values[FieldX]);
+                    event.MouseY = static_cast<int>(fields.Values[FieldY]);
+                    break;
+                case RecordedAction::MouseMoved:
+                    event.MouseX = static_cast<int>(fields.Values[FieldX]);
+                    event.MouseY = static_cast<int>(fields.Values[FieldY]);
+                    break;
+                case RecordedAction::MouseScrolled:
+                    event.ScrollDX = static_cast<int>(fields.Values[FieldDX]);
+                    event.ScrollDY = static_cast<int>(fields.Values[FieldDY]);
+                    break;
+                }
+
+                return true;
+            }
+
+            // Skips whitespace and consumes the expected character if it is next
+            bool Consume(char expected)
+            {
+                m_Position = SkipWhitespace(m_Position, m_End);
+                if (m_Position == m_End || *m_Position != expected)
+                    return false;
+
+                m_Position++;
+                return true;
+            }
+
+            bool ParseKey(std::string_view& key)
+            {
+                return ParseString(key) && Consume(':');
+            }
+
+            // The view points into the text, or into m_Unescaped if the string had escapes,
+            // so it is only valid until the next string is parsed
+            bool ParseString(std::string_view& value)
+            {
+                if (!Consume('"'))
+                    return false;
+
+                const char* start = m_Position;
+                m_Position = ScanString(m_Position, m_End);
+
+                if (m_Position < m_End && *m_Position == '"')
+                {
+                    value = std::string_view(start, static_cast<size_t>(m_Position - start));
+                    m_Position++;
+                    return true;
+                }
+
+                m_Unescaped.assign(start, m_Position);
+
+                while (m_Position < m_End && *m_Position == '\\')
+                {
+                    if (m_End - m_Position < 2)
+                        return false;
+
+                    switch (m_Position[1])
+                    {
+                    case '"': m_Unescaped += '"'; break;
+                    case '\\': m_Unescaped += '\\'; break;
+                    case '/': m_Unescaped += '/'; break;
+                    case 'b': m_Unescaped += '\b'; break;
+                    case 'f': m_Unescaped += '\f'; break;
+                    case 'n': m_Unescaped += '\n'; break;
+                    case 'r': m_Unescaped += '\r'; break;
+                    case 't': m_Unescaped += '\t'; break;
+                    default:
+                        // Unicode escapes are left to the general parser
+                        return false;
+                    }
+
+                    m_Position += 2;
+
+                    start = m_Position;
+                    m_Position = ScanString(m_Position, m_End);
+                    m_Unescaped.append(start, m_Position);
+                }
+
+                // A control character or the end of the text
+                if (m_Position == m_End || *m_Position != '"')
+                    return false;
+
+                m_Position++;
+                value = m_Unescaped;
+                return true;
+            }
+
+            // JSON numbers start with an optional minus and a digit, and only "0" may start with 0.
+            // from_chars would also take leading zeros, and for doubles "inf", "nan" and ".5".
+            bool IsNumberStart() const
+            {
+                const char* digit = m_Position < m_End && *m_Position == '-' ? m_Position + 1 : m_Position;
+                if (digit == m_End || *digit < '0' || *digit > '9')
+                    return false;
+
+                return *digit != '0' || digit + 1 == m_End || digit[1] < '0' || digit[1] > '9';
+            }
+
+            bool ParseInteger(int64_t& value)
+            {
+                m_Position = SkipWhitespace(m_Position, m_End);
+
+                if (!IsNumberStart())
+                    return false;
+
+                auto [next, error] = std::from_chars(m_Position, m_End, value);
+                if (error != std::errc())
+                    return false;
+
+                // Fractions and exponents are left to the general parser, which converts them
+                if (next < m_End && (*next == '.' || *next == 'e' || *next == 'E'))
+                    return false;
+
+                m_Position = next;
+                return true;
+            }
+
+            bool ParseDouble(double& value)
+            {
+                m_Position = SkipWhitespace(m_Position, m_End);
+
+                if (!IsNumberStart())
+                    return false;
+
+                auto [next, error] = std::from_chars(m_Position, m_End, value);
+                if (error != std::errc())
+                    return false;
+
+                m_Position = next;
+                return true;
+            }
+
+            bool ParseBool(bool& value)
+            {
+                m_Position = SkipWhitespace(m_Position, m_End);
+
+                if (ConsumeLiteral("true"))
+                {
+                    value = true;
+                    return true;
+                }
+
+                if (ConsumeLiteral("false"))
+                {
+                    value = false;
+                    return true;
+                }
+
+                return false;
+            }
+
+            bool ConsumeLiteral(std::string_view literal)
+            {
+                if (static_cast<size_t>(m_End - m_Position) < literal.size() ||
+                    std::memcmp(m_Position, literal.data(), literal.size()) != 0)
+                    return false;
+
+                m_Position += literal.size();
+                return true;
+            }
+
+            // Skips the value of a field the recording does not use
+            bool SkipValue(int depth)
+            {
+                if (depth > MaxSkipDepth)
+                    return false;
+
+                m_Position = SkipWhitespace(m_Position, m_End);
+                if (m_Position == m_End)
+                    return false;
+
+                switch (*m_Position)
+                {
+                case '"':
+                {
+                    std::string_view ignored;
+                    return ParseString(ignored);
+                }
+                case '{':
+                {
+                    m_Position++;
+                    if (Consume('}'))
+                        return true;
+
+                    do
+                    {
+                        std::string_view key;
+                        if (!ParseKey(key) || !SkipValue(depth + 1))
+                            return false;
+                    } while (Consume(','));
+
+                    return Consume('}');
+                }
+                case '[':
+                {
+                    m_Position++;
+                    if (Consume(']'))
+                        return true;
+
+                    do
+                    {
+                        if (!SkipValue(depth + 1))
+                            return false;
+                    } while (Consume(','));
+
+                    return Consume(']');
+                }
+                case 't':
+                    return ConsumeLiteral("true");
+                case 'f':
+                    return ConsumeLiteral("false");
+                case 'n':
+                    return ConsumeLiteral("null");
+                default:
+                {
+                    double ignored;
+                    return ParseDouble(ignored);
+                }
+                }
+            }
+
+        private:
+            const char* m_Begin;
+            const char* m_Position;
+            const char* m_End;
+            const Serialization::ProgressCallback& m_Progress;
+
+            std::string m_Unescaped;
+            bool m_SawTimestamps = false;
+            bool m_SawTimeOnly = false;
+            bool m_Cancelled = false;
+        };
+    }
+
+    JsonRecordingReader::Result JsonRecordingReader::Read(Recording& recording, const char* text, size_t size, const Serialization::ProgressCallback& progress)
+    {
+        Parser parser(text, size, progress);
+        Result result = parser.Parse(recording);
+
+        if (result != Result::Loaded)
+            recording.Events.Clear();
+
+        return result;
+    }
+}
\ No newline at end of file
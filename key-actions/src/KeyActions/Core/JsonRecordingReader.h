@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Recording.h"
+#include "Serialization.h"
+
+#include <cstddef>
+
+namespace KeyActions
+{
+    // Streaming parser for the JSON recording layout, used by Serialization::ImportJson
+    // ahead of the general JSON parser. It reads the known fields straight into the
+    // recording's event store without building a document, and skips whitespace and
+    // string bodies 16 bytes at a time where SSE2 is available.
+    //
+    // Anything outside the layout ExportJson and older versions wrote (unicode escapes,
+    // fractional values in integer fields, missing fields) is reported as Unrecognized
+    // so the caller can fall back to the general parser, which accepts or rejects the
+    // file exactly as before.
+    namespace JsonRecordingReader
+    {
+        enum class Result
+        {
+            Loaded,
+            Unrecognized,
+            Cancelled
+        };
+
+        // Progress is the fraction of the text consumed. The recording's events are left
+        // empty unless the result is Loaded.
+        Result Read(Recording& recording, const char* text, size_t size, const Serialization::ProgressCallback& progress = {});
+    }
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "MappedFile.h"
+
+#include "Lumina/Core/Log.h"
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace KeyActions
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+#ifdef LUMINA_PLATFORM_WINDOWS
+            m_FileHandle = std::exchange(other.m_FileHandle, nullptr);
+            m_MappingHandle = std::exchange(other.m_MappingHandle, nullptr);
+#endif
+        }
+
+        return *this;
+    }
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            LUMINA_LOG_ERROR("Failed to open file for mapping: {}", path.string());
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            LUMINA_LOG_ERROR("Failed to create file mapping: {}", path.string());
+            CloseHandle(file);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            LUMINA_LOG_ERROR("Failed to map view of file: {}", path.string());
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_FileHandle = file;
+        m_MappingHandle = mapping;
+        m_Data = static_cast<const uint8_t*>(view);
+        m_Size = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_Data)
+            UnmapViewOfFile(m_Data);
+        if (m_MappingHandle)
+            CloseHandle(m_MappingHandle);
+        if (m_FileHandle)
+            CloseHandle(m_FileHandle);
+
+        m_Data = nullptr;
+        m_Size = 0;
+        m_FileHandle = nullptr;
+        m_MappingHandle = nullptr;
+    }
+
+#else
+
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            LUMINA_LOG_ERROR("Failed to open file for mapping: {}", path.string());
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (view == MAP_FAILED)
+        {
+            LUMINA_LOG_ERROR("Failed to map file: {}", path.string());
+            return false;
+        }
+
+        madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+        m_Data = static_cast<const uint8_t*>(view);
+        m_Size = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_Data)
+            munmap(const_cast<uint8_t*>(m_Data), m_Size);
+
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "ModifierTracker.h"
+
+#include "Lumina/Core/Input.h"
+
+namespace KeyActions
+{
+    void ModifierTracker::Reset(uint8_t modifiers)
+    {
+        // The OS only says a side is down, not which; attribute it to the left key
+        m_Held = 0;
+        if (modifiers & ModifierShift) m_Held |= HeldLeftShift;
+        if (modifiers & ModifierCtrl) m_Held |= HeldLeftCtrl;
+        if (modifiers & ModifierAlt) m_Held |= HeldLeftAlt;
+        if (modifiers & ModifierSuper) m_Held |= HeldLeftSuper;
+
+        m_Modifiers = modifiers;
+        m_CapsLockHeld = false;
+    }
+
+    uint8_t ModifierTracker::Apply(RecordedAction action, KeyCode key)
+    {
+        if (key == KeyCode::CapsLock)
+        {
+            // Auto-repeat sends more presses while the key is held; only the first one toggles
+            if (action == RecordedAction::KeyPressed && !m_CapsLockHeld)
+                m_Modifiers ^= ModifierCapsLock;
+
+            m_CapsLockHeld = action == RecordedAction::KeyPressed;
+
+            return m_Modifiers;
+        }
+
+        uint8_t held = ToHeldKey(key);
+        if (held == 0)
+            return m_Modifiers;
+
+        if (action == RecordedAction::KeyPressed)
+            m_Held |= held;
+        else
+            m_Held &= ~held;
+
+        uint8_t modifiers = m_Modifiers & ModifierCapsLock;
+        if (m_Held & (HeldLeftShift | HeldRightShift)) modifiers |= ModifierShift;
+        if (m_Held & (HeldLeftCtrl | HeldRightCtrl)) modifiers |= ModifierCtrl;
+        if (m_Held & (HeldLeftAlt | HeldRightAlt)) modifiers |= ModifierAlt;
+        if (m_Held & (HeldLeftSuper | HeldRightSuper)) modifiers |= ModifierSuper;
+
+        m_Modifiers = modifiers;
+        return m_Modifiers;
+    }
+
+    uint8_t ModifierTracker::Query()
+    {
+        uint8_t modifiers = 0;
+        if (Lumina::Input::IsShiftPressed()) modifiers |= ModifierShift;
+        if (Lumina::Input::IsCtrlPressed()) modifiers |= ModifierCtrl;
+        if (Lumina::Input::IsAltPressed()) modifiers |= ModifierAlt;
+        if (Lumina::Input::IsSuperPressed()) modifiers |= ModifierSuper;
+        if (Lumina::Input::IsCapsLockActive()) modifiers |= ModifierCapsLock;
+        return modifiers;
+    }
+
+    uint8_t ModifierTracker::ToHeldKey(KeyCode key)
+    {
+        switch (key)
+        {
+        case KeyCode::LeftShift: return HeldLeftShift;
+        case KeyCode::RightShift: return HeldRightShift;
+        case KeyCode::LeftControl: return HeldLeftCtrl;
+        case KeyCode::RightControl: return HeldRightCtrl;
+        case KeyCode::LeftAlt: return HeldLeftAlt;
+        case KeyCode::RightAlt: return HeldRightAlt;
+        case KeyCode::LeftSuper: return HeldLeftSuper;
+        case KeyCode::RightSuper: return HeldRightSuper;
+        default: return 0;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "RecordedEvent.h"
+
+#include <cstdint>
+
+namespace KeyActions
+{
+    // Modifier state kept up to date from the captured key stream, so key events don't
+    // have to ask the OS for five modifier states each. Left and right keys are tracked
+    // separately, so releasing one Shift while the other is held still reports Shift.
+    class ModifierTracker
+    {
+    public:
+        using KeyCode = Lumina::KeyCode;
+
+        // Seeds the state, typically once from Query() when capture starts
+        void Reset(uint8_t modifiers = 0);
+
+        // Applies a key transition and returns the ModifierFlag bits in effect after it
+        uint8_t Apply(RecordedAction action, KeyCode key);
+
+        uint8_t Get() const { return m_Modifiers; }
+
+        // Asks the OS for the current modifier state
+        static uint8_t Query();
+
+    private:
+        enum HeldKey : uint8_t
+        {
+            HeldLeftShift = 1 << 0,
+            HeldRightShift = 1 << 1,
+            HeldLeftCtrl = 1 << 2,
+            HeldRightCtrl = 1 << 3,
+            HeldLeftAlt = 1 << 4,
+            HeldRightAlt = 1 << 5,
+            HeldLeftSuper = 1 << 6,
+            HeldRightSuper = 1 << 7
+        };
+
+        static uint8_t ToHeldKey(KeyCode key);
+
+    private:
+        uint8_t m_Held = 0;         // HeldKey bits
+        uint8_t m_Modifiers = 0;    // ModifierFlag bits derived from m_Held, plus caps lock
+        bool m_CapsLockHeld = false;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "MouseMoveDecimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KeyActions
+{
+    MouseMoveDecimator::MouseMoveDecimator(float tolerance, size_t maxPending)
+    {
+        Reset(tolerance, maxPending);
+    }
+
+    void MouseMoveDecimator::Reset(float tolerance, size_t maxPending)
+    {
+        m_Tolerance = tolerance;
+        m_MaxPending = std::max<size_t>(maxPending, 1);
+
+        m_HasAnchor = false;
+        m_Pending.clear();
+        m_Pending.reserve(m_MaxPending);
+    }
+
+    bool MouseMoveDecimator::Add(const MousePoint& point, MousePoint& kept)
+    {
+        if (!m_HasAnchor || m_Tolerance <= 0.0f)
+        {
+            m_HasAnchor = true;
+            m_Anchor = point;
+            kept = point;
+            return true;
+        }
+
+        if (m_Pending.empty() || (m_Pending.size() < m_MaxPending && Fits(point)))
+        {
+            m_Pending.push_back(point);
+            return false;
+        }
+
+        // The line to this point would stray too far, so the path turned at the previous one
+        kept = m_Pending.back();
+        m_Anchor = kept;
+
+        m_Pending.clear();
+        m_Pending.push_back(point);
+        return true;
+    }
+
+    bool MouseMoveDecimator::Flush(MousePoint& kept)
+    {
+        if (m_Pending.empty())
+            return false;
+
+        kept = m_Pending.back();
+        m_Anchor = kept;
+        m_Pending.clear();
+        return true;
+    }
+
+    bool MouseMoveDecimator::Fits(const MousePoint& end) const
+    {
+        for (const MousePoint& point : m_Pending)
+        {
+            if (DistanceToSegment(point, m_Anchor, end) > m_Tolerance)
+                return false;
+        }
+
+        return true;
+    }
+
+    float MouseMoveDecimator::DistanceToSegment(const MousePoint& p, const MousePoint& a, const MousePoint& b)
+    {
+        float dx = static_cast<float>(b.X - a.X);
+        float dy = static_cast<float>(b.Y - a.Y);
+        float px = static_cast<float>(p.X - a.X);
+        float py = static_cast<float>(p.Y - a.Y);
+
+        float lengthSquared = dx * dx + dy * dy;
+        float t = lengthSquared > 0.0f ? std::clamp((px * dx + py * dy) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+
+        return std::hypot(px - t * dx, py - t * dy);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace KeyActions
+{
+    struct MousePoint
+    {
+        int64_t Timestamp = 0;
+        int X = 0;
+        int Y = 0;
+    };
+
+    // Online path simplification for mouse moves. Points are held back while the straight
+    // line from the last kept point to the newest one stays within Tolerance pixels of every
+    // point in between; once it doesn't, the previous point is kept and becomes the new
+    // anchor. Straight drags collapse to their endpoints while corners are always kept, and
+    // every dropped point lies within Tolerance of the kept path. The window is capped at
+    // MaxPending points so each move costs at most that many distance checks.
+    class MouseMoveDecimator
+    {
+    public:
+        static constexpr size_t DefaultMaxPending = 64;
+
+        explicit MouseMoveDecimator(float tolerance = 2.0f, size_t maxPending = DefaultMaxPending);
+
+        void Reset(float tolerance, size_t maxPending = DefaultMaxPending);
+
+        // Adds a move; returns true with the point to record when one becomes final
+        bool Add(const MousePoint& point, MousePoint& kept);
+
+        // Releases the held back end of the path, e.g. before a click or when recording stops
+        bool Flush(MousePoint& kept);
+
+        float GetTolerance() const { return m_Tolerance; }
+
+        // Distance from p to the segment a-b, in pixels
+        static float DistanceToSegment(const MousePoint& p, const MousePoint& a, const MousePoint& b);
+
+    private:
+        bool Fits(const MousePoint& end) const;
+
+    private:
+        float m_Tolerance;
+        size_t m_MaxPending;
+
+        bool m_HasAnchor = false;
+        MousePoint m_Anchor;                // Last kept point
+        std::vector<MousePoint> m_Pending;  // Points since the anchor; back() is the candidate to keep
+    };
+}
\ No newline at end of file
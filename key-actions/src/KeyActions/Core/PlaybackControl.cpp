@@ -0,0 +1,184 @@
+#include "PlaybackControl.h"
+
+#include "Clock.h"
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+    #ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+        #define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+    #endif
+#endif
+
+#include <chrono>
+
+namespace KeyActions
+{
+    PlaybackControl::PlaybackControl()
+    {
+#ifdef LUMINA_PLATFORM_WINDOWS
+        m_WakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr); // Auto-reset
+
+        // High resolution timers need Windows 10 1803+; fall back to a regular waitable timer
+        m_Timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!m_Timer)
+            m_Timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+#endif
+    }
+
+    PlaybackControl::~PlaybackControl()
+    {
+#ifdef LUMINA_PLATFORM_WINDOWS
+        if (m_Timer)
+            CloseHandle(m_Timer);
+        if (m_WakeEvent)
+            CloseHandle(m_WakeEvent);
+#endif
+    }
+
+    void PlaybackControl::Reset()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_StopRequested = false;
+        m_Paused = false;
+        m_SeekPending = false;
+        m_WakePending = false;
+        m_SeekTarget = SeekTarget();
+    }
+
+    void PlaybackControl::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_StopRequested = true;
+        }
+
+        Signal();
+    }
+
+    void PlaybackControl::Pause()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Paused = true;
+        }
+
+        Signal();
+    }
+
+    void PlaybackControl::Resume()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Paused = false;
+        }
+
+        Signal();
+    }
+
+    void PlaybackControl::Seek(int64_t time)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_SeekTarget = { time, false };
+            m_SeekPending = true;
+        }
+
+        Signal();
+    }
+
+    void PlaybackControl::SeekToEvent(size_t index)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_SeekTarget = { static_cast<int64_t>(index), true };
+            m_SeekPending = true;
+        }
+
+        Signal();
+    }
+
+    void PlaybackControl::Wake()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_WakePending = true;
+        }
+
+        Signal();
+    }
+
+    bool PlaybackControl::SleepUntil(int64_t deadline)
+    {
+#ifdef LUMINA_PLATFORM_WINDOWS
+        if (m_WakeEvent && m_Timer)
+        {
+            HANDLE handles[] = { m_WakeEvent, m_Timer };
+
+            // A stale wake from an earlier command just costs one extra pass
+            while (!IsInterrupted())
+            {
+                int64_t now = Clock::Now();
+                if (now >= deadline)
+                    return true;
+
+                LARGE_INTEGER dueTime;
+                dueTime.QuadPart = -((deadline - now + 99) / 100); // Relative, in 100 ns units
+
+                if (!SetWaitableTimer(m_Timer, &dueTime, 0, nullptr, nullptr, FALSE))
+                    break;
+
+                WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+            }
+
+            if (IsInterrupted())
+                return false;
+        }
+#endif
+        // steady_clock matches Clock, and on Linux this is an absolute CLOCK_MONOTONIC futex wait
+        std::chrono::steady_clock::time_point wakeTime{ std::chrono::nanoseconds(deadline) };
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        return !m_Condition.wait_until(lock, wakeTime, [this]() { return IsInterrupted(); });
+    }
+
+    void PlaybackControl::WaitWhilePaused()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this]() { return !m_Paused || m_StopRequested || m_SeekPending; });
+    }
+
+    bool PlaybackControl::TakeSeek(SeekTarget& target)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_SeekPending)
+            return false;
+
+        target = m_SeekTarget;
+        m_SeekPending = false;
+        return true;
+    }
+
+    bool PlaybackControl::TakeWake()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        bool wasPending = m_WakePending;
+        m_WakePending = false;
+        return wasPending;
+    }
+
+    void PlaybackControl::Signal()
+    {
+        m_Condition.notify_all();
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+        if (m_WakeEvent)
+            SetEvent(m_WakeEvent);
+#endif
+    }
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace KeyActions
+{
+    // Control channel between the thread driving a playback (stop, pause, resume,
+    // seek) and the playback thread. The playback thread blocks on the channel
+    // instead of polling, so commands wake it immediately and an idle or paused
+    // playback uses no CPU.
+    class PlaybackControl
+    {
+    public:
+        struct SeekTarget
+        {
+            int64_t Value = 0;
+            bool ByEvent = false;   // Value is an event index rather than a recording time
+        };
+
+        PlaybackControl();
+        ~PlaybackControl();
+
+        PlaybackControl(const PlaybackControl&) = delete;
+        PlaybackControl& operator=(const PlaybackControl&) = delete;
+
+        // Commands
+        void Reset();
+        void Stop();
+        void Pause();
+        void Resume();
+        void Seek(int64_t time);
+        void SeekToEvent(size_t index);
+        void Wake();                // Nothing changed for the thread itself, but its schedule did
+
+        bool IsStopRequested() const { return m_StopRequested; }
+        bool IsPaused() const { return m_Paused; }
+
+        // True while a command is waiting for the playback thread to act on it
+        bool IsInterrupted() const { return m_StopRequested || m_Paused || m_SeekPending || m_WakePending; }
+
+        // Blocks until the Clock deadline passes; returns false as soon as a command interrupts the wait
+        bool SleepUntil(int64_t deadline);
+
+        // Blocks while paused; returns once resumed, stopped or seeked
+        void WaitWhilePaused();
+
+        // Takes the pending seek target, if any
+        bool TakeSeek(SeekTarget& target);
+
+        // Clears a pending Wake(); returns whether there was one
+        bool TakeWake();
+
+    private:
+        void Signal();
+
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+
+        std::atomic<bool> m_StopRequested{ false };
+        std::atomic<bool> m_Paused{ false };
+        std::atomic<bool> m_SeekPending{ false };
+        std::atomic<bool> m_WakePending{ false };
+        SeekTarget m_SeekTarget;
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+        // Condition variable timeouts follow the ~15 ms system tick on Windows, so timed
+        // sleeps wait on a high resolution timer together with a wake event instead
+        void* m_WakeEvent = nullptr;
+        void* m_Timer = nullptr;
+#endif
+    };
+}
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include "PlaybackEngine.h"
+#include "InputBatch.h"
+
+#include "Lumina/Core/Log.h"
+
+#include <algorithm>
+
+namespace KeyActions
+{
+    namespace
+    {
+        // How long the timer thread sleeps with nothing scheduled; any Play() wakes it sooner
+        constexpr int64_t IdleTimeout = 60 * Clock::NanosecondsPerSecond;
+    }
+
+    PlaybackEngine::PlaybackEngine(const TimingSettings& timing)
+        : PlaybackEngine(Lumina::GlobalInputPlayback::Create(), timing)
+    {
+        if (!m_Playback)
+        {
+            LUMINA_LOG_ERROR("Failed to create GlobalInputPlayback - platform not supported");
+        }
+    }
+
+    PlaybackEngine::PlaybackEngine(std::unique_ptr<Lumina::GlobalInputPlayback> playback, const TimingSettings& timing)
+        : m_Playback(std::move(playback)), m_Timing(TimingEngine::Create(timing))
+    {
+        // Without a backend Play() always fails, so there is nothing to run
+        if (m_Playback)
+            m_TimerThread = std::thread(&PlaybackEngine::TimerThread, this);
+    }
+
+    PlaybackEngine::~PlaybackEngine()
+    {
+        m_Control.Stop();
+
+        if (m_TimerThread.joinable())
+        {
+            m_TimerThread.join();
+        }
+    }
+
+    PlaybackId PlaybackEngine::Play(RecordingSnapshot recording, const PlaybackSettings& settings)
+    {
+        if (!m_Playback)
+        {
+            LUMINA_LOG_ERROR("GlobalInputPlayback not available");
+            return InvalidPlaybackId;
+        }
+
+        if (!recording || recording->Events.IsEmpty())
+        {
+            LUMINA_LOG_WARN("Cannot play empty recording");
+            return InvalidPlaybackId;
+        }
+
+        if (settings.Speed <= 0.0f)
+        {
+            LUMINA_LOG_WARN("Invalid playback speed: {}", settings.Speed);
+            return InvalidPlaybackId;
+        }
+
+        std::string name = recording->Name;
+        PlaybackId id;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            id = m_NextId++;
+            ActivePlayback& playback = m_Playbacks[id];
+            playback.Recording = std::move(recording);
+            playback.Settings = settings;
+            playback.StartIndex = std::max(0, settings.StartFromIndex);
+            playback.EndIndex = settings.StopAtIndex >= 0 ?
+                std::min(settings.StopAtIndex, (int)playback.Recording->Events.Size() - 1) :
+                (int)playback.Recording->Events.Size() - 1;
+            playback.Index = playback.StartIndex;
+            playback.TimelineStart = Clock::Now();
+
+            if (!Schedule(id, playback))
+            {
+                m_Playbacks.erase(id);
+                LUMINA_LOG_WARN("Nothing to play in recording: {}", name);
+                return InvalidPlaybackId;
+            }
+        }
+
+        m_Control.Wake();
+
+        LUMINA_LOG_INFO("Started playback {} of recording: {}", id, name);
+        return id;
+    }
+
+    void PlaybackEngine::Stop(PlaybackId id)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto it = m_Playbacks.find(id);
+            if (it == m_Playbacks.end())
+                return;
+
+            // Its heap entry is skipped once it reaches the top
+            if (!it->second.Held.IsEmpty())
+                m_StoppedHeld.push_back(it->second.Held);
+
+            m_Playbacks.erase(it);
+        }
+
+        m_Control.Wake();
+
+        LUMINA_LOG_INFO("Stopped playback {}", id);
+    }
+
+    void PlaybackEngine::StopAll()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (const auto& entry : m_Playbacks)
+            {
+                if (!entry.second.Held.IsEmpty())
+                    m_StoppedHeld.push_back(entry.second.Held);
+            }
+
+            m_Playbacks.clear();
+            m_Deadlines = {};
+        }
+
+        m_Control.Wake();
+    }
+
+    void PlaybackEngine::Pause(PlaybackId id)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Playbacks.find(id);
+        if (it == m_Playbacks.end() || it->second.Paused)
+            return;
+
+        ActivePlayback& playback = it->second;
+        playback.PausedPosition = GetPosition(playback, Clock::Now());
+        playback.Paused = true;
+        playback.Generation++;
+    }
+
+    void PlaybackEngine::Resume(PlaybackId id)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto it = m_Playbacks.find(id);
+            if (it == m_Playbacks.end() || !it->second.Paused)
+                return;
+
+            ActivePlayback& playback = it->second;
+            playback.TimelineStart = Clock::Now() - static_cast<int64_t>(playback.PausedPosition / static_cast<double>(playback.Settings.Speed));
+            playback.Paused = false;
+            Schedule(id, playback);
+        }
+
+        m_Control.Wake();
+    }
+
+    void PlaybackEngine::SetSpeed(PlaybackId id, float speed)
+    {
+        if (speed <= 0.0f)
+        {
+            LUMINA_LOG_WARN("Invalid playback speed: {}", speed);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto it = m_Playbacks.find(id);
+            if (it == m_Playbacks.end())
+                return;
+
+            ActivePlayback& playback = it->second;
+            if (playback.Paused)
+            {
+                // Takes effect from the paused position on Resume()
+                playback.Settings.Speed = speed;
+                return;
+            }
+
+            // Keep the current position and stretch the rest of the timeline
+            int64_t now = Clock::Now();
+            int64_t position = GetPosition(playback, now);
+            playback.Settings.Speed = speed;
+            playback.TimelineStart = now - static_cast<int64_t>(position / static_cast<double>(speed));
+            Schedule(id, playback);
+        }
+
+        m_Control.Wake();
+    }
+
+    void PlaybackEngine::SetLoop(PlaybackId id, bool loop)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Playbacks.find(id);
+        if (it != m_Playbacks.end())
+            it->second.Settings.Loop = loop;
+    }
+
+    bool PlaybackEngine::IsPlaying(PlaybackId id) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Playbacks.find(id) != m_Playbacks.end();
+    }
+
+    bool PlaybackEngine::IsPaused(PlaybackId id) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Playbacks.find(id);
+        return it != m_Playbacks.end() && it->second.Paused;
+    }
+
+    size_t PlaybackEngine::GetActiveCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Playbacks.size();
+    }
+
+    void PlaybackEngine::SetFinishedCallback(PlaybackFinishedCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_CallbackMutex);
+        m_FinishedCallback = callback;
+    }
+
+    void PlaybackEngine::TimerThread()
+    {
+        InputBatch batch(*m_Playback);
+        std::vector<PlaybackId> finished;
+        std::vector<PlaybackId> restarted;
+
+        while (!m_Control.IsStopRequested())
+        {
+            m_Control.TakeWake();
+
+            ReleaseStopped(batch);
+
+            int64_t deadline = 0;
+            bool idle = false;
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                // Drop entries for playbacks that were stopped, paused or rescheduled
+                while (!m_Deadlines.empty())
+                {
+                    const Deadline& next = m_Deadlines.top();
+                    auto it = m_Playbacks.find(next.Id);
+                    if (it != m_Playbacks.end() && it->second.Generation == next.Generation)
+                        break;
+
+                    m_Deadlines.pop();
+                }
+
+                idle = m_Deadlines.empty();
+                if (!idle)
+                    deadline = m_Deadlines.top().Time;
+            }
+
+            if (idle)
+            {
+                m_Control.SleepUntil(Clock::Now() + IdleTimeout);
+                continue;
+            }
+
+            // Woken early when a playback is added or rescheduled; pick the new earliest deadline
+            if (!m_Timing->WaitUntil(deadline, m_Control))
+                continue;
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                int64_t now = Clock::Now();
+                while (!m_Deadlines.empty() && m_Deadlines.top().Time <= now)
+                {
+                    Deadline due = m_Deadlines.top();
+                    m_Deadlines.pop();
+
+                    auto it = m_Playbacks.find(due.Id);
+                    if (it == m_Playbacks.end() || it->second.Generation != due.Generation)
+                        continue;
+
+                    ActivePlayback& playback = it->second;
+                    const auto event = playback.Recording->Events[playback.Index];
+                    batch.Add(event);
+                    playback.Held.Apply(event);
+                    playback.Index++;
+
+                    if (Schedule(due.Id, playback))
+                        continue;
+
+                    // Each run starts with nothing held, whether it loops or ends here
+                    playback.Held.AddTransition(HeldInputState(), batch);
+                    playback.Held = HeldInputState();
+
+                    if (playback.Settings.Loop)
+                    {
+                        // Rescheduled after this pass; an event at time zero would otherwise be due again at once
+                        restarted.push_back(due.Id);
+                        continue;
+                    }
+
+                    finished.push_back(due.Id);
+                    m_Playbacks.erase(it);
+                }
+
+                for (PlaybackId id : restarted)
+                {
+                    auto it = m_Playbacks.find(id);
+                    if (it == m_Playbacks.end())
+                        continue;
+
+                    ActivePlayback& playback = it->second;
+                    playback.Index = playback.StartIndex;
+                    playback.TimelineStart = now;
+
+                    if (!Schedule(id, playback))
+                    {
+                        finished.push_back(id);
+                        m_Playbacks.erase(it);
+                    }
+                }
+
+                restarted.clear();
+            }
+
+            // Everything due in this pass, across all playbacks, goes to the backend at once.
+            // Injection can block, so it happens outside the lock.
+            batch.Submit();
+
+            if (!finished.empty())
+            {
+                std::lock_guard<std::mutex> lock(m_CallbackMutex);
+                for (PlaybackId id : finished)
+                {
+                    LUMINA_LOG_INFO("Playback {} completed", id);
+
+                    if (m_FinishedCallback)
+                        m_FinishedCallback(id);
+                }
+
+                finished.clear();
+            }
+        }
+
+        // Playbacks still running when the engine is destroyed release what they hold too
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (const auto& entry : m_Playbacks)
+                entry.second.Held.AddTransition(HeldInputState(), batch);
+
+            m_Playbacks.clear();
+        }
+
+        ReleaseStopped(batch);
+    }
+
+    void PlaybackEngine::ReleaseStopped(InputBatch& batch)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            for (const HeldInputState& held : m_StoppedHeld)
+                held.AddTransition(HeldInputState(), batch);
+
+            m_StoppedHeld.clear();
+        }
+
+        // Injection can block, so it happens outside the lock
+        batch.Submit();
+    }
+
+    bool PlaybackEngine::Schedule(PlaybackId id, ActivePlayback& playback)
+    {
+        const EventStore& events = playback.Recording->Events;
+
+        // Skip mouse moves if requested
+        while (playback.Index <= playback.EndIndex && playback.Settings.IgnoreMouseMove &&
+            events[playback.Index].GetAction() == RecordedAction::MouseMoved)
+        {
+            playback.Index++;
+        }
+
+        if (playback.Index > playback.EndIndex)
+            return false;
+
+        playback.Generation++;
+
+        int64_t targetTime = static_cast<int64_t>(events[playback.Index].GetTimestamp() / static_cast<double>(playback.Settings.Speed));
+        m_Deadlines.push({ playback.TimelineStart + targetTime, id, playback.Generation });
+        return true;
+    }
+
+    int64_t PlaybackEngine::GetPosition(const ActivePlayback& playback, int64_t now) const
+    {
+        if (playback.Paused)
+            return playback.PausedPosition;
+
+        return static_cast<int64_t>((now - playback.TimelineStart) * static_cast<double>(playback.Settings.Speed));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Recording.h"
+#include "PlaybackControl.h"
+#include "PlaybackSession.h"
+#include "RecordingIndex.h"
+#include "TimingEngine.h"
+
+#include "Lumina/Input/GlobalInputPlayback.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace KeyActions
+{
+    using PlaybackId = uint64_t;
+    inline constexpr PlaybackId InvalidPlaybackId = 0;
+
+    using PlaybackFinishedCallback = std::function<void(PlaybackId id)>;
+
+    // Plays any number of recordings at once on a single timer thread. Every active
+    // playback keeps one entry in a min-heap keyed by its next event deadline; the
+    // thread sleeps until the earliest one, injects whatever is due and reschedules.
+    class PlaybackEngine
+    {
+    public:
+        PlaybackEngine(const TimingSettings& timing = TimingSettings());
+        explicit PlaybackEngine(std::unique_ptr<Lumina::GlobalInputPlayback> playback, const TimingSettings& timing = TimingSettings());
+        ~PlaybackEngine();
+
+        PlaybackEngine(const PlaybackEngine&) = delete;
+        PlaybackEngine& operator=(const PlaybackEngine&) = delete;
+
+        // Returns InvalidPlaybackId if the recording cannot be played. Settings.Timing is
+        // ignored; all playbacks share the engine's timing.
+        PlaybackId Play(RecordingSnapshot recording, const PlaybackSettings& settings = PlaybackSettings());
+        void Stop(PlaybackId id);
+        void StopAll();
+
+        // Per-playback controls
+        void Pause(PlaybackId id);
+        void Resume(PlaybackId id);
+        void SetSpeed(PlaybackId id, float speed);
+        void SetLoop(PlaybackId id, bool loop);
+
+        // State queries
+        bool IsPlaying(PlaybackId id) const;
+        bool IsPaused(PlaybackId id) const;
+        size_t GetActiveCount() const;
+
+        // Called on the timer thread when a playback reaches its end (not when stopped)
+        void SetFinishedCallback(PlaybackFinishedCallback callback);
+
+    private:
+        struct ActivePlayback
+        {
+            RecordingSnapshot Recording;
+            PlaybackSettings Settings;
+            int StartIndex = 0;
+            int EndIndex = -1;
+            int Index = 0;                 // Next event to inject
+            int64_t TimelineStart = 0;     // Clock time that recording time zero maps to at the current speed
+            int64_t PausedPosition = 0;    // Recording time at which the playback was paused
+            bool Paused = false;
+            uint64_t Generation = 0;       // Bumped on every reschedule so stale heap entries are skipped
+            HeldInputState Held;           // What its injected events left down, released when it ends
+        };
+
+        struct Deadline
+        {
+            int64_t Time;
+            PlaybackId Id;
+            uint64_t Generation;
+
+            bool operator>(const Deadline& other) const { return Time > other.Time; }
+        };
+
+        void TimerThread();
+        void ReleaseStopped(InputBatch& batch);
+        bool Schedule(PlaybackId id, ActivePlayback& playback);
+        int64_t GetPosition(const ActivePlayback& playback, int64_t now) const;
+
+    private:
+        std::unique_ptr<Lumina::GlobalInputPlayback> m_Playback;
+        std::unique_ptr<TimingEngine> m_Timing;
+        PlaybackControl m_Control;
+        std::thread m_TimerThread;
+
+        mutable std::mutex m_Mutex;
+        std::unordered_map<PlaybackId, ActivePlayback> m_Playbacks;
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> m_Deadlines;
+        PlaybackId m_NextId = 1;
+        std::vector<HeldInputState> m_StoppedHeld; // Released by the timer thread, after anything it already collected
+
+        std::mutex m_CallbackMutex;
+        PlaybackFinishedCallback m_FinishedCallback;
+    };
+}
\ No newline at end of file
@@ -1,12 +1,93 @@
 #include "PlaybackSession.h"
+#include "InputBatch.h"
+#include "RecordingIndex.h"
 
 #include "Lumina/Core/Application.h"
 #include "Lumina/Core/Log.h"
 
-#include <chrono>
+#include <algorithm>
 
 namespace KeyActions
 {
+    // The events a playback thread plays, held in memory or decoded block by block from disk
+    class PlaybackEvents
+    {
+    public:
+        virtual ~PlaybackEvents() = default;
+
+        // Store holding the event and its offset in it, or null if it can't be read. The
+        // store stays valid until the call after next.
+        virtual const EventStore* Get(size_t index, size_t& offset) = 0;
+
+        virtual size_t FindEvent(int64_t time) = 0;
+        virtual HeldInputState GetStateAt(size_t index) = 0;
+    };
+
+    namespace
+    {
+        class SnapshotEvents : public PlaybackEvents
+        {
+        public:
+            explicit SnapshotEvents(RecordingSnapshot snapshot) : m_Snapshot(std::move(snapshot)) {}
+
+            const EventStore* Get(size_t index, size_t& offset) override
+            {
+                offset = index;
+                return &m_Snapshot->Events;
+            }
+
+            size_t FindEvent(int64_t time) override { return GetIndex().FindEvent(time); }
+            HeldInputState GetStateAt(size_t index) override { return GetIndex().GetStateAt(index); }
+
+        private:
+            // Built on first use, which is on the playback thread before the timeline starts
+            const RecordingIndex& GetIndex()
+            {
+                if (!m_Indexed)
+                {
+                    m_Index.Build(m_Snapshot->Events);
+                    m_Indexed = true;
+                }
+
+                return m_Index;
+            }
+
+            RecordingSnapshot m_Snapshot;
+            RecordingIndex m_Index;
+            bool m_Indexed = false;
+        };
+
+        class StreamedEvents : public PlaybackEvents
+        {
+        public:
+            explicit StreamedEvents(std::shared_ptr<RecordingReader> reader) : m_Reader(std::move(reader)) {}
+
+            const EventStore* Get(size_t index, size_t& offset) override
+            {
+                size_t block = RecordingReader::GetBlockIndex(index);
+                if (!m_Current || block != m_CurrentBlock)
+                {
+                    // The previous block is kept so the last view handed out stays valid
+                    m_Previous = std::move(m_Current);
+                    m_Current = m_Reader->GetBlock(block);
+                    m_CurrentBlock = block;
+                }
+
+                offset = index - RecordingReader::GetBlockStart(block);
+                return m_Current.get();
+            }
+
+            size_t FindEvent(int64_t time) override { return m_Reader->FindEvent(time); }
+            HeldInputState GetStateAt(size_t index) override { return m_Reader->GetStateAt(index); }
+
+        private:
+            std::shared_ptr<RecordingReader> m_Reader;
+            RecordingReader::Block m_Current;
+            RecordingReader::Block m_Previous;
+            size_t m_CurrentBlock = 0;
+        };
+    }
+
     PlaybackSession::PlaybackSession()
     {
         m_Playback = Lumina::GlobalInputPlayback::Create();
@@ -17,6 +98,11 @@ namespace KeyActions
         }
     }
 
+    PlaybackSession::PlaybackSession(std::unique_ptr<Lumina::GlobalInputPlayback> playback)
+        : m_Playback(std::move(playback))
+    {
+    }
+
     PlaybackSession::~PlaybackSession()
     {
         Stop();
@@ -27,23 +113,48 @@ namespace KeyActions
         }
     }
 
-    bool PlaybackSession::Play(const Recording& recording, const PlaybackSettings& settings)
+    bool PlaybackSession::Play(RecordingSnapshot recording, const PlaybackSettings& settings)
     {
-        if (!m_Playback)
+        if (!recording || recording->Events.IsEmpty())
         {
-            LUMINA_LOG_ERROR("GlobalInputPlayback not available");
+            LUMINA_LOG_WARN("Cannot play empty recording");
             return false;
         }
 
-        if (m_IsPlaying)
+        // The thread shares the snapshot rather than copying the events
+        size_t eventCount = recording->Events.Size();
+        int64_t duration = recording->Duration;
+        std::string name = recording->Name;
+
+        return Start(std::make_unique<SnapshotEvents>(std::move(recording)), eventCount, duration, name, settings);
+    }
+
+    bool PlaybackSession::Play(std::shared_ptr<RecordingReader> reader, const PlaybackSettings& settings)
+    {
+        if (!reader || reader->GetEventCount() == 0)
         {
-            LUMINA_LOG_WARN("Already playing a recording");
+            LUMINA_LOG_WARN("Cannot play empty recording");
+            return false;
+        }
+
+        size_t eventCount = reader->GetEventCount();
+        int64_t duration = reader->GetDuration();
+        std::string name = reader->GetName();
+
+        return Start(std::make_unique<StreamedEvents>(std::move(reader)), eventCount, duration, name, settings);
+    }
+
+    bool PlaybackSession::Start(std::unique_ptr<PlaybackEvents> events, size_t eventCount, int64_t duration, const std::string& name, const PlaybackSettings& settings)
+    {
+        if (!m_Playback)
+        {
+            LUMINA_LOG_ERROR("GlobalInputPlayback not available");
             return false;
         }
 
-        if (recording.Events.empty())
+        if (m_IsPlaying)
         {
-            LUMINA_LOG_WARN("Cannot play empty recording");
+            LUMINA_LOG_WARN("Already playing a recording");
             return false;
         }
 
@@ -53,18 +164,18 @@ namespace KeyActions
             m_PlaybackThread.join();
         }
 
+        m_Control.Reset();
         m_IsPlaying = true;
-        m_IsPaused = false;
-        m_ShouldStop = false;
-        m_CurrentTime = 0.0f;
+        m_CurrentTime = 0;
+        m_TimelineStart = Clock::Now();
         m_CurrentEventIndex = 0;
-        m_TotalEvents = recording.Events.size();
-        m_TotalDuration = recording.TotalDuration;
+        m_TotalEvents = eventCount;
+        m_TotalDuration = duration;
 
-        // Start playback on separate thread
-        m_PlaybackThread = std::thread(&PlaybackSession::PlaybackThread, this, recording, settings);
+        LUMINA_LOG_INFO("Started playback of recording: {}", name);
 
-        LUMINA_LOG_INFO("Started playback of recording: {}", recording.Name);
+        // Start playback on separate thread
+        m_PlaybackThread = std::thread(&PlaybackSession::PlaybackThread, this, std::move(events), settings);
         return true;
     }
 
@@ -73,9 +184,8 @@ namespace KeyActions
         if (!m_IsPlaying)
             return;
 
-        m_ShouldStop = true;
+        m_Control.Stop();
         m_IsPlaying = false;
-        m_IsPaused = false;
 
         if (m_PlaybackThread.joinable())
         {
@@ -87,28 +197,60 @@ namespace KeyActions
 
     void PlaybackSession::Pause()
     {
-        if (m_IsPlaying && !m_IsPaused)
+        if (m_IsPlaying && !m_Control.IsPaused())
         {
-            m_IsPaused = true;
+            m_Control.Pause();
             LUMINA_LOG_INFO("Paused playback");
         }
     }
 
     void PlaybackSession::Resume()
     {
-        if (m_IsPlaying && m_IsPaused)
+        if (m_IsPlaying && m_Control.IsPaused())
         {
-            m_IsPaused = false;
+            m_Control.Resume();
             LUMINA_LOG_INFO("Resumed playback");
         }
     }
 
+    void PlaybackSession::Seek(int64_t time)
+    {
+        if (m_IsPlaying)
+        {
+            m_Control.Seek(std::clamp<int64_t>(time, 0, m_TotalDuration));
+            LUMINA_LOG_INFO("Seeking playback to {:.2f}s", Clock::ToSeconds(time));
+        }
+    }
+
+    void PlaybackSession::SeekToEvent(size_t index)
+    {
+        if (m_IsPlaying)
+        {
+            m_Control.SeekToEvent(index);
+            LUMINA_LOG_INFO("Seeking playback to event {}", index);
+        }
+    }
+
     float PlaybackSession::GetProgress() const
     {
-        if (m_TotalDuration <= 0.0f)
+        if (m_TotalDuration <= 0)
             return 0.0f;
 
-        return std::min(1.0f, m_CurrentTime / m_TotalDuration);
+        return std::min(1.0f, static_cast<float>(static_cast<double>(GetElapsedNanoseconds()) / m_TotalDuration));
+    }
+
+    float PlaybackSession::GetElapsedTime() const
+    {
+        return static_cast<float>(Clock::ToSeconds(GetElapsedNanoseconds()));
+    }
+
+    int64_t PlaybackSession::GetElapsedNanoseconds() const
+    {
+        // The playback thread sleeps between events, so derive the live position from the timeline start
+        if (m_IsPlaying && !m_Control.IsPaused())
+            return Clock::Now() - m_TimelineStart;
+
+        return m_CurrentTime;
     }
 
     void PlaybackSession::SetProgressCallback(PlaybackProgressCallback callback)
@@ -123,92 +265,159 @@ namespace KeyActions
         m_CompleteCallback = callback;
     }
 
-    void PlaybackSession::PlaybackThread(Recording recording, PlaybackSettings settings)
+    void PlaybackSession::PlaybackThread(std::unique_ptr<PlaybackEvents> events, PlaybackSettings settings)
     {
-        using namespace std::chrono;
-
-        auto startTime = high_resolution_clock::now();
-        auto pauseStartTime = startTime;
-        duration<float> totalPausedTime = duration<float>::zero();
-
-        do // Loop if settings.Loop is true
+        // All scheduling is done in integer nanoseconds against the monotonic clock
+        std::unique_ptr<TimingEngine> timing = TimingEngine::Create(settings.Timing);
+        InputBatch batch(*m_Playback);
+
+        auto toPlaybackTime = [&settings](int64_t time) {
+            return static_cast<int64_t>(time / static_cast<double>(settings.Speed));
+        };
+
+        int startIndex = std::max(0, settings.StartFromIndex);
+        int endIndex = settings.StopAtIndex >= 0 ?
+            std::min(settings.StopAtIndex, (int)m_TotalEvents - 1) :
+            (int)m_TotalEvents - 1;
+
+        // Seeks binary search the timestamps and restore held input from the nearest checkpoint
+        HeldInputState held;
+        size_t offset = 0;   // Position of the current event in the store Get returned
+
+        // Presses or releases whatever differs from what the recording holds just before the event
+        auto restoreHeldInput = [&](int eventIndex) {
+            HeldInputState target = events->GetStateAt(eventIndex);
+            held.AddTransition(target, batch);
+            batch.Submit();
+            held = target;
+        };
+
+        restoreHeldInput(startIndex);
+
+        // The timeline starts once the index is ready, so building it never makes events late
+        int64_t timelineStart = Clock::Now();
+        m_TimelineStart = timelineStart;
+        int index = startIndex;
+
+        while (!m_Control.IsStopRequested())
         {
-            int startIndex = std::max(0, settings.StartFromIndex);
-            int endIndex = settings.StopAtIndex >= 0 ?
-                std::min(settings.StopAtIndex, (int)recording.Events.size() - 1) :
-                recording.Events.size() - 1;
-
-            for (int i = startIndex; i <= endIndex && !m_ShouldStop; ++i)
+            // Handle seek first so a seek while paused moves the paused position
+            PlaybackControl::SeekTarget seek;
+            if (m_Control.TakeSeek(seek))
             {
-                const auto& event = recording.Events[i];
+                size_t target = seek.ByEvent ? static_cast<size_t>(std::max<int64_t>(0, seek.Value)) : events->FindEvent(seek.Value);
+                index = std::max(startIndex, static_cast<int>(std::min<size_t>(target, endIndex + 1)));
 
-                // Skip mouse moves if requested
-                if (settings.IgnoreMouseMove && event.Action == RecordedAction::MouseMoved)
-                    continue;
+                restoreHeldInput(index);
 
-                // Handle pause
-                while (m_IsPaused && !m_ShouldStop)
+                int64_t seekTime = seek.Value;
+                if (seek.ByEvent)
                 {
-                    if (pauseStartTime == startTime) // First time pausing
-                        pauseStartTime = high_resolution_clock::now();
-
-                    std::this_thread::sleep_for(milliseconds(10));
+                    const EventStore* store = index <= endIndex ? events->Get(index, offset) : nullptr;
+                    seekTime = store ? (*store)[offset].GetTimestamp() : m_TotalDuration;
                 }
 
-                // Account for paused time
-                if (pauseStartTime != startTime)
-                {
-                    auto pauseEndTime = high_resolution_clock::now();
-                    totalPausedTime += duration_cast<duration<float>>(pauseEndTime - pauseStartTime);
-                    pauseStartTime = startTime; // Reset
-                }
+                int64_t position = toPlaybackTime(seekTime);
+                timelineStart = Clock::Now() - position;
+                m_TimelineStart = timelineStart;
+                m_CurrentTime = position;
+                m_CurrentEventIndex = index;
+                continue;
+            }
 
-                // Calculate target time for this event
-                float targetTime = event.Time / settings.Speed;
+            // Handle pause, blocking until the next command
+            if (m_Control.IsPaused())
+            {
+                int64_t position = Clock::Now() - timelineStart;
+                m_CurrentTime = position;
 
-                // Wait until it's time to play this event
-                while (!m_ShouldStop)
-                {
-                    auto currentTime = high_resolution_clock::now();
-                    auto elapsed = duration_cast<duration<float>>(currentTime - startTime) - totalPausedTime;
+                m_Control.WaitWhilePaused();
 
-                    m_CurrentTime = elapsed.count();
+                // Shift the timeline past the time spent paused
+                timelineStart = Clock::Now() - position;
+                m_TimelineStart = timelineStart;
+                continue;
+            }
 
-                    if (elapsed.count() >= targetTime)
-                        break;
+            if (index > endIndex)
+            {
+                if (!settings.Loop)
+                    break;
 
-                    std::this_thread::sleep_for(milliseconds(1));
-                }
+                // Reset for loop
+                restoreHeldInput(startIndex);
+                index = startIndex;
+                timelineStart = Clock::Now();
+                m_TimelineStart = timelineStart;
+                m_CurrentTime = 0;
+                m_CurrentEventIndex = startIndex;
+                continue;
+            }
 
-                if (m_ShouldStop)
-                    break;
+            const EventStore* store = events->Get(index, offset);
+            if (!store)
+                break;
+
+            const auto event = (*store)[offset];
+
+            // Skip mouse moves if requested
+            if (settings.IgnoreMouseMove && event.GetAction() == RecordedAction::MouseMoved)
+            {
+                index++;
+                continue;
+            }
 
-                // Simulate the event
-                SimulateEvent(event);
+            // Wait until it's time to play this event; a command cuts the wait short and is handled above
+            if (!timing->WaitUntil(timelineStart + toPlaybackTime(event.GetTimestamp()), m_Control))
+                continue;
 
-                m_CurrentEventIndex = i;
+            int64_t now = Clock::Now();
+            m_CurrentTime = now - timelineStart;
 
-                // Call progress callback if set
+            // Inject this event together with any that are already due behind it
+            batch.Add(event);
+            held.Apply(event);
+            int lastIndex = index++;
+
+            while (index <= endIndex)
+            {
+                const EventStore* nextStore = events->Get(index, offset);
+                if (!nextStore)
+                    break;
+
+                const auto next = (*nextStore)[offset];
+                if (settings.IgnoreMouseMove && next.GetAction() == RecordedAction::MouseMoved)
                 {
-                    std::lock_guard<std::mutex> lock(m_CallbackMutex);
-                    if (m_ProgressCallback)
-                    {
-                        float progress = m_TotalDuration > 0.0f ? (m_CurrentTime / m_TotalDuration) : 0.0f;
-                        m_ProgressCallback(progress, i);
-                    }
+                    index++;
+                    continue;
                 }
+
+                if (timelineStart + toPlaybackTime(next.GetTimestamp()) > now)
+                    break;
+
+                batch.Add(next);
+                held.Apply(next);
+                lastIndex = index++;
             }
 
-            // Reset for loop
-            if (settings.Loop && !m_ShouldStop)
+            batch.Submit();
+
+            m_CurrentEventIndex = lastIndex;
+
+            // Call progress callback if set
             {
-                startTime = high_resolution_clock::now();
-                totalPausedTime = duration<float>::zero();
-                m_CurrentTime = 0.0f;
-                m_CurrentEventIndex = 0;
+                std::lock_guard<std::mutex> lock(m_CallbackMutex);
+                if (m_ProgressCallback)
+                {
+                    float progress = GetProgress();
+                    m_ProgressCallback(progress, lastIndex);
+                }
             }
+        }
 
-        } while (settings.Loop && !m_ShouldStop);
+        // Release anything still held so stopping mid-recording leaves no key stuck
+        held.AddTransition(HeldInputState(), batch);
+        batch.Submit();
 
         m_IsPlaying = false;
 
@@ -223,34 +432,4 @@ namespace KeyActions
 
         LUMINA_LOG_INFO("Playback completed");
     }
-
-    void PlaybackSession::SimulateEvent(const RecordedEvent& event)
-    {
-        switch (event.Action)
-        {
-        case RecordedAction::KeyPressed:
-            m_Playback->SimulateKeyPress(event.Key);
-            break;
-
-        case RecordedAction::KeyReleased:
-            m_Playback->SimulateKeyRelease(event.Key);
-            break;
-
-        case RecordedAction::MousePressed:
-            m_Playback->SimulateMouseButtonPress(event.Button, event.MouseX, event.MouseY);
-            break;
-
-        case RecordedAction::MouseReleased:
-            m_Playback->SimulateMouseButtonRelease(event.Button, event.MouseX, event.MouseY);
-            break;
-
-        case RecordedAction::MouseMoved:
-            m_Playback->SimulateMouseMove(event.MouseX, event.MouseY);
-            break;
-
-        case RecordedAction::MouseScrolled:
-            m_Playback->SimulateMouseScroll(event.ScrollDX, event.ScrollDY);
-            break;
-        }
-    }
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Recording.h"
+#include "RecordingReader.h"
+#include "PlaybackControl.h"
+#include "TimingEngine.h"
 
 #include "Lumina/Input/GlobalInputPlayback.h"
 
@@ -23,48 +26,58 @@ namespace KeyActions
         bool IgnoreMouseMove = false;    // Skip mouse movement events
         int StartFromIndex = 0;          // Start from specific event index
         int StopAtIndex = -1;            // Stop at specific event index (-1 = play to end)
+        TimingSettings Timing;           // How the playback thread waits for each event
     };
 
+    class PlaybackEvents;
+
     class PlaybackSession
     {
     public:
         PlaybackSession();
+        explicit PlaybackSession(std::unique_ptr<Lumina::GlobalInputPlayback> playback);
         ~PlaybackSession();
 
         // Playback control
-        bool Play(const Recording& recording, const PlaybackSettings& settings = PlaybackSettings());
+        bool Play(RecordingSnapshot recording, const PlaybackSettings& settings = PlaybackSettings());
+
+        // Plays straight from disk, decoding blocks as playback reaches them
+        bool Play(std::shared_ptr<RecordingReader> reader, const PlaybackSettings& settings = PlaybackSettings());
         void Stop();
         void Pause();
         void Resume();
+        void Seek(int64_t time);    // Recording time in nanoseconds
+        void SeekToEvent(size_t index);
 
         // State queries
         bool IsPlaying() const { return m_IsPlaying; }
-        bool IsPaused() const { return m_IsPaused; }
+        bool IsPaused() const { return m_IsPlaying && m_Control.IsPaused(); }
         float GetProgress() const;
         size_t GetCurrentEventIndex() const { return m_CurrentEventIndex; }
         size_t GetTotalEvents() const { return m_TotalEvents; }
-        float GetElapsedTime() const { return m_CurrentTime; }
-        float GetTotalDuration() const { return m_TotalDuration; }
+        float GetElapsedTime() const;
+        float GetTotalDuration() const { return static_cast<float>(Clock::ToSeconds(m_TotalDuration)); }
 
         // Callbacks
         void SetProgressCallback(PlaybackProgressCallback callback);
         void SetCompleteCallback(PlaybackCompleteCallback callback);
 
     private:
-        void PlaybackThread(Recording recording, PlaybackSettings settings);
-        void SimulateEvent(const RecordedEvent& event);
+        bool Start(std::unique_ptr<PlaybackEvents> events, size_t eventCount, int64_t duration, const std::string& name, const PlaybackSettings& settings);
+        void PlaybackThread(std::unique_ptr<PlaybackEvents> events, PlaybackSettings settings);
+        int64_t GetElapsedNanoseconds() const;
 
         std::unique_ptr<Lumina::GlobalInputPlayback> m_Playback;
         std::thread m_PlaybackThread;
         std::mutex m_CallbackMutex;
+        PlaybackControl m_Control;
 
         std::atomic<bool> m_IsPlaying{ false };
-        std::atomic<bool> m_IsPaused{ false };
-        std::atomic<bool> m_ShouldStop{ false };
-        std::atomic<float> m_CurrentTime{ 0.0f };
+        std::atomic<int64_t> m_CurrentTime{ 0 };   // Nanoseconds of playback, excluding pauses
+        std::atomic<int64_t> m_TimelineStart{ 0 }; // Clock time that event timestamps are scheduled from
         std::atomic<size_t> m_CurrentEventIndex{ 0 };
         std::atomic<size_t> m_TotalEvents{ 0 };
-        float m_TotalDuration{ 0.0f };
+        int64_t m_TotalDuration{ 0 };
 
         PlaybackProgressCallback m_ProgressCallback;
         PlaybackCompleteCallback m_CompleteCallback;
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Lumina/Core/KeyCodes.h"
+
+namespace KeyActions
+{
+    enum class RecordedAction : uint8_t
+    {
+        KeyPressed,
+        KeyReleased,
+        MousePressed,
+        MouseReleased,
+        MouseMoved,
+        MouseScrolled
+    };
+
+    enum ModifierFlag : uint8_t
+    {
+        ModifierShift = 1 << 0,
+        ModifierCtrl = 1 << 1,
+        ModifierAlt = 1 << 2,
+        ModifierSuper = 1 << 3,
+        ModifierCapsLock = 1 << 4
+    };
+
+    // Single event in unpacked form, used for callbacks and conversions.
+    // Recordings themselves are stored column-wise in an EventStore.
+    struct RecordedEvent
+    {
+        using KeyCode = Lumina::KeyCode;
+		using MouseCode = Lumina::MouseCode;
+
+        RecordedAction Action;
+        uint8_t Modifiers = 0; // ModifierFlag bits, key events only
+        int64_t Timestamp = 0; // Nanoseconds since the recording started
+
+        KeyCode Key = KeyCode::Unknown;
+
+        MouseCode Button = MouseCode::Button0;
+        int MouseX = 0;
+        int MouseY = 0;
+        int ScrollDX = 0;
+        int ScrollDY = 0;
+
+        bool HasModifier(ModifierFlag flag) const { return (Modifiers & flag) != 0; }
+
+        std::string ToString() const;
+    };
+}
\ No newline at end of file
@@ -12,9 +12,10 @@ namespace KeyActions
         std::stringstream ss;
 
         // Format time as MM:SS.mmm
-        int minutes = static_cast<int>(Time) / 60;
-        int seconds = static_cast<int>(Time) % 60;
-        int milliseconds = static_cast<int>((Time - static_cast<int>(Time)) * 1000);
+        int64_t totalMilliseconds = Timestamp / Clock::NanosecondsPerMillisecond;
+        int minutes = static_cast<int>(totalMilliseconds / 60000);
+        int seconds = static_cast<int>((totalMilliseconds / 1000) % 60);
+        int milliseconds = static_cast<int>(totalMilliseconds % 1000);
 
         ss << std::setfill('0') << std::setw(2) << minutes << ":"
             << std::setw(2) << seconds << "."
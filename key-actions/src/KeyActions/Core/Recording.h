@@ -1,54 +1,28 @@
 #pragma once
 
+#include <memory>
 #include <string>
-#include <vector>
 
-#include "Lumina/Core/KeyCodes.h"
+#include "Clock.h"
+#include "RecordedEvent.h"
+#include "EventStore.h"
 
 namespace KeyActions
 {
-    enum class RecordedAction
-    {
-        KeyPressed,
-        KeyReleased,
-        MousePressed,
-        MouseReleased,
-        MouseMoved,
-        MouseScrolled
-    };
-
-    struct RecordedEvent
-    {
-        using KeyCode = Lumina::KeyCode;
-		using MouseCode = Lumina::MouseCode;
-
-        RecordedAction Action;
-        float Time;
-
-        KeyCode Key = KeyCode::Unknown;
-        bool ShiftPressed = false;
-        bool CtrlPressed = false;
-        bool AltPressed = false;
-        bool SuperPressed = false;
-        bool CapsLockActive = false;
-
-        MouseCode Button = MouseCode::Button0;
-        int MouseX = 0;
-        int MouseY = 0;
-        int ScrollDX = 0;
-        int ScrollDY = 0;
-
-        std::string ToString() const;
-    };
-
     struct Recording
     {
         std::string Name;
-        std::vector<RecordedEvent> Events;
-        float TotalDuration = 0.0f;
+        EventStore Events;
+        int64_t Duration = 0; // Nanoseconds
         bool RecordsMouse = false;
 
+        double GetDurationSeconds() const { return Clock::ToSeconds(Duration); }
+
         Recording() = default;
         Recording(const std::string& name, bool recordMouse = false) : Name(name), RecordsMouse(recordMouse) {}
     };
+
+    // Immutable, shared recording. Playback holds one of these instead of a copy, so
+    // starting playback is O(1) and any number of sessions can share the events.
+    using RecordingSnapshot = std::shared_ptr<const Recording>;
 }
\ No newline at end of file
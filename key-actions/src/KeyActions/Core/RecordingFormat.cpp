@@ -0,0 +1,209 @@
+#include "RecordingFormat.h"
+
+#include <cstring>
+#include <limits>
+
+namespace KeyActions
+{
+    namespace RecordingFormat
+    {
+        namespace
+        {
+            // Both record versions share the payload layout
+            template<typename TRecord>
+            void UnpackPayload(const TRecord& record, RecordedEvent& event)
+            {
+                event.Action = static_cast<RecordedAction>(record.Action);
+
+                switch (event.Action)
+                {
+                case RecordedAction::KeyPressed:
+                case RecordedAction::KeyReleased:
+                    event.Key = static_cast<Lumina::KeyCode>(record.Code);
+                    event.Modifiers = record.Modifiers;
+                    break;
+                case RecordedAction::MousePressed:
+                case RecordedAction::MouseReleased:
+                    event.Button = static_cast<Lumina::MouseCode>(record.Code);
+                    event.MouseX = record.A;
+                    event.MouseY = record.B;
+                    break;
+                case RecordedAction::MouseMoved:
+                    event.MouseX = record.A;
+                    event.MouseY = record.B;
+                    break;
+                case RecordedAction::MouseScrolled:
+                    event.ScrollDX = record.A;
+                    event.ScrollDY = record.B;
+                    break;
+                }
+            }
+
+            template<typename THeader>
+            bool ValidateLayout(const THeader& header, size_t fileSize, uint64_t recordCount, size_t recordSize, uint32_t magic = Magic)
+            {
+                if (header.Magic != magic)
+                    return false;
+
+                if (header.HeaderSize < sizeof(THeader) || header.RecordSize != recordSize)
+                    return false;
+
+                // In 64 bits: a 32-bit sum wraps for a huge NameLength, and the name would be read past the file
+                uint64_t nameEnd = static_cast<uint64_t>(header.HeaderSize) + header.NameLength;
+                if (header.EventsOffset < nameEnd || header.EventsOffset % EventAlignment != 0)
+                    return false;
+
+                if (header.EventsOffset > fileSize)
+                    return false;
+
+                if (header.Flags & FlagIncomplete)
+                    return true;
+
+                return (fileSize - header.EventsOffset) / header.RecordSize >= recordCount;
+            }
+        }
+
+        void EventEncoder::Encode(const EventView& event, std::vector<EventRecord>& records)
+        {
+            int64_t delta = event.GetTimestamp() - m_PreviousTimestamp;
+            m_PreviousTimestamp = event.GetTimestamp();
+
+            if (delta < 0 || delta > std::numeric_limits<uint32_t>::max())
+            {
+                EventRecord gap = {};
+                gap.Action = RecordTimeGap;
+                gap.A = static_cast<int32_t>(static_cast<uint64_t>(delta) & 0xFFFFFFFF);
+                gap.B = static_cast<int32_t>(static_cast<uint64_t>(delta) >> 32);
+                records.push_back(gap);
+
+                delta = 0;
+            }
+
+            EventRecord record = {};
+            record.TimeDelta = static_cast<uint32_t>(delta);
+            record.Action = static_cast<uint8_t>(event.GetAction());
+
+            switch (event.GetAction())
+            {
+            case RecordedAction::KeyPressed:
+            case RecordedAction::KeyReleased:
+                record.Code = static_cast<int16_t>(event.GetKey());
+                record.Modifiers = event.GetModifiers();
+                break;
+            case RecordedAction::MousePressed:
+            case RecordedAction::MouseReleased:
+                record.Code = static_cast<int16_t>(event.GetButton());
+                record.A = event.GetX();
+                record.B = event.GetY();
+                break;
+            case RecordedAction::MouseMoved:
+                record.A = event.GetX();
+                record.B = event.GetY();
+                break;
+            case RecordedAction::MouseScrolled:
+                record.A = event.GetScrollDX();
+                record.B = event.GetScrollDY();
+                break;
+            }
+
+            records.push_back(record);
+        }
+
+        bool EventDecoder::Decode(const EventRecord& record, RecordedEvent& event)
+        {
+            if (record.Action == RecordTimeGap)
+            {
+                uint64_t gap = static_cast<uint64_t>(static_cast<uint32_t>(record.A)) |
+                    (static_cast<uint64_t>(static_cast<uint32_t>(record.B)) << 32);
+                m_Timestamp += static_cast<int64_t>(gap);
+                return false;
+            }
+
+            m_Timestamp += record.TimeDelta;
+
+            event = RecordedEvent();
+            event.Timestamp = m_Timestamp;
+            UnpackPayload(record, event);
+            return true;
+        }
+
+        RecordedEvent UnpackLegacyEvent(const LegacyEventRecord& record)
+        {
+            RecordedEvent event;
+            event.Timestamp = Clock::FromSeconds(record.Time);
+            UnpackPayload(record, event);
+            return event;
+        }
+
+        uint16_t ReadVersion(const uint8_t* data, size_t size)
+        {
+            uint32_t magic = 0;
+            uint16_t version = 0;
+
+            if (size < sizeof(magic) + sizeof(version))
+                return 0;
+
+            std::memcpy(&magic, data, sizeof(magic));
+            std::memcpy(&version, data + sizeof(magic), sizeof(version));
+
+            return magic == Magic ? version : 0;
+        }
+
+        bool ValidateHeader(const FileHeader& header, size_t fileSize)
+        {
+            return header.Version == Version &&
+                ValidateLayout(header, fileSize, header.RecordCount, sizeof(EventRecord));
+        }
+
+        bool ValidateCompressedHeader(const FileHeader& header, size_t fileSize)
+        {
+            return header.Version == CompressedVersion && (header.Flags & FlagIncomplete) == 0 &&
+                ValidateLayout(header, fileSize, header.RecordCount, sizeof(BlockEntry));
+        }
+
+        bool ValidateManifestHeader(const FileHeader& header, size_t fileSize)
+        {
+            return header.Version == ManifestVersion && (header.Flags & FlagIncomplete) == 0 &&
+                ValidateLayout(header, fileSize, header.RecordCount, sizeof(ChunkEntry), ManifestMagic);
+        }
+
+        bool ValidateBlocks(const FileHeader& header, const BlockEntry* blocks, size_t fileSize)
+        {
+            uint64_t tableEnd = header.EventsOffset + header.RecordCount * sizeof(BlockEntry);
+
+            for (uint64_t i = 0; i < header.RecordCount; i++)
+            {
+                const BlockEntry& block = blocks[i];
+                if (block.Offset < tableEnd || block.Offset > fileSize || block.Size > fileSize - block.Offset)
+                    return false;
+
+                if (block.EventCount > EventsPerBlock)
+                    return false;
+            }
+
+            return true;
+        }
+
+        bool ValidateHeader(const LegacyFileHeader& header, size_t fileSize)
+        {
+            return header.Version == LegacyVersion &&
+                ValidateLayout(header, fileSize, header.EventCount, sizeof(LegacyEventRecord));
+        }
+
+        uint64_t GetReadableRecordCount(const FileHeader& header, size_t fileSize)
+        {
+            if (header.Flags & FlagIncomplete)
+                return (fileSize - header.EventsOffset) / header.RecordSize;
+
+            return header.RecordCount;
+        }
+
+        uint64_t GetReadableRecordCount(const LegacyFileHeader& header, size_t fileSize)
+        {
+            if (header.Flags & FlagIncomplete)
+                return (fileSize - header.EventsOffset) / header.RecordSize;
+
+            return header.EventCount;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "Recording.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace KeyActions
+{
+    // Binary layout of a .rec file:
+    //
+    //   [RecordingFileHeader][name bytes][padding to 16][EventRecord * RecordCount]
+    //
+    // All fields are little-endian. Event records are fixed size and aligned so the
+    // event section of a memory-mapped file can be read in place.
+    //
+    // Timestamps are delta-encoded: each record stores the nanoseconds since the
+    // previous record. A gap that does not fit in 32 bits (about 4.3 seconds) is
+    // written as a separate RecordTimeGap record ahead of the event.
+    //
+    // Compressed files share the header, but the records at EventsOffset are a table
+    // of BlockEntry records, each pointing at a block of up to EventsPerBlock events
+    // encoded by EventCodec:
+    //
+    //   [RecordingFileHeader][name bytes][padding to 16][BlockEntry * RecordCount][blocks]
+    //
+    // A RecordingStore keeps one manifest per recording instead, with the same header under
+    // ManifestMagic. Its records list the chunks that make up the events, in order; each chunk
+    // is an EventCodec block kept in its own file under the store and named by its hash:
+    //
+    //   [RecordingFileHeader][name bytes][padding to 16][ChunkEntry * RecordCount]
+    namespace RecordingFormat
+    {
+        inline constexpr uint32_t Magic = 0x4345524B; // "KREC"
+        inline constexpr uint16_t Version = 2;
+        inline constexpr uint16_t LegacyVersion = 1;  // Float seconds, migrated on load
+        inline constexpr uint16_t CompressedVersion = 3;
+        inline constexpr uint32_t EventsPerBlock = 16384;
+        inline constexpr size_t EventAlignment = 16;
+
+        inline constexpr uint32_t ManifestMagic = 0x4E414D4B; // "KMAN"
+        inline constexpr uint16_t ManifestVersion = 2;    // 1 keyed chunks by a 64-bit hash
+
+        enum HeaderFlags : uint32_t
+        {
+            FlagRecordsMouse = 1 << 0,
+            FlagIncomplete = 1 << 1     // Still being streamed; RecordCount is not final
+        };
+
+        // Action value of a record that only advances the clock
+        inline constexpr uint8_t RecordTimeGap = 0xFF;
+
+        struct FileHeader
+        {
+            uint32_t Magic = RecordingFormat::Magic;
+            uint16_t Version = RecordingFormat::Version;
+            uint16_t HeaderSize = sizeof(FileHeader);
+            uint32_t Flags = 0;
+            uint32_t NameLength = 0;
+            uint64_t RecordCount = 0;
+            uint64_t EventsOffset = 0;
+            int64_t Duration = 0;
+            uint32_t RecordSize = 0;
+            uint32_t Reserved = 0;
+        };
+
+        // One packed event. The meaning of Code, A and B depends on Action:
+        //   Key events:    Code = KeyCode, Modifiers = ModifierFlag bits
+        //   Mouse buttons: Code = MouseCode, A/B = X/Y
+        //   Mouse moves:   A/B = X/Y
+        //   Mouse scrolls: A/B = DX/DY
+        //   Time gaps:     A/B = low/high 32 bits of the signed gap
+        struct EventRecord
+        {
+            uint32_t TimeDelta;
+            uint8_t Action;
+            uint8_t Modifiers;
+            int16_t Code;
+            int32_t A;
+            int32_t B;
+        };
+
+        // One block of a compressed file. Blocks decode independently, so a reader can
+        // seek by FirstTimestamp and decode only the blocks it needs.
+        struct BlockEntry
+        {
+            uint64_t Offset;        // From the start of the file
+            int64_t FirstTimestamp;
+            uint32_t Size;          // Encoded bytes
+            uint32_t EventCount;
+        };
+
+        // First 128 bits of the SHA-256 of an encoded chunk, the chunk's address in a store
+        struct ChunkHash
+        {
+            uint64_t High = 0;
+            uint64_t Low = 0;
+
+            bool operator==(const ChunkHash& other) const = default;
+        };
+
+        // One chunk of a store manifest. The chunk's bytes are shared by every manifest that
+        // lists the same hash, so its timestamps are relative and FirstTimestamp lives here.
+        struct ChunkEntry
+        {
+            ChunkHash Hash;
+            int64_t FirstTimestamp;
+            uint32_t Size;          // Encoded bytes
+            uint32_t EventCount;
+        };
+
+        // Version 1 layout, kept so older recordings can still be read
+        struct LegacyFileHeader
+        {
+            uint32_t Magic;
+            uint16_t Version;
+            uint16_t HeaderSize;
+            uint32_t Flags;
+            uint32_t NameLength;
+            uint64_t EventCount;
+            uint64_t EventsOffset;
+            float TotalDuration;
+            uint32_t RecordSize;
+        };
+
+        struct LegacyEventRecord
+        {
+            float Time;
+            uint8_t Action;
+            uint8_t Modifiers;
+            int16_t Code;
+            int32_t A;
+            int32_t B;
+        };
+
+        static_assert(sizeof(FileHeader) == 48, "FileHeader layout changed");
+        static_assert(sizeof(EventRecord) == 16, "EventRecord layout changed");
+        static_assert(sizeof(BlockEntry) == 24, "BlockEntry layout changed");
+        static_assert(sizeof(ChunkEntry) == 32, "ChunkEntry layout changed");
+        static_assert(sizeof(LegacyFileHeader) == 40, "LegacyFileHeader layout changed");
+        static_assert(sizeof(LegacyEventRecord) == 16, "LegacyEventRecord layout changed");
+
+        inline constexpr uint64_t AlignEventsOffset(uint64_t offset)
+        {
+            return (offset + EventAlignment - 1) & ~(uint64_t)(EventAlignment - 1);
+        }
+
+        inline constexpr uint64_t GetEventsOffset(uint32_t nameLength)
+        {
+            return AlignEventsOffset(sizeof(FileHeader) + nameLength);
+        }
+
+        // Turns absolute timestamps into delta records. Keeps state between calls so a
+        // recording can be encoded in chunks.
+        class EventEncoder
+        {
+        public:
+            void Encode(const EventView& event, std::vector<EventRecord>& records);
+
+        private:
+            int64_t m_PreviousTimestamp = 0;
+        };
+
+        // Inverse of EventEncoder
+        class EventDecoder
+        {
+        public:
+            // Returns false for records that only advance the clock
+            bool Decode(const EventRecord& record, RecordedEvent& event);
+
+            int64_t GetTimestamp() const { return m_Timestamp; }
+
+        private:
+            int64_t m_Timestamp = 0;
+        };
+
+        RecordedEvent UnpackLegacyEvent(const LegacyEventRecord& record);
+
+        // Returns the format version of a file, or 0 if it is not a recording
+        uint16_t ReadVersion(const uint8_t* data, size_t size);
+
+        // Returns true if the header describes a file this build can read
+        bool ValidateHeader(const FileHeader& header, size_t fileSize);
+        bool ValidateCompressedHeader(const FileHeader& header, size_t fileSize);
+        bool ValidateManifestHeader(const FileHeader& header, size_t fileSize);
+
+        // Checks that every block lies after the table and inside the file
+        bool ValidateBlocks(const FileHeader& header, const BlockEntry* blocks, size_t fileSize);
+        bool ValidateHeader(const LegacyFileHeader& header, size_t fileSize);
+
+        // Number of records that can be read; for incomplete files this is every whole record on disk
+        uint64_t GetReadableRecordCount(const FileHeader& header, size_t fileSize);
+        uint64_t GetReadableRecordCount(const LegacyFileHeader& header, size_t fileSize);
+    }
+}
\ No newline at end of file
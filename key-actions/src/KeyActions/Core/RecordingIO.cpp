@@ -0,0 +1,293 @@
+#include "RecordingIO.h"
+
+#include "Serialization.h"
+
+#include "Lumina/Core/Log.h"
+
+#include <algorithm>
+
+namespace KeyActions
+{
+    RecordingIO::RecordingIO()
+    {
+        m_Thread = std::thread(&RecordingIO::WorkerThread, this);
+    }
+
+    RecordingIO::~RecordingIO()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            // Queued saves still run so nothing recorded is lost on shutdown
+            std::erase_if(m_Queue, [](const RequestPtr& request) { return request->Kind != RequestKind::Save; });
+
+            if (m_Running && m_Running->Kind != RequestKind::Save)
+                m_Running->CancelRequested = true;
+
+            m_StopRequested = true;
+        }
+
+        m_QueueCondition.notify_one();
+
+        if (m_Thread.joinable())
+        {
+            m_Thread.join();
+        }
+    }
+
+    IORequestId RecordingIO::Load(const std::filesystem::path& filePath, LoadCallback callback)
+    {
+        auto request = std::make_shared<Request>();
+        request->Kind = RequestKind::Load;
+        request->Path = filePath;
+        request->OnLoaded = std::move(callback);
+        return Submit(std::move(request));
+    }
+
+    IORequestId RecordingIO::Save(RecordingSnapshot recording, const std::filesystem::path& recordingsFolder, SaveCallback callback)
+    {
+        if (!recording)
+            return InvalidIORequest;
+
+        auto request = std::make_shared<Request>();
+        request->Kind = RequestKind::Save;
+        request->Path = recordingsFolder;
+        request->Recording = std::move(recording);
+        request->OnSaved = std::move(callback);
+        return Submit(std::move(request));
+    }
+
+    IORequestId RecordingIO::List(const std::filesystem::path& recordingsFolder, ListCallback callback)
+    {
+        auto request = std::make_shared<Request>();
+        request->Kind = RequestKind::List;
+        request->Path = recordingsFolder;
+        request->OnListed = std::move(callback);
+        return Submit(std::move(request));
+    }
+
+    IORequestId RecordingIO::Submit(RequestPtr request)
+    {
+        IORequestId id;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            id = m_NextId++;
+            request->Id = id;
+            m_Queue.push_back(std::move(request));
+        }
+
+        m_QueueCondition.notify_one();
+        return id;
+    }
+
+    bool RecordingIO::Cancel(IORequestId id)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto queued = std::find_if(m_Queue.begin(), m_Queue.end(),
+            [id](const RequestPtr& request) { return request->Id == id; });
+
+        if (queued != m_Queue.end())
+        {
+            RequestPtr request = std::move(*queued);
+            m_Queue.erase(queued);
+
+            request->Status = IOStatus::Cancelled;
+            request->Progress = 1.0f;
+            m_Completed.push_back(std::move(request));
+            m_DoneCondition.notify_all();
+            return true;
+        }
+
+        if (m_Running && m_Running->Id == id)
+        {
+            m_Running->CancelRequested = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    void RecordingIO::CancelAll()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (RequestPtr& request : m_Queue)
+        {
+            request->Status = IOStatus::Cancelled;
+            request->Progress = 1.0f;
+            m_Completed.push_back(std::move(request));
+        }
+        m_Queue.clear();
+
+        if (m_Running)
+            m_Running->CancelRequested = true;
+
+        m_DoneCondition.notify_all();
+    }
+
+    size_t RecordingIO::Update()
+    {
+        std::vector<RequestPtr> completed;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            completed.swap(m_Completed);
+        }
+
+        // Callbacks run without the lock so they can submit new requests
+        for (const RequestPtr& request : completed)
+        {
+            switch (request->Kind)
+            {
+            case RequestKind::Load:
+                if (request->OnLoaded)
+                    request->OnLoaded(request->Status, std::move(request->Recording));
+                break;
+            case RequestKind::Save:
+                if (request->OnSaved)
+                    request->OnSaved(request->Status);
+                break;
+            case RequestKind::List:
+                if (request->OnListed)
+                    request->OnListed(request->Status, std::move(request->Recordings));
+                break;
+            }
+        }
+
+        return completed.size();
+    }
+
+    float RecordingIO::GetProgress(IORequestId id) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        RequestPtr request = FindRunningOrQueued(id);
+        return request ? request->Progress.load() : 1.0f;
+    }
+
+    bool RecordingIO::IsPending(IORequestId id) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (FindRunningOrQueued(id))
+            return true;
+
+        return std::any_of(m_Completed.begin(), m_Completed.end(),
+            [id](const RequestPtr& request) { return request->Id == id; });
+    }
+
+    bool RecordingIO::IsBusy() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Running || !m_Queue.empty();
+    }
+
+    void RecordingIO::Wait(IORequestId id)
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_DoneCondition.wait(lock, [this, id]() { return !FindRunningOrQueued(id); });
+    }
+
+    RecordingIO::RequestPtr RecordingIO::FindRunningOrQueued(IORequestId id) const
+    {
+        if (m_Running && m_Running->Id == id)
+            return m_Running;
+
+        for (const RequestPtr& request : m_Queue)
+        {
+            if (request->Id == id)
+                return request;
+        }
+
+        return nullptr;
+    }
+
+    void RecordingIO::WorkerThread()
+    {
+        while (true)
+        {
+            RequestPtr request;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_QueueCondition.wait(lock, [this]() { return !m_Queue.empty() || m_StopRequested; });
+
+                if (m_Queue.empty())
+                    break;
+
+                request = std::move(m_Queue.front());
+                m_Queue.pop_front();
+                m_Running = request;
+            }
+
+            request->Status = Run(*request);
+            request->Progress = 1.0f;
+
+            Complete(std::move(request));
+        }
+    }
+
+    IOStatus RecordingIO::Run(Request& request)
+    {
+        switch (request.Kind)
+        {
+        case RequestKind::Load:
+        {
+            auto progress = [&request](float fraction) {
+                request.Progress = fraction;
+                return !request.CancelRequested.load();
+            };
+
+            Recording recording;
+            if (!Serialization::LoadRecording(recording, std::filesystem::absolute(request.Path).string(), progress))
+                return request.CancelRequested ? IOStatus::Cancelled : IOStatus::Failed;
+
+            request.Recording = std::make_shared<const Recording>(std::move(recording));
+            return IOStatus::Completed;
+        }
+        case RequestKind::Save:
+        {
+            // Saves go through a temporary file, so cancelling one keeps the previous version
+            auto progress = [&request](float fraction) {
+                request.Progress = fraction;
+                return !request.CancelRequested.load();
+            };
+
+            if (!Serialization::SaveRecordingTo(*request.Recording, request.Path, progress))
+                return request.CancelRequested ? IOStatus::Cancelled : IOStatus::Failed;
+
+            return IOStatus::Completed;
+        }
+        case RequestKind::List:
+        {
+            if (request.CancelRequested)
+                return IOStatus::Cancelled;
+
+            RecordingLibrary library(request.Path);
+            library.Refresh();
+            request.Recordings = library.GetRecordings();
+            return IOStatus::Completed;
+        }
+        }
+
+        return IOStatus::Failed;
+    }
+
+    void RecordingIO::Complete(RequestPtr request)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running.reset();
+
+            // Results are only handed back through the callback
+            if (request->Kind == RequestKind::Save)
+                request->Recording.reset();
+
+            m_Completed.push_back(std::move(request));
+        }
+
+        m_DoneCondition.notify_all();
+    }
+}
\ No newline at end of file
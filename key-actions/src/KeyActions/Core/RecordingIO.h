@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Recording.h"
+#include "RecordingLibrary.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace KeyActions
+{
+    using IORequestId = uint64_t;
+    inline constexpr IORequestId InvalidIORequest = 0;
+
+    enum class IOStatus
+    {
+        Completed,
+        Failed,
+        Cancelled
+    };
+
+    // Runs recording loads, saves and folder listings on a background thread so large files
+    // never stall the UI. Requests run one at a time in submission order. Completion callbacks
+    // are queued and only run from Update(), on whichever thread calls it, so they can touch
+    // UI state freely.
+    class RecordingIO
+    {
+    public:
+        using LoadCallback = std::function<void(IOStatus status, RecordingSnapshot recording)>;
+        using SaveCallback = std::function<void(IOStatus status)>;
+        using ListCallback = std::function<void(IOStatus status, std::vector<RecordingInfo> recordings)>;
+
+        RecordingIO();
+
+        // Finishes queued and running saves; pending loads and listings are dropped without their callbacks
+        ~RecordingIO();
+
+        RecordingIO(const RecordingIO&) = delete;
+        RecordingIO& operator=(const RecordingIO&) = delete;
+
+        // Paths are resolved by the caller, so the worker never reads Settings
+        IORequestId Load(const std::filesystem::path& filePath, LoadCallback callback);
+        IORequestId Save(RecordingSnapshot recording, const std::filesystem::path& recordingsFolder, SaveCallback callback = {});
+        IORequestId List(const std::filesystem::path& recordingsFolder, ListCallback callback);
+
+        // Queued requests are dropped; a running load or save stops at its next progress report.
+        // A cancelled save leaves any existing file as it was. The callback still runs, with
+        // IOStatus::Cancelled. Returns false if the request is done.
+        bool Cancel(IORequestId id);
+        void CancelAll();
+
+        // Runs callbacks of finished requests; returns how many ran
+        size_t Update();
+
+        // 0 while queued, the fraction done while running, 1 once finished
+        float GetProgress(IORequestId id) const;
+
+        // True until the request's callback has run
+        bool IsPending(IORequestId id) const;
+        bool IsBusy() const;
+
+        // Blocks until the request has finished running; its callback still waits for Update()
+        void Wait(IORequestId id);
+
+    private:
+        enum class RequestKind
+        {
+            Load,
+            Save,
+            List
+        };
+
+        struct Request
+        {
+            IORequestId Id = InvalidIORequest;
+            RequestKind Kind = RequestKind::Load;
+            std::filesystem::path Path;
+
+            RecordingSnapshot Recording;    // To save, or the loaded result
+            std::vector<RecordingInfo> Recordings;
+
+            LoadCallback OnLoaded;
+            SaveCallback OnSaved;
+            ListCallback OnListed;
+
+            std::atomic<float> Progress{ 0.0f };
+            std::atomic<bool> CancelRequested{ false };
+            IOStatus Status = IOStatus::Completed;
+        };
+
+        using RequestPtr = std::shared_ptr<Request>;
+
+        IORequestId Submit(RequestPtr request);
+        void WorkerThread();
+        IOStatus Run(Request& request);
+        void Complete(RequestPtr request);
+
+        // Callers hold m_Mutex
+        RequestPtr FindRunningOrQueued(IORequestId id) const;
+
+    private:
+        std::thread m_Thread;
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_QueueCondition;
+        std::condition_variable m_DoneCondition;
+
+        std::deque<RequestPtr> m_Queue;
+        RequestPtr m_Running;
+        std::vector<RequestPtr> m_Completed;
+        bool m_StopRequested = false;
+
+        IORequestId m_NextId = 1;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "RecordingIndex.h"
+
+#include <algorithm>
+
+namespace KeyActions
+{
+    void HeldInputState::Apply(const EventView& event)
+    {
+        Apply(InputCommand::FromEvent(event));
+    }
+
+    void HeldInputState::Apply(const InputCommand& command)
+    {
+        switch (command.Action)
+        {
+        case RecordedAction::KeyPressed:
+        case RecordedAction::KeyReleased:
+            if (command.Code >= 0 && command.Code < MaxKeyCode)
+                Keys[command.Code] = command.Action == RecordedAction::KeyPressed;
+            break;
+
+        case RecordedAction::MousePressed:
+        case RecordedAction::MouseReleased:
+            if (command.Code >= 0 && command.Code < MaxMouseCode)
+                Buttons[command.Code] = command.Action == RecordedAction::MousePressed;
+            MouseX = command.A;
+            MouseY = command.B;
+            break;
+
+        case RecordedAction::MouseMoved:
+            MouseX = command.A;
+            MouseY = command.B;
+            break;
+
+        case RecordedAction::MouseScrolled:
+            break;
+        }
+    }
+
+    void HeldInputState::AddTransition(const HeldInputState& target, InputBatch& batch) const
+    {
+        // Release first so a seek never has more keys down than either end
+        for (int code = 0; code < MaxKeyCode; code++)
+        {
+            if (Keys[code] && !target.Keys[code])
+                batch.Add(InputCommand{ RecordedAction::KeyReleased, code });
+        }
+
+        for (int code = 0; code < MaxMouseCode; code++)
+        {
+            if (Buttons[code] && !target.Buttons[code])
+                batch.Add(InputCommand{ RecordedAction::MouseReleased, code, MouseX, MouseY });
+        }
+
+        for (int code = 0; code < MaxKeyCode; code++)
+        {
+            if (!Keys[code] && target.Keys[code])
+                batch.Add(InputCommand{ RecordedAction::KeyPressed, code });
+        }
+
+        for (int code = 0; code < MaxMouseCode; code++)
+        {
+            if (!Buttons[code] && target.Buttons[code])
+                batch.Add(InputCommand{ RecordedAction::MousePressed, code, target.MouseX, target.MouseY });
+        }
+    }
+
+    void RecordingIndex::Build(const EventStore& events)
+    {
+        m_Events = &events;
+        m_Checkpoints.clear();
+        m_Checkpoints.reserve(events.Size() / CheckpointInterval + 1);
+
+        HeldInputState state;
+        for (size_t i = 0; i < events.Size(); i++)
+        {
+            if (i % CheckpointInterval == 0)
+                m_Checkpoints.push_back(state);
+
+            state.Apply(events[i]);
+        }
+    }
+
+    size_t RecordingIndex::FindEvent(int64_t time) const
+    {
+        if (!m_Events)
+            return 0;
+
+        const auto& timestamps = m_Events->GetTimestamps();
+        return static_cast<size_t>(std::lower_bound(timestamps.begin(), timestamps.end(), time) - timestamps.begin());
+    }
+
+    HeldInputState RecordingIndex::GetStateAt(size_t index) const
+    {
+        if (!m_Events || m_Checkpoints.empty())
+            return HeldInputState();
+
+        index = std::min(index, m_Events->Size());
+
+        size_t checkpoint = std::min(index / CheckpointInterval, m_Checkpoints.size() - 1);
+        HeldInputState state = m_Checkpoints[checkpoint];
+
+        for (size_t i = checkpoint * CheckpointInterval; i < index; i++)
+            state.Apply((*m_Events)[i]);
+
+        return state;
+    }
+}
\ No newline at end of file
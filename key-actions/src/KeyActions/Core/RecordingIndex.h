@@ -0,0 +1,58 @@
+#pragma once
+
+#include "EventStore.h"
+#include "InputBatch.h"
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace KeyActions
+{
+    // Which keys and mouse buttons are down at some point in a recording
+    struct HeldInputState
+    {
+        static constexpr int MaxKeyCode = 512;
+        static constexpr int MaxMouseCode = 8;
+
+        std::bitset<MaxKeyCode> Keys;
+        std::bitset<MaxMouseCode> Buttons;
+        int MouseX = 0;     // Last known cursor position, used to press or release buttons
+        int MouseY = 0;
+
+        void Apply(const EventView& event);
+        void Apply(const InputCommand& command);
+
+        bool IsEmpty() const { return Keys.none() && Buttons.none(); }
+
+        // Adds the releases and presses that take this state to the target state
+        void AddTransition(const HeldInputState& target, InputBatch& batch) const;
+    };
+
+    // Seek index over an immutable EventStore. Events are found by binary search on the
+    // timestamp column; held input is checkpointed every CheckpointInterval events, so
+    // the state at any event replays at most that many events.
+    class RecordingIndex
+    {
+    public:
+        static constexpr size_t CheckpointInterval = 1024;
+
+        RecordingIndex() = default;
+        explicit RecordingIndex(const EventStore& events) { Build(events); }
+
+        void Build(const EventStore& events);
+
+        // First event at or after the time (recording nanoseconds); Size() if none
+        size_t FindEvent(int64_t time) const;
+
+        // Held input just before the event at index plays
+        HeldInputState GetStateAt(size_t index) const;
+
+        size_t GetCheckpointCount() const { return m_Checkpoints.size(); }
+
+    private:
+        const EventStore* m_Events = nullptr;
+        std::vector<HeldInputState> m_Checkpoints; // [k] is the state before event k * CheckpointInterval
+    };
+}
\ No newline at end of file
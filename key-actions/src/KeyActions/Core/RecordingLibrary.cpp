@@ -0,0 +1,402 @@
+#include "RecordingLibrary.h"
+
+#include "Lumina/Core/Log.h"
+
+#include "AtomicFile.h"
+#include "MappedFile.h"
+#include "RecordingFormat.h"
+#include "Serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <json.hpp>
+
+using json = nlohmann::json;
+
+namespace KeyActions
+{
+    namespace
+    {
+        constexpr const char* IndexFileName = ".library.json";
+        constexpr int IndexVersion = 1;
+
+        int64_t ToTicks(std::filesystem::file_time_type time)
+        {
+            return static_cast<int64_t>(time.time_since_epoch().count());
+        }
+
+        bool ReadFileStatus(const std::filesystem::path& filePath, RecordingInfo& info)
+        {
+            std::error_code errorCode;
+            info.FileSize = std::filesystem::file_size(filePath, errorCode);
+            if (errorCode)
+                return false;
+
+            info.ModifiedTime = ToTicks(std::filesystem::last_write_time(filePath, errorCode));
+            return !errorCode;
+        }
+    }
+
+    RecordingLibrary::RecordingLibrary(std::filesystem::path folder) : m_Folder(std::move(folder)) {}
+
+    std::filesystem::path RecordingLibrary::GetIndexPath() const
+    {
+        return m_Folder / IndexFileName;
+    }
+
+    bool RecordingLibrary::Load()
+    {
+        m_Recordings.clear();
+        m_Modified = false;
+
+        std::filesystem::path indexPath = GetIndexPath();
+
+        std::error_code errorCode;
+        if (!std::filesystem::exists(indexPath, errorCode))
+            return false;
+
+        try
+        {
+            std::ifstream file(indexPath);
+            if (!file.is_open())
+                return false;
+
+            json j = json::parse(file);
+            if (j.value("version", 0) != IndexVersion)
+                return false;
+
+            for (const auto& entry : j["recordings"])
+            {
+                RecordingInfo info;
+                info.Name = entry["name"].get<std::string>();
+                info.FileSize = entry["size"].get<uint64_t>();
+                info.ModifiedTime = entry["modified"].get<int64_t>();
+                info.Duration = entry["duration"].get<int64_t>();
+                info.EventCount = entry["events"].get<uint64_t>();
+                info.RecordsMouse = entry["recordsMouse"].get<bool>();
+                info.Hash = entry["hash"].get<uint64_t>();
+                m_Recordings.push_back(std::move(info));
+            }
+
+            std::sort(m_Recordings.begin(), m_Recordings.end(),
+                [](const RecordingInfo& a, const RecordingInfo& b) { return a.Name < b.Name; });
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            // The index is only a cache; the next Refresh() rebuilds it
+            LUMINA_LOG_WARN("Ignoring unreadable recording index {}: {}", indexPath.string(), e.what());
+            m_Recordings.clear();
+            return false;
+        }
+    }
+
+    bool RecordingLibrary::Save()
+    {
+        std::filesystem::path indexPath = GetIndexPath();
+
+        try
+        {
+            json recordings = json::array();
+            for (const auto& info : m_Recordings)
+            {
+                json entry;
+                entry["name"] = info.Name;
+                entry["size"] = info.FileSize;
+                entry["modified"] = info.ModifiedTime;
+                entry["duration"] = info.Duration;
+                entry["events"] = info.EventCount;
+                entry["recordsMouse"] = info.RecordsMouse;
+                entry["hash"] = info.Hash;
+                recordings.push_back(std::move(entry));
+            }
+
+            json j;
+            j["version"] = IndexVersion;
+            j["recordings"] = std::move(recordings);
+
+            std::string text = j.dump();
+
+            AtomicFile file;
+            if (!file.Open(indexPath))
+            {
+                LUMINA_LOG_ERROR("Failed to open recording index for writing: {}", indexPath.string());
+                return false;
+            }
+
+            file.Write(text.data(), text.size());
+
+            if (!file.Commit())
+            {
+                LUMINA_LOG_ERROR("Failed to write recording index: {}", indexPath.string());
+                return false;
+            }
+
+            m_Modified = false;
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            LUMINA_LOG_ERROR("Failed to save recording index: {}", e.what());
+            return false;
+        }
+    }
+
+    size_t RecordingLibrary::Refresh(TaskPool* pool)
+    {
+        Load();
+
+        std::error_code errorCode;
+        if (!std::filesystem::exists(m_Folder, errorCode))
+        {
+            LUMINA_LOG_WARN("Recordings folder does not exist: {}", m_Folder.string());
+            m_Recordings.clear();
+            return 0;
+        }
+
+        std::vector<RecordingInfo> scanned;
+        scanned.reserve(m_Recordings.size());
+        size_t reread = 0;
+
+        std::vector<RecordingInfo> stale;
+        std::vector<std::filesystem::path> stalePaths;
+
+        for (const auto& entry : std::filesystem::directory_iterator(m_Folder, errorCode))
+        {
+            std::error_code entryError;
+            if (!entry.is_regular_file(entryError) || entry.path().extension() != ".rec")
+                continue;
+
+            RecordingInfo info;
+            info.Name = entry.path().stem().string();
+            info.FileSize = entry.file_size(entryError);
+            info.ModifiedTime = ToTicks(entry.last_write_time(entryError));
+
+            const RecordingInfo* cached = Find(info.Name);
+            if (cached && cached->FileSize == info.FileSize && cached->ModifiedTime == info.ModifiedTime)
+            {
+                scanned.push_back(*cached);
+                continue;
+            }
+
+            stalePaths.push_back(entry.path());
+            stale.push_back(std::move(info));
+        }
+
+        if (errorCode)
+            LUMINA_LOG_ERROR("Error reading recordings directory: {}", errorCode.message());
+
+        // Changed files are independent, so a pool reads them in parallel
+        std::vector<uint8_t> read(stale.size(), 0);
+        auto readInfo = [&](size_t i) { read[i] = ReadInfo(stalePaths[i], stale[i]); };
+
+        if (pool)
+        {
+            pool->ParallelFor(stale.size(), readInfo);
+        }
+        else
+        {
+            for (size_t i = 0; i < stale.size(); i++)
+                readInfo(i);
+        }
+
+        for (size_t i = 0; i < stale.size(); i++)
+        {
+            if (!read[i])
+                continue;
+
+            scanned.push_back(std::move(stale[i]));
+            reread++;
+        }
+
+        std::sort(scanned.begin(), scanned.end(),
+            [](const RecordingInfo& a, const RecordingInfo& b) { return a.Name < b.Name; });
+
+        if (reread > 0 || scanned.size() != m_Recordings.size())
+            m_Modified = true;
+
+        m_Recordings = std::move(scanned);
+
+        if (m_Modified)
+            Save();
+
+        return reread;
+    }
+
+    bool RecordingLibrary::Update(const std::filesystem::path& filePath)
+    {
+        RecordingInfo info;
+        if (!ReadFileStatus(filePath, info) || !ReadInfo(filePath, info))
+            return false;
+
+        Store(std::move(info));
+        return true;
+    }
+
+    bool RecordingLibrary::Remove(const std::string& name)
+    {
+        auto it = LowerBound(name);
+        if (it == m_Recordings.end() || it->Name != name)
+            return false;
+
+        m_Recordings.erase(it);
+        m_Modified = true;
+        return true;
+    }
+
+    const RecordingInfo* RecordingLibrary::Find(const std::string& name) const
+    {
+        auto it = const_cast<RecordingLibrary*>(this)->LowerBound(name);
+        if (it == m_Recordings.end() || it->Name != name)
+            return nullptr;
+
+        return &*it;
+    }
+
+    std::vector<RecordingInfo>::iterator RecordingLibrary::LowerBound(const std::string& name)
+    {
+        return std::lower_bound(m_Recordings.begin(), m_Recordings.end(), name,
+            [](const RecordingInfo& info, const std::string& value) { return info.Name < value; });
+    }
+
+    void RecordingLibrary::Store(RecordingInfo info)
+    {
+        auto it = LowerBound(info.Name);
+        if (it != m_Recordings.end() && it->Name == info.Name)
+            *it = std::move(info);
+        else
+            m_Recordings.insert(it, std::move(info));
+
+        m_Modified = true;
+    }
+
+    bool RecordingLibrary::ReadInfo(const std::filesystem::path& filePath, RecordingInfo& info)
+    {
+        using namespace RecordingFormat;
+
+        MappedFile mapping;
+        if (!mapping.Open(filePath))
+        {
+            LUMINA_LOG_ERROR("Failed to open recording file: {}", filePath.string());
+            return false;
+        }
+
+        const uint8_t* data = mapping.GetData();
+        size_t size = mapping.GetSize();
+
+        info.Name = filePath.stem().string();
+        info.Hash = HashBytes(data, size);
+
+        uint16_t version = ReadVersion(data, size);
+        if (version == Version)
+        {
+            FileHeader header;
+            if (size >= sizeof(FileHeader))
+                std::memcpy(&header, data, sizeof(FileHeader));
+
+            if (size < sizeof(FileHeader) || !ValidateHeader(header, size))
+            {
+                LUMINA_LOG_ERROR("Invalid or unsupported recording file: {}", filePath.string());
+                return false;
+            }
+
+            // Unfinished streams need their events decoded to find the duration
+            if ((header.Flags & FlagIncomplete) == 0)
+            {
+                const auto* records = reinterpret_cast<const EventRecord*>(data + header.EventsOffset);
+                uint64_t recordCount = GetReadableRecordCount(header, size);
+
+                info.EventCount = 0;
+                for (uint64_t i = 0; i < recordCount; i++)
+                {
+                    if (records[i].Action != RecordTimeGap)
+                        info.EventCount++;
+                }
+
+                info.Duration = header.Duration;
+                info.RecordsMouse = (header.Flags & FlagRecordsMouse) != 0;
+                return true;
+            }
+        }
+        else if (version == CompressedVersion)
+        {
+            FileHeader header;
+            if (size >= sizeof(FileHeader))
+                std::memcpy(&header, data, sizeof(FileHeader));
+
+            if (size < sizeof(FileHeader) || !ValidateCompressedHeader(header, size))
+            {
+                LUMINA_LOG_ERROR("Invalid or unsupported recording file: {}", filePath.string());
+                return false;
+            }
+
+            // The block table has every count, so no block needs decoding
+            const auto* blocks = reinterpret_cast<const BlockEntry*>(data + header.EventsOffset);
+
+            info.EventCount = 0;
+            for (uint64_t i = 0; i < header.RecordCount; i++)
+                info.EventCount += blocks[i].EventCount;
+
+            info.Duration = header.Duration;
+            info.RecordsMouse = (header.Flags & FlagRecordsMouse) != 0;
+            return true;
+        }
+        else if (version == LegacyVersion)
+        {
+            LegacyFileHeader header = {};
+            if (size >= sizeof(LegacyFileHeader))
+                std::memcpy(&header, data, sizeof(LegacyFileHeader));
+
+            if (size < sizeof(LegacyFileHeader) || !ValidateHeader(header, size))
+            {
+                LUMINA_LOG_ERROR("Invalid or unsupported recording file: {}", filePath.string());
+                return false;
+            }
+
+            if ((header.Flags & FlagIncomplete) == 0)
+            {
+                info.EventCount = GetReadableRecordCount(header, size);
+                info.Duration = Clock::FromSeconds(header.TotalDuration);
+                info.RecordsMouse = (header.Flags & FlagRecordsMouse) != 0;
+                return true;
+            }
+        }
+
+        mapping.Close();
+
+        Recording recording;
+        bool loaded = version != 0 ? Serialization::ReadBinary(recording, filePath) : Serialization::ImportJson(recording, filePath);
+        if (!loaded)
+            return false;
+
+        info.EventCount = recording.Events.Size();
+        info.Duration = recording.Duration;
+        info.RecordsMouse = recording.RecordsMouse;
+        return true;
+    }
+
+    uint64_t RecordingLibrary::HashBytes(const uint8_t* data, size_t size)
+    {
+        constexpr uint64_t OffsetBasis = 14695981039346656037ull;
+        constexpr uint64_t Prime = 1099511628211ull;
+
+        // Only used to notice changed files, so speed matters more than distribution
+        uint64_t hash = OffsetBasis;
+        size_t i = 0;
+
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * Prime;
+            hash ^= hash >> 29;
+        }
+
+        for (; i < size; i++)
+            hash = (hash ^ data[i]) * Prime;
+
+        return hash ^ size;
+    }
+}
\ No newline at end of file
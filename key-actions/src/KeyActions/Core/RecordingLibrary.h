@@ -0,0 +1,69 @@
+#pragma once
+
+#include "TaskPool.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace KeyActions
+{
+    // What the recordings list shows about a file, read without loading its events
+    struct RecordingInfo
+    {
+        std::string Name;           // File stem, as passed to Serialization::LoadRecording
+        uint64_t FileSize = 0;
+        int64_t ModifiedTime = 0;   // Ticks of std::filesystem::file_time_type
+        int64_t Duration = 0;       // Nanoseconds
+        uint64_t EventCount = 0;
+        bool RecordsMouse = false;
+        uint64_t Hash = 0;          // Of the file contents, see RecordingLibrary::HashBytes
+    };
+
+    // Cached metadata for every recording in a folder, persisted next to the recordings as
+    // ".library.json". Refresh() only opens files whose size or modification time no longer
+    // match their entry, so listing a folder of thousands of recordings reads one small file.
+    class RecordingLibrary
+    {
+    public:
+        explicit RecordingLibrary(std::filesystem::path folder);
+
+        // Reads the index file; a missing or unreadable index just starts empty
+        bool Load();
+        bool Save();
+
+        // Loads the index, rescans the folder, re-reads changed files, drops entries for
+        // deleted ones and saves the index if anything changed. Returns the number of
+        // files that had to be read. With a pool, changed files are read in parallel.
+        size_t Refresh(TaskPool* pool = nullptr);
+
+        // Re-reads one file, e.g. right after it was saved, without scanning the folder
+        bool Update(const std::filesystem::path& filePath);
+        bool Remove(const std::string& name);
+
+        // Sorted by name
+        const std::vector<RecordingInfo>& GetRecordings() const { return m_Recordings; }
+        const RecordingInfo* Find(const std::string& name) const;
+
+        const std::filesystem::path& GetFolder() const { return m_Folder; }
+        std::filesystem::path GetIndexPath() const;
+        bool IsModified() const { return m_Modified; }
+
+        // Fills everything but FileSize and ModifiedTime. Current binary recordings are read
+        // from their header and records, or block table, in place; legacy JSON files are fully parsed.
+        static bool ReadInfo(const std::filesystem::path& filePath, RecordingInfo& info);
+
+        // 64-bit FNV-1a variant that mixes eight bytes per step
+        static uint64_t HashBytes(const uint8_t* data, size_t size);
+
+    private:
+        std::vector<RecordingInfo>::iterator LowerBound(const std::string& name);
+        void Store(RecordingInfo info);
+
+    private:
+        std::filesystem::path m_Folder;
+        std::vector<RecordingInfo> m_Recordings;
+        bool m_Modified = false;
+    };
+}
\ No newline at end of file
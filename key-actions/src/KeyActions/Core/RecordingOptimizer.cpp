@@ -0,0 +1,184 @@
+#include "RecordingOptimizer.h"
+
+#include "MouseMoveDecimator.h"
+#include "RecordingIndex.h"
+
+namespace KeyActions
+{
+    RecordingOptimizer::RecordingOptimizer(const OptimizerSettings& settings)
+        : m_Settings(settings)
+    {
+    }
+
+    Recording RecordingOptimizer::Optimize(const Recording& recording)
+    {
+        m_Stats = OptimizerStats();
+        m_Stats.EventsBefore = recording.Events.Size();
+        m_Stats.DurationBefore = recording.Duration;
+
+        Recording result(recording.Name, recording.RecordsMouse);
+        EventStore& output = result.Events;
+
+        HeldInputState held;
+        MouseMoveDecimator decimator(m_Settings.MergeMouseMoves ? m_Settings.MouseMoveTolerance : 0.0f);
+
+        int64_t trimmed = 0;        // Idle time removed so far
+        int64_t previousTime = 0;   // Original timestamp of the previous event
+
+        bool hasCursor = false;     // Last cursor position written to the output
+        int cursorX = 0;
+        int cursorY = 0;
+
+        bool hasScroll = false;     // Scroll burst being accumulated
+        RecordedEvent scroll;
+        int64_t lastScrollTime = 0;
+
+        size_t movesIn = 0;
+        size_t movesOut = 0;
+
+        auto emitMove = [&](const MousePoint& point) {
+            if (hasCursor && point.X == cursorX && point.Y == cursorY)
+                return;
+
+            RecordedEvent move;
+            move.Action = RecordedAction::MouseMoved;
+            move.Timestamp = point.Timestamp;
+            move.MouseX = point.X;
+            move.MouseY = point.Y;
+            output.Add(move);
+
+            hasCursor = true;
+            cursorX = point.X;
+            cursorY = point.Y;
+            movesOut++;
+        };
+
+        auto flushMoves = [&]() {
+            MousePoint point;
+            if (decimator.Flush(point))
+                emitMove(point);
+        };
+
+        auto flushScroll = [&]() {
+            if (hasScroll)
+                output.Add(scroll);
+            hasScroll = false;
+        };
+
+        auto trimGap = [&](int64_t time) {
+            int64_t gap = time - previousTime;
+            if (m_Settings.TrimIdleGaps && held.IsEmpty() && gap > m_Settings.MaxIdleGap)
+            {
+                trimmed += gap - m_Settings.MaxIdleGap;
+                m_Stats.IdleGapsTrimmed++;
+            }
+            previousTime = time;
+        };
+
+        for (const EventView& view : recording.Events)
+        {
+            trimGap(view.GetTimestamp());
+
+            RecordedEvent event = view.ToEvent();
+            event.Timestamp -= trimmed;
+
+            switch (event.Action)
+            {
+            case RecordedAction::MouseMoved:
+            {
+                flushScroll();
+                movesIn++;
+
+                MousePoint kept;
+                if (decimator.Add(MousePoint{ event.Timestamp, event.MouseX, event.MouseY }, kept))
+                    emitMove(kept);
+                break;
+            }
+
+            case RecordedAction::MouseScrolled:
+            {
+                flushMoves();
+
+                bool sameDirection = (event.ScrollDX > 0) == (scroll.ScrollDX > 0) && (event.ScrollDX < 0) == (scroll.ScrollDX < 0) &&
+                    (event.ScrollDY > 0) == (scroll.ScrollDY > 0) && (event.ScrollDY < 0) == (scroll.ScrollDY < 0);
+
+                if (m_Settings.CoalesceScrolls && hasScroll && sameDirection &&
+                    event.Timestamp - lastScrollTime <= m_Settings.ScrollBurstWindow)
+                {
+                    scroll.ScrollDX += event.ScrollDX;
+                    scroll.ScrollDY += event.ScrollDY;
+                    m_Stats.ScrollsCoalesced++;
+                }
+                else
+                {
+                    flushScroll();
+                    scroll = event;
+                    hasScroll = true;
+                }
+
+                lastScrollTime = event.Timestamp;
+                break;
+            }
+
+            case RecordedAction::KeyPressed:
+            {
+                int code = static_cast<int>(event.Key);
+                bool isRepeat = code >= 0 && code < HeldInputState::MaxKeyCode && held.Keys[code];
+
+                if (m_Settings.DropKeyRepeats && isRepeat)
+                {
+                    m_Stats.KeyRepeatsDropped++;
+                    break;
+                }
+
+                flushMoves();
+                flushScroll();
+                output.Add(event);
+                break;
+            }
+
+            case RecordedAction::KeyReleased:
+                flushMoves();
+                flushScroll();
+                output.Add(event);
+                break;
+
+            case RecordedAction::MousePressed:
+            case RecordedAction::MouseReleased:
+                flushMoves();
+                flushScroll();
+                output.Add(event);
+
+                hasCursor = true;
+                cursorX = event.MouseX;
+                cursorY = event.MouseY;
+                break;
+            }
+
+            held.Apply(view);
+        }
+
+        flushMoves();
+        flushScroll();
+
+        // The tail after the last event counts as idle too
+        int64_t duration = recording.Duration;
+        if (duration > previousTime)
+        {
+            int64_t gap = duration - previousTime;
+            if (m_Settings.TrimIdleGaps && held.IsEmpty() && gap > m_Settings.MaxIdleGap)
+            {
+                trimmed += gap - m_Settings.MaxIdleGap;
+                m_Stats.IdleGapsTrimmed++;
+            }
+        }
+
+        result.Duration = duration - trimmed;
+
+        m_Stats.MouseMovesMerged = movesIn - movesOut;
+        m_Stats.EventsAfter = output.Size();
+        m_Stats.DurationAfter = result.Duration;
+
+        return result;
+    }
+}
\ No newline at end of file
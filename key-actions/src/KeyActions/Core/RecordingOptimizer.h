@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Recording.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace KeyActions
+{
+    struct OptimizerSettings
+    {
+        // Consecutive mouse moves are simplified to a path within this many pixels of the original
+        bool MergeMouseMoves = true;
+        float MouseMoveTolerance = 1.0f;
+
+        // Scrolls in the same direction less than ScrollBurstWindow apart become one scroll
+        bool CoalesceScrolls = true;
+        int64_t ScrollBurstWindow = 50 * Clock::NanosecondsPerMillisecond;
+
+        // A KeyPressed for a key that is already down is OS auto-repeat
+        bool DropKeyRepeats = true;
+
+        // Gaps longer than MaxIdleGap are shortened to it, but only while nothing is held down
+        bool TrimIdleGaps = true;
+        int64_t MaxIdleGap = 2 * Clock::NanosecondsPerSecond;
+    };
+
+    struct OptimizerStats
+    {
+        size_t EventsBefore = 0;
+        size_t EventsAfter = 0;
+        int64_t DurationBefore = 0;
+        int64_t DurationAfter = 0;
+
+        size_t MouseMovesMerged = 0;
+        size_t ScrollsCoalesced = 0;
+        size_t KeyRepeatsDropped = 0;
+        size_t IdleGapsTrimmed = 0;
+    };
+
+    // Offline pass that rewrites a recording into a smaller one that plays back the same:
+    // redundant mouse moves, scroll bursts and key auto-repeat are folded away and long idle
+    // stretches are shortened. One streaming pass over the events.
+    class RecordingOptimizer
+    {
+    public:
+        explicit RecordingOptimizer(const OptimizerSettings& settings = OptimizerSettings());
+
+        Recording Optimize(const Recording& recording);
+
+        const OptimizerStats& GetStats() const { return m_Stats; }
+        const OptimizerSettings& GetSettings() const { return m_Settings; }
+
+    private:
+        OptimizerSettings m_Settings;
+        OptimizerStats m_Stats;
+    };
+}
\ No newline at end of file
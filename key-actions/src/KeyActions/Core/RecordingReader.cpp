@@ -0,0 +1,231 @@
+#include "RecordingReader.h"
+
+#include "EventCodec.h"
+
+#include "Lumina/Core/Log.h"
+
+#include <algorithm>
+
+namespace KeyActions
+{
+    bool RecordingReader::Open(const std::filesystem::path& path, size_t cacheBlocks)
+    {
+        using namespace RecordingFormat;
+
+        Close();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        std::error_code error;
+        uint64_t fileSize = std::filesystem::file_size(path, error);
+        if (error || fileSize < sizeof(FileHeader))
+            return false;
+
+        // Blocks are read with plain file reads rather than a mapping, so pages of a long
+        // recording that playback has moved past don't stay resident
+        m_File.open(path, std::ios::binary);
+        if (!m_File)
+            return false;
+
+        FileHeader header;
+        m_File.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+        if (!m_File || header.Magic != Magic || header.Version != CompressedVersion)
+        {
+            m_File.close();
+            return false;
+        }
+
+        bool valid = ValidateCompressedHeader(header, fileSize);
+        if (valid)
+        {
+            m_Name.resize(header.NameLength);
+            m_Blocks.resize(header.RecordCount);
+
+            m_File.seekg(header.HeaderSize);
+            m_File.read(m_Name.data(), m_Name.size());
+            m_File.seekg(header.EventsOffset);
+            m_File.read(reinterpret_cast<char*>(m_Blocks.data()), m_Blocks.size() * sizeof(BlockEntry));
+
+            valid = m_File && ValidateBlocks(header, m_Blocks.data(), fileSize);
+        }
+
+        // Events are found by index arithmetic, so only the last block may be short
+        for (size_t i = 0; valid && i < m_Blocks.size(); i++)
+        {
+            bool last = i + 1 == m_Blocks.size();
+            valid = m_Blocks[i].EventCount == EventsPerBlock || (last && m_Blocks[i].EventCount > 0);
+            m_EventCount += m_Blocks[i].EventCount;
+        }
+
+        if (!valid)
+        {
+            LUMINA_LOG_ERROR("Invalid or unsupported recording file: {}", path.string());
+            m_File.close();
+            m_Name.clear();
+            m_Blocks.clear();
+            m_EventCount = 0;
+            return false;
+        }
+
+        m_Duration = header.Duration;
+        m_RecordsMouse = (header.Flags & FlagRecordsMouse) != 0;
+        m_CacheBlocks = std::max<size_t>(1, cacheBlocks);
+        m_BlockStates.assign(1, HeldInputState());
+
+        LUMINA_LOG_INFO("Opened recording: {} ({} events in {} blocks)", path.string(), m_EventCount, m_Blocks.size());
+        return true;
+    }
+
+    void RecordingReader::Close()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_File.is_open())
+            m_File.close();
+
+        m_File.clear();
+        m_Name.clear();
+        m_Duration = 0;
+        m_RecordsMouse = false;
+        m_EventCount = 0;
+        m_Blocks.clear();
+        m_BlockStates.clear();
+        m_Buffer.clear();
+        m_Cache.clear();
+        m_DecodeCount = 0;
+    }
+
+    RecordingReader::Block RecordingReader::GetBlock(size_t block)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return GetBlockLocked(block);
+    }
+
+    RecordingReader::Block RecordingReader::GetBlockLocked(size_t block)
+    {
+        if (block >= m_Blocks.size())
+            return nullptr;
+
+        Block events;
+
+        auto cached = std::find_if(m_Cache.begin(), m_Cache.end(),
+            [block](const auto& entry) { return entry.first == block; });
+
+        if (cached != m_Cache.end())
+        {
+            m_Cache.splice(m_Cache.begin(), m_Cache, cached);
+            events = cached->second;
+        }
+        else
+        {
+            const RecordingFormat::BlockEntry& entry = m_Blocks[block];
+
+            m_Buffer.resize(entry.Size);
+            m_File.clear();
+            m_File.seekg(entry.Offset);
+            m_File.read(reinterpret_cast<char*>(m_Buffer.data()), m_Buffer.size());
+
+            auto decoded = std::make_shared<EventStore>();
+            if (!m_File || !EventCodec::DecodeBlock(m_Buffer.data(), m_Buffer.size(), entry.FirstTimestamp, entry.EventCount, *decoded) ||
+                decoded->Size() != entry.EventCount)
+            {
+                LUMINA_LOG_ERROR("Failed to decode block {} of recording: {}", block, m_Name);
+                return nullptr;
+            }
+
+            m_DecodeCount++;
+            events = std::move(decoded);
+
+            m_Cache.emplace_front(block, events);
+            if (m_Cache.size() > m_CacheBlocks)
+                m_Cache.pop_back();
+        }
+
+        // Playing through in order is enough to learn the state at every boundary
+        if (block + 1 == m_BlockStates.size())
+        {
+            HeldInputState state = m_BlockStates.back();
+            for (size_t i = 0; i < events->Size(); i++)
+                state.Apply((*events)[i]);
+
+            m_BlockStates.push_back(state);
+        }
+
+        return events;
+    }
+
+    bool RecordingReader::ExtendBlockStates(size_t block)
+    {
+        while (m_BlockStates.size() <= block)
+        {
+            if (!GetBlockLocked(m_BlockStates.size() - 1))
+                return false;
+        }
+
+        return true;
+    }
+
+    size_t RecordingReader::FindEvent(int64_t time)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // The event is in the last block starting before the time, or is the first of the next one
+        auto next = std::lower_bound(m_Blocks.begin(), m_Blocks.end(), time,
+            [](const RecordingFormat::BlockEntry& entry, int64_t value) { return entry.FirstTimestamp < value; });
+
+        if (next == m_Blocks.begin())
+            return 0;
+
+        size_t block = static_cast<size_t>(next - m_Blocks.begin()) - 1;
+
+        Block events = GetBlockLocked(block);
+        if (!events)
+            return GetBlockStart(block + 1);
+
+        const auto& timestamps = events->GetTimestamps();
+        size_t offset = static_cast<size_t>(std::lower_bound(timestamps.begin(), timestamps.end(), time) - timestamps.begin());
+        return std::min(GetBlockStart(block) + offset, m_EventCount);
+    }
+
+    HeldInputState RecordingReader::GetStateAt(size_t index)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_Blocks.empty())
+            return HeldInputState();
+
+        index = std::min(index, m_EventCount);
+
+        size_t block = GetBlockIndex(index);
+        if (!ExtendBlockStates(block))
+            return HeldInputState();
+
+        HeldInputState state = m_BlockStates[block];
+
+        size_t offset = index - GetBlockStart(block);
+        if (offset == 0)
+            return state;
+
+        Block events = GetBlockLocked(block);
+        if (!events)
+            return state;
+
+        for (size_t i = 0; i < offset; i++)
+            state.Apply((*events)[i]);
+
+        return state;
+    }
+
+    size_t RecordingReader::GetCachedBlockCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Cache.size();
+    }
+
+    size_t RecordingReader::GetDecodeCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_DecodeCount;
+    }
+}
\ No newline at end of file
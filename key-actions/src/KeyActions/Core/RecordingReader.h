@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Clock.h"
+#include "EventStore.h"
+#include "RecordingFormat.h"
+#include "RecordingIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace KeyActions
+{
+    // Random access to a compressed recording without loading it. Open reads only the
+    // header and block table; a block of events is read and decoded the first time it is
+    // reached and kept in a small least-recently-used cache, so memory use depends on the
+    // cache size rather than the length of the recording.
+    //
+    // Held input at each block boundary is recorded as blocks are decoded in order, so
+    // once playback has passed a block, finding the state anywhere in it replays at most
+    // one block. Blocks are handed out as shared pointers and stay valid after they leave
+    // the cache. All methods may be called from any thread.
+    class RecordingReader
+    {
+    public:
+        using Block = std::shared_ptr<const EventStore>;
+
+        static constexpr size_t DefaultCacheBlocks = 8;
+
+        RecordingReader() = default;
+
+        RecordingReader(const RecordingReader&) = delete;
+        RecordingReader& operator=(const RecordingReader&) = delete;
+
+        // Fails for anything but a complete compressed recording; other files are loaded whole
+        bool Open(const std::filesystem::path& path, size_t cacheBlocks = DefaultCacheBlocks);
+        void Close();
+
+        bool IsOpen() const { return m_File.is_open(); }
+
+        const std::string& GetName() const { return m_Name; }
+        int64_t GetDuration() const { return m_Duration; }
+        double GetDurationSeconds() const { return Clock::ToSeconds(m_Duration); }
+        bool RecordsMouse() const { return m_RecordsMouse; }
+
+        size_t GetEventCount() const { return m_EventCount; }
+        size_t GetBlockCount() const { return m_Blocks.size(); }
+
+        // Every block but the last holds exactly EventsPerBlock events
+        static size_t GetBlockIndex(size_t eventIndex) { return eventIndex / RecordingFormat::EventsPerBlock; }
+        static size_t GetBlockStart(size_t block) { return block * RecordingFormat::EventsPerBlock; }
+
+        // Decoded events of a block, indexed from the block start; null if the block is damaged
+        Block GetBlock(size_t block);
+
+        // First event at or after the time (recording nanoseconds); GetEventCount() if none
+        size_t FindEvent(int64_t time);
+
+        // Held input just before the event at index plays
+        HeldInputState GetStateAt(size_t index);
+
+        size_t GetCachedBlockCount() const;
+        size_t GetDecodeCount() const;      // Blocks decoded since opening, including repeats
+
+    private:
+        Block GetBlockLocked(size_t block);
+
+        // Decodes blocks in order until the state before the block is known
+        bool ExtendBlockStates(size_t block);
+
+        mutable std::mutex m_Mutex;
+        std::ifstream m_File;
+        std::string m_Name;
+        int64_t m_Duration = 0;
+        bool m_RecordsMouse = false;
+        size_t m_EventCount = 0;
+
+        std::vector<RecordingFormat::BlockEntry> m_Blocks;
+        std::vector<HeldInputState> m_BlockStates; // [b] is the state before block b
+        std::vector<uint8_t> m_Buffer;
+
+        std::list<std::pair<size_t, Block>> m_Cache; // Most recently used first
+        size_t m_CacheBlocks = DefaultCacheBlocks;
+        size_t m_DecodeCount = 0;
+    };
+}
\ No newline at end of file
@@ -1,12 +1,25 @@
 #include "RecordingSession.h"
+#include "AtomicFile.h"
+#include "Serialization.h"
 
-#include "Lumina/Core/Application.h"
-#include "Lumina/Core/Input.h"
 #include "Lumina/Core/Log.h"
 
+#ifdef LUMINA_PLATFORM_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#endif
+
 namespace KeyActions
 {
-    RecordingSession::RecordingSession() { }
+    RecordingSession::RecordingSession(size_t captureBufferSize)
+        : m_CaptureRing(captureBufferSize), m_Notifications(captureBufferSize)
+    {
+    }
 
     RecordingSession::~RecordingSession()
     {
@@ -14,6 +27,9 @@ namespace KeyActions
         {
             Stop();
         }
+
+        StopCaptureSource();
+        StopCaptureThread();
     }
 
     bool RecordingSession::Start(const RecordingSettings& settings)
@@ -32,7 +48,32 @@ namespace KeyActions
 
         m_Settings = settings;
 
+        // Anything a hook queued after the last Stop() is stale
+        m_CaptureRing.Drain([](const CapturedInput&) {});
+        m_DroppedAtStart = m_CaptureRing.GetDroppedCount();
+        m_Notifications.Drain([](const RecordedEvent&) {});
+        m_NotificationsDroppedAtStart = m_Notifications.GetDroppedCount();
+        m_MouseDecimator.Reset(settings.MouseMoveTolerance);
+
         m_CurrentRecording = Recording(settings.Name, settings.RecordMouseMovement);
+        m_TotalEventCount = 0;
+        m_WasStreamedToDisk = false;
+
+        if (settings.StreamToDisk)
+        {
+            std::filesystem::path streamPath = settings.OutputPath;
+            streamPath += ".part";
+
+            if (m_Writer.Open(streamPath, settings.Name, settings.RecordMouseMovement))
+            {
+                m_PendingChunk.Reserve(settings.StreamChunkSize);
+                m_WasStreamedToDisk = true;
+            }
+            else
+            {
+                LUMINA_LOG_WARN("Could not stream recording to disk, keeping it in memory");
+            }
+        }
 
         if (settings.InitialDelaySeconds > 0)
         {
@@ -42,14 +83,7 @@ namespace KeyActions
         }
         else
         {
-            m_IsRecording = true;
-            m_RecordingStartTime = Lumina::Application::GetTime();
-            LUMINA_LOG_INFO("Recording started: {}", settings.Name);
-
-            if (m_RecordingStartedCallback)
-            {
-                m_RecordingStartedCallback();
-            }
+            BeginRecording();
         }
 
         return true;
@@ -63,18 +97,33 @@ namespace KeyActions
         if (m_IsWaitingForDelay)
         {
             m_IsWaitingForDelay = false;
+            m_Writer.Discard();
             LUMINA_LOG_INFO("Recording cancelled (was waiting for delay)");
 
             return;
         }
 
+        m_RecordingStopTime = Clock::Now();
         m_IsRecording = false;
-        m_CurrentRecording.TotalDuration = Lumina::Application::GetTime() - m_RecordingStartTime;
+
+        // The capture thread owns the recording until it has joined
+        StopCaptureSource();
+        StopCaptureThread();
+        DrainCaptured();
+        FlushMouseMoves();
+        DeliverNotifications();
+
+        m_CurrentRecording.Duration = m_RecordingStopTime - m_RecordingStartTime;
+
+        if (m_Writer.IsOpen())
+        {
+            FinishStream();
+        }
 
         LUMINA_LOG_INFO("Recording stopped: {} (Duration: {}s, Events: {})",
             m_CurrentRecording.Name,
-            m_CurrentRecording.TotalDuration,
-            m_CurrentRecording.Events.size());
+            m_CurrentRecording.GetDurationSeconds(),
+            m_TotalEventCount);
 
         if (m_RecordingStoppedCallback)
         {
@@ -90,7 +139,16 @@ namespace KeyActions
         m_IsRecording = false;
         m_IsWaitingForDelay = false;
 
+        StopCaptureSource();
+        StopCaptureThread();
+        m_CaptureRing.Drain([](const CapturedInput&) {});
+        m_Notifications.Drain([](const RecordedEvent&) {});
+        m_Writer.Discard();
+        m_PendingChunk.Clear();
+        m_WasStreamedToDisk = false;
+
         m_CurrentRecording = Recording();
+        m_TotalEventCount = 0;
 
         LUMINA_LOG_INFO("Recording cancelled");
     }
@@ -100,12 +158,12 @@ namespace KeyActions
         if (!m_IsRecording)
             return 0.0f;
 
-        return Lumina::Application::GetTime() - m_RecordingStartTime;
+        return static_cast<float>(Clock::ToSeconds(Clock::Now() - m_RecordingStartTime));
     }
 
     size_t RecordingSession::GetEventCount() const
     {
-        return m_CurrentRecording.Events.size();
+        return m_TotalEventCount;
     }
 
     Recording RecordingSession::TakeRecording()
@@ -123,16 +181,101 @@ namespace KeyActions
             if (m_DelayTimer <= 0.0f)
             {
                 m_IsWaitingForDelay = false;
-                m_IsRecording = true;
-                m_RecordingStartTime = Lumina::Application::GetTime();
-                LUMINA_LOG_INFO("Recording started: {}", m_Settings.Name);
-
-                if (m_RecordingStartedCallback)
-                {
-                    m_RecordingStartedCallback();
-                }
+                BeginRecording();
+            }
+        }
+
+        if (m_IsRecording && !m_CaptureThread.joinable())
+        {
+            DrainCaptured();
+        }
+
+        DeliverNotifications();
+    }
+
+    void RecordingSession::BeginRecording()
+    {
+        // The only modifier query of the recording; key events keep it current from here
+        m_Modifiers.Reset(ModifierTracker::Query());
+
+        // After a delay the start combo has had time to be let go
+        m_Hotkeys.Reset(m_Settings.InitialDelaySeconds > 0 ? std::vector<Lumina::KeyCode>{} : m_Settings.HeldAtStart, m_Settings.StopHotkey);
+
+        m_RecordingStartTime = Clock::Now();
+        m_IsRecording = true;
+
+        if (m_Settings.UseCaptureThread)
+        {
+            m_CaptureControl.Reset();
+            m_CaptureThread = std::thread(&RecordingSession::CaptureThread, this);
+        }
+
+        if (m_CaptureSource)
+        {
+            m_IsSourceCapturing = m_CaptureSource->Start([this](const CapturedInput& input) { Capture(input); });
+            if (!m_IsSourceCapturing)
+            {
+                LUMINA_LOG_WARN("Capture source failed to start, recording application events instead");
             }
         }
+
+        LUMINA_LOG_INFO("Recording started: {}", m_Settings.Name);
+
+        if (m_RecordingStartedCallback)
+        {
+            m_RecordingStartedCallback();
+        }
+    }
+
+    void RecordingSession::CaptureThread()
+    {
+#ifdef LUMINA_PLATFORM_WINDOWS
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+#endif
+
+        int64_t next = Clock::Now();
+        while (!m_CaptureControl.IsStopRequested())
+        {
+            DrainCaptured();
+
+            next += m_Settings.CaptureInterval;
+
+            // Fell behind (the machine stalled); don't try to catch up on missed ticks
+            int64_t now = Clock::Now();
+            if (next < now)
+                next = now;
+
+            m_CaptureControl.SleepUntil(next);
+        }
+    }
+
+    void RecordingSession::StopCaptureThread()
+    {
+        if (!m_CaptureThread.joinable())
+            return;
+
+        m_CaptureControl.Stop();
+        m_CaptureThread.join();
+    }
+
+    void RecordingSession::StopCaptureSource()
+    {
+        if (!m_IsSourceCapturing)
+            return;
+
+        m_CaptureSource->Stop();
+        m_IsSourceCapturing = false;
+    }
+
+    void RecordingSession::DeliverNotifications()
+    {
+        if (!m_EventRecordedCallback)
+        {
+            m_Notifications.Drain([](const RecordedEvent&) {});
+            return;
+        }
+
+        m_Notifications.Drain([this](const RecordedEvent& event) { m_EventRecordedCallback(event); });
     }
 
     void RecordingSession::SetEventRecordedCallback(RecordingEventCallback callback)
@@ -152,135 +295,236 @@ namespace KeyActions
 
     void RecordingSession::OnKeyPressed(KeyPressedEvent& e)
     {
-        if (!m_IsRecording)
+        if (!m_IsRecording || m_IsSourceCapturing)
             return;
 
-        RecordedEvent event;
-        event.Action = RecordedAction::KeyPressed;
-        event.Time = Lumina::Application::GetTime() - m_RecordingStartTime;
-        event.Key = e.GetKeyCode();
-
-        // Capture modifier states
-        event.ShiftPressed = Lumina::Input::IsShiftPressed();
-        event.CtrlPressed = Lumina::Input::IsCtrlPressed();
-        event.AltPressed = Lumina::Input::IsAltPressed();
-        event.SuperPressed = Lumina::Input::IsSuperPressed();
-        event.CapsLockActive = Lumina::Input::IsCapsLockActive();
+        CapturedInput input;
+        input.Timestamp = Clock::Now();
+        input.Action = RecordedAction::KeyPressed;
+        input.Code = static_cast<int>(e.GetKeyCode());
 
-        m_CurrentRecording.Events.push_back(event);
-
-        if (m_EventRecordedCallback)
-        {
-            m_EventRecordedCallback(event);
-        }
+        Capture(input);
     }
 
     void RecordingSession::OnKeyReleased(KeyReleasedEvent& e)
     {
-        if (!m_IsRecording)
+        if (!m_IsRecording || m_IsSourceCapturing)
             return;
 
-        RecordedEvent event;
-        event.Action = RecordedAction::KeyReleased;
-        event.Time = Lumina::Application::GetTime() - m_RecordingStartTime;
-        event.Key = e.GetKeyCode();
+        CapturedInput input;
+        input.Timestamp = Clock::Now();
+        input.Action = RecordedAction::KeyReleased;
+        input.Code = static_cast<int>(e.GetKeyCode());
 
-        event.ShiftPressed = Lumina::Input::IsShiftPressed();
-        event.CtrlPressed = Lumina::Input::IsCtrlPressed();
-        event.AltPressed = Lumina::Input::IsAltPressed();
-        event.SuperPressed = Lumina::Input::IsSuperPressed();
-        event.CapsLockActive = Lumina::Input::IsCapsLockActive();
+        Capture(input);
+    }
 
-        m_CurrentRecording.Events.push_back(event);
+    void RecordingSession::OnMouseButtonPressed(MouseButtonPressedEvent& e)
+    {
+        if (!m_IsRecording || m_IsSourceCapturing)
+            return;
 
-        if (m_EventRecordedCallback)
-        {
-            m_EventRecordedCallback(event);
-        }
+        CapturedInput input;
+        input.Timestamp = Clock::Now();
+        input.Action = RecordedAction::MousePressed;
+        input.Code = static_cast<int>(e.GetMouseButton());
+        input.A = e.GetX();
+        input.B = e.GetY();
+
+        Capture(input);
     }
 
-    void RecordingSession::OnMouseButtonPressed(MouseButtonPressedEvent& e)
+    void RecordingSession::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
     {
-        if (!m_IsRecording)
+        if (!m_IsRecording || m_IsSourceCapturing)
             return;
 
-        RecordedEvent event;
-        event.Action = RecordedAction::MousePressed;
-        event.Time = Lumina::Application::GetTime() - m_RecordingStartTime;
-        event.Button = e.GetMouseButton();
-        event.MouseX = e.GetX();
-        event.MouseY = e.GetY();
+        CapturedInput input;
+        input.Timestamp = Clock::Now();
+        input.Action = RecordedAction::MouseReleased;
+        input.Code = static_cast<int>(e.GetMouseButton());
+        input.A = e.GetX();
+        input.B = e.GetY();
 
-        m_CurrentRecording.Events.push_back(event);
+        Capture(input);
+    }
 
-        if (m_EventRecordedCallback)
-        {
-            m_EventRecordedCallback(event);
-        }
+    void RecordingSession::OnMouseMoved(MouseMovedEvent& e)
+    {
+        if (!m_IsRecording || m_IsSourceCapturing)
+            return;
+
+        CapturedInput input;
+        input.Timestamp = Clock::Now();
+        input.Action = RecordedAction::MouseMoved;
+        input.A = e.GetX();
+        input.B = e.GetY();
+
+        Capture(input);
     }
 
-    void RecordingSession::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
+    void RecordingSession::OnMouseScrolled(MouseScrolledEvent& e)
     {
-        if (!m_IsRecording)
+        if (!m_IsRecording || m_IsSourceCapturing)
             return;
 
-        RecordedEvent event;
-        event.Action = RecordedAction::MouseReleased;
-        event.Time = Lumina::Application::GetTime() - m_RecordingStartTime;
-        event.Button = e.GetMouseButton();
-        event.MouseX = e.GetX();
-        event.MouseY = e.GetY();
+        CapturedInput input;
+        input.Timestamp = Clock::Now();
+        input.Action = RecordedAction::MouseScrolled;
+        input.A = e.GetDX();
+        input.B = e.GetDY();
 
-        m_CurrentRecording.Events.push_back(event);
+        Capture(input);
+    }
 
-        if (m_EventRecordedCallback)
-        {
-            m_EventRecordedCallback(event);
-        }
+    bool RecordingSession::Capture(const CapturedInput& input)
+    {
+        if (!m_IsRecording.load(std::memory_order_acquire))
+            return false;
+
+        return m_CaptureRing.TryPush(input);
     }
 
-    void RecordingSession::OnMouseMoved(MouseMovedEvent& e)
+    size_t RecordingSession::DrainCaptured()
     {
-        if (!m_IsRecording)
+        return m_CaptureRing.Drain([this](const CapturedInput& input) { AppendCaptured(input); });
+    }
+
+    void RecordingSession::AppendCaptured(const CapturedInput& input)
+    {
+        // A hook can race Start() and Stop(); keep only what happened in between
+        if (input.Timestamp < m_RecordingStartTime)
+            return;
+
+        if (!m_IsRecording && input.Timestamp > m_RecordingStopTime)
             return;
 
-        float currentTime = Lumina::Application::GetTime();
+        if (input.Action == RecordedAction::MouseMoved)
+        {
+            MousePoint kept;
+            if (m_MouseDecimator.Add(MousePoint{ input.Timestamp, input.A, input.B }, kept))
+                AppendMouseMove(kept);
 
-        if (currentTime - m_LastMouseMoveTime < m_Settings.MouseMoveThreshold)
             return;
+        }
+
+        // Anything else happens after the path so far, so its held back end goes first
+        FlushMouseMoves();
+
+        RecordedEvent event;
+        event.Action = input.Action;
+        event.Timestamp = input.Timestamp - m_RecordingStartTime;
 
-        m_LastMouseMoveTime = currentTime;
+        switch (input.Action)
+        {
+        case RecordedAction::KeyPressed:
+        case RecordedAction::KeyReleased:
+            event.Key = static_cast<Lumina::KeyCode>(input.Code);
+            event.Modifiers = m_Modifiers.Apply(input.Action, event.Key);
+
+            if (!m_Hotkeys.Apply(input.Action, event.Key))
+                return;
+
+            break;
+
+        case RecordedAction::MousePressed:
+        case RecordedAction::MouseReleased:
+            event.Button = static_cast<Lumina::MouseCode>(input.Code);
+            event.MouseX = input.A;
+            event.MouseY = input.B;
+            break;
+
+        case RecordedAction::MouseMoved:
+            break;
+
+        case RecordedAction::MouseScrolled:
+            event.ScrollDX = input.A;
+            event.ScrollDY = input.B;
+            break;
+        }
 
+        AppendEvent(event);
+    }
+
+    void RecordingSession::AppendMouseMove(const MousePoint& point)
+    {
         RecordedEvent event;
         event.Action = RecordedAction::MouseMoved;
-        event.Time = currentTime - m_RecordingStartTime;
-        event.MouseX = e.GetX();
-        event.MouseY = e.GetY();
+        event.Timestamp = point.Timestamp - m_RecordingStartTime;
+        event.MouseX = point.X;
+        event.MouseY = point.Y;
 
-        m_CurrentRecording.Events.push_back(event);
+        AppendEvent(event);
+    }
+
+    void RecordingSession::FlushMouseMoves()
+    {
+        MousePoint kept;
+        if (m_MouseDecimator.Flush(kept))
+            AppendMouseMove(kept);
+    }
+
+    void RecordingSession::AppendEvent(const RecordedEvent& event)
+    {
+        m_CurrentRecording.Events.Add(event);
+        m_TotalEventCount++;
 
-        if (m_EventRecordedCallback)
+        if (m_Writer.IsOpen())
+        {
+            m_PendingChunk.Add(event);
+
+            if (m_PendingChunk.Size() >= m_Settings.StreamChunkSize)
+            {
+                m_Writer.Submit(std::move(m_PendingChunk));
+                m_PendingChunk = EventStore();
+                m_PendingChunk.Reserve(m_Settings.StreamChunkSize);
+            }
+
+            // Everything older than the tail has already been handed to the writer
+            auto& events = m_CurrentRecording.Events;
+            if (events.Size() > m_Settings.MaxEventsInMemory)
+            {
+                events.EraseFront(events.Size() - m_Settings.MaxEventsInMemory / 2);
+            }
+        }
+
+        if (m_Settings.UseCaptureThread)
+        {
+            // Stored from the capture thread; the callback belongs to the UI thread
+            m_Notifications.TryPush(event);
+        }
+        else if (m_EventRecordedCallback)
         {
             m_EventRecordedCallback(event);
         }
     }
 
-    void RecordingSession::OnMouseScrolled(MouseScrolledEvent& e)
+    void RecordingSession::FinishStream()
     {
-        if (!m_IsRecording)
-            return;
+        m_Writer.Submit(std::move(m_PendingChunk));
+        m_PendingChunk = EventStore();
 
-        RecordedEvent event;
-        event.Action = RecordedAction::MouseScrolled;
-        event.Time = Lumina::Application::GetTime() - m_RecordingStartTime;
-        event.ScrollDX = e.GetDX();
-        event.ScrollDY = e.GetDY();
+        std::filesystem::path streamPath = m_Writer.GetFilePath();
 
-        m_CurrentRecording.Events.push_back(event);
+        if (!m_Writer.Finalize(m_CurrentRecording.Duration))
+        {
+            LUMINA_LOG_ERROR("Failed to finalize streamed recording, partial file kept at {}", streamPath.string());
+            return;
+        }
 
-        if (m_EventRecordedCallback)
+        // Saved compressed like any other recording, so the lazy reader can open it
+        if (Serialization::CompressStream(streamPath, m_Settings.OutputPath))
         {
-            m_EventRecordedCallback(event);
+            std::error_code error;
+            std::filesystem::remove(streamPath, error);
+            return;
+        }
+
+        // The uncompressed stream still loads, so it is kept rather than lost.
+        // Durable before it replaces an older recording of the same name, as any other save
+        if (!AtomicFile::Replace(streamPath, m_Settings.OutputPath))
+        {
+            LUMINA_LOG_ERROR("Failed to move streamed recording into place, partial file kept at {}", streamPath.string());
         }
     }
 }
\ No newline at end of file
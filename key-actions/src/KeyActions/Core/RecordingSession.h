@@ -1,13 +1,24 @@
 #pragma once
 
 #include "Recording.h"
+#include "RecordingWriter.h"
+#include "CaptureRing.h"
+#include "CaptureSource.h"
+#include "ModifierTracker.h"
+#include "HotkeyFilter.h"
+#include "MouseMoveDecimator.h"
+#include "PlaybackControl.h"
 
 #include "Lumina/Events/GlobalKeyEvent.h"
 #include "Lumina/Events/GlobalMouseEvent.h"
 
+#include <atomic>
 #include <memory>
 #include <functional>
 #include <string>
+#include <thread>
+#include <vector>
+#include <filesystem>
 
 namespace KeyActions
 {
@@ -16,7 +27,27 @@ namespace KeyActions
         std::string Name;
         bool RecordMouseMovement = false;
         int InitialDelaySeconds = 0;
-        float MouseMoveThreshold = 0.02f;
+        // Pixels a dropped mouse move may lie off the recorded path; 0 keeps every move
+        float MouseMoveTolerance = 2.0f;
+
+        // An OS hook sees the hotkeys too. Releases of keys held when recording starts (the
+        // start combo) and the press completing StopHotkey are left out of the recording.
+        std::vector<Lumina::KeyCode> HeldAtStart;
+        std::vector<Lumina::KeyCode> StopHotkey;
+
+        // Streaming: events are flushed to "<OutputPath>.part" in chunks while recording,
+        // and only a bounded tail is kept in memory. On Stop() the file is compressed into
+        // OutputPath a block at a time and the partial file removed.
+        bool StreamToDisk = false;
+        std::filesystem::path OutputPath;
+        size_t StreamChunkSize = 4096;
+        size_t MaxEventsInMemory = 16384;
+
+        // Captured input is stored by a dedicated thread every CaptureInterval instead of in
+        // Update(), so a stalled or minimized window does not delay it. The UI still hears
+        // about each event, but only when Update() runs.
+        bool UseCaptureThread = false;
+        int64_t CaptureInterval = Clock::NanosecondsPerMillisecond;
     };
 
     class RecordingSession
@@ -34,7 +65,8 @@ namespace KeyActions
         using RecordingStateCallback = std::function<void()>;
 
 
-        RecordingSession();
+        // Capture buffer size is how many inputs can queue between drains before new ones drop
+        explicit RecordingSession(size_t captureBufferSize = 8192);
         ~RecordingSession();
 
         // Recording control
@@ -48,9 +80,14 @@ namespace KeyActions
         float GetElapsedTime() const;
         size_t GetEventCount() const;
 
+        // While streaming, only the most recent events are held here
         const Recording& GetRecording() const { return m_CurrentRecording; }
         Recording TakeRecording();
 
+        // True if the last recording was streamed to disk, so GetRecording() only holds its tail
+        bool WasStreamedToDisk() const { return m_WasStreamedToDisk; }
+        const std::filesystem::path& GetOutputPath() const { return m_Settings.OutputPath; }
+
         void Update(float timestep);
 
         void OnKeyPressed(KeyPressedEvent& e);
@@ -60,19 +97,67 @@ namespace KeyActions
         void OnMouseMoved(MouseMovedEvent& e);
         void OnMouseScrolled(MouseScrolledEvent& e);
 
+        // Input comes from the source while recording instead of the On* handlers, which then
+        // ignore events. Not owned; must outlive the recording. Null goes back to the handlers.
+        void SetCaptureSource(CaptureSource* source) { m_CaptureSource = source; }
+
+        // Queues raw input for the next drain. Safe to call from one producer thread
+        // (an input hook) while another thread calls Update() and Stop(). Returns false
+        // if the input was not recording or was dropped because the ring was full.
+        bool Capture(const CapturedInput& input);
+
+        // Moves queued input into the recording; Update() or the capture thread calls this
+        size_t DrainCaptured();
+
+        uint64_t GetDroppedInputCount() const { return m_CaptureRing.GetDroppedCount() - m_DroppedAtStart; }
+
+        // Events stored while the UI was too far behind to be told about them
+        uint64_t GetDroppedNotificationCount() const { return m_Notifications.GetDroppedCount() - m_NotificationsDroppedAtStart; }
+
         void SetEventRecordedCallback(RecordingEventCallback callback);
         void SetRecordingStartedCallback(RecordingStateCallback callback);
         void SetRecordingStoppedCallback(RecordingStateCallback callback);
 
     private:
-        bool m_IsRecording = false;
+        void BeginRecording();
+        void CaptureThread();
+        void StopCaptureThread();
+        void StopCaptureSource();
+        void DeliverNotifications();
+
+        void AppendCaptured(const CapturedInput& input);
+        void AppendMouseMove(const MousePoint& point);
+        void FlushMouseMoves();
+        void AppendEvent(const RecordedEvent& event);
+        void FinishStream();
+
+    private:
+        std::atomic<bool> m_IsRecording{ false };
         bool m_IsWaitingForDelay = false;
         float m_DelayTimer = 0.0f;
-        float m_RecordingStartTime = 0.0f;
-        float m_LastMouseMoveTime = 0.0f;
+        int64_t m_RecordingStartTime = 0;   // Clock::Now() nanoseconds
+        int64_t m_RecordingStopTime = 0;
+        ModifierTracker m_Modifiers;
+        HotkeyFilter m_Hotkeys;
+        MouseMoveDecimator m_MouseDecimator;
+
+        CaptureRing m_CaptureRing;
+        CaptureSource* m_CaptureSource = nullptr;
+        bool m_IsSourceCapturing = false;
+        uint64_t m_DroppedAtStart = 0;
+
+        std::thread m_CaptureThread;
+        PlaybackControl m_CaptureControl;
+        SpscRing<RecordedEvent> m_Notifications;   // Capture thread to Update()
+        uint64_t m_NotificationsDroppedAtStart = 0;
 
         Recording m_CurrentRecording;
         RecordingSettings m_Settings;
+        std::atomic<size_t> m_TotalEventCount{ 0 };
+
+        RecordingWriter m_Writer;
+        EventStore m_PendingChunk;
+        bool m_WasStreamedToDisk = false;
 
         RecordingEventCallback m_EventRecordedCallback;
         RecordingStateCallback m_RecordingStartedCallback;
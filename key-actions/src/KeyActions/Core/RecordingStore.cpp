@@ -0,0 +1,666 @@
+#include "RecordingStore.h"
+
+#include "Lumina/Core/Log.h"
+
+#include "AtomicFile.h"
+#include "EventCodec.h"
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+
+namespace KeyActions
+{
+    namespace
+    {
+        constexpr const char* ManifestFolder = "manifests";
+        constexpr const char* ChunkFolder = "chunks";
+        constexpr const char* ManifestExtension = ".manifest";
+        constexpr const char* ChunkExtension = ".chunk";
+
+        using RecordingFormat::ChunkHash;
+
+        // splitmix64 finalizer; spreads every input bit over the whole word
+        uint64_t Mix(uint64_t value)
+        {
+            value ^= value >> 30;
+            value *= 0xBF58476D1CE4E5B9ull;
+            value ^= value >> 27;
+            value *= 0x94D049BB133111EBull;
+            value ^= value >> 31;
+            return value;
+        }
+
+        // Covers everything a chunk encodes about the event except its absolute time
+        uint64_t Fingerprint(const RecordedEvent& event, int64_t timeDelta)
+        {
+            uint64_t code = event.Action == RecordedAction::KeyPressed || event.Action == RecordedAction::KeyReleased
+                ? static_cast<uint64_t>(event.Key)
+                : static_cast<uint64_t>(event.Button);
+
+            uint64_t hash = Mix(static_cast<uint64_t>(timeDelta));
+            hash = Mix(hash ^ (static_cast<uint64_t>(event.Action) | static_cast<uint64_t>(event.Modifiers) << 8 | (code & 0xFFFFFFFF) << 16));
+            hash = Mix(hash ^ (static_cast<uint64_t>(static_cast<uint32_t>(event.MouseX)) | static_cast<uint64_t>(static_cast<uint32_t>(event.MouseY)) << 32));
+            hash = Mix(hash ^ (static_cast<uint64_t>(static_cast<uint32_t>(event.ScrollDX)) | static_cast<uint64_t>(static_cast<uint32_t>(event.ScrollDY)) << 32));
+            return hash;
+        }
+
+        // FIPS 180-4 SHA-256. Chunks are addressed by content, so the hash has to make finding
+        // two chunks with one address impractical, not merely unlikely by chance.
+        class Sha256
+        {
+        public:
+            std::array<uint8_t, 32> Hash(const uint8_t* data, size_t size)
+            {
+                m_State = { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+
+                size_t whole = size - size % 64;
+                for (size_t offset = 0; offset < whole; offset += 64)
+                    Compress(data + offset);
+
+                // Remaining bytes, the 0x80 marker and the bit length, in one or two blocks
+                uint8_t tail[128] = {};
+                size_t remaining = size - whole;
+                std::memcpy(tail, data + whole, remaining);
+                tail[remaining] = 0x80;
+
+                size_t tailSize = remaining + 1 + 8 <= 64 ? 64 : 128;
+                uint64_t bits = static_cast<uint64_t>(size) * 8;
+                for (int i = 0; i < 8; i++)
+                    tail[tailSize - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+
+                for (size_t offset = 0; offset < tailSize; offset += 64)
+                    Compress(tail + offset);
+
+                std::array<uint8_t, 32> digest;
+                for (int i = 0; i < 8; i++)
+                {
+                    for (int j = 0; j < 4; j++)
+                        digest[i * 4 + j] = static_cast<uint8_t>(m_State[i] >> (24 - 8 * j));
+                }
+
+                return digest;
+            }
+
+        private:
+            static uint32_t Rotate(uint32_t value, int bits) { return (value >> bits) | (value << (32 - bits)); }
+
+            void Compress(const uint8_t* block)
+            {
+                static constexpr uint32_t K[64] = {
+                    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+                    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+                    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+                    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+                    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+                    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+                    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+                    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+                };
+
+                uint32_t w[64];
+                for (int i = 0; i < 16; i++)
+                {
+                    w[i] = static_cast<uint32_t>(block[i * 4]) << 24 | static_cast<uint32_t>(block[i * 4 + 1]) << 16 |
+                        static_cast<uint32_t>(block[i * 4 + 2]) << 8 | static_cast<uint32_t>(block[i * 4 + 3]);
+                }
+
+                for (int i = 16; i < 64; i++)
+                {
+                    uint32_t s0 = Rotate(w[i - 15], 7) ^ Rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                    uint32_t s1 = Rotate(w[i - 2], 17) ^ Rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+
+                std::array<uint32_t, 8> v = m_State;
+                for (int i = 0; i < 64; i++)
+                {
+                    uint32_t s1 = Rotate(v[4], 6) ^ Rotate(v[4], 11) ^ Rotate(v[4], 25);
+                    uint32_t choose = (v[4] & v[5]) ^ (~v[4] & v[6]);
+                    uint32_t t1 = v[7] + s1 + choose + K[i] + w[i];
+                    uint32_t s0 = Rotate(v[0], 2) ^ Rotate(v[0], 13) ^ Rotate(v[0], 22);
+                    uint32_t majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+                    uint32_t t2 = s0 + majority;
+
+                    v = { t1 + t2, v[0], v[1], v[2], v[3] + t1, v[4], v[5], v[6] };
+                }
+
+                for (int i = 0; i < 8; i++)
+                    m_State[i] += v[i];
+            }
+
+        private:
+            std::array<uint32_t, 8> m_State = {};
+        };
+
+        void AppendHex(uint64_t value, std::string& text)
+        {
+            constexpr char Digits[] = "0123456789abcdef";
+
+            for (int shift = 60; shift >= 0; shift -= 4)
+                text += Digits[(value >> shift) & 0xF];
+        }
+
+        std::string ToHex(const ChunkHash& hash)
+        {
+            std::string text;
+            text.reserve(32);
+            AppendHex(hash.High, text);
+            AppendHex(hash.Low, text);
+            return text;
+        }
+
+        bool ParseHex(const std::string& text, ChunkHash& hash)
+        {
+            if (text.size() != 32)
+                return false;
+
+            const char* middle = text.data() + 16;
+            const char* end = text.data() + text.size();
+
+            auto high = std::from_chars(text.data(), middle, hash.High, 16);
+            auto low = std::from_chars(middle, end, hash.Low, 16);
+            return high.ec == std::errc() && high.ptr == middle && low.ec == std::errc() && low.ptr == end;
+        }
+
+        bool ReadWholeFile(const std::filesystem::path& path, std::vector<uint8_t>& bytes)
+        {
+            std::error_code errorCode;
+            uint64_t size = std::filesystem::file_size(path, errorCode);
+            if (errorCode)
+                return false;
+
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                return false;
+
+            bytes.resize(size);
+            file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+            return static_cast<bool>(file);
+        }
+    }
+
+    RecordingStore::RecordingStore(std::filesystem::path folder) : m_Folder(std::move(folder)) {}
+
+    bool RecordingStore::IsValidName(const std::string& name)
+    {
+        if (name.empty() || name == "." || name == "..")
+            return false;
+
+        // Both separators on every platform, as names travel with recordings between them
+        return name.find_first_of("/\\") == std::string::npos && name.find('\0') == std::string::npos;
+    }
+
+    std::filesystem::path RecordingStore::GetManifestPath(const std::string& name) const
+    {
+        return m_Folder / ManifestFolder / (name + ManifestExtension);
+    }
+
+    RecordingFormat::ChunkHash RecordingStore::HashChunk(const uint8_t* data, size_t size)
+    {
+        std::array<uint8_t, 32> digest = Sha256().Hash(data, size);
+
+        ChunkHash hash;
+        for (int i = 0; i < 8; i++)
+        {
+            hash.High = (hash.High << 8) | digest[i];
+            hash.Low = (hash.Low << 8) | digest[8 + i];
+        }
+
+        return hash;
+    }
+
+    std::filesystem::path RecordingStore::GetChunkPath(const ChunkHash& hash) const
+    {
+        // Spread over 256 folders so none grows to hold every chunk
+        std::string hex = ToHex(hash);
+        return m_Folder / ChunkFolder / hex.substr(0, 2) / (hex + ChunkExtension);
+    }
+
+    std::vector<size_t> RecordingStore::FindChunkEnds(const EventStore& events)
+    {
+        std::vector<size_t> ends;
+
+        const auto& timestamps = events.GetTimestamps();
+        size_t count = events.Size();
+        size_t start = 0;
+        uint64_t hash = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            int64_t delta = i > 0 ? timestamps[i] - timestamps[i - 1] : 0;
+
+            // Each step shifts older events further up, so the top bits only depend on the last 64 events
+            hash = (hash << 1) + Fingerprint(events[i].ToEvent(), delta);
+
+            size_t length = i + 1 - start;
+            bool boundary = length >= MinChunkEvents && (hash >> (64 - AverageChunkBits)) == 0;
+
+            if (boundary || length >= MaxChunkEvents)
+            {
+                ends.push_back(i + 1);
+                start = i + 1;
+            }
+        }
+
+        if (start < count)
+            ends.push_back(count);
+
+        return ends;
+    }
+
+    bool RecordingStore::Open()
+    {
+        std::error_code errorCode;
+        std::filesystem::create_directories(m_Folder / ManifestFolder, errorCode);
+        if (!errorCode)
+            std::filesystem::create_directories(m_Folder / ChunkFolder, errorCode);
+
+        if (errorCode)
+        {
+            LUMINA_LOG_ERROR("Failed to create recording store: {} ({})", m_Folder.string(), errorCode.message());
+            return false;
+        }
+
+        LoadManifests();
+
+        LUMINA_LOG_INFO("Opened recording store: {} ({} recordings, {} chunks)", m_Folder.string(), m_Manifests.size(), m_Chunks.size());
+        return true;
+    }
+
+    bool RecordingStore::LoadManifests()
+    {
+        m_Manifests.clear();
+        m_Chunks.clear();
+
+        bool complete = true;
+
+        std::error_code errorCode;
+        for (std::filesystem::directory_iterator it(m_Folder / ManifestFolder, errorCode), end; !errorCode && it != end; it.increment(errorCode))
+        {
+            const std::filesystem::path& path = it->path();
+            if (path.extension() != ManifestExtension)
+                continue;
+
+            Manifest manifest;
+            if (!ReadManifest(path, manifest))
+            {
+                LUMINA_LOG_WARN("Skipping damaged manifest: {}", path.string());
+                complete = false;
+                continue;
+            }
+
+            AddReferences(manifest);
+            m_Manifests.emplace(path.stem().string(), std::move(manifest));
+        }
+
+        if (errorCode)
+        {
+            LUMINA_LOG_ERROR("Failed to list recording store manifests: {}", errorCode.message());
+            return false;
+        }
+
+        return complete;
+    }
+
+    bool RecordingStore::ReadManifest(const std::filesystem::path& path, Manifest& manifest)
+    {
+        using namespace RecordingFormat;
+
+        std::vector<uint8_t> bytes;
+        if (!ReadWholeFile(path, bytes) || bytes.size() < sizeof(FileHeader))
+            return false;
+
+        FileHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (!ValidateManifestHeader(header, bytes.size()))
+            return false;
+
+        manifest.Duration = header.Duration;
+        manifest.RecordsMouse = (header.Flags & FlagRecordsMouse) != 0;
+        manifest.FileSize = bytes.size();
+        manifest.Chunks.resize(header.RecordCount);
+        std::memcpy(manifest.Chunks.data(), bytes.data() + header.EventsOffset, manifest.Chunks.size() * sizeof(ChunkEntry));
+
+        for (const ChunkEntry& entry : manifest.Chunks)
+        {
+            if (entry.EventCount == 0 || entry.EventCount > MaxChunkEvents)
+                return false;
+
+            manifest.EventCount += entry.EventCount;
+        }
+
+        return true;
+    }
+
+    bool RecordingStore::Put(const Recording& recording)
+    {
+        using namespace RecordingFormat;
+
+        if (!IsValidName(recording.Name))
+        {
+            LUMINA_LOG_ERROR("Invalid name for recording store: '{}'", recording.Name);
+            return false;
+        }
+
+        Manifest manifest;
+        manifest.Duration = recording.Duration;
+        manifest.RecordsMouse = recording.RecordsMouse;
+        manifest.EventCount = recording.Events.Size();
+
+        std::vector<size_t> ends = FindChunkEnds(recording.Events);
+        manifest.Chunks.reserve(ends.size());
+
+        std::vector<uint8_t> bytes;
+        size_t first = 0;
+
+        // Chunks go to disk before the manifest, so the manifest never lists a missing chunk
+        for (size_t end : ends)
+        {
+            bytes.clear();
+            EventCodec::EncodeBlock(recording.Events, first, end - first, true, bytes);
+
+            ChunkEntry entry;
+            entry.Hash = HashChunk(bytes.data(), bytes.size());
+            entry.FirstTimestamp = recording.Events[first].GetTimestamp();
+            entry.Size = static_cast<uint32_t>(bytes.size());
+            entry.EventCount = static_cast<uint32_t>(end - first);
+
+            if (!StoreChunk(entry.Hash, bytes))
+                return false;
+
+            manifest.Chunks.push_back(entry);
+            first = end;
+        }
+
+        FileHeader header;
+        header.Magic = ManifestMagic;
+        header.Version = ManifestVersion;
+        header.Flags = recording.RecordsMouse ? static_cast<uint32_t>(FlagRecordsMouse) : 0u;
+        header.NameLength = static_cast<uint32_t>(recording.Name.size());
+        header.RecordCount = manifest.Chunks.size();
+        header.EventsOffset = GetEventsOffset(header.NameLength);
+        header.Duration = recording.Duration;
+        header.RecordSize = sizeof(ChunkEntry);
+
+        std::filesystem::path manifestPath = GetManifestPath(recording.Name);
+
+        AtomicFile file;
+        if (!file.Open(manifestPath))
+        {
+            LUMINA_LOG_ERROR("Failed to open manifest for writing: {}", manifestPath.string());
+            return false;
+        }
+
+        const char padding[EventAlignment] = {};
+        file.Write(&header, sizeof(header));
+        file.Write(recording.Name.data(), recording.Name.size());
+        file.Write(padding, header.EventsOffset - sizeof(header) - header.NameLength);
+        file.Write(manifest.Chunks.data(), manifest.Chunks.size() * sizeof(ChunkEntry));
+
+        if (!file.Commit())
+        {
+            LUMINA_LOG_ERROR("Failed to write manifest: {}", manifestPath.string());
+            return false;
+        }
+
+        manifest.FileSize = header.EventsOffset + manifest.Chunks.size() * sizeof(ChunkEntry);
+
+        // Referenced before the old version is released, so chunks both versions share stay on disk
+        AddReferences(manifest);
+
+        auto existing = m_Manifests.find(recording.Name);
+        if (existing != m_Manifests.end())
+        {
+            Manifest replaced = std::move(existing->second);
+            existing->second = std::move(manifest);
+            ReleaseReferences(replaced);
+        }
+        else
+        {
+            m_Manifests.emplace(recording.Name, std::move(manifest));
+        }
+
+        return true;
+    }
+
+    bool RecordingStore::StoreChunk(const ChunkHash& hash, const std::vector<uint8_t>& bytes)
+    {
+        std::filesystem::path path = GetChunkPath(hash);
+
+        auto known = m_Chunks.find(hash);
+        if (known != m_Chunks.end())
+        {
+            std::vector<uint8_t> stored;
+            if (ReadWholeFile(path, stored))
+            {
+                if (stored == bytes)
+                    return true;
+
+                // Intact but different contents would be a SHA-256 collision; refuse rather than
+                // overwrite a chunk other manifests use. Anything else is damage and is rewritten.
+                if (HashChunk(stored.data(), stored.size()) == hash)
+                {
+                    LUMINA_LOG_ERROR("Chunk hash collision in recording store: {}", path.string());
+                    return false;
+                }
+            }
+
+            LUMINA_LOG_WARN("Rewriting missing or damaged chunk: {}", path.string());
+        }
+        else
+        {
+            // Unreferenced until a manifest commits; CollectGarbage() removes it if none does
+            m_Chunks.emplace(hash, ChunkInfo{ static_cast<uint32_t>(bytes.size()), 0 });
+        }
+
+        std::error_code errorCode;
+        std::filesystem::create_directories(path.parent_path(), errorCode);
+
+        AtomicFile file;
+        if (errorCode || !file.Open(path))
+        {
+            LUMINA_LOG_ERROR("Failed to open chunk for writing: {}", path.string());
+            return false;
+        }
+
+        file.Write(bytes.data(), bytes.size());
+
+        if (!file.Commit())
+        {
+            LUMINA_LOG_ERROR("Failed to write chunk: {}", path.string());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool RecordingStore::ReadChunk(const RecordingFormat::ChunkEntry& entry, std::vector<uint8_t>& bytes) const
+    {
+        return ReadWholeFile(GetChunkPath(entry.Hash), bytes) && bytes.size() == entry.Size &&
+            HashChunk(bytes.data(), bytes.size()) == entry.Hash;
+    }
+
+    bool RecordingStore::Get(const std::string& name, Recording& recording) const
+    {
+        auto it = m_Manifests.find(name);
+        if (it == m_Manifests.end())
+        {
+            LUMINA_LOG_ERROR("Recording not in store: {}", name);
+            return false;
+        }
+
+        const Manifest& manifest = it->second;
+
+        Recording loaded(name, manifest.RecordsMouse);
+        loaded.Duration = manifest.Duration;
+        loaded.Events.Reserve(manifest.EventCount);
+
+        std::vector<uint8_t> bytes;
+        for (const RecordingFormat::ChunkEntry& entry : manifest.Chunks)
+        {
+            if (!ReadChunk(entry, bytes) ||
+                !EventCodec::DecodeBlock(bytes.data(), bytes.size(), entry.FirstTimestamp, entry.EventCount, loaded.Events))
+            {
+                LUMINA_LOG_ERROR("Missing or damaged chunk {} of recording: {}", ToHex(entry.Hash), name);
+                return false;
+            }
+        }
+
+        recording = std::move(loaded);
+        return true;
+    }
+
+    bool RecordingStore::Remove(const std::string& name)
+    {
+        auto it = m_Manifests.find(name);
+        if (it == m_Manifests.end())
+            return false;
+
+        // The manifest goes first, so a crash part way leaves unused chunks rather than a broken recording
+        std::error_code errorCode;
+        std::filesystem::remove(GetManifestPath(name), errorCode);
+        if (errorCode)
+        {
+            LUMINA_LOG_ERROR("Failed to remove manifest: {} ({})", GetManifestPath(name).string(), errorCode.message());
+            return false;
+        }
+
+        Manifest removed = std::move(it->second);
+        m_Manifests.erase(it);
+        ReleaseReferences(removed);
+        return true;
+    }
+
+    std::vector<std::string> RecordingStore::List() const
+    {
+        std::vector<std::string> names;
+        names.reserve(m_Manifests.size());
+
+        for (const auto& [name, manifest] : m_Manifests)
+            names.push_back(name);
+
+        return names;
+    }
+
+    void RecordingStore::AddReferences(const Manifest& manifest)
+    {
+        for (const RecordingFormat::ChunkEntry& entry : manifest.Chunks)
+        {
+            ChunkInfo& chunk = m_Chunks[entry.Hash];
+            chunk.Size = entry.Size;
+            chunk.References++;
+        }
+    }
+
+    void RecordingStore::ReleaseReferences(const Manifest& manifest)
+    {
+        for (const RecordingFormat::ChunkEntry& entry : manifest.Chunks)
+        {
+            auto it = m_Chunks.find(entry.Hash);
+            if (it == m_Chunks.end() || --it->second.References > 0)
+                continue;
+
+            m_Chunks.erase(it);
+
+            std::error_code errorCode;
+            std::filesystem::remove(GetChunkPath(entry.Hash), errorCode);
+            if (errorCode)
+                LUMINA_LOG_WARN("Failed to remove unused chunk: {}", GetChunkPath(entry.Hash).string());
+        }
+    }
+
+    uint32_t RecordingStore::GetReferenceCount(const ChunkHash& hash) const
+    {
+        auto it = m_Chunks.find(hash);
+        return it != m_Chunks.end() ? it->second.References : 0;
+    }
+
+    size_t RecordingStore::CollectGarbage()
+    {
+        // Sweeping with a manifest missing from the count would delete chunks it still needs
+        if (!LoadManifests())
+        {
+            LUMINA_LOG_ERROR("Not collecting garbage in {}: some manifests could not be read", m_Folder.string());
+            return 0;
+        }
+
+        std::vector<std::filesystem::path> unused;
+
+        std::error_code errorCode;
+        for (std::filesystem::recursive_directory_iterator it(m_Folder, errorCode), end; !errorCode && it != end; it.increment(errorCode))
+        {
+            if (!it->is_regular_file(errorCode))
+                continue;
+
+            const std::filesystem::path& path = it->path();
+            std::filesystem::path folder = path.parent_path();
+
+            // Another process may be writing into the store; its temporaries aren't garbage yet
+            if (AtomicFile::IsTemporaryPath(path) && !AtomicFile::IsAbandonedTemporary(path))
+                continue;
+
+            if (folder == m_Folder / ManifestFolder)
+            {
+                if (AtomicFile::IsTemporaryPath(path))
+                    unused.push_back(path);
+            }
+            else if (folder.parent_path() == m_Folder / ChunkFolder)
+            {
+                ChunkHash hash;
+                bool referenced = path.extension() == ChunkExtension && ParseHex(path.stem().string(), hash) &&
+                    GetReferenceCount(hash) > 0 && GetChunkPath(hash) == path;
+
+                if (!referenced)
+                    unused.push_back(path);
+            }
+        }
+
+        if (errorCode)
+        {
+            LUMINA_LOG_ERROR("Failed to scan recording store {}: {}", m_Folder.string(), errorCode.message());
+            return 0;
+        }
+
+        size_t removed = 0;
+        for (const std::filesystem::path& path : unused)
+        {
+            if (std::filesystem::remove(path, errorCode))
+                removed++;
+        }
+
+        // Chunks written for a manifest that never committed
+        std::erase_if(m_Chunks, [](const auto& chunk) { return chunk.second.References == 0; });
+
+        LUMINA_LOG_INFO("Collected {} unused files from recording store: {}", removed, m_Folder.string());
+        return removed;
+    }
+
+    StoreStats RecordingStore::GetStats() const
+    {
+        StoreStats stats;
+        stats.Recordings = m_Manifests.size();
+
+        for (const auto& [name, manifest] : m_Manifests)
+        {
+            stats.Events += manifest.EventCount;
+            stats.ManifestBytes += manifest.FileSize;
+
+            for (const RecordingFormat::ChunkEntry& entry : manifest.Chunks)
+                stats.ReferencedBytes += entry.Size;
+        }
+
+        for (const auto& [hash, chunk] : m_Chunks)
+        {
+            if (chunk.References == 0)
+                continue;
+
+            stats.Chunks++;
+            stats.ChunkBytes += chunk.Size;
+        }
+
+        return stats;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Recording.h"
+#include "RecordingFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace KeyActions
+{
+    // Space used by a store, and what the same recordings would take as separate chunk sets
+    struct StoreStats
+    {
+        size_t Recordings = 0;
+        uint64_t Events = 0;
+        size_t Chunks = 0;              // Distinct chunks on disk
+        uint64_t ChunkBytes = 0;        // Encoded bytes of the distinct chunks
+        uint64_t ManifestBytes = 0;
+        uint64_t ReferencedBytes = 0;   // Encoded bytes of every chunk of every recording
+    };
+
+    // Deduplicating store for recordings that repeat long stretches of input, such as the
+    // same login sequence at the start of every session.
+    //
+    // Events are cut into chunks at content-defined boundaries: a rolling hash over the last
+    // few dozen events decides where a chunk ends, so the same run of events is cut the same
+    // way wherever it appears and whatever came before it. Each chunk is encoded with
+    // EventCodec, timestamps relative to its first event, and stored once under its hash in
+    // "chunks/". A recording is a manifest in "manifests/" listing its chunks in order.
+    //
+    // Chunks are written before the manifest that uses them and removed after the last one
+    // that used it, so a crash can only leave chunks nothing refers to; CollectGarbage()
+    // deletes those. A store is used from one thread at a time.
+    class RecordingStore
+    {
+    public:
+        static constexpr size_t MinChunkEvents = 256;
+        static constexpr size_t MaxChunkEvents = 8192;
+        static constexpr int AverageChunkBits = 10;   // A boundary every 1024 events past the minimum, on average
+
+        explicit RecordingStore(std::filesystem::path folder);
+
+        // Creates the folders if needed and reads every manifest to count chunk references.
+        // Damaged manifests are skipped; only failing to create the folders fails.
+        bool Open();
+
+        // Adds the recording under its name, replacing any recording of the same name.
+        // Fails if the name isn't valid.
+        bool Put(const Recording& recording);
+        bool Get(const std::string& name, Recording& recording) const;
+        bool Remove(const std::string& name);
+
+        bool Contains(const std::string& name) const { return m_Manifests.count(name) != 0; }
+
+        // Sorted by name
+        std::vector<std::string> List() const;
+
+        // Re-reads the manifests and deletes every chunk none of them lists, along with
+        // temporaries of writes whose process has exited. Returns the number of files deleted.
+        size_t CollectGarbage();
+
+        StoreStats GetStats() const;
+
+        // Manifests listing the chunk, counting a manifest once per listing
+        uint32_t GetReferenceCount(const RecordingFormat::ChunkHash& hash) const;
+
+        // A name becomes the manifest's file name, so it can't be empty, "." or "..", or hold a
+        // path separator that would place the manifest outside "manifests/"
+        static bool IsValidName(const std::string& name);
+
+        const std::filesystem::path& GetFolder() const { return m_Folder; }
+        std::filesystem::path GetManifestPath(const std::string& name) const;
+        std::filesystem::path GetChunkPath(const RecordingFormat::ChunkHash& hash) const;
+
+        // A chunk's address. Finding two chunks with one hash would take about 2^64 tries, so a
+        // stored chunk whose bytes differ from a new one with its hash is treated as an error.
+        static RecordingFormat::ChunkHash HashChunk(const uint8_t* data, size_t size);
+
+        // Index one past the last event of each chunk, in order
+        static std::vector<size_t> FindChunkEnds(const EventStore& events);
+
+    private:
+        struct Manifest
+        {
+            int64_t Duration = 0;
+            bool RecordsMouse = false;
+            uint64_t EventCount = 0;
+            uint64_t FileSize = 0;
+            std::vector<RecordingFormat::ChunkEntry> Chunks;
+        };
+
+        struct ChunkInfo
+        {
+            uint32_t Size = 0;
+            uint32_t References = 0;
+        };
+
+        // Returns false if any manifest could not be read
+        bool LoadManifests();
+        static bool ReadManifest(const std::filesystem::path& path, Manifest& manifest);
+
+        // Writes the chunk unless an identical one is already stored
+        bool StoreChunk(const RecordingFormat::ChunkHash& hash, const std::vector<uint8_t>& bytes);
+        bool ReadChunk(const RecordingFormat::ChunkEntry& entry, std::vector<uint8_t>& bytes) const;
+
+        void AddReferences(const Manifest& manifest);
+
+        // Deletes chunks that lose their last reference
+        void ReleaseReferences(const Manifest& manifest);
+
+    private:
+        std::filesystem::path m_Folder;
+        std::map<std::string, Manifest> m_Manifests;
+        struct ChunkHashKey
+        {
+            // SHA-256 bits are already uniform
+            size_t operator()(const RecordingFormat::ChunkHash& hash) const { return static_cast<size_t>(hash.Low); }
+        };
+
+        std::unordered_map<RecordingFormat::ChunkHash, ChunkInfo, ChunkHashKey> m_Chunks;
+    };
+}
\ No newline at end of file
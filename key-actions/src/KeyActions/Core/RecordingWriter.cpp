@@ -0,0 +1,199 @@
+#include "RecordingWriter.h"
+
+#include "RecordingFormat.h"
+
+#include "Lumina/Core/Log.h"
+
+namespace KeyActions
+{
+    RecordingWriter::~RecordingWriter()
+    {
+        if (IsOpen())
+        {
+            // Leave the file marked incomplete; it can still be recovered
+            StopThread();
+            m_File.close();
+        }
+    }
+
+    bool RecordingWriter::Open(const std::filesystem::path& filePath, const std::string& name, bool recordsMouse)
+    {
+        using namespace RecordingFormat;
+
+        if (IsOpen())
+        {
+            LUMINA_LOG_WARN("RecordingWriter is already open: {}", m_FilePath.string());
+            return false;
+        }
+
+        m_File.open(filePath, std::ios::binary | std::ios::trunc);
+        if (!m_File.is_open())
+        {
+            LUMINA_LOG_ERROR("Failed to open recording stream: {}", filePath.string());
+            return false;
+        }
+
+        m_FilePath = filePath;
+        m_Name = name;
+        m_Flags = recordsMouse ? static_cast<uint32_t>(FlagRecordsMouse) : 0u;
+        m_Failed = false;
+        m_WrittenEvents = 0;
+        m_WrittenRecords = 0;
+        m_StopRequested = false;
+
+        FileHeader header;
+        header.Flags = m_Flags | FlagIncomplete;
+        header.NameLength = static_cast<uint32_t>(name.size());
+        header.EventsOffset = GetEventsOffset(header.NameLength);
+        header.RecordSize = sizeof(EventRecord);
+
+        m_File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_File.write(name.data(), name.size());
+
+        const char padding[EventAlignment] = {};
+        m_File.write(padding, header.EventsOffset - sizeof(header) - header.NameLength);
+        m_File.flush();
+
+        if (!m_File)
+        {
+            LUMINA_LOG_ERROR("Failed to write recording stream header: {}", filePath.string());
+            m_File.close();
+            return false;
+        }
+
+        m_Thread = std::thread(&RecordingWriter::WriterThread, this);
+        return true;
+    }
+
+    void RecordingWriter::Submit(EventStore chunk)
+    {
+        if (chunk.IsEmpty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_Queue.push_back(std::move(chunk));
+        }
+
+        m_QueueCondition.notify_one();
+    }
+
+    void RecordingWriter::Flush()
+    {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_DrainedCondition.wait(lock, [this]() { return m_Queue.empty() && !m_Writing; });
+    }
+
+    bool RecordingWriter::Finalize(int64_t duration)
+    {
+        using namespace RecordingFormat;
+
+        if (!IsOpen())
+            return false;
+
+        StopThread();
+
+        FileHeader header;
+        header.Flags = m_Flags;
+        header.NameLength = static_cast<uint32_t>(m_Name.size());
+        header.RecordCount = m_WrittenRecords;
+        header.EventsOffset = GetEventsOffset(header.NameLength);
+        header.Duration = duration;
+        header.RecordSize = sizeof(EventRecord);
+
+        m_File.seekp(0);
+        m_File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_File.close();
+
+        if (!m_File || m_Failed)
+        {
+            LUMINA_LOG_ERROR("Failed to finalize recording stream: {}", m_FilePath.string());
+            return false;
+        }
+
+        return true;
+    }
+
+    void RecordingWriter::Discard()
+    {
+        if (!IsOpen())
+            return;
+
+        StopThread();
+        m_File.close();
+
+        std::error_code errorCode;
+        std::filesystem::remove(m_FilePath, errorCode);
+    }
+
+    void RecordingWriter::StopThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_StopRequested = true;
+        }
+
+        m_QueueCondition.notify_one();
+
+        if (m_Thread.joinable())
+        {
+            m_Thread.join();
+        }
+    }
+
+    void RecordingWriter::WriterThread()
+    {
+        using namespace RecordingFormat;
+
+        std::vector<EventRecord> records;
+        EventEncoder encoder;
+
+        while (true)
+        {
+            EventStore chunk;
+
+            {
+                std::unique_lock<std::mutex> lock(m_QueueMutex);
+                m_QueueCondition.wait(lock, [this]() { return !m_Queue.empty() || m_StopRequested; });
+
+                // Drain everything queued before honouring a stop request
+                if (m_Queue.empty())
+                    break;
+
+                chunk = std::move(m_Queue.front());
+                m_Queue.pop_front();
+                m_Writing = true;
+            }
+
+            records.clear();
+            records.reserve(chunk.Size());
+            for (const auto& event : chunk)
+            {
+                encoder.Encode(event, records);
+            }
+
+            m_File.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(EventRecord));
+            m_File.flush();
+
+            if (!m_File)
+            {
+                if (!m_Failed.exchange(true))
+                    LUMINA_LOG_ERROR("Failed to write to recording stream: {}", m_FilePath.string());
+            }
+            else
+            {
+                m_WrittenEvents += chunk.Size();
+                m_WrittenRecords += records.size();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_QueueMutex);
+                m_Writing = false;
+            }
+
+            m_DrainedCondition.notify_all();
+        }
+
+        m_DrainedCondition.notify_all();
+    }
+}
\ No newline at end of file
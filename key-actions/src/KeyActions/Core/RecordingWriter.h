@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Recording.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace KeyActions
+{
+    // Appends events to a binary .rec file from a background thread.
+    // The file header stays marked incomplete until Finalize(), so a file left
+    // behind by a crash can still be read back with Serialization::RecoverRecording.
+    class RecordingWriter
+    {
+    public:
+        RecordingWriter() = default;
+        ~RecordingWriter();
+
+        RecordingWriter(const RecordingWriter&) = delete;
+        RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+        bool Open(const std::filesystem::path& filePath, const std::string& name, bool recordsMouse);
+
+        // Queues a chunk of events for writing; never blocks on disk I/O
+        void Submit(EventStore chunk);
+
+        // Blocks until every submitted chunk has reached the OS
+        void Flush();
+
+        // Writes the final header and closes the file
+        bool Finalize(int64_t duration);
+
+        // Stops writing and deletes the file
+        void Discard();
+
+        bool IsOpen() const { return m_Thread.joinable(); }
+        bool HasFailed() const { return m_Failed; }
+        uint64_t GetWrittenEventCount() const { return m_WrittenEvents; }
+        const std::filesystem::path& GetFilePath() const { return m_FilePath; }
+
+    private:
+        void WriterThread();
+        void StopThread();
+
+    private:
+        std::filesystem::path m_FilePath;
+        std::ofstream m_File;
+        uint32_t m_Flags = 0;
+        std::string m_Name;
+
+        std::thread m_Thread;
+        std::mutex m_QueueMutex;
+        std::condition_variable m_QueueCondition;
+        std::condition_variable m_DrainedCondition;
+        std::deque<EventStore> m_Queue;
+        bool m_Writing = false;
+        bool m_StopRequested = false;
+
+        std::atomic<bool> m_Failed{ false };
+        std::atomic<uint64_t> m_WrittenEvents{ 0 };
+        uint64_t m_WrittenRecords = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace KeyActions
+{
+    // Append-only array stored in separately allocated segments. Growing allocates one more
+    // segment and never moves what is already stored, so a push costs the same at ten events
+    // or a hundred million and element addresses stay valid. Segments start at BaseSize
+    // elements and double until MaxSegmentSize, so small arrays stay small.
+    template<typename T, size_t BaseShift = 6, size_t SegmentShift = 14>
+    class SegmentedArray
+    {
+    public:
+        static constexpr size_t BaseSize = size_t(1) << BaseShift;
+        static constexpr size_t MaxSegmentSize = size_t(1) << SegmentShift;
+
+        class ConstIterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            ConstIterator() = default;
+            ConstIterator(const SegmentedArray* array, size_t index) : m_Array(array), m_Index(index) {}
+
+            reference operator*() const { return (*m_Array)[m_Index]; }
+            pointer operator->() const { return &(*m_Array)[m_Index]; }
+            reference operator[](difference_type offset) const { return (*m_Array)[m_Index + offset]; }
+
+            ConstIterator& operator++() { ++m_Index; return *this; }
+            ConstIterator operator++(int) { ConstIterator copy = *this; ++m_Index; return copy; }
+            ConstIterator& operator--() { --m_Index; return *this; }
+            ConstIterator operator--(int) { ConstIterator copy = *this; --m_Index; return copy; }
+
+            ConstIterator& operator+=(difference_type offset) { m_Index += offset; return *this; }
+            ConstIterator& operator-=(difference_type offset) { m_Index -= offset; return *this; }
+            ConstIterator operator+(difference_type offset) const { return ConstIterator(m_Array, m_Index + offset); }
+            ConstIterator operator-(difference_type offset) const { return ConstIterator(m_Array, m_Index - offset); }
+            friend ConstIterator operator+(difference_type offset, const ConstIterator& it) { return it + offset; }
+
+            difference_type operator-(const ConstIterator& other) const
+            {
+                return static_cast<difference_type>(m_Index) - static_cast<difference_type>(other.m_Index);
+            }
+
+            bool operator==(const ConstIterator& other) const { return m_Index == other.m_Index; }
+            bool operator!=(const ConstIterator& other) const { return m_Index != other.m_Index; }
+            bool operator<(const ConstIterator& other) const { return m_Index < other.m_Index; }
+            bool operator>(const ConstIterator& other) const { return m_Index > other.m_Index; }
+            bool operator<=(const ConstIterator& other) const { return m_Index <= other.m_Index; }
+            bool operator>=(const ConstIterator& other) const { return m_Index >= other.m_Index; }
+
+        private:
+            const SegmentedArray* m_Array = nullptr;
+            size_t m_Index = 0;
+        };
+
+        SegmentedArray() = default;
+        SegmentedArray(SegmentedArray&&) noexcept = default;
+        SegmentedArray& operator=(SegmentedArray&&) noexcept = default;
+
+        SegmentedArray(const SegmentedArray& other)
+        {
+            *this = other;
+        }
+
+        SegmentedArray& operator=(const SegmentedArray& other)
+        {
+            if (this == &other)
+                return *this;
+
+            clear();
+            reserve(other.size());
+            for (size_t i = 0; i < other.size(); i++)
+                push_back(other[i]);
+
+            return *this;
+        }
+
+        void push_back(const T& value)
+        {
+            size_t physical = m_Front + m_Size;
+            size_t segment = SegmentOf(physical);
+
+            if (segment >= m_Segments.size() || !m_Segments[segment])
+                Allocate(segment);
+
+            m_Segments[segment][physical - SegmentStart(segment)] = value;
+            m_Size++;
+        }
+
+        T& operator[](size_t index) { return At(m_Front + index); }
+        const T& operator[](size_t index) const { return const_cast<SegmentedArray*>(this)->At(m_Front + index); }
+
+        T& back() { return (*this)[m_Size - 1]; }
+        const T& back() const { return (*this)[m_Size - 1]; }
+
+        size_t size() const { return m_Size; }
+        bool empty() const { return m_Size == 0; }
+
+        ConstIterator begin() const { return ConstIterator(this, 0); }
+        ConstIterator end() const { return ConstIterator(this, m_Size); }
+
+        // Allocates the segments needed to hold count elements without further allocation
+        void reserve(size_t count)
+        {
+            if (count == 0)
+                return;
+
+            size_t last = SegmentOf(m_Front + count - 1);
+            for (size_t segment = SegmentOf(m_Front + m_Size); segment <= last; segment++)
+            {
+                if (segment >= m_Segments.size() || !m_Segments[segment])
+                    Allocate(segment);
+            }
+        }
+
+        void clear()
+        {
+            m_Segments.clear();
+            m_Front = 0;
+            m_Size = 0;
+        }
+
+        // Drops the first count elements. Segments that become empty are freed; nothing moves.
+        void erase_front(size_t count)
+        {
+            count = std::min(count, m_Size);
+            m_Front += count;
+            m_Size -= count;
+
+            if (m_Size == 0)
+            {
+                clear();
+                return;
+            }
+
+            size_t first = SegmentOf(m_Front);
+            for (size_t segment = 0; segment < first && segment < m_Segments.size(); segment++)
+                m_Segments[segment].reset();
+        }
+
+        // Elements the allocated segments can hold
+        size_t capacity() const
+        {
+            size_t total = 0;
+            for (size_t segment = 0; segment < m_Segments.size(); segment++)
+            {
+                if (m_Segments[segment])
+                    total += SegmentSize(segment);
+            }
+            return total;
+        }
+
+    private:
+        static constexpr size_t FirstFixedSegment = SegmentShift - BaseShift + 1;
+
+        // Segment 0 and 1 hold BaseSize elements, each one after that twice the previous,
+        // up to MaxSegmentSize. Physical index i lives in segment SegmentOf(i).
+        static size_t SegmentOf(size_t physical)
+        {
+            if (physical < MaxSegmentSize)
+                return static_cast<size_t>(std::bit_width(physical >> BaseShift));
+
+            return FirstFixedSegment + ((physical - MaxSegmentSize) >> SegmentShift);
+        }
+
+        static size_t SegmentStart(size_t segment)
+        {
+            if (segment < FirstFixedSegment)
+                return segment == 0 ? 0 : BaseSize << (segment - 1);
+
+            return MaxSegmentSize + ((segment - FirstFixedSegment) << SegmentShift);
+        }
+
+        static size_t SegmentSize(size_t segment)
+        {
+            if (segment < FirstFixedSegment)
+                return segment == 0 ? BaseSize : BaseSize << (segment - 1);
+
+            return MaxSegmentSize;
+        }
+
+        T& At(size_t physical)
+        {
+            size_t segment = SegmentOf(physical);
+            return m_Segments[segment][physical - SegmentStart(segment)];
+        }
+
+        void Allocate(size_t segment)
+        {
+            if (segment >= m_Segments.size())
+                m_Segments.resize(segment + 1);
+
+            // Default-initialized; elements are written before they are read
+            m_Segments[segment].reset(new T[SegmentSize(segment)]);
+        }
+
+    private:
+        std::vector<std::unique_ptr<T[]>> m_Segments;
+        size_t m_Front = 0;     // Physical index of element 0, advanced by erase_front()
+        size_t m_Size = 0;
+    };
+}
\ No newline at end of file
@@ -3,20 +3,41 @@
 #include "Lumina/Core/Log.h"
 
 #include "Settings.h"
+#include "AtomicFile.h"
+#include "EventCodec.h"
+#include "JsonRecordingReader.h"
+#include "MappedFile.h"
+#include "RecordingFormat.h"
+#include "RecordingLibrary.h"
 
 #include <fstream>
 #include <filesystem>
+#include <cstring>
+#include <algorithm>
 #include <json.hpp>
 
 using json = nlohmann::json;
 
 namespace KeyActions
 {
+    namespace
+    {
+        // Records between progress reports on reads; writes report once per batch
+        constexpr uint64_t ProgressInterval = 65536;
+
+        bool ReportProgress(const Serialization::ProgressCallback& progress, uint64_t done, uint64_t total)
+        {
+            return !progress || progress(total > 0 ? static_cast<float>(done) / total : 1.0f);
+        }
+    }
+
     bool Serialization::SaveRecording(const Recording& recording, const std::string& folderPath)
     {
-        const auto& settings = Settings::Data();
-        std::filesystem::path recordingsFolder = settings.RecordingsFolder; 
+        return SaveRecordingTo(recording, Settings::Data().RecordingsFolder);
+    }
 
+    bool Serialization::SaveRecordingTo(const Recording& recording, const std::filesystem::path& recordingsFolder, const ProgressCallback& progress)
+    {
         if (!std::filesystem::exists(recordingsFolder))
         {
             std::error_code errorCode;
@@ -36,19 +57,636 @@ namespace KeyActions
             LUMINA_LOG_INFO("Overwriting existing recording: {}", filePath.string());
         }
 
+        if (!WriteCompressed(recording, filePath, progress))
+            return false;
+
+        // Keep the library index current so the recordings list does not have to reopen this file
+        RecordingLibrary library(recordingsFolder);
+        library.Load();
+        if (library.Update(filePath))
+            library.Save();
+
+        return true;
+    }
+
+    bool Serialization::LoadRecording(Recording& recording, const std::string& filename, const ProgressCallback& progress)
+    {
+        std::filesystem::path filePath = filename;
+
+        // Absolute paths never touch Settings, so they can be loaded from any thread
+        if (!filePath.is_absolute())
+        {
+            filePath = Settings::Data().RecordingsFolder / filename;
+        }
+
+        uint16_t version = GetBinaryVersion(filePath);
+        bool loaded = version != 0 ? ReadBinary(recording, filePath, progress) : ImportJson(recording, filePath, progress);
+
+        if (!loaded)
+            return false;
+
+        // Version 1 binaries stored float seconds; rewrite them with integer timestamps. JSON
+        // files, whatever their extension, are the user's and only change on an explicit save.
+        if (version == RecordingFormat::LegacyVersion)
+        {
+            if (WriteCompressed(recording, filePath))
+                LUMINA_LOG_INFO("Migrated recording to format version {}: {}", RecordingFormat::CompressedVersion, filePath.string());
+        }
+
+        return true;
+    }
+
+    std::vector<std::string> Serialization::GetAvailableRecordings(const std::string& folderPath)
+    {
+        const auto& settings = Settings::Data();
+        std::filesystem::path recordingsFolder = settings.RecordingsFolder;
+
+        std::vector<std::string> recordings;
+
+        if (!std::filesystem::exists(recordingsFolder))
+        {
+            LUMINA_LOG_WARN("Recordings folder does not exist: {}", recordingsFolder.string());
+            return recordings;
+        }
+
+        try
+        {
+            for (const auto& entry : std::filesystem::directory_iterator(recordingsFolder))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".rec")
+                {
+                    recordings.push_back(entry.path().stem().string());
+                }
+            }
+        }
+        catch (const std::filesystem::filesystem_error& e)
+        {
+            LUMINA_LOG_ERROR("Error reading recordings directory: {}", e.what());
+        }
+
+        return recordings;
+    }
+
+    bool Serialization::WriteBinary(const Recording& recording, const std::filesystem::path& filePath, const ProgressCallback& progress)
+    {
+        using namespace RecordingFormat;
+
+        // Written beside the target and renamed over it, so an interrupted save never truncates a recording
+        AtomicFile file;
+        if (!file.Open(filePath))
+        {
+            LUMINA_LOG_ERROR("Failed to open recording file for writing: {}", filePath.string());
+            return false;
+        }
+
+        FileHeader header;
+        header.Flags = recording.RecordsMouse ? static_cast<uint32_t>(FlagRecordsMouse) : 0u;
+        header.NameLength = static_cast<uint32_t>(recording.Name.size());
+        header.EventsOffset = GetEventsOffset(header.NameLength);
+        header.Duration = recording.Duration;
+        header.RecordSize = sizeof(EventRecord);
+
+        // The record count is only known after encoding; the header is rewritten at the end
+        file.Write(&header, sizeof(header));
+        file.Write(recording.Name.data(), recording.Name.size());
+
+        const char padding[EventAlignment] = {};
+        file.Write(padding, header.EventsOffset - sizeof(header) - header.NameLength);
+
+        // Pack into a fixed buffer so large recordings are written in a few big writes
+        constexpr size_t BatchSize = 4096;
+        std::vector<EventRecord> batch;
+        batch.reserve(BatchSize + 1);
+
+        EventEncoder encoder;
+        size_t encoded = 0;
+        for (const auto& event : recording.Events)
+        {
+            encoder.Encode(event, batch);
+            encoded++;
+
+            if (batch.size() >= BatchSize)
+            {
+                file.Write(batch.data(), batch.size() * sizeof(EventRecord));
+                header.RecordCount += batch.size();
+                batch.clear();
+
+                if (!ReportProgress(progress, encoded, recording.Events.Size()))
+                {
+                    file.Abort();
+                    LUMINA_LOG_INFO("Cancelled writing recording: {}", filePath.string());
+                    return false;
+                }
+            }
+        }
+
+        if (!batch.empty())
+        {
+            file.Write(batch.data(), batch.size() * sizeof(EventRecord));
+            header.RecordCount += batch.size();
+        }
+
+        file.WriteAt(0, &header, sizeof(header));
+
+        if (!file.Commit())
+        {
+            LUMINA_LOG_ERROR("Failed to write recording: {}", filePath.string());
+            return false;
+        }
+
+        LUMINA_LOG_INFO("Saved recording: {}", filePath.string());
+        return true;
+    }
+
+    bool Serialization::WriteCompressed(const Recording& recording, const std::filesystem::path& filePath, const ProgressCallback& progress, bool entropy, TaskPool* pool)
+    {
+        using namespace RecordingFormat;
+
+        AtomicFile file;
+        if (!file.Open(filePath))
+        {
+            LUMINA_LOG_ERROR("Failed to open recording file for writing: {}", filePath.string());
+            return false;
+        }
+
+        size_t eventCount = recording.Events.Size();
+
+        FileHeader header;
+        header.Version = CompressedVersion;
+        header.Flags = recording.RecordsMouse ? static_cast<uint32_t>(FlagRecordsMouse) : 0u;
+        header.NameLength = static_cast<uint32_t>(recording.Name.size());
+        header.RecordCount = (eventCount + EventsPerBlock - 1) / EventsPerBlock;
+        header.EventsOffset = GetEventsOffset(header.NameLength);
+        header.Duration = recording.Duration;
+        header.RecordSize = sizeof(BlockEntry);
+
+        file.Write(&header, sizeof(header));
+        file.Write(recording.Name.data(), recording.Name.size());
+
+        const char padding[EventAlignment] = {};
+        file.Write(padding, header.EventsOffset - sizeof(header) - header.NameLength);
+
+        // The block table is filled in as blocks are written and rewritten at the end
+        std::vector<BlockEntry> blocks(header.RecordCount);
+        file.Write(blocks.data(), blocks.size() * sizeof(BlockEntry));
+
+        uint64_t offset = header.EventsOffset + blocks.size() * sizeof(BlockEntry);
+
+        // Blocks encode independently, so a pool encodes a batch at a time and they are written in order
+        size_t batchSize = pool ? pool->GetThreadCount() * 2 : 1;
+        std::vector<std::vector<uint8_t>> encoded(batchSize);
+
+        for (size_t batchStart = 0; batchStart < blocks.size(); batchStart += batchSize)
+        {
+            size_t batchCount = std::min(batchSize, blocks.size() - batchStart);
+
+            auto encode = [&](size_t i) {
+                size_t first = (batchStart + i) * EventsPerBlock;
+                size_t count = std::min<size_t>(EventsPerBlock, eventCount - first);
+
+                encoded[i].clear();
+                EventCodec::EncodeBlock(recording.Events, first, count, entropy, encoded[i]);
+            };
+
+            if (pool)
+                pool->ParallelFor(batchCount, encode);
+            else
+                encode(0);
+
+            for (size_t i = 0; i < batchCount; i++)
+            {
+                size_t first = (batchStart + i) * EventsPerBlock;
+                size_t count = std::min<size_t>(EventsPerBlock, eventCount - first);
+
+                file.Write(encoded[i].data(), encoded[i].size());
+
+                BlockEntry& block = blocks[batchStart + i];
+                block.Offset = offset;
+                block.FirstTimestamp = recording.Events[first].GetTimestamp();
+                block.Size = static_cast<uint32_t>(encoded[i].size());
+                block.EventCount = static_cast<uint32_t>(count);
+                offset += encoded[i].size();
+            }
+
+            size_t written = std::min<size_t>((batchStart + batchCount) * EventsPerBlock, eventCount);
+            if (!ReportProgress(progress, written, eventCount))
+            {
+                file.Abort();
+                LUMINA_LOG_INFO("Cancelled writing recording: {}", filePath.string());
+                return false;
+            }
+        }
+
+        file.WriteAt(header.EventsOffset, blocks.data(), blocks.size() * sizeof(BlockEntry));
+
+        if (!file.Commit())
+        {
+            LUMINA_LOG_ERROR("Failed to write recording: {}", filePath.string());
+            return false;
+        }
+
+        LUMINA_LOG_INFO("Saved recording: {}", filePath.string());
+        return true;
+    }
+
+    bool Serialization::CompressStream(const std::filesystem::path& streamPath, const std::filesystem::path& filePath)
+    {
+        using namespace RecordingFormat;
+
+        MappedFile mapping;
+        if (!mapping.Open(streamPath) || mapping.GetSize() < sizeof(FileHeader))
+            return false;
+
+        FileHeader source;
+        std::memcpy(&source, mapping.GetData(), sizeof(FileHeader));
+
+        if (!ValidateHeader(source, mapping.GetSize()) || (source.Flags & FlagIncomplete) != 0)
+        {
+            LUMINA_LOG_ERROR("Not a finished recording stream: {}", streamPath.string());
+            return false;
+        }
+
+        const uint8_t* data = mapping.GetData();
+        const auto* records = reinterpret_cast<const EventRecord*>(data + source.EventsOffset);
+
+        // The block table goes first, so count the events before writing any block
+        uint64_t eventCount = 0;
+        for (uint64_t i = 0; i < source.RecordCount; i++)
+        {
+            if (records[i].Action != RecordTimeGap)
+                eventCount++;
+        }
+
+        AtomicFile file;
+        if (!file.Open(filePath))
+        {
+            LUMINA_LOG_ERROR("Failed to open recording file for writing: {}", filePath.string());
+            return false;
+        }
+
+        FileHeader header;
+        header.Version = CompressedVersion;
+        header.Flags = source.Flags & FlagRecordsMouse;
+        header.NameLength = source.NameLength;
+        header.RecordCount = (eventCount + EventsPerBlock - 1) / EventsPerBlock;
+        header.EventsOffset = GetEventsOffset(header.NameLength);
+        header.Duration = source.Duration;
+        header.RecordSize = sizeof(BlockEntry);
+
+        file.Write(&header, sizeof(header));
+        file.Write(data + source.HeaderSize, header.NameLength);
+
+        const char padding[EventAlignment] = {};
+        file.Write(padding, header.EventsOffset - sizeof(header) - header.NameLength);
+
+        std::vector<BlockEntry> blocks(header.RecordCount);
+        file.Write(blocks.data(), blocks.size() * sizeof(BlockEntry));
+
+        uint64_t offset = header.EventsOffset + blocks.size() * sizeof(BlockEntry);
+
+        // One block of events in memory at a time, however long the stream
+        EventStore block;
+        block.Reserve(EventsPerBlock);
+        std::vector<uint8_t> encoded;
+        size_t blockIndex = 0;
+
+        auto writeBlock = [&]() {
+            encoded.clear();
+            EventCodec::EncodeBlock(block, 0, block.Size(), true, encoded);
+            file.Write(encoded.data(), encoded.size());
+
+            BlockEntry& entry = blocks[blockIndex++];
+            entry.Offset = offset;
+            entry.FirstTimestamp = block[0].GetTimestamp();
+            entry.Size = static_cast<uint32_t>(encoded.size());
+            entry.EventCount = static_cast<uint32_t>(block.Size());
+            offset += encoded.size();
+
+            block.Clear();
+        };
+
+        EventDecoder decoder;
+        RecordedEvent event;
+        for (uint64_t i = 0; i < source.RecordCount; i++)
+        {
+            if (!decoder.Decode(records[i], event))
+                continue;
+
+            block.Add(event);
+            if (block.Size() == EventsPerBlock)
+                writeBlock();
+        }
+
+        if (!block.IsEmpty())
+            writeBlock();
+
+        file.WriteAt(header.EventsOffset, blocks.data(), blocks.size() * sizeof(BlockEntry));
+
+        if (!file.Commit())
+        {
+            LUMINA_LOG_ERROR("Failed to write recording: {}", filePath.string());
+            return false;
+        }
+
+        return true;
+    }
+
+    namespace
+    {
+        bool ReadCompressedRecords(Recording& recording, const MappedFile& mapping, const Serialization::ProgressCallback& progress, bool& cancelled)
+        {
+            using namespace RecordingFormat;
+
+            FileHeader header;
+            if (mapping.GetSize() < sizeof(FileHeader))
+                return false;
+
+            std::memcpy(&header, mapping.GetData(), sizeof(FileHeader));
+
+            const uint8_t* data = mapping.GetData();
+            const auto* blocks = reinterpret_cast<const BlockEntry*>(data + header.EventsOffset);
+
+            if (!ValidateCompressedHeader(header, mapping.GetSize()) || !ValidateBlocks(header, blocks, mapping.GetSize()))
+                return false;
+
+            uint64_t eventCount = 0;
+            for (uint64_t i = 0; i < header.RecordCount; i++)
+                eventCount += blocks[i].EventCount;
+
+            recording.Name.assign(reinterpret_cast<const char*>(data + header.HeaderSize), header.NameLength);
+            recording.RecordsMouse = (header.Flags & FlagRecordsMouse) != 0;
+            recording.Duration = header.Duration;
+
+            recording.Events.Clear();
+            recording.Events.Reserve(eventCount);
+
+            for (uint64_t i = 0; i < header.RecordCount; i++)
+            {
+                const BlockEntry& block = blocks[i];
+                if (!EventCodec::DecodeBlock(data + block.Offset, block.Size, block.FirstTimestamp, block.EventCount, recording.Events))
+                    return false;
+
+                if (!ReportProgress(progress, recording.Events.Size(), eventCount))
+                {
+                    cancelled = true;
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool ReadRecords(Recording& recording, const MappedFile& mapping, bool& incomplete, const Serialization::ProgressCallback& progress, bool& cancelled)
+        {
+            using namespace RecordingFormat;
+
+            FileHeader header;
+            if (mapping.GetSize() < sizeof(FileHeader))
+                return false;
+
+            std::memcpy(&header, mapping.GetData(), sizeof(FileHeader));
+
+            if (!ValidateHeader(header, mapping.GetSize()))
+                return false;
+
+            const uint8_t* data = mapping.GetData();
+            const auto* records = reinterpret_cast<const EventRecord*>(data + header.EventsOffset);
+
+            uint64_t recordCount = GetReadableRecordCount(header, mapping.GetSize());
+
+            recording.Name.assign(reinterpret_cast<const char*>(data + header.HeaderSize), header.NameLength);
+            recording.RecordsMouse = (header.Flags & FlagRecordsMouse) != 0;
+            recording.Duration = header.Duration;
+
+            recording.Events.Clear();
+            recording.Events.Reserve(recordCount);
+
+            EventDecoder decoder;
+            RecordedEvent event;
+            for (uint64_t i = 0; i < recordCount; i++)
+            {
+                if (decoder.Decode(records[i], event))
+                    recording.Events.Add(event);
+
+                if ((i + 1) % ProgressInterval == 0 && !ReportProgress(progress, i + 1, recordCount))
+                {
+                    cancelled = true;
+                    return false;
+                }
+            }
+
+            incomplete = (header.Flags & FlagIncomplete) != 0;
+            return true;
+        }
+
+        bool ReadLegacyRecords(Recording& recording, const MappedFile& mapping, bool& incomplete, const Serialization::ProgressCallback& progress, bool& cancelled)
+        {
+            using namespace RecordingFormat;
+
+            LegacyFileHeader header;
+            if (mapping.GetSize() < sizeof(LegacyFileHeader))
+                return false;
+
+            std::memcpy(&header, mapping.GetData(), sizeof(LegacyFileHeader));
+
+            if (!ValidateHeader(header, mapping.GetSize()))
+                return false;
+
+            const uint8_t* data = mapping.GetData();
+            const auto* records = reinterpret_cast<const LegacyEventRecord*>(data + header.EventsOffset);
+
+            uint64_t recordCount = GetReadableRecordCount(header, mapping.GetSize());
+
+            recording.Name.assign(reinterpret_cast<const char*>(data + header.HeaderSize), header.NameLength);
+            recording.RecordsMouse = (header.Flags & FlagRecordsMouse) != 0;
+            recording.Duration = Clock::FromSeconds(header.TotalDuration);
+
+            recording.Events.Clear();
+            recording.Events.Reserve(recordCount);
+
+            for (uint64_t i = 0; i < recordCount; i++)
+            {
+                recording.Events.Add(UnpackLegacyEvent(records[i]));
+
+                if ((i + 1) % ProgressInterval == 0 && !ReportProgress(progress, i + 1, recordCount))
+                {
+                    cancelled = true;
+                    return false;
+                }
+            }
+
+            incomplete = (header.Flags & FlagIncomplete) != 0;
+            return true;
+        }
+    }
+
+    bool Serialization::ReadBinary(Recording& recording, const std::filesystem::path& filePath, const ProgressCallback& progress)
+    {
+        using namespace RecordingFormat;
+
+        MappedFile mapping;
+        if (!mapping.Open(filePath))
+        {
+            LUMINA_LOG_ERROR("Failed to open recording file: {}", filePath.string());
+            return false;
+        }
+
+        bool incomplete = false;
+        bool cancelled = false;
+        bool loaded = false;
+
+        switch (ReadVersion(mapping.GetData(), mapping.GetSize()))
+        {
+        case Version:
+            loaded = ReadRecords(recording, mapping, incomplete, progress, cancelled);
+            break;
+        case LegacyVersion:
+            loaded = ReadLegacyRecords(recording, mapping, incomplete, progress, cancelled);
+            break;
+        case CompressedVersion:
+            loaded = ReadCompressedRecords(recording, mapping, progress, cancelled);
+            break;
+        }
+
+        if (cancelled)
+        {
+            recording.Events.Clear();
+            LUMINA_LOG_INFO("Cancelled loading recording: {}", filePath.string());
+            return false;
+        }
+
+        if (!loaded)
+        {
+            recording.Events.Clear();
+            LUMINA_LOG_ERROR("Invalid or unsupported recording file: {}", filePath.string());
+            return false;
+        }
+
+        if (incomplete)
+        {
+            // The stream was never finalized, so the duration ends at the last event on disk
+            recording.Duration = recording.Events.IsEmpty() ? 0 : recording.Events.Back().GetTimestamp();
+            LUMINA_LOG_WARN("Recording was not finalized, recovered {} events: {}", recording.Events.Size(), filePath.string());
+        }
+
+        LUMINA_LOG_INFO("Loaded recording: {}", filePath.string());
+        return true;
+    }
+
+    std::filesystem::path Serialization::GetRecordingPath(const std::string& name)
+    {
+        return Settings::Data().RecordingsFolder / (name + ".rec");
+    }
+
+    bool Serialization::RecoverRecording(const std::filesystem::path& partialPath)
+    {
+        Recording recording;
+        if (!ReadBinary(recording, partialPath))
+            return false;
+
+        std::filesystem::path finalPath = partialPath;
+        finalPath.replace_extension(); // strip ".part"
+
+        if (!WriteCompressed(recording, finalPath))
+            return false;
+
+        std::error_code errorCode;
+        std::filesystem::remove(partialPath, errorCode);
+
+        LUMINA_LOG_INFO("Recovered recording: {} ({} events)", finalPath.string(), recording.Events.Size());
+        return true;
+    }
+
+    bool Serialization::IsAbandonedSave(const std::filesystem::path& filePath)
+    {
+        // The folder is the user's; other programs' ".tmp" files and saves still running are left alone
+        std::filesystem::path targetPath;
+        uint64_t process = 0;
+        if (!AtomicFile::ParseTemporaryPath(filePath, targetPath, process))
+            return false;
+
+        std::filesystem::path extension = targetPath.extension();
+        return (extension == ".rec" || extension == ".json") && AtomicFile::IsAbandonedTemporary(filePath);
+    }
+
+    size_t Serialization::RecoverPartialRecordings()
+    {
+        std::filesystem::path recordingsFolder = Settings::Data().RecordingsFolder;
+        size_t recovered = 0;
+
+        std::error_code errorCode;
+        if (!std::filesystem::exists(recordingsFolder, errorCode))
+            return recovered;
+
+        std::vector<std::filesystem::path> partialFiles;
+        std::vector<std::filesystem::path> temporaryFiles;
+        for (const auto& entry : std::filesystem::directory_iterator(recordingsFolder, errorCode))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".part")
+            {
+                partialFiles.push_back(entry.path());
+            }
+            else if (entry.is_regular_file() && IsAbandonedSave(entry.path()))
+            {
+                temporaryFiles.push_back(entry.path());
+            }
+        }
+
+        for (const auto& path : partialFiles)
+        {
+            if (RecoverRecording(path))
+                recovered++;
+        }
+
+        // An interrupted save never replaced its target, so the temporary is all that is lost
+        for (const auto& path : temporaryFiles)
+        {
+            if (std::filesystem::remove(path, errorCode))
+                LUMINA_LOG_WARN("Removed unfinished save: {}", path.string());
+        }
+
+        return recovered;
+    }
+
+    bool Serialization::IsBinaryRecording(const std::filesystem::path& filePath)
+    {
+        return GetBinaryVersion(filePath) != 0;
+    }
+
+    uint16_t Serialization::GetBinaryVersion(const std::filesystem::path& filePath)
+    {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open())
+            return 0;
+
+        uint8_t prefix[sizeof(uint32_t) + sizeof(uint16_t)] = {};
+        file.read(reinterpret_cast<char*>(prefix), sizeof(prefix));
+
+        if (!file)
+            return 0;
+
+        return RecordingFormat::ReadVersion(prefix, sizeof(prefix));
+    }
+
+    bool Serialization::ExportJson(const Recording& recording, const std::filesystem::path& filePath)
+    {
         try
         {
             json j;
             j["name"] = recording.Name;
             j["recordsMouse"] = recording.RecordsMouse;
-            j["totalDuration"] = recording.TotalDuration;
+            j["duration"] = recording.Duration;
+            j["totalDuration"] = recording.GetDurationSeconds(); // For older versions, which read float seconds
 
             json eventsArray = json::array();
-            for (const auto& event : recording.Events)
+            for (const auto& view : recording.Events)
             {
+                const RecordedEvent event = view.ToEvent();
+
                 json eventJson;
                 eventJson["action"] = static_cast<int>(event.Action);
-                eventJson["time"] = event.Time;
+                eventJson["timestamp"] = event.Timestamp;
+                eventJson["time"] = Clock::ToSeconds(event.Timestamp);
 
                 if (event.Action == RecordedAction::KeyPressed || event.Action == RecordedAction::KeyReleased)
                 {
@@ -76,36 +714,62 @@ namespace KeyActions
 
             j["events"] = eventsArray;
 
-            std::ofstream file(filePath);
-            file << j.dump(2);
-            file.close();
+            std::string text = j.dump(2);
 
-            LUMINA_LOG_INFO("Saved recording: {}", filePath.string());
+            // Exports can replace the JSON file they were imported from, so they get the same
+            // all-or-nothing write as recordings
+            AtomicFile file;
+            if (!file.Open(filePath))
+            {
+                LUMINA_LOG_ERROR("Failed to open export file for writing: {}", filePath.string());
+                return false;
+            }
+
+            file.Write(text.data(), text.size());
+
+            if (!file.Commit())
+            {
+                LUMINA_LOG_ERROR("Failed to write export file: {}", filePath.string());
+                return false;
+            }
+
+            LUMINA_LOG_INFO("Exported recording: {}", filePath.string());
             return true;
         }
         catch (const std::exception& e)
         {
-            LUMINA_LOG_ERROR("Failed to save recording: {}", e.what());
+            LUMINA_LOG_ERROR("Failed to export recording: {}", e.what());
             return false;
         }
     }
 
-    bool Serialization::LoadRecording(Recording& recording, const std::string& filename)
+    bool Serialization::ImportJson(Recording& recording, const std::filesystem::path& filePath, const ProgressCallback& progress)
     {
-        const auto& settings = Settings::Data();
-		std::filesystem::path recordingsFolder = settings.RecordingsFolder;
-
-        std::filesystem::path filePath = recordingsFolder;
-
-        if (std::filesystem::path(recordingsFolder).is_absolute())
-        {
-            filePath = recordingsFolder;
-        }
-        else
         {
-            filePath = recordingsFolder / filename;
+            MappedFile mapping;
+            if (mapping.Open(filePath))
+            {
+                const char* text = reinterpret_cast<const char*>(mapping.GetData());
+
+                switch (JsonRecordingReader::Read(recording, text, mapping.GetSize(), progress))
+                {
+                case JsonRecordingReader::Result::Loaded:
+                    LUMINA_LOG_INFO("Loaded recording: {}", filePath.string());
+                    return true;
+                case JsonRecordingReader::Result::Cancelled:
+                    return false;
+                case JsonRecordingReader::Result::Unrecognized:
+                    break;
+                }
+            }
         }
 
+        // Hand-edited files, and anything malformed, which this reports properly
+        return ImportJsonDocument(recording, filePath);
+    }
+
+    bool Serialization::ImportJsonDocument(Recording& recording, const std::filesystem::path& filePath)
+    {
         try
         {
 			std::ifstream file(filePath);
@@ -121,14 +785,17 @@ namespace KeyActions
 
             recording.Name = j["name"];
             recording.RecordsMouse = j["recordsMouse"];
-            recording.TotalDuration = j["totalDuration"];
 
-            recording.Events.clear();
+            // Files written before integer timestamps store only float seconds
+            bool legacyTimes = !j.contains("duration");
+            recording.Duration = legacyTimes ? Clock::FromSeconds(j["totalDuration"].get<double>()) : j["duration"].get<int64_t>();
+
+            recording.Events.Clear();
             for (const auto& eventJson : j["events"])
             {
                 RecordedEvent event;
                 event.Action = static_cast<RecordedAction>(eventJson["action"]);
-                event.Time = eventJson["time"];
+                event.Timestamp = legacyTimes ? Clock::FromSeconds(eventJson["time"].get<double>()) : eventJson["timestamp"].get<int64_t>();
 
                 if (event.Action == RecordedAction::KeyPressed || event.Action == RecordedAction::KeyReleased)
                 {
@@ -151,7 +818,7 @@ namespace KeyActions
                     event.ScrollDY = eventJson["dy"];
                 }
 
-                recording.Events.push_back(event);
+                recording.Events.Add(event);
             }
 
             LUMINA_LOG_INFO("Loaded recording: {}", filePath.string());
@@ -163,35 +830,4 @@ namespace KeyActions
             return false;
         }
     }
-
-    std::vector<std::string> Serialization::GetAvailableRecordings(const std::string& folderPath)
-    {
-        const auto& settings = Settings::Data();
-        std::filesystem::path recordingsFolder = settings.RecordingsFolder;
-
-        std::vector<std::string> recordings;
-
-        if (!std::filesystem::exists(recordingsFolder))
-        {
-            LUMINA_LOG_WARN("Recordings folder does not exist: {}", recordingsFolder.string());
-            return recordings;
-        }
-
-        try
-        {
-            for (const auto& entry : std::filesystem::directory_iterator(recordingsFolder))
-            {
-                if (entry.is_regular_file() && entry.path().extension() == ".rec")
-                {
-                    recordings.push_back(entry.path().stem().string());
-                }
-            }
-        }
-        catch (const std::filesystem::filesystem_error& e)
-        {
-            LUMINA_LOG_ERROR("Error reading recordings directory: {}", e.what());
-        }
-
-        return recordings;
-    }
 }
\ No newline at end of file
@@ -1,16 +1,60 @@
 #pragma once
 
 #include "Recording.h"
+#include "TaskPool.h"
 
 #include <string>
+#include <filesystem>
+#include <functional>
 
 namespace KeyActions
 {
     class Serialization
     {
     public:
+        // Called periodically by long reads and writes with the fraction done. Returning false
+        // cancels: a cancelled read leaves the recording empty, a cancelled write leaves the
+        // existing file untouched.
+        using ProgressCallback = std::function<bool(float progress)>;
+
+        // Saves in the compressed .rec format; loading accepts every binary version and legacy JSON files
         static bool SaveRecording(const Recording& recording, const std::string& folderPath = "recordings");
-        static bool LoadRecording(Recording& recording, const std::string& filename);
+        static bool SaveRecordingTo(const Recording& recording, const std::filesystem::path& recordingsFolder, const ProgressCallback& progress = {});
+        static bool LoadRecording(Recording& recording, const std::string& filename, const ProgressCallback& progress = {});
         static std::vector<std::string> GetAvailableRecordings(const std::string& folderPath = "recordings");
+
+        // Writes to a temporary beside the file, flushes it to disk and renames it over the file
+        static bool WriteBinary(const Recording& recording, const std::filesystem::path& filePath, const ProgressCallback& progress = {});
+
+        // Same, in the block-compressed format saved recordings use. Entropy coding roughly
+        // halves the size again over the delta and varint packing alone, at some encode speed.
+        // With a pool, blocks are encoded in parallel; the file is the same either way.
+        static bool WriteCompressed(const Recording& recording, const std::filesystem::path& filePath, const ProgressCallback& progress = {}, bool entropy = true, TaskPool* pool = nullptr);
+        // Rewrites a finished stream (the uncompressed format RecordingWriter appends to) as a
+        // compressed recording, one block at a time, so a long capture is never held whole
+        static bool CompressStream(const std::filesystem::path& streamPath, const std::filesystem::path& filePath);
+        static bool ReadBinary(Recording& recording, const std::filesystem::path& filePath, const ProgressCallback& progress = {});
+        static bool IsBinaryRecording(const std::filesystem::path& filePath);
+
+        // Returns the .rec format version of a file, or 0 if it is not a binary recording
+        static uint16_t GetBinaryVersion(const std::filesystem::path& filePath);
+
+        static std::filesystem::path GetRecordingPath(const std::string& name);
+
+        // Streamed recordings are written to "<name>.rec.part" and renamed once finalized.
+        // Recovery turns a partial file left behind by a crash into a normal recording and
+        // deletes temporaries of saves that never completed.
+        static bool RecoverRecording(const std::filesystem::path& partialPath);
+        static size_t RecoverPartialRecordings();
+
+        // An AtomicFile temporary of a .rec or .json save whose process has exited
+        static bool IsAbandonedSave(const std::filesystem::path& filePath);
+
+        // JSON is kept for import/export and for reading recordings saved by older versions.
+        // ImportJson parses the exported layout in place and hands anything else to
+        // ImportJsonDocument, which builds a full JSON document and accepts any field order.
+        static bool ExportJson(const Recording& recording, const std::filesystem::path& filePath);
+        static bool ImportJson(Recording& recording, const std::filesystem::path& filePath, const ProgressCallback& progress = {});
+        static bool ImportJsonDocument(Recording& recording, const std::filesystem::path& filePath);
     };
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace KeyActions
+{
+    namespace
+    {
+        // Which pool and queue the current thread works for, if it is a worker
+        thread_local const TaskPool* t_Pool = nullptr;
+        thread_local size_t t_QueueIndex = 0;
+    }
+
+    TaskPool::TaskPool(size_t threadCount)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        for (size_t i = 0; i <= threadCount; i++)
+            m_Queues.push_back(std::make_unique<Queue>());
+
+        m_Threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++)
+            m_Threads.emplace_back(&TaskPool::WorkerThread, this, i);
+    }
+
+    TaskPool::~TaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+            m_StopRequested = true;
+        }
+
+        m_WakeCondition.notify_all();
+
+        for (std::thread& thread : m_Threads)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+
+    void TaskPool::ParallelFor(size_t count, const std::function<void(size_t)>& body)
+    {
+        if (count == 0)
+            return;
+
+        struct Group
+        {
+            std::atomic<size_t> Remaining;
+            std::mutex Mutex;
+            std::condition_variable Done;
+            std::exception_ptr Error;   // The first body to throw
+        };
+
+        Group group;
+        group.Remaining = count;
+
+        size_t self = GetCurrentQueue();
+
+        {
+            Queue& queue = *m_Queues[self];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+
+            // Counted before they are visible, so a worker never sees more tasks than are counted
+            m_Queued += count;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                queue.Tasks.push_back([&body, &group, i]() {
+                    // Caught here so it neither ends a worker nor leaves the group waiting on this task
+                    std::exception_ptr error;
+                    try
+                    {
+                        body(i);
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                    }
+
+                    // Decremented under the lock so the waiter can't return while this still uses the group
+                    std::lock_guard<std::mutex> groupLock(group.Mutex);
+                    if (error && !group.Error)
+                        group.Error = error;
+
+                    if (--group.Remaining == 0)
+                        group.Done.notify_all();
+                    });
+            }
+        }
+
+        // Passing through the lock keeps a worker from missing the count between its check and its wait
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+        }
+        m_WakeCondition.notify_all();
+
+        // Help until nothing is left to take; what remains is already running elsewhere
+        while (group.Remaining > 0 && RunOne(self))
+        {
+        }
+
+        std::unique_lock<std::mutex> lock(group.Mutex);
+        group.Done.wait(lock, [&group]() { return group.Remaining == 0; });
+
+        if (group.Error)
+            std::rethrow_exception(group.Error);
+    }
+
+    bool TaskPool::RunOne(size_t self)
+    {
+        if (m_Queued == 0)
+            return false;
+
+        Task task;
+
+        {
+            Queue& own = *m_Queues[self];
+            std::lock_guard<std::mutex> lock(own.Mutex);
+
+            if (!own.Tasks.empty())
+            {
+                task = std::move(own.Tasks.back());
+                own.Tasks.pop_back();
+            }
+        }
+
+        for (size_t offset = 1; !task && offset < m_Queues.size(); offset++)
+        {
+            Queue& victim = *m_Queues[(self + offset) % m_Queues.size()];
+            std::lock_guard<std::mutex> lock(victim.Mutex);
+
+            if (!victim.Tasks.empty())
+            {
+                task = std::move(victim.Tasks.front());
+                victim.Tasks.pop_front();
+                m_StealCount++;
+            }
+        }
+
+        if (!task)
+            return false;
+
+        m_Queued--;
+        task();
+        return true;
+    }
+
+    size_t TaskPool::GetCurrentQueue() const
+    {
+        return t_Pool == this ? t_QueueIndex : m_Threads.size();
+    }
+
+    void TaskPool::WorkerThread(size_t index)
+    {
+        t_Pool = this;
+        t_QueueIndex = index;
+
+        while (true)
+        {
+            if (RunOne(index))
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_WakeMutex);
+            m_WakeCondition.wait(lock, [this]() { return m_StopRequested || m_Queued > 0; });
+
+            if (m_StopRequested)
+                break;
+        }
+    }
+}
\ No newline at end of file
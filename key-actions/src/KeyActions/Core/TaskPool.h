@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace KeyActions
+{
+    // Work-stealing pool for CPU-bound batch work such as converting a folder of recordings.
+    // Each worker owns a queue: it takes its own tasks from the back, newest first, and when
+    // that is empty steals the oldest task from the front of another queue. Threads outside
+    // the pool submit through a shared queue of their own.
+    //
+    // A thread waiting in ParallelFor runs queued tasks instead of blocking, so a task may
+    // itself call ParallelFor (one per file, then one per block of that file) without the
+    // nested work waiting for a free worker.
+    class TaskPool
+    {
+    public:
+        // Zero uses one worker per hardware thread
+        explicit TaskPool(size_t threadCount = 0);
+        ~TaskPool();
+
+        TaskPool(const TaskPool&) = delete;
+        TaskPool& operator=(const TaskPool&) = delete;
+
+        size_t GetThreadCount() const { return m_Threads.size(); }
+
+        // Runs body(i) for every i in [0, count) across the pool and returns once all have run.
+        // The calling thread takes part. If a body throws, the rest still run and the first
+        // exception is rethrown here once they have.
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+        // Tasks a worker took from another worker's queue
+        uint64_t GetStealCount() const { return m_StealCount; }
+
+    private:
+        using Task = std::function<void()>;
+
+        struct Queue
+        {
+            std::mutex Mutex;
+            std::deque<Task> Tasks;
+        };
+
+        void WorkerThread(size_t index);
+
+        // Runs one queued task, preferring the caller's own queue. Returns false if every queue was empty.
+        bool RunOne(size_t self);
+        size_t GetCurrentQueue() const;
+
+        std::vector<std::unique_ptr<Queue>> m_Queues; // One per worker, then the shared queue
+        std::vector<std::thread> m_Threads;
+
+        std::mutex m_WakeMutex;
+        std::condition_variable m_WakeCondition;
+        std::atomic<size_t> m_Queued{ 0 };
+        std::atomic<uint64_t> m_StealCount{ 0 };
+        bool m_StopRequested = false;
+    };
+}
\ No newline at end of file
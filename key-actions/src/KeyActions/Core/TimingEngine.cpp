@@ -0,0 +1,78 @@
+#include "TimingEngine.h"
+
+#include "Clock.h"
+#include "PlaybackControl.h"
+
+#include <thread>
+
+namespace KeyActions
+{
+    namespace
+    {
+        class PollTimingEngine : public TimingEngine
+        {
+        public:
+            PollTimingEngine(const TimingSettings& settings) : TimingEngine(settings) {}
+
+            bool WaitUntil(int64_t deadline, PlaybackControl& control) override
+            {
+                while (Clock::Now() < deadline)
+                {
+                    if (!control.SleepUntil(Clock::Now() + Clock::NanosecondsPerMillisecond))
+                        return false;
+                }
+
+                return !control.IsInterrupted();
+            }
+        };
+
+        class SleepSpinTimingEngine : public TimingEngine
+        {
+        public:
+            SleepSpinTimingEngine(const TimingSettings& settings) : TimingEngine(settings) {}
+
+            bool WaitUntil(int64_t deadline, PlaybackControl& control) override
+            {
+                // Sleep until just before the deadline...
+                if (!control.SleepUntil(deadline - m_Settings.Tolerance))
+                    return false;
+
+                // ...then spin the rest of the way
+                while (!control.IsInterrupted())
+                {
+                    if (Clock::Now() >= deadline)
+                        return true;
+
+                    std::this_thread::yield();
+                }
+
+                return false;
+            }
+        };
+
+        class AbsoluteSleepTimingEngine : public TimingEngine
+        {
+        public:
+            AbsoluteSleepTimingEngine(const TimingSettings& settings) : TimingEngine(settings) {}
+
+            bool WaitUntil(int64_t deadline, PlaybackControl& control) override
+            {
+                return control.SleepUntil(deadline);
+            }
+        };
+    }
+
+    std::unique_ptr<TimingEngine> TimingEngine::Create(const TimingSettings& settings)
+    {
+        switch (settings.Strategy)
+        {
+        case TimingStrategy::Poll:
+            return std::make_unique<PollTimingEngine>(settings);
+        case TimingStrategy::AbsoluteSleep:
+            return std::make_unique<AbsoluteSleepTimingEngine>(settings);
+        case TimingStrategy::SleepSpin:
+        default:
+            return std::make_unique<SleepSpinTimingEngine>(settings);
+        }
+    }
+}
\ No newline at end of file
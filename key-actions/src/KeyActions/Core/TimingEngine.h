@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace KeyActions
+{
+    class PlaybackControl;
+
+    enum class TimingStrategy
+    {
+        Poll,           // Sleep 1 ms at a time until the deadline (legacy behaviour)
+        SleepSpin,      // Sleep until Tolerance before the deadline, then spin
+        AbsoluteSleep   // Sleep straight to the absolute deadline, no spinning
+    };
+
+    struct TimingSettings
+    {
+        TimingStrategy Strategy = TimingStrategy::SleepSpin;
+        int64_t Tolerance = 2000000;        // Nanoseconds before the deadline to stop sleeping
+    };
+
+    // Waits for event deadlines on the playback thread. Deadlines are absolute
+    // Clock::Now() nanoseconds; all sleeping goes through the PlaybackControl so
+    // commands cut a wait short.
+    class TimingEngine
+    {
+    public:
+        virtual ~TimingEngine() = default;
+
+        // Blocks until the deadline passes; returns false if a control command arrives first
+        virtual bool WaitUntil(int64_t deadline, PlaybackControl& control) = 0;
+
+        const TimingSettings& GetSettings() const { return m_Settings; }
+
+        static std::unique_ptr<TimingEngine> Create(const TimingSettings& settings = TimingSettings());
+
+    protected:
+        TimingEngine(const TimingSettings& settings) : m_Settings(settings) {}
+
+        TimingSettings m_Settings;
+    };
+}
\ No newline at end of file
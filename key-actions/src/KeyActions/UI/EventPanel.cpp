@@ -7,6 +7,8 @@
 
 #include "Styles/Theme.h"
 
+#include <algorithm>
+#include <climits>
 #include <sstream>
 #include <iomanip>
 
@@ -16,17 +18,24 @@ namespace KeyActions
 
     void EventPanel::AddEvent(const RecordedEvent& event)
     {
-        m_Events.push_back(event);
+        m_Events.Add(event);
 
-        if (m_Events.size() > m_MaxEvents)
+        if (m_Events.Size() > m_MaxEvents)
         {
-            m_Events.erase(m_Events.begin());
+            m_Events.EraseFront(m_Events.Size() - m_MaxEvents);
         }
     }
 
     void EventPanel::Clear()
     {
-        m_Events.clear();
+        m_Events.Clear();
+        m_Recording.reset();
+    }
+
+    void EventPanel::ShowRecording(std::shared_ptr<RecordingReader> recording)
+    {
+        m_Events.Clear();
+        m_Recording = std::move(recording);
     }
 
     ImVec4 EventPanel::GetEventColor(RecordedAction action) const
@@ -59,58 +68,59 @@ namespace KeyActions
         }
     }
 
-    void EventPanel::RenderEvent(const RecordedEvent& event, int index)
+    void EventPanel::RenderEvent(const EventView& event, int index)
     {
         ImGui::PushID(index);
 
-        int minutes = static_cast<int>(event.Time) / 60;
-        int seconds = static_cast<int>(event.Time) % 60;
-        int milliseconds = static_cast<int>((event.Time - static_cast<int>(event.Time)) * 1000);
+        int64_t totalMilliseconds = event.GetTimestamp() / Clock::NanosecondsPerMillisecond;
+        int minutes = static_cast<int>(totalMilliseconds / 60000);
+        int seconds = static_cast<int>((totalMilliseconds / 1000) % 60);
+        int milliseconds = static_cast<int>(totalMilliseconds % 1000);
 
         std::stringstream timeStr;
         timeStr << std::setfill('0') << std::setw(2) << minutes << ":"
             << std::setw(2) << seconds << "."
             << std::setw(3) << milliseconds;
 
-        ImVec4 color = GetEventColor(event.Action);
+        ImVec4 color = GetEventColor(event.GetAction());
 
         UI::ButtonColored(timeStr.str(), color, ImVec2(90, 26));
   
 		UI::SameLine(0.0f, -1.0f);
 
-        UI::ButtonColored(GetEventIcon(event.Action), color, ImVec2(90, 26));
+        UI::ButtonColored(GetEventIcon(event.GetAction()), color, ImVec2(90, 26));
         
         UI::SameLine(0.0f, -1.0f);
 
         std::string details;
-        switch (event.Action)
+        switch (event.GetAction())
         {
         case RecordedAction::KeyPressed:
         case RecordedAction::KeyReleased:
-            details = Lumina::Input::KeyCodeToString(event.Key);
+            details = Lumina::Input::KeyCodeToString(event.GetKey());
             break;
         case RecordedAction::MousePressed:
         case RecordedAction::MouseReleased:
         {
             std::stringstream ss;
-            ss << "Button " << static_cast<int>(event.Button)
-                << " at (" << static_cast<int>(event.MouseX)
-                << ", " << static_cast<int>(event.MouseY) << ")";
+            ss << "Button " << static_cast<int>(event.GetButton())
+                << " at (" << event.GetX()
+                << ", " << event.GetY() << ")";
             details = ss.str();
             break;
         }
         case RecordedAction::MouseMoved:
         {
             std::stringstream ss;
-            ss << "(" << static_cast<int>(event.MouseX)
-                << ", " << static_cast<int>(event.MouseY) << ")";
+            ss << "(" << event.GetX()
+                << ", " << event.GetY() << ")";
             details = ss.str();
             break;
         }
         case RecordedAction::MouseScrolled:
         {
             std::stringstream ss;
-            ss << "dx=" << event.ScrollDX << ", dy=" << event.ScrollDY;
+            ss << "dx=" << event.GetScrollDX() << ", dy=" << event.GetScrollDY();
             details = ss.str();
             break;
         }
@@ -125,17 +135,46 @@ namespace KeyActions
     {
         UI::BeginPanel("EventPanelEvents", ImVec2(size.x, size.y - 45), true);
 
-        for (size_t i = 0; i < m_Events.size(); i++)
+        if (m_Recording)
         {
-            RenderEvent(m_Events[i], static_cast<int>(i));
+            // Recordings can be far too long to lay out every row, so decode just the blocks in view
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(std::min<size_t>(m_Recording->GetEventCount(), INT_MAX)));
+
+            while (clipper.Step())
+            {
+                RecordingReader::Block block;
+                size_t blockIndex = 0;
+
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+                {
+                    if (!block || RecordingReader::GetBlockIndex(i) != blockIndex)
+                    {
+                        blockIndex = RecordingReader::GetBlockIndex(i);
+                        block = m_Recording->GetBlock(blockIndex);
+                    }
+
+                    if (!block)
+                        break;
+
+                    RenderEvent((*block)[i - RecordingReader::GetBlockStart(blockIndex)], i);
+                }
+            }
         }
+        else
+        {
+            for (size_t i = 0; i < m_Events.Size(); i++)
+            {
+                RenderEvent(m_Events[i], static_cast<int>(i));
+            }
 
-        if (m_AutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
-            ImGui::SetScrollHereY(1.0f);
+            if (m_AutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+                ImGui::SetScrollHereY(1.0f);
+        }
 
         UI::EndPanel();
 
-        if (UI::ButtonClear())
+        if (!m_Recording && UI::ButtonClear())
         {
             Clear();
         }
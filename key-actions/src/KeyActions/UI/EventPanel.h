@@ -4,6 +4,9 @@
 #include <imgui.h>
 
 #include "KeyActions/Core/Recording.h"
+#include "KeyActions/Core/RecordingReader.h"
+
+#include <memory>
 
 namespace KeyActions
 {
@@ -14,17 +17,21 @@ namespace KeyActions
 
         void AddEvent(const RecordedEvent& event);
         void Clear();
+
+        // Lists a recording on disk instead of added events; only the rows in view are decoded
+        void ShowRecording(std::shared_ptr<RecordingReader> recording);
         void Render(const ImVec2& size = ImVec2(0, 0));
 
-        size_t GetEventCount() const { return m_Events.size(); }
+        size_t GetEventCount() const { return m_Recording ? m_Recording->GetEventCount() : m_Events.Size(); }
 
     private:
-        void RenderEvent(const RecordedEvent& event, int index);
+        void RenderEvent(const EventView& event, int index);
         ImVec4 GetEventColor(RecordedAction action) const;
         const char* GetEventIcon(RecordedAction action) const;
 
     private:
-        std::vector<RecordedEvent> m_Events;
+        EventStore m_Events;
+        std::shared_ptr<RecordingReader> m_Recording;
         int m_MaxEvents;
         bool m_AutoScroll = true;
     };
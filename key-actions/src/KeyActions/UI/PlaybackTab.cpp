@@ -2,6 +2,8 @@
 
 #include "Lumina/Core/Log.h"
 
+#include "KeyActions/Core/Settings.h"
+
 namespace KeyActions
 {
     PlaybackTab::PlaybackTab() : Tab("Playback") {}
@@ -31,10 +33,13 @@ namespace KeyActions
         {
             m_PlaybackSession.Stop();
         }
+
+        m_PlaybackEngine.StopAll();
     }
 
     void PlaybackTab::OnUpdate(float timestep)
     {
+        m_IO.Update();
     }
 
     void PlaybackTab::OnEvent(Event& e)
@@ -54,29 +59,116 @@ namespace KeyActions
         ImGui::BeginChild("RecordingsList", ImVec2(0, 150), true);
         for (int i = 0; i < m_AvailableRecordings.size(); i++)
         {
+            const RecordingInfo& info = m_AvailableRecordings[i];
+
             bool isSelected = (m_SelectedRecordingIndex == i);
-            if (ImGui::Selectable(m_AvailableRecordings[i].c_str(), isSelected))
+            if (ImGui::Selectable(info.Name.c_str(), isSelected))
             {
                 m_SelectedRecordingIndex = i;
                 LoadSelectedRecording();
             }
+
+            ImGui::SameLine(ImGui::GetContentRegionAvail().x * 0.6f);
+            ImGui::TextDisabled("%llu events, %.2fs%s", static_cast<unsigned long long>(info.EventCount),
+                Clock::ToSeconds(info.Duration), info.RecordsMouse ? ", mouse" : "");
         }
         ImGui::EndChild();
 
+        if (m_IO.IsPending(m_PendingLoad))
+        {
+            ImGui::ProgressBar(m_IO.GetProgress(m_PendingLoad), ImVec2(-80.0f, 0.0f), m_PendingLoadName.c_str());
+            ImGui::SameLine();
+            if (ImGui::Button("Cancel"))
+            {
+                m_IO.Cancel(m_PendingLoad);
+            }
+        }
+
         ImGui::Separator();
 
         // Loaded recording info
-        if (m_HasLoadedRecording)
+        if (m_OpenedRecording && !m_LoadedRecording)
+        {
+            ImGui::Text("Opened: %s", m_OpenedRecording->GetName().c_str());
+            ImGui::Text("Events: %zu", m_OpenedRecording->GetEventCount());
+            ImGui::Text("Duration: %.2fs", m_OpenedRecording->GetDurationSeconds());
+
+            if (m_OpenedRecording->GetEventCount() > FullLoadEventLimit)
+                ImGui::TextDisabled("Playing from disk; too long to load for exporting or optimizing");
+        }
+        else if (m_LoadedRecording)
         {
-            ImGui::Text("Loaded: %s", m_LoadedRecording.Name.c_str());
-            ImGui::Text("Events: %zu", m_LoadedRecording.Events.size());
-            ImGui::Text("Duration: %.2fs", m_LoadedRecording.TotalDuration);
+            ImGui::Text("Loaded: %s", m_LoadedRecording->Name.c_str());
+            ImGui::Text("Events: %zu", m_LoadedRecording->Events.Size());
+            ImGui::Text("Duration: %.2fs", m_LoadedRecording->GetDurationSeconds());
+
+            if (ImGui::Button("Export JSON"))
+            {
+                std::filesystem::path exportPath = Settings::Data().RecordingsFolder / (m_LoadedRecording->Name + ".json");
+                Serialization::ExportJson(*m_LoadedRecording, exportPath);
+            }
+
+            if (ImGui::TreeNode("Optimize"))
+            {
+                ImGui::SliderFloat("Mouse Tolerance (px)", &m_OptimizerSettings.MouseMoveTolerance, 0.0f, 10.0f, "%.1f");
+
+                float maxIdleSeconds = static_cast<float>(Clock::ToSeconds(m_OptimizerSettings.MaxIdleGap));
+                if (ImGui::SliderFloat("Max Idle Gap (s)", &maxIdleSeconds, 0.1f, 10.0f, "%.1f"))
+                    m_OptimizerSettings.MaxIdleGap = Clock::FromSeconds(maxIdleSeconds);
+
+                ImGui::Checkbox("Drop Key Repeats", &m_OptimizerSettings.DropKeyRepeats);
+                ImGui::Checkbox("Coalesce Scrolls", &m_OptimizerSettings.CoalesceScrolls);
+                ImGui::Checkbox("Trim Idle Gaps", &m_OptimizerSettings.TrimIdleGaps);
+
+                if (ImGui::Button("Optimize Recording"))
+                {
+                    OptimizeLoadedRecording();
+                }
+
+                if (m_HasOptimizerStats)
+                {
+                    ImGui::Text("Events: %zu -> %zu", m_OptimizerStats.EventsBefore, m_OptimizerStats.EventsAfter);
+                    ImGui::Text("Duration: %.2fs -> %.2fs", Clock::ToSeconds(m_OptimizerStats.DurationBefore), Clock::ToSeconds(m_OptimizerStats.DurationAfter));
+                }
+
+                if (m_IO.IsPending(m_PendingSave))
+                {
+                    ImGui::ProgressBar(m_IO.GetProgress(m_PendingSave), ImVec2(-1.0f, 0.0f), "Saving...");
+                }
+                else if (m_HasUnsavedOptimization && ImGui::Button("Save Optimized"))
+                {
+                    // The file is replaced, so let go of it first
+                    m_OpenedRecording.reset();
+                    m_EventPanel.Clear();
+
+                    std::string name = m_LoadedRecording->Name;
+                    m_PendingSave = m_IO.Save(m_LoadedRecording, Settings::Data().RecordingsFolder, [this, name](IOStatus status) {
+                        if (status == IOStatus::Completed)
+                        {
+                            m_HasUnsavedOptimization = false;
+                            LoadRecordingsList();
+                        }
+                        else
+                        {
+                            LUMINA_LOG_ERROR("Failed to save optimized recording: {}", name);
+                        }
+                        });
+                }
+
+                ImGui::TreePop();
+            }
         }
         else
         {
             ImGui::Text("No recording loaded");
         }
 
+        if (m_OpenedRecording && ImGui::TreeNode("Events"))
+        {
+            m_EventPanel.Render(ImVec2(0, 300));
+            ImGui::TreePop();
+        }
+
         ImGui::Separator();
 
         // Playback settings
@@ -85,16 +177,24 @@ namespace KeyActions
         ImGui::Checkbox("Loop", &m_Settings.Loop);
         ImGui::Checkbox("Ignore Mouse Movement", &m_Settings.IgnoreMouseMove);
 
+        int strategy = static_cast<int>(m_Settings.Timing.Strategy);
+        if (ImGui::Combo("Timing", &strategy, "Poll (1 ms)\0Sleep + Spin\0Absolute Sleep\0"))
+            m_Settings.Timing.Strategy = static_cast<TimingStrategy>(strategy);
+
+        float toleranceMs = static_cast<float>(m_Settings.Timing.Tolerance) / Clock::NanosecondsPerMillisecond;
+        if (ImGui::SliderFloat("Spin Tolerance (ms)", &toleranceMs, 0.0f, 20.0f, "%.1f"))
+            m_Settings.Timing.Tolerance = Clock::FromSeconds(toleranceMs / 1000.0);
+
         ImGui::Separator();
 
         // Playback controls
-        ImGui::BeginDisabled(!m_HasLoadedRecording);
+        ImGui::BeginDisabled(!m_LoadedRecording && !m_OpenedRecording);
 
         if (!m_PlaybackSession.IsPlaying())
         {
             if (ImGui::Button("Play", ImVec2(100, 40)))
             {
-                m_PlaybackSession.Play(m_LoadedRecording, m_Settings);
+                PlaySelectedRecording();
             }
         }
         else
@@ -143,6 +243,20 @@ namespace KeyActions
             ImGui::EndDisabled();
         }
 
+        ImGui::SameLine();
+
+        // The engine interleaves recordings from memory, so this waits for the full load
+        ImGui::BeginDisabled(!m_LoadedRecording);
+        if (ImGui::Button("Play in Background", ImVec2(160, 40)))
+        {
+            PlaybackId id = m_PlaybackEngine.Play(m_LoadedRecording, m_Settings);
+            if (id != InvalidPlaybackId)
+            {
+                m_BackgroundPlaybacks.push_back({ id, m_LoadedRecording->Name });
+            }
+        }
+        ImGui::EndDisabled();
+
         ImGui::EndDisabled();
 
         ImGui::Separator();
@@ -164,6 +278,60 @@ namespace KeyActions
                 m_PlaybackSession.GetTotalDuration());
 
             ImGui::ProgressBar(m_CurrentProgress, ImVec2(-1, 0));
+
+            float seekSeconds = m_PlaybackSession.GetElapsedTime();
+            if (ImGui::SliderFloat("Seek", &seekSeconds, 0.0f, m_PlaybackSession.GetTotalDuration(), "%.2fs"))
+            {
+                m_PlaybackSession.Seek(Clock::FromSeconds(seekSeconds));
+            }
+
+            ImGui::InputInt("##SeekEvent", &m_SeekEventIndex);
+            ImGui::SameLine();
+            if (ImGui::Button("Jump to Event"))
+            {
+                m_PlaybackSession.SeekToEvent(static_cast<size_t>(std::max(0, m_SeekEventIndex)));
+            }
+        }
+
+        // Background playbacks, all driven by the engine's single timer thread
+        std::erase_if(m_BackgroundPlaybacks, [this](const BackgroundPlayback& playback) {
+            return !m_PlaybackEngine.IsPlaying(playback.Id);
+            });
+
+        if (!m_BackgroundPlaybacks.empty())
+        {
+            ImGui::Separator();
+            ImGui::Text("Background Playbacks: %zu", m_BackgroundPlaybacks.size());
+
+            for (const auto& playback : m_BackgroundPlaybacks)
+            {
+                ImGui::PushID(static_cast<int>(playback.Id));
+
+                bool paused = m_PlaybackEngine.IsPaused(playback.Id);
+                ImGui::Text("%s%s", playback.Name.c_str(), paused ? " (paused)" : "");
+
+                ImGui::SameLine();
+                if (ImGui::SmallButton(paused ? "Resume" : "Pause"))
+                {
+                    if (paused)
+                        m_PlaybackEngine.Resume(playback.Id);
+                    else
+                        m_PlaybackEngine.Pause(playback.Id);
+                }
+
+                ImGui::SameLine();
+                if (ImGui::SmallButton("Stop"))
+                {
+                    m_PlaybackEngine.Stop(playback.Id);
+                }
+
+                ImGui::PopID();
+            }
+
+            if (ImGui::Button("Stop All"))
+            {
+                m_PlaybackEngine.StopAll();
+            }
         }
 
         ImGui::Separator();
@@ -174,8 +342,29 @@ namespace KeyActions
 
     void PlaybackTab::LoadRecordingsList()
     {
-        m_AvailableRecordings = Serialization::GetAvailableRecordings();
-        LUMINA_LOG_INFO("Found {} recordings", m_AvailableRecordings.size());
+        if (m_IO.IsPending(m_PendingList))
+            return;
+
+        m_PendingList = m_IO.List(Settings::Data().RecordingsFolder, [this](IOStatus status, std::vector<RecordingInfo> recordings) {
+            if (status != IOStatus::Completed)
+                return;
+
+            // Keep the same recording selected if it is still there
+            std::string selected;
+            if (m_SelectedRecordingIndex >= 0 && m_SelectedRecordingIndex < m_AvailableRecordings.size())
+                selected = m_AvailableRecordings[m_SelectedRecordingIndex].Name;
+
+            m_AvailableRecordings = std::move(recordings);
+            m_SelectedRecordingIndex = -1;
+
+            for (int i = 0; i < m_AvailableRecordings.size(); i++)
+            {
+                if (m_AvailableRecordings[i].Name == selected)
+                    m_SelectedRecordingIndex = i;
+            }
+
+            LUMINA_LOG_INFO("Found {} recordings", m_AvailableRecordings.size());
+            });
     }
 
     void PlaybackTab::LoadSelectedRecording()
@@ -183,17 +372,84 @@ namespace KeyActions
         if (m_SelectedRecordingIndex < 0 || m_SelectedRecordingIndex >= m_AvailableRecordings.size())
             return;
 
-        std::string filepath = "recordings/" + m_AvailableRecordings[m_SelectedRecordingIndex] + ".rec";
+        std::string name = m_AvailableRecordings[m_SelectedRecordingIndex].Name;
+        std::filesystem::path path = Serialization::GetRecordingPath(name);
 
-        if (Serialization::LoadRecording(m_LoadedRecording, filepath))
+        // Only the most recent selection is loaded
+        m_IO.Cancel(m_PendingLoad);
+        m_PendingLoadName.clear();
+
+        // Opening reads just the header and block table, so the recording can be shown and
+        // played before, or instead of, loading it whole
+        auto reader = std::make_shared<RecordingReader>();
+        if (reader->Open(path))
         {
-            m_HasLoadedRecording = true;
-            LUMINA_LOG_INFO("Loaded recording: {}", m_LoadedRecording.Name);
+            m_OpenedRecording = std::move(reader);
+            m_EventPanel.ShowRecording(m_OpenedRecording);
+            m_LoadedRecording.reset();
+            m_HasOptimizerStats = false;
+            m_HasUnsavedOptimization = false;
+
+            if (m_OpenedRecording->GetEventCount() > FullLoadEventLimit)
+                return;
         }
         else
         {
-            m_HasLoadedRecording = false;
-            LUMINA_LOG_ERROR("Failed to load recording: {}", filepath);
+            m_OpenedRecording.reset();
+            m_EventPanel.Clear();
         }
+
+        m_PendingLoadName = name;
+
+        m_PendingLoad = m_IO.Load(path, [this, name](IOStatus status, RecordingSnapshot recording) {
+            if (name != m_PendingLoadName)
+                return;
+
+            m_PendingLoadName.clear();
+
+            if (status == IOStatus::Completed)
+            {
+                // A playback already running keeps its own reference to the previous recording
+                m_LoadedRecording = std::move(recording);
+                m_HasOptimizerStats = false;
+                m_HasUnsavedOptimization = false;
+                LUMINA_LOG_INFO("Loaded recording: {}", m_LoadedRecording->Name);
+            }
+            else if (status == IOStatus::Failed)
+            {
+                m_LoadedRecording.reset();
+                LUMINA_LOG_ERROR("Failed to load recording: {}", name);
+            }
+            });
+    }
+
+    void PlaybackTab::PlaySelectedRecording()
+    {
+        // An optimized recording only exists in memory, so the loaded copy wins when there is one
+        if (m_LoadedRecording)
+            m_PlaybackSession.Play(m_LoadedRecording, m_Settings);
+        else if (m_OpenedRecording)
+            m_PlaybackSession.Play(m_OpenedRecording, m_Settings);
+    }
+
+    void PlaybackTab::OptimizeLoadedRecording()
+    {
+        if (!m_LoadedRecording)
+            return;
+
+        RecordingOptimizer optimizer(m_OptimizerSettings);
+        Recording optimized = optimizer.Optimize(*m_LoadedRecording);
+
+        m_OptimizerStats = optimizer.GetStats();
+        m_HasOptimizerStats = true;
+        m_HasUnsavedOptimization = true;
+
+        LUMINA_LOG_INFO("Optimized {}: {} -> {} events, {:.2f}s -> {:.2f}s",
+            optimized.Name,
+            m_OptimizerStats.EventsBefore, m_OptimizerStats.EventsAfter,
+            Clock::ToSeconds(m_OptimizerStats.DurationBefore), Clock::ToSeconds(m_OptimizerStats.DurationAfter));
+
+        // Playbacks already running keep the original
+        m_LoadedRecording = std::make_shared<const Recording>(std::move(optimized));
     }
 }
\ No newline at end of file
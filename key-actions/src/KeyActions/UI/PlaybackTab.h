@@ -1,10 +1,16 @@
 #pragma once
 
 #include "Tab.h"
+#include "EventPanel.h"
 
 #include "KeyActions/Core/Recording.h"
 #include "KeyActions/Core/PlaybackSession.h"
+#include "KeyActions/Core/PlaybackEngine.h"
 #include "KeyActions/Core/Serialization.h"
+#include "KeyActions/Core/RecordingOptimizer.h"
+#include "KeyActions/Core/RecordingLibrary.h"
+#include "KeyActions/Core/RecordingIO.h"
+#include "KeyActions/Core/RecordingReader.h"
 
 #include <vector>
 #include <string>
@@ -25,24 +31,56 @@ namespace KeyActions
     private:
         void LoadRecordingsList();
         void LoadSelectedRecording();
+        void OptimizeLoadedRecording();
+        void PlaySelectedRecording();
 
     private:
         PlaybackSession m_PlaybackSession;
+        PlaybackEngine m_PlaybackEngine;
 
-        // Available recordings
-        std::vector<std::string> m_AvailableRecordings;
+        // Recordings playing in the background alongside the main playback
+        struct BackgroundPlayback
+        {
+            PlaybackId Id;
+            std::string Name;
+        };
+        std::vector<BackgroundPlayback> m_BackgroundPlaybacks;
+
+        // Available recordings, from the library index
+        std::vector<RecordingInfo> m_AvailableRecordings;
         int m_SelectedRecordingIndex = -1;
 
-        // Loaded recording
-        Recording m_LoadedRecording;
-        bool m_HasLoadedRecording = false;
+        // Loads, saves and listings run here so large files don't stall the UI
+        RecordingIO m_IO;
+        IORequestId m_PendingList = InvalidIORequest;
+        IORequestId m_PendingLoad = InvalidIORequest;
+        IORequestId m_PendingSave = InvalidIORequest;
+        std::string m_PendingLoadName;
+
+        // Compressed recordings are opened on disk so they show and play straight away; they
+        // are also loaded whole, for exporting and optimizing, when no longer than this
+        static constexpr size_t FullLoadEventLimit = 4'000'000;
+
+        // Selected recording on disk, decoded a block at a time by playback and the event list
+        std::shared_ptr<RecordingReader> m_OpenedRecording;
+        EventPanel m_EventPanel;
+
+        // Loaded recording, shared with the playback thread while playing
+        RecordingSnapshot m_LoadedRecording;
 
         // Playback settings
         PlaybackSettings m_Settings;
 
+        // Optimizer
+        OptimizerSettings m_OptimizerSettings;
+        OptimizerStats m_OptimizerStats;
+        bool m_HasOptimizerStats = false;
+        bool m_HasUnsavedOptimization = false;
+
         // Progress tracking
         float m_CurrentProgress = 0.0f;
         size_t m_CurrentEventIndex = 0;
+        int m_SeekEventIndex = 0;
 
         // Stats
         int m_TotalPlays = 0;
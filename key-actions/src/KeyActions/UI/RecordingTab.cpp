@@ -21,6 +21,9 @@ namespace KeyActions
     
     void RecordingTab::OnAttach()
     {
+        // Stamps input with the OS hook time; where there is no hook the session records application events
+        m_RecordingSession.SetCaptureSource(&m_CaptureSource);
+
         m_RecordingSession.SetEventRecordedCallback([this](const RecordedEvent& event) {
             m_EventPanel.AddEvent(event);
             });
@@ -30,17 +33,32 @@ namespace KeyActions
             });
 
         m_RecordingSession.SetRecordingStoppedCallback([this]() {
-            const Recording& recording = m_RecordingSession.GetRecording();
-            if (Serialization::SaveRecording(recording))
-            {
-                LUMINA_LOG_INFO("Recording saved successfully!");
-            }
-            else
+            if (m_RecordingSession.WasStreamedToDisk())
             {
-                LUMINA_LOG_ERROR("Failed to save recording!");
+                LUMINA_LOG_INFO("Recording streamed to {}", m_RecordingSession.GetOutputPath().string());
+                return;
             }
+
+            // Saved in the background; the session starts the next recording empty anyway
+            auto recording = std::make_shared<const Recording>(m_RecordingSession.TakeRecording());
+            m_IO.Save(recording, Settings::Data().RecordingsFolder, [](IOStatus status) {
+                if (status == IOStatus::Completed)
+                {
+                    LUMINA_LOG_INFO("Recording saved successfully!");
+                }
+                else
+                {
+                    LUMINA_LOG_ERROR("Failed to save recording!");
+                }
+                });
             });
 
+        size_t recovered = Serialization::RecoverPartialRecordings();
+        if (recovered > 0)
+        {
+            LUMINA_LOG_WARN("Recovered {} unfinished recording(s)", recovered);
+        }
+
         LUMINA_LOG_INFO("Recording tab initialized");
     }
 
@@ -55,6 +73,7 @@ namespace KeyActions
     void RecordingTab::OnUpdate(float timestep)
     {
         m_RecordingSession.Update(timestep);
+        m_IO.Update();
     }
 
     void RecordingTab::OnEvent(Event& e)
@@ -77,7 +96,7 @@ namespace KeyActions
                     !m_RecordingSession.IsWaitingForDelay() &&
                     strnlen(m_RecordingName, sizeof(m_RecordingName)) > 0)
                 {
-                    m_RecordingSession.Start({ m_RecordingName, m_RecordMouseMovement, m_InitialDelay });
+                    StartRecording();
                     return true;
                 }
             }
@@ -153,6 +172,12 @@ namespace KeyActions
 
         UI::Checkbox("Record Mouse Movement", &m_RecordMouseMovement);
 
+        if (m_RecordMouseMovement)
+        {
+            UI::Label("Mouse Path Tolerance (px):");
+            UI::SliderFloat("##MouseMoveTolerance", &m_MouseMoveTolerance, 0.0f, 10.0f, "%.1f");
+        }
+
         UI::Spacing();
 
         UI::Label("Delay (seconds):");
@@ -218,7 +243,13 @@ namespace KeyActions
         RecordingSettings settings;
         settings.Name = m_RecordingName;
         settings.RecordMouseMovement = m_RecordMouseMovement;
+        settings.MouseMoveTolerance = m_MouseMoveTolerance;
         settings.InitialDelaySeconds = m_InitialDelay;
+        settings.HeldAtStart = m_CapturedKeyCombo.Keys;
+        settings.StopHotkey = Settings::Data().StopRecording.Keys;
+        settings.StreamToDisk = true;
+        settings.OutputPath = Serialization::GetRecordingPath(settings.Name);
+        settings.UseCaptureThread = true;
 
         // Start recording
         m_RecordingSession.Start(settings);
@@ -3,8 +3,10 @@
 
 #include "EventPanel.h"
 
+#include "KeyActions/Core/HookCaptureSource.h"
 #include "KeyActions/Core/RecordingSession.h"
 #include "KeyActions/Core/Serialization.h"
+#include "KeyActions/Core/RecordingIO.h"
 
 #include "Lumina/Events/GlobalKeyEvent.h"
 #include "Lumina/Events/GlobalMouseEvent.h"
@@ -39,11 +41,14 @@ namespace KeyActions
         void StopRecording();
 
     private:
+        HookCaptureSource m_CaptureSource; // Declared first so it outlives the session using it
         RecordingSession m_RecordingSession;
+        RecordingIO m_IO;
 
         // UI State
         char m_RecordingName[256] = "";
         bool m_RecordMouseMovement = false;
+        float m_MouseMoveTolerance = 2.0f;
         int m_InitialDelay = 0;
         bool m_ShowNameError = false;
 
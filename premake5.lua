@@ -9,9 +9,13 @@ include "lumina/lumina-external.lua"
 
 group "App"
    include "key-actions"
+   include "key-actions-cli"
 group ""
 
 group "Tests"
    include "tests/nodes"
    include "tests/node-graph"
+   include "tests/serialization"
+   include "tests/recording"
+   include "tests/playback"
 group ""
\ No newline at end of file
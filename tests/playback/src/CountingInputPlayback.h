@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Lumina/Input/GlobalInputPlayback.h"
+
+#include "KeyActions/Core/InputBatch.h"
+
+#include <atomic>
+#include <cstddef>
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        // Counts injected inputs and backend calls, standing in for an OS injection API
+        class CountingInputPlayback : public Lumina::GlobalInputPlayback
+        {
+        public:
+            void SimulateKeyPress(Lumina::KeyCode /*key*/) override { Count(1); }
+            void SimulateKeyRelease(Lumina::KeyCode /*key*/) override { Count(1); }
+            void SimulateMouseButtonPress(Lumina::MouseCode /*button*/, int /*x*/, int /*y*/) override { Count(1); }
+            void SimulateMouseButtonRelease(Lumina::MouseCode /*button*/, int /*x*/, int /*y*/) override { Count(1); }
+            void SimulateMouseMove(int /*x*/, int /*y*/) override { Count(1); }
+            void SimulateMouseScroll(int /*dx*/, int /*dy*/) override { Count(1); }
+
+            size_t GetCalls() const { return m_Calls; }
+            size_t GetEvents() const { return m_Events; }
+
+        protected:
+            void Count(size_t events)
+            {
+                m_Calls.fetch_add(1, std::memory_order_relaxed);
+                m_Events.fetch_add(events, std::memory_order_relaxed);
+            }
+
+        private:
+            std::atomic<size_t> m_Calls{ 0 };
+            std::atomic<size_t> m_Events{ 0 };
+        };
+
+        // Same, but accepts a whole batch per call like SendInput does
+        class BatchCountingInputPlayback : public CountingInputPlayback, public BatchInputPlayback
+        {
+        public:
+            void SimulateBatch(const InputCommand* /*commands*/, size_t count) override { Count(count); }
+        };
+    }
+}
\ No newline at end of file
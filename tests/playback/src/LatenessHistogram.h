@@ -0,0 +1,83 @@
+#pragma once
+
+#include "KeyActions/Core/Clock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        // Collects how late each event was injected relative to its deadline
+        class LatenessHistogram
+        {
+        public:
+            void Add(int64_t lateness) { m_Samples.push_back(lateness); }
+
+            size_t GetCount() const { return m_Samples.size(); }
+
+            int64_t GetPercentile(double percentile) const
+            {
+                if (m_Samples.empty())
+                    return 0;
+
+                std::vector<int64_t> sorted = m_Samples;
+                std::sort(sorted.begin(), sorted.end());
+
+                size_t index = static_cast<size_t>(percentile / 100.0 * (sorted.size() - 1) + 0.5);
+                return sorted[std::min(index, sorted.size() - 1)];
+            }
+
+            int64_t GetMax() const
+            {
+                return m_Samples.empty() ? 0 : *std::max_element(m_Samples.begin(), m_Samples.end());
+            }
+
+            int64_t GetMin() const
+            {
+                return m_Samples.empty() ? 0 : *std::min_element(m_Samples.begin(), m_Samples.end());
+            }
+
+            // "p50 12.3us | p99 45.6us | max 78.9us | <50us:10 <100us:3 ..."
+            std::string ToString() const
+            {
+                static const int64_t bounds[] = { 50000, 100000, 250000, 500000, 1000000, 2000000, 5000000, 10000000 };
+                static const char* labels[] = { "<50us", "<100us", "<250us", "<500us", "<1ms", "<2ms", "<5ms", "<10ms", ">=10ms" };
+
+                size_t counts[std::size(labels)] = {};
+                for (int64_t sample : m_Samples)
+                {
+                    size_t bucket = 0;
+                    while (bucket < std::size(bounds) && sample >= bounds[bucket])
+                        bucket++;
+                    counts[bucket]++;
+                }
+
+                std::stringstream ss;
+                ss.setf(std::ios::fixed);
+                ss.precision(1);
+                ss << "p50 " << ToMicroseconds(GetPercentile(50.0)) << "us"
+                    << " | p99 " << ToMicroseconds(GetPercentile(99.0)) << "us"
+                    << " | max " << ToMicroseconds(GetMax()) << "us |";
+
+                for (size_t i = 0; i < std::size(labels); i++)
+                {
+                    ss << " " << labels[i] << ":" << counts[i];
+                }
+
+                return ss.str();
+            }
+
+        private:
+            static double ToMicroseconds(int64_t nanoseconds) { return nanoseconds / 1000.0; }
+
+        private:
+            std::vector<int64_t> m_Samples;
+        };
+    }
+}
\ No newline at end of file
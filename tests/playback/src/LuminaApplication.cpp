@@ -0,0 +1,17 @@
+#include "Lumina/Core/Application.h"
+#include "Lumina/Core/EntryPoint.h"
+
+#include "PlaybackTestLayer.h"
+
+Lumina::Application* Lumina::CreateApplication(int argc, char** argv)
+{
+    Lumina::ApplicationSpecification spec;
+    spec.Name = "Playback Test";
+    spec.Width = 900;
+    spec.Height = 900;
+    
+    Lumina::Application* app = new Lumina::Application(spec);
+    app->PushLayer<PlaybackTestLayer>();
+    
+    return app;
+}
\ No newline at end of file
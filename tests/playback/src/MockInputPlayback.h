@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Lumina/Input/GlobalInputPlayback.h"
+
+#include "KeyActions/Core/Clock.h"
+#include "KeyActions/Core/Recording.h"
+
+#include <mutex>
+#include <vector>
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        // Records what would have been injected, and when, instead of touching the OS
+        class MockInputPlayback : public Lumina::GlobalInputPlayback
+        {
+        public:
+            struct Injection
+            {
+                RecordedAction Action;
+                int64_t Time;   // Clock::Now() at injection
+                int A = 0;
+                int B = 0;
+            };
+
+            void SimulateKeyPress(Lumina::KeyCode key) override { Record(RecordedAction::KeyPressed, static_cast<int>(key), 0); }
+            void SimulateKeyRelease(Lumina::KeyCode key) override { Record(RecordedAction::KeyReleased, static_cast<int>(key), 0); }
+            void SimulateMouseButtonPress(Lumina::MouseCode /*button*/, int x, int y) override { Record(RecordedAction::MousePressed, x, y); }
+            void SimulateMouseButtonRelease(Lumina::MouseCode /*button*/, int x, int y) override { Record(RecordedAction::MouseReleased, x, y); }
+            void SimulateMouseMove(int x, int y) override { Record(RecordedAction::MouseMoved, x, y); }
+            void SimulateMouseScroll(int dx, int dy) override { Record(RecordedAction::MouseScrolled, dx, dy); }
+
+            std::vector<Injection> GetInjections() const
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                return m_Injections;
+            }
+
+            void Reserve(size_t count)
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Injections.reserve(count);
+            }
+
+        private:
+            void Record(RecordedAction action, int a, int b)
+            {
+                int64_t time = Clock::Now();
+
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Injections.push_back({ action, time, a, b });
+            }
+
+        private:
+            mutable std::mutex m_Mutex;
+            std::vector<Injection> m_Injections;
+        };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,1250 @@
+#include "PlaybackTestSuite.h"
+
+#include "MockInputPlayback.h"
+#include "CountingInputPlayback.h"
+#include "LatenessHistogram.h"
+
+#include "Lumina/Core/Log.h"
+#include "Lumina/Utils/Timer.h"
+
+#include "KeyActions/Core/Clock.h"
+#include "KeyActions/Core/InputBatch.h"
+#include "KeyActions/Core/PlaybackControl.h"
+#include "KeyActions/Core/RecordingIndex.h"
+#include "KeyActions/Core/RecordingReader.h"
+#include "KeyActions/Core/Serialization.h"
+#include "KeyActions/Core/TimingEngine.h"
+
+#ifdef LUMINA_PLATFORM_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#else
+    #include <time.h>
+#endif
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <thread>
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        namespace
+        {
+            const TimingStrategy AllStrategies[] = { TimingStrategy::Poll, TimingStrategy::SleepSpin, TimingStrategy::AbsoluteSleep };
+
+            const char* GetStrategyName(TimingStrategy strategy)
+            {
+                switch (strategy)
+                {
+                case TimingStrategy::Poll:          return "Poll";
+                case TimingStrategy::SleepSpin:     return "SleepSpin";
+                case TimingStrategy::AbsoluteSleep: return "AbsoluteSleep";
+                default:                            return "Unknown";
+                }
+            }
+
+            // Mouse moves spaced evenly, starting at time zero; MouseX holds the event index and MouseY the tag
+            RecordingSnapshot MakeTimedRecording(size_t eventCount, int64_t interval, int tag = 0)
+            {
+                Recording recording("Timed", true);
+                recording.Events.Reserve(eventCount);
+
+                for (size_t i = 0; i < eventCount; i++)
+                {
+                    RecordedEvent event;
+                    event.Action = RecordedAction::MouseMoved;
+                    event.Timestamp = static_cast<int64_t>(i) * interval;
+                    event.MouseX = static_cast<int>(i);
+                    event.MouseY = tag;
+                    recording.Events.Add(event);
+                }
+
+                recording.Duration = recording.Events.Back().GetTimestamp();
+                return std::make_shared<const Recording>(std::move(recording));
+            }
+
+            void WaitForPlayback(const PlaybackSession& session, int64_t timeout)
+            {
+                int64_t deadline = Clock::Now() + timeout;
+                while (session.IsPlaying())
+                {
+                    if (Clock::Now() > deadline)
+                        throw std::runtime_error("Playback did not finish in time");
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+
+            void WaitForEngine(const PlaybackEngine& engine, int64_t timeout)
+            {
+                int64_t deadline = Clock::Now() + timeout;
+                while (engine.GetActiveCount() > 0)
+                {
+                    if (Clock::Now() > deadline)
+                        throw std::runtime_error("Engine playbacks did not finish in time");
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+
+            std::vector<MockInputPlayback::Injection> FilterByTag(const std::vector<MockInputPlayback::Injection>& injections, int tag)
+            {
+                std::vector<MockInputPlayback::Injection> filtered;
+                std::copy_if(injections.begin(), injections.end(), std::back_inserter(filtered),
+                    [tag](const MockInputPlayback::Injection& injection) { return injection.B == tag; });
+                return filtered;
+            }
+
+            // Random key and button presses/releases with non-decreasing timestamps
+            Recording MakeRandomInputRecording(size_t eventCount, uint32_t seed)
+            {
+                std::mt19937 rng(seed);
+                std::uniform_int_distribution<int> action(0, 4);
+                std::uniform_int_distribution<int> key(static_cast<int>(Lumina::KeyCode::A), static_cast<int>(Lumina::KeyCode::Z));
+                std::uniform_int_distribution<int> button(0, 2);
+                std::uniform_int_distribution<int> gap(0, 3);
+
+                Recording recording("Random", true);
+                recording.Events.Reserve(eventCount);
+
+                int64_t time = 0;
+                for (size_t i = 0; i < eventCount; i++)
+                {
+                    RecordedEvent event;
+                    event.Timestamp = time;
+                    time += gap(rng) * Clock::NanosecondsPerMillisecond;
+
+                    switch (action(rng))
+                    {
+                    case 0: event.Action = RecordedAction::KeyPressed; event.Key = static_cast<Lumina::KeyCode>(key(rng)); break;
+                    case 1: event.Action = RecordedAction::KeyReleased; event.Key = static_cast<Lumina::KeyCode>(key(rng)); break;
+                    case 2: event.Action = RecordedAction::MousePressed; event.Button = static_cast<Lumina::MouseCode>(button(rng)); break;
+                    case 3: event.Action = RecordedAction::MouseReleased; event.Button = static_cast<Lumina::MouseCode>(button(rng)); break;
+                    default: event.Action = RecordedAction::MouseMoved; event.MouseX = static_cast<int>(i); break;
+                    }
+
+                    recording.Events.Add(event);
+                }
+
+                recording.Duration = recording.Events.Back().GetTimestamp();
+                return recording;
+            }
+
+            // CPU time consumed by the whole process so far, in nanoseconds
+            int64_t GetProcessCpuTime()
+            {
+#ifdef LUMINA_PLATFORM_WINDOWS
+                FILETIME creation, exit, kernel, user;
+                GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+
+                auto toNanoseconds = [](const FILETIME& time) {
+                    return ((static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100;
+                };
+
+                return toNanoseconds(kernel) + toNanoseconds(user);
+#else
+                timespec time;
+                clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+                return static_cast<int64_t>(time.tv_sec) * Clock::NanosecondsPerSecond + time.tv_nsec;
+#endif
+            }
+
+            // Lateness of every event, measured from just before Play() so it slightly overstates rather than hides delay
+            LatenessHistogram MeasureLateness(const RecordingSnapshot& recording, TimingStrategy strategy)
+            {
+                auto mock = std::make_unique<MockInputPlayback>();
+                MockInputPlayback* injected = mock.get();
+                injected->Reserve(recording->Events.Size());
+
+                PlaybackSession session(std::move(mock));
+
+                PlaybackSettings settings;
+                settings.Timing.Strategy = strategy;
+
+                int64_t playTime = Clock::Now();
+                if (!session.Play(recording, settings))
+                    throw std::runtime_error("Play failed");
+
+                WaitForPlayback(session, recording->Duration + 5 * Clock::NanosecondsPerSecond);
+
+                auto injections = injected->GetInjections();
+                if (injections.size() != recording->Events.Size())
+                    throw std::runtime_error("Expected " + std::to_string(recording->Events.Size()) + " injections, got " + std::to_string(injections.size()));
+
+                LatenessHistogram histogram;
+                for (size_t i = 0; i < injections.size(); i++)
+                {
+                    int64_t scheduled = playTime + recording->Events[i].GetTimestamp();
+                    histogram.Add(injections[i].Time - scheduled);
+                }
+
+                return histogram;
+            }
+        }
+
+        std::vector<TestResult> PlaybackTestSuite::RunAllTests()
+        {
+            m_LastSummary = TestSummary();
+            m_LastSummary.Results.clear();
+
+            LUMINA_LOG_INFO("========================================");
+            LUMINA_LOG_INFO("Running Playback Test Suite");
+            LUMINA_LOG_INFO("========================================");
+
+            Lumina::Timer totalTimer;
+
+            // Timing Engine Tests
+            m_LastSummary.Results.push_back(RunTest("Timing - Never Wakes Early", [this]() { Test_Timing_NeverWakesEarly(); }));
+            m_LastSummary.Results.push_back(RunTest("Timing - Stop Interrupts Wait", [this]() { Test_Timing_StopInterruptsWait(); }));
+
+            // Input Batch Tests
+            m_LastSummary.Results.push_back(RunTest("Injection - Batch Falls Back To Per Event Calls", [this]() { Test_Injection_BatchFallsBackToPerEventCalls(); }));
+            m_LastSummary.Results.push_back(RunTest("Injection - Batch Submits In One Call", [this]() { Test_Injection_BatchSubmitsInOneCall(); }));
+
+            // Recording Index Tests
+            m_LastSummary.Results.push_back(RunTest("Index - Finds Events By Time", [this]() { Test_Index_FindsEventsByTime(); }));
+            m_LastSummary.Results.push_back(RunTest("Index - Held State Matches Replay", [this]() { Test_Index_HeldStateMatchesReplay(); }));
+
+            // Playback Session Tests
+            m_LastSummary.Results.push_back(RunTest("Playback - Injects All Events In Order", [this]() { Test_Playback_InjectsAllEventsInOrder(); }));
+            m_LastSummary.Results.push_back(RunTest("Playback - Pause Holds Injection", [this]() { Test_Playback_PauseHoldsInjection(); }));
+            m_LastSummary.Results.push_back(RunTest("Playback - Seek Skips Ahead", [this]() { Test_Playback_SeekSkipsAhead(); }));
+            m_LastSummary.Results.push_back(RunTest("Playback - Sessions Share Snapshot", [this]() { Test_Playback_SessionsShareSnapshot(); }));
+            m_LastSummary.Results.push_back(RunTest("Playback - Coalesces Simultaneous Events", [this]() { Test_Playback_CoalescesSimultaneousEvents(); }));
+            m_LastSummary.Results.push_back(RunTest("Playback - Seek Restores Held Keys", [this]() { Test_Playback_SeekRestoresHeldKeys(); }));
+            m_LastSummary.Results.push_back(RunTest("Playback - Streams From Reader", [this]() { Test_Playback_StreamsFromReader(); }));
+
+            // Playback Engine Tests
+            m_LastSummary.Results.push_back(RunTest("Engine - Interleaves Playbacks", [this]() { Test_Engine_InterleavesPlaybacks(); }));
+            m_LastSummary.Results.push_back(RunTest("Engine - Per Playback Controls", [this]() { Test_Engine_PerPlaybackControls(); }));
+            m_LastSummary.Results.push_back(RunTest("Engine - Loops Until Stopped", [this]() { Test_Engine_LoopsUntilStopped(); }));
+            m_LastSummary.Results.push_back(RunTest("Engine - Releases Held Input", [this]() { Test_Engine_ReleasesHeldInput(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Lateness Histogram", [this]() { Test_Performance_LatenessHistogram(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Stop To Join Latency", [this]() { Test_Performance_StopToJoinLatency(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Idle CPU", [this]() { Test_Performance_IdleCpu(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Play Latency By Size", [this]() { Test_Performance_PlayLatencyBySize(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Engine Hundreds Of Playbacks", [this]() { Test_Performance_EngineHundredsOfPlaybacks(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Batched Injection Throughput", [this]() { Test_Performance_BatchedInjectionThroughput(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Seek Cost", [this]() { Test_Performance_SeekCost(); }));
+
+            m_LastSummary.TotalTimeMs = totalTimer.ElapsedMillis();
+
+            // Calculate summary
+            m_LastSummary.TotalTests = static_cast<int>(m_LastSummary.Results.size());
+            for (const auto& result : m_LastSummary.Results)
+            {
+                if (result.Passed)
+                    m_LastSummary.PassedTests++;
+                else
+                    m_LastSummary.FailedTests++;
+            }
+
+            LUMINA_LOG_INFO("========================================");
+            LUMINA_LOG_INFO("Test Suite Complete");
+            LUMINA_LOG_INFO("Total: {} | Passed: {} | Failed: {}",
+                m_LastSummary.TotalTests,
+                m_LastSummary.PassedTests,
+                m_LastSummary.FailedTests);
+            LUMINA_LOG_INFO("Total Time: {:.3f}ms", m_LastSummary.TotalTimeMs);
+            LUMINA_LOG_INFO("========================================");
+
+            return m_LastSummary.Results;
+        }
+
+        TestResult PlaybackTestSuite::RunTest(const std::string& name, std::function<void()> testFunc)
+        {
+            TestResult result;
+            result.TestName = name;
+            result.Passed = false;
+
+            Lumina::Timer timer;
+
+            try
+            {
+                testFunc();
+                result.Passed = true;
+                result.Message = "Passed";
+            }
+            catch (const std::exception& e)
+            {
+                result.Passed = false;
+                result.Message = std::string("Exception: ") + e.what();
+            }
+            catch (...)
+            {
+                result.Passed = false;
+                result.Message = "Unknown exception";
+            }
+
+            result.ElapsedMs = timer.ElapsedMillis();
+
+            if (result.Passed)
+                LUMINA_LOG_INFO("[PASS] {} ({:.3f}ms)", name, result.ElapsedMs);
+            else
+                LUMINA_LOG_ERROR("[FAIL] {} - {} ({:.3f}ms)", name, result.Message, result.ElapsedMs);
+
+            return result;
+        }
+
+        void PlaybackTestSuite::Test_Timing_NeverWakesEarly()
+        {
+            std::mt19937 rng(42);
+            std::uniform_int_distribution<int64_t> delay(100000, 3000000);
+            PlaybackControl control;
+
+            for (TimingStrategy strategy : AllStrategies)
+            {
+                TimingSettings settings;
+                settings.Strategy = strategy;
+                auto timing = TimingEngine::Create(settings);
+
+                for (int i = 0; i < 20; i++)
+                {
+                    int64_t deadline = Clock::Now() + delay(rng);
+
+                    if (!timing->WaitUntil(deadline, control))
+                        throw std::runtime_error(std::string(GetStrategyName(strategy)) + " reported a cancellation");
+
+                    if (Clock::Now() < deadline)
+                        throw std::runtime_error(std::string(GetStrategyName(strategy)) + " returned before the deadline");
+                }
+            }
+        }
+
+        void PlaybackTestSuite::Test_Timing_StopInterruptsWait()
+        {
+            for (TimingStrategy strategy : AllStrategies)
+            {
+                TimingSettings settings;
+                settings.Strategy = strategy;
+                auto timing = TimingEngine::Create(settings);
+
+                PlaybackControl control;
+                std::atomic<int64_t> stopTime{ 0 };
+                std::thread stopper([&control, &stopTime]() {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    stopTime = Clock::Now();
+                    control.Stop();
+                });
+
+                bool completed = timing->WaitUntil(Clock::Now() + 10 * Clock::NanosecondsPerSecond, control);
+                int64_t wakeLatency = Clock::Now() - stopTime;
+
+                stopper.join();
+
+                if (completed)
+                    throw std::runtime_error(std::string(GetStrategyName(strategy)) + " ignored the stop");
+
+                // The wait is woken directly rather than noticing the stop on its next poll
+                if (wakeLatency > 10 * Clock::NanosecondsPerMillisecond)
+                    throw std::runtime_error(std::string(GetStrategyName(strategy)) + " took too long to notice the stop");
+            }
+        }
+
+        void PlaybackTestSuite::Test_Injection_BatchFallsBackToPerEventCalls()
+        {
+            MockInputPlayback mock;
+            InputBatch batch(mock);
+
+            if (batch.IsBatched())
+                throw std::runtime_error("Mock backend should not take the batch path");
+
+            batch.Add(InputCommand{ RecordedAction::KeyPressed, static_cast<int>(Lumina::KeyCode::A) });
+            batch.Add(InputCommand{ RecordedAction::MouseMoved, 0, 10, 20 });
+            batch.Add(InputCommand{ RecordedAction::MouseScrolled, 0, 0, -3 });
+            batch.Add(InputCommand{ RecordedAction::KeyReleased, static_cast<int>(Lumina::KeyCode::A) });
+            batch.Submit();
+
+            auto injections = mock.GetInjections();
+            if (injections.size() != 4 || !batch.IsEmpty())
+                throw std::runtime_error("Expected 4 injections and an empty batch");
+
+            if (injections[0].Action != RecordedAction::KeyPressed || injections[0].A != static_cast<int>(Lumina::KeyCode::A) ||
+                injections[1].Action != RecordedAction::MouseMoved || injections[1].A != 10 || injections[1].B != 20 ||
+                injections[2].Action != RecordedAction::MouseScrolled || injections[2].B != -3 ||
+                injections[3].Action != RecordedAction::KeyReleased)
+                throw std::runtime_error("Fallback injected the wrong inputs or order");
+        }
+
+        void PlaybackTestSuite::Test_Injection_BatchSubmitsInOneCall()
+        {
+            BatchCountingInputPlayback backend;
+            InputBatch batch(backend);
+
+            if (!batch.IsBatched())
+                throw std::runtime_error("Batch backend was not detected");
+
+            for (int i = 0; i < 100; i++)
+                batch.Add(InputCommand{ RecordedAction::MouseMoved, 0, i, i });
+
+            batch.Submit();
+            batch.Submit(); // Empty, must not reach the backend
+
+            if (backend.GetCalls() != 1 || backend.GetEvents() != 100)
+                throw std::runtime_error("Expected 1 call with 100 events, got " + std::to_string(backend.GetCalls()) + " calls");
+        }
+
+        void PlaybackTestSuite::Test_Index_FindsEventsByTime()
+        {
+            Recording recording = MakeRandomInputRecording(5000, 7);
+            RecordingIndex index(recording.Events);
+
+            const auto& timestamps = recording.Events.GetTimestamps();
+            for (int64_t time = -Clock::NanosecondsPerMillisecond; time <= recording.Duration + Clock::NanosecondsPerMillisecond; time += Clock::NanosecondsPerMillisecond / 2)
+            {
+                size_t expected = 0;
+                while (expected < timestamps.size() && timestamps[expected] < time)
+                    expected++;
+
+                if (index.FindEvent(time) != expected)
+                    throw std::runtime_error("Wrong event for time " + std::to_string(time));
+            }
+        }
+
+        void PlaybackTestSuite::Test_Index_HeldStateMatchesReplay()
+        {
+            Recording recording = MakeRandomInputRecording(10000, 11);
+            RecordingIndex index(recording.Events);
+
+            if (index.GetCheckpointCount() != (recording.Events.Size() + RecordingIndex::CheckpointInterval - 1) / RecordingIndex::CheckpointInterval)
+                throw std::runtime_error("Unexpected checkpoint count");
+
+            // Every index, including checkpoint boundaries and one past the end
+            HeldInputState replayed;
+            for (size_t i = 0; i <= recording.Events.Size(); i++)
+            {
+                HeldInputState indexed = index.GetStateAt(i);
+                if (indexed.Keys != replayed.Keys || indexed.Buttons != replayed.Buttons)
+                    throw std::runtime_error("Held state differs from replay at event " + std::to_string(i));
+
+                if (i < recording.Events.Size())
+                    replayed.Apply(recording.Events[i]);
+            }
+        }
+
+        void PlaybackTestSuite::Test_Playback_InjectsAllEventsInOrder()
+        {
+            RecordingSnapshot recording = MakeTimedRecording(50, Clock::NanosecondsPerMillisecond);
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+
+            PlaybackSession session(std::move(mock));
+
+            int64_t playTime = Clock::Now();
+            if (!session.Play(recording))
+                throw std::runtime_error("Play failed");
+
+            WaitForPlayback(session, 5 * Clock::NanosecondsPerSecond);
+
+            auto injections = injected->GetInjections();
+            if (injections.size() != recording->Events.Size())
+                throw std::runtime_error("Expected " + std::to_string(recording->Events.Size()) + " injections, got " + std::to_string(injections.size()));
+
+            for (size_t i = 0; i < injections.size(); i++)
+            {
+                if (injections[i].Action != RecordedAction::MouseMoved || injections[i].A != static_cast<int>(i))
+                    throw std::runtime_error("Injection out of order at index " + std::to_string(i));
+
+                // Never ahead of schedule
+                if (injections[i].Time < playTime + recording->Events[i].GetTimestamp())
+                    throw std::runtime_error("Event injected early at index " + std::to_string(i));
+            }
+        }
+
+        void PlaybackTestSuite::Test_Playback_PauseHoldsInjection()
+        {
+            RecordingSnapshot recording = MakeTimedRecording(100, Clock::NanosecondsPerMillisecond);
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+
+            PlaybackSession session(std::move(mock));
+            if (!session.Play(recording))
+                throw std::runtime_error("Play failed");
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            session.Pause();
+
+            // Let an in-flight event land, then nothing more may be injected while paused
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            size_t pausedCount = injected->GetInjections().size();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+            auto injections = injected->GetInjections();
+            if (injections.size() != pausedCount)
+                throw std::runtime_error("Events were injected while paused");
+
+            if (pausedCount == 0 || pausedCount >= recording->Events.Size())
+                throw std::runtime_error("Pause landed outside the recording (" + std::to_string(pausedCount) + " events played)");
+
+            int64_t resumeTime = Clock::Now();
+            session.Resume();
+            WaitForPlayback(session, 5 * Clock::NanosecondsPerSecond);
+
+            injections = injected->GetInjections();
+            if (injections.size() != recording->Events.Size())
+                throw std::runtime_error("Expected " + std::to_string(recording->Events.Size()) + " injections, got " + std::to_string(injections.size()));
+
+            // The remaining events keep their spacing after the pause instead of firing in a burst
+            int64_t resumedSpan = injections.back().Time - injections[pausedCount].Time;
+            int64_t recordedSpan = recording->Events.Back().GetTimestamp() - recording->Events[pausedCount].GetTimestamp();
+            if (injections[pausedCount].Time < resumeTime || resumedSpan < recordedSpan - 2 * Clock::NanosecondsPerMillisecond)
+                throw std::runtime_error("Playback did not shift its timeline past the pause");
+        }
+
+        void PlaybackTestSuite::Test_Playback_SeekSkipsAhead()
+        {
+            const int64_t INTERVAL = 10 * Clock::NanosecondsPerMillisecond;
+            RecordingSnapshot recording = MakeTimedRecording(100, INTERVAL);
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+
+            PlaybackSession session(std::move(mock));
+            if (!session.Play(recording))
+                throw std::runtime_error("Play failed");
+
+            // Event 90 onwards, which leaves about 100 ms of a 1 s recording
+            std::this_thread::sleep_for(std::chrono::milliseconds(25));
+            session.Seek(90 * INTERVAL);
+
+            Lumina::Timer timer;
+            WaitForPlayback(session, 5 * Clock::NanosecondsPerSecond);
+            float remainingMs = timer.ElapsedMillis();
+
+            auto injections = injected->GetInjections();
+            auto seekTarget = std::find_if(injections.begin(), injections.end(), [](const MockInputPlayback::Injection& injection) { return injection.A >= 90; });
+
+            if (seekTarget == injections.end() || seekTarget->A != 90)
+                throw std::runtime_error("Seek did not resume at the target event");
+
+            if (seekTarget != injections.begin() && (seekTarget - 1)->A > 10)
+                throw std::runtime_error("Events between the old position and the seek target were played");
+
+            if (remainingMs > 500.0f)
+                throw std::runtime_error("Playback after the seek took " + std::to_string(remainingMs) + "ms");
+        }
+
+        void PlaybackTestSuite::Test_Playback_SessionsShareSnapshot()
+        {
+            RecordingSnapshot recording = MakeTimedRecording(50, Clock::NanosecondsPerMillisecond);
+
+            auto firstMock = std::make_unique<MockInputPlayback>();
+            auto secondMock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* firstInjected = firstMock.get();
+            MockInputPlayback* secondInjected = secondMock.get();
+
+            PlaybackSession first(std::move(firstMock));
+            PlaybackSession second(std::move(secondMock));
+
+            if (!first.Play(recording) || !second.Play(recording))
+                throw std::runtime_error("Play failed");
+
+            // Both playback threads reference the same events rather than copies
+            if (recording.use_count() < 3)
+                throw std::runtime_error("Sessions did not share the snapshot");
+
+            WaitForPlayback(first, 5 * Clock::NanosecondsPerSecond);
+            WaitForPlayback(second, 5 * Clock::NanosecondsPerSecond);
+
+            if (firstInjected->GetInjections().size() != recording->Events.Size() ||
+                secondInjected->GetInjections().size() != recording->Events.Size())
+                throw std::runtime_error("A session did not play every event");
+
+            // Finished playbacks release their reference; the thread may still be unwinding
+            int64_t deadline = Clock::Now() + Clock::NanosecondsPerSecond;
+            while (recording.use_count() > 1 && Clock::Now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            if (recording.use_count() != 1)
+                throw std::runtime_error("Finished playback kept the snapshot alive");
+        }
+
+        void PlaybackTestSuite::Test_Playback_CoalescesSimultaneousEvents()
+        {
+            // Two bursts of 20 events sharing a timestamp each
+            Recording bursts("Bursts", true);
+            for (int64_t burstTime : { int64_t(0), 30 * Clock::NanosecondsPerMillisecond })
+            {
+                for (int i = 0; i < 20; i++)
+                {
+                    RecordedEvent event;
+                    event.Action = RecordedAction::MouseMoved;
+                    event.Timestamp = burstTime;
+                    event.MouseX = i;
+                    bursts.Events.Add(event);
+                }
+            }
+            bursts.Duration = bursts.Events.Back().GetTimestamp();
+            RecordingSnapshot recording = std::make_shared<const Recording>(std::move(bursts));
+
+            auto sessionBackend = std::make_unique<BatchCountingInputPlayback>();
+            BatchCountingInputPlayback* sessionCounts = sessionBackend.get();
+
+            PlaybackSession session(std::move(sessionBackend));
+            if (!session.Play(recording))
+                throw std::runtime_error("Play failed");
+            WaitForPlayback(session, 5 * Clock::NanosecondsPerSecond);
+
+            auto engineBackend = std::make_unique<BatchCountingInputPlayback>();
+            BatchCountingInputPlayback* engineCounts = engineBackend.get();
+
+            PlaybackEngine engine(std::move(engineBackend));
+            if (engine.Play(recording) == InvalidPlaybackId)
+                throw std::runtime_error("Play failed");
+            WaitForEngine(engine, 5 * Clock::NanosecondsPerSecond);
+
+            for (BatchCountingInputPlayback* counts : { sessionCounts, engineCounts })
+            {
+                if (counts->GetEvents() != recording->Events.Size())
+                    throw std::runtime_error("Expected " + std::to_string(recording->Events.Size()) + " events, got " + std::to_string(counts->GetEvents()));
+
+                if (counts->GetCalls() != 2)
+                    throw std::runtime_error("Expected one backend call per burst, got " + std::to_string(counts->GetCalls()));
+            }
+        }
+
+        void PlaybackTestSuite::Test_Playback_SeekRestoresHeldKeys()
+        {
+            // Shift held from 0 to 800 ms, with mouse moves every 10 ms up to 1 s
+            Recording shifted("Shifted", true);
+
+            RecordedEvent press;
+            press.Action = RecordedAction::KeyPressed;
+            press.Key = Lumina::KeyCode::LeftShift;
+            shifted.Events.Add(press);
+
+            for (int i = 1; i <= 100; i++)
+            {
+                if (i == 80)
+                {
+                    RecordedEvent release;
+                    release.Action = RecordedAction::KeyReleased;
+                    release.Key = Lumina::KeyCode::LeftShift;
+                    release.Timestamp = 800 * Clock::NanosecondsPerMillisecond;
+                    shifted.Events.Add(release);
+                }
+
+                RecordedEvent move;
+                move.Action = RecordedAction::MouseMoved;
+                move.Timestamp = i * 10 * Clock::NanosecondsPerMillisecond;
+                move.MouseX = i;
+                shifted.Events.Add(move);
+            }
+
+            shifted.Duration = shifted.Events.Back().GetTimestamp();
+            RecordingSnapshot recording = std::make_shared<const Recording>(std::move(shifted));
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+
+            PlaybackSession session(std::move(mock));
+            if (!session.Play(recording))
+                throw std::runtime_error("Play failed");
+
+            auto keyActions = [injected]() {
+                std::vector<RecordedAction> actions;
+                for (const auto& injection : injected->GetInjections())
+                {
+                    if (injection.Action == RecordedAction::KeyPressed || injection.Action == RecordedAction::KeyReleased)
+                        actions.push_back(injection.Action);
+                }
+                return actions;
+            };
+
+            // Past the release: the seek has to let go of shift itself
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            session.Seek(900 * Clock::NanosecondsPerMillisecond);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            // Back inside the held range, by event index: shift goes down again
+            session.SeekToEvent(10);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            // Stopping while shift is held releases it
+            session.Stop();
+
+            std::vector<RecordedAction> expected = {
+                RecordedAction::KeyPressed, RecordedAction::KeyReleased,
+                RecordedAction::KeyPressed, RecordedAction::KeyReleased };
+
+            if (keyActions() != expected)
+                throw std::runtime_error("Expected press, release, press, release of shift; got " + std::to_string(keyActions().size()) + " key events");
+        }
+
+        void PlaybackTestSuite::Test_Playback_StreamsFromReader()
+        {
+            // Three blocks at a microsecond apart, so playback crosses block boundaries quickly
+            const size_t COUNT = 2 * RecordingFormat::EventsPerBlock + 100;
+            RecordingSnapshot recording = MakeTimedRecording(COUNT, 1000);
+
+            std::filesystem::path directory = std::filesystem::temp_directory_path() / "KeyActionsPlaybackTests";
+            std::filesystem::create_directories(directory);
+            std::filesystem::path path = directory / "Streamed.rec";
+
+            if (!Serialization::WriteCompressed(*recording, path))
+                throw std::runtime_error("WriteCompressed failed");
+
+            auto reader = std::make_shared<RecordingReader>();
+            if (!reader->Open(path))
+                throw std::runtime_error("Open failed");
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+
+            PlaybackSession session(std::move(mock));
+            if (!session.Play(reader))
+                throw std::runtime_error("Play failed");
+
+            if (session.GetTotalEvents() != COUNT)
+                throw std::runtime_error("Event count not taken from the reader");
+
+            WaitForPlayback(session, 5 * Clock::NanosecondsPerSecond);
+
+            auto injections = injected->GetInjections();
+            if (injections.size() != COUNT)
+                throw std::runtime_error("Expected " + std::to_string(COUNT) + " injections, got " + std::to_string(injections.size()));
+
+            for (size_t i = 0; i < injections.size(); i++)
+            {
+                if (injections[i].Action != RecordedAction::MouseMoved || injections[i].A != static_cast<int>(i))
+                    throw std::runtime_error("Injection out of order at index " + std::to_string(i));
+            }
+
+            // Playing straight through decodes each block once
+            if (reader->GetDecodeCount() != reader->GetBlockCount())
+                throw std::runtime_error("Blocks were decoded " + std::to_string(reader->GetDecodeCount()) + " times");
+
+            reader->Close();
+            std::filesystem::remove_all(directory);
+        }
+
+        void PlaybackTestSuite::Test_Engine_InterleavesPlaybacks()
+        {
+            const int64_t SLOW_INTERVAL = 5 * Clock::NanosecondsPerMillisecond;
+            const int64_t FAST_INTERVAL = 2 * Clock::NanosecondsPerMillisecond;
+
+            RecordingSnapshot slow = MakeTimedRecording(40, SLOW_INTERVAL, 1);
+            RecordingSnapshot fast = MakeTimedRecording(100, FAST_INTERVAL, 2);
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+
+            PlaybackEngine engine(std::move(mock));
+
+            int64_t slowStart = Clock::Now();
+            PlaybackId slowId = engine.Play(slow);
+            int64_t fastStart = Clock::Now();
+            PlaybackId fastId = engine.Play(fast);
+
+            if (slowId == InvalidPlaybackId || fastId == InvalidPlaybackId || slowId == fastId)
+                throw std::runtime_error("Play failed");
+
+            WaitForEngine(engine, 5 * Clock::NanosecondsPerSecond);
+
+            auto injections = injected->GetInjections();
+            struct Expected { int Tag; RecordingSnapshot Recording; int64_t Start; };
+            for (const Expected& expected : { Expected{ 1, slow, slowStart }, Expected{ 2, fast, fastStart } })
+            {
+                auto played = FilterByTag(injections, expected.Tag);
+                if (played.size() != expected.Recording->Events.Size())
+                    throw std::runtime_error("Playback " + std::to_string(expected.Tag) + " injected " + std::to_string(played.size()) + " events");
+
+                for (size_t i = 0; i < played.size(); i++)
+                {
+                    if (played[i].A != static_cast<int>(i))
+                        throw std::runtime_error("Playback " + std::to_string(expected.Tag) + " out of order at index " + std::to_string(i));
+
+                    if (played[i].Time < expected.Start + expected.Recording->Events[i].GetTimestamp())
+                        throw std::runtime_error("Playback " + std::to_string(expected.Tag) + " injected early at index " + std::to_string(i));
+                }
+            }
+        }
+
+        void PlaybackTestSuite::Test_Engine_PerPlaybackControls()
+        {
+            const int64_t INTERVAL = 2 * Clock::NanosecondsPerMillisecond;
+
+            RecordingSnapshot paused = MakeTimedRecording(100, INTERVAL, 1);
+            RecordingSnapshot fast = MakeTimedRecording(100, INTERVAL, 2);
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+
+            PlaybackEngine engine(std::move(mock));
+            PlaybackId pausedId = engine.Play(paused);
+            PlaybackId fastId = engine.Play(fast);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            engine.Pause(pausedId);
+            engine.SetSpeed(fastId, 4.0f);
+
+            // The sped up playback finishes while the other one stays paused
+            int64_t deadline = Clock::Now() + 5 * Clock::NanosecondsPerSecond;
+            while (engine.IsPlaying(fastId) && Clock::Now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            auto injections = injected->GetInjections();
+            auto fastPlayed = FilterByTag(injections, 2);
+            if (fastPlayed.size() != fast->Events.Size())
+                throw std::runtime_error("Sped up playback did not finish");
+
+            // About 200 ms of events at 4x, so roughly 60 ms including the first 10 ms at 1x
+            int64_t fastSpan = fastPlayed.back().Time - fastPlayed.front().Time;
+            if (fastSpan > 150 * Clock::NanosecondsPerMillisecond)
+                throw std::runtime_error("Speed change was ignored (" + std::to_string(fastSpan / Clock::NanosecondsPerMillisecond) + "ms)");
+
+            size_t pausedCount = FilterByTag(injections, 1).size();
+            if (!engine.IsPaused(pausedId) || pausedCount >= paused->Events.Size())
+                throw std::runtime_error("Paused playback kept running");
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            if (FilterByTag(injected->GetInjections(), 1).size() != pausedCount)
+                throw std::runtime_error("Events were injected while paused");
+
+            engine.Resume(pausedId);
+            WaitForEngine(engine, 5 * Clock::NanosecondsPerSecond);
+
+            if (FilterByTag(injected->GetInjections(), 1).size() != paused->Events.Size())
+                throw std::runtime_error("Resumed playback did not finish");
+        }
+
+        void PlaybackTestSuite::Test_Engine_LoopsUntilStopped()
+        {
+            RecordingSnapshot recording = MakeTimedRecording(5, Clock::NanosecondsPerMillisecond);
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+
+            PlaybackEngine engine(std::move(mock));
+
+            std::atomic<int> finishedCount{ 0 };
+            engine.SetFinishedCallback([&finishedCount](PlaybackId) { finishedCount++; });
+
+            PlaybackSettings settings;
+            settings.Loop = true;
+            PlaybackId id = engine.Play(recording, settings);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            if (!engine.IsPlaying(id) || injected->GetInjections().size() <= recording->Events.Size())
+                throw std::runtime_error("Looping playback did not repeat");
+
+            engine.Stop(id);
+            size_t stoppedCount = injected->GetInjections().size();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            if (engine.IsPlaying(id) || injected->GetInjections().size() != stoppedCount)
+                throw std::runtime_error("Stopped playback kept injecting");
+
+            if (finishedCount != 0)
+                throw std::runtime_error("Finished callback fired for a stopped playback");
+
+            // A loop whose only event is at time zero is due again as soon as it restarts;
+            // each restart has to wait for the next pass instead of spinning under the lock
+            PlaybackId single = engine.Play(MakeTimedRecording(1, 0), settings);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            if (!engine.IsPlaying(single) || engine.GetActiveCount() != 1)
+                throw std::runtime_error("Single event loop stopped on its own");
+
+            engine.Stop(single);
+
+            if (engine.IsPlaying(single) || engine.GetActiveCount() != 0)
+                throw std::runtime_error("Single event loop could not be stopped");
+        }
+
+        void PlaybackTestSuite::Test_Engine_ReleasesHeldInput()
+        {
+            // Shift and a mouse button go down at the start and are never released by the recording
+            auto makeHeld = [](int64_t lastTime) {
+                Recording held("Held", true);
+
+                RecordedEvent press;
+                press.Action = RecordedAction::KeyPressed;
+                press.Key = Lumina::KeyCode::LeftShift;
+                held.Events.Add(press);
+
+                RecordedEvent button;
+                button.Action = RecordedAction::MousePressed;
+                button.Timestamp = Clock::NanosecondsPerMillisecond;
+                held.Events.Add(button);
+
+                RecordedEvent move;
+                move.Action = RecordedAction::MouseMoved;
+                move.Timestamp = lastTime;
+                held.Events.Add(move);
+
+                held.Duration = lastTime;
+                return std::make_shared<const Recording>(std::move(held));
+            };
+
+            auto actionsOf = [](const MockInputPlayback& injected) {
+                std::vector<RecordedAction> actions;
+                for (const auto& injection : injected.GetInjections())
+                {
+                    if (injection.Action != RecordedAction::MouseMoved)
+                        actions.push_back(injection.Action);
+                }
+                return actions;
+            };
+
+            const std::vector<RecordedAction> once = {
+                RecordedAction::KeyPressed, RecordedAction::MousePressed,
+                RecordedAction::KeyReleased, RecordedAction::MouseReleased };
+
+            // Stopped mid-recording
+            {
+                auto mock = std::make_unique<MockInputPlayback>();
+                MockInputPlayback* injected = mock.get();
+
+                PlaybackEngine engine(std::move(mock));
+                PlaybackId id = engine.Play(makeHeld(10 * Clock::NanosecondsPerSecond));
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                engine.Stop(id);
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+                if (actionsOf(*injected) != once)
+                    throw std::runtime_error("Stop left input held");
+            }
+
+            // Played to the end
+            {
+                auto mock = std::make_unique<MockInputPlayback>();
+                MockInputPlayback* injected = mock.get();
+
+                PlaybackEngine engine(std::move(mock));
+                engine.Play(makeHeld(2 * Clock::NanosecondsPerMillisecond));
+                WaitForEngine(engine, 5 * Clock::NanosecondsPerSecond);
+
+                if (actionsOf(*injected) != once)
+                    throw std::runtime_error("Finishing left input held");
+            }
+
+            // Every loop lets go before it starts over
+            {
+                auto mock = std::make_unique<MockInputPlayback>();
+                MockInputPlayback* injected = mock.get();
+
+                PlaybackEngine engine(std::move(mock));
+
+                PlaybackSettings settings;
+                settings.Loop = true;
+                PlaybackId id = engine.Play(makeHeld(2 * Clock::NanosecondsPerMillisecond), settings);
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                engine.Stop(id);
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+                // Presses and releases alternate for each input, and nothing is left down
+                bool keyDown = false;
+                bool buttonDown = false;
+                size_t keyPresses = 0;
+                for (RecordedAction action : actionsOf(*injected))
+                {
+                    bool press = action == RecordedAction::KeyPressed || action == RecordedAction::MousePressed;
+                    bool& down = action == RecordedAction::KeyPressed || action == RecordedAction::KeyReleased ? keyDown : buttonDown;
+                    if (down == press)
+                        throw std::runtime_error("Loop pressed again before releasing");
+
+                    down = press;
+                    keyPresses += action == RecordedAction::KeyPressed;
+                }
+
+                if (keyPresses < 2 || keyDown || buttonDown)
+                    throw std::runtime_error("Looping left input held after " + std::to_string(keyPresses) + " loops");
+            }
+        }
+
+        void PlaybackTestSuite::Test_Performance_LatenessHistogram()
+        {
+            const size_t COUNT = 300;
+            const int64_t INTERVAL = 3 * Clock::NanosecondsPerMillisecond;
+
+            RecordingSnapshot recording = MakeTimedRecording(COUNT, INTERVAL);
+
+            for (TimingStrategy strategy : AllStrategies)
+            {
+                LatenessHistogram histogram = MeasureLateness(recording, strategy);
+
+                LUMINA_LOG_INFO("{} events every {}ms | {}: {}",
+                    COUNT, INTERVAL / Clock::NanosecondsPerMillisecond,
+                    GetStrategyName(strategy), histogram.ToString());
+
+                if (histogram.GetMin() < 0)
+                    throw std::runtime_error(std::string(GetStrategyName(strategy)) + " injected an event early");
+            }
+        }
+
+        void PlaybackTestSuite::Test_Performance_StopToJoinLatency()
+        {
+            const int ITERATIONS = 10;
+
+            // One event far in the future, so Stop() lands in the middle of a long wait
+            RecordingSnapshot recording = MakeTimedRecording(2, 60 * Clock::NanosecondsPerSecond);
+
+            for (TimingStrategy strategy : AllStrategies)
+            {
+                for (bool paused : { false, true })
+                {
+                    LatenessHistogram latency;
+
+                    for (int i = 0; i < ITERATIONS; i++)
+                    {
+                        PlaybackSession session(std::make_unique<MockInputPlayback>());
+
+                        PlaybackSettings settings;
+                        settings.Timing.Strategy = strategy;
+                        if (!session.Play(recording, settings))
+                            throw std::runtime_error("Play failed");
+
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                        if (paused)
+                        {
+                            session.Pause();
+                            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                        }
+
+                        // Stop() returns once the playback thread has been joined
+                        int64_t stopStart = Clock::Now();
+                        session.Stop();
+                        latency.Add(Clock::Now() - stopStart);
+                    }
+
+                    LUMINA_LOG_INFO("Stop to join | {} {}: {}",
+                        GetStrategyName(strategy), paused ? "paused" : "waiting", latency.ToString());
+
+                    if (latency.GetMax() > 10 * Clock::NanosecondsPerMillisecond)
+                        throw std::runtime_error(std::string(GetStrategyName(strategy)) + " took longer than 10ms to stop");
+                }
+            }
+        }
+
+        void PlaybackTestSuite::Test_Performance_IdleCpu()
+        {
+            const int64_t MEASURE_TIME = 500 * Clock::NanosecondsPerMillisecond;
+
+            RecordingSnapshot recording = MakeTimedRecording(2, 60 * Clock::NanosecondsPerSecond);
+
+            for (TimingStrategy strategy : AllStrategies)
+            {
+                for (bool paused : { false, true })
+                {
+                    PlaybackSession session(std::make_unique<MockInputPlayback>());
+
+                    PlaybackSettings settings;
+                    settings.Timing.Strategy = strategy;
+                    if (!session.Play(recording, settings))
+                        throw std::runtime_error("Play failed");
+
+                    if (paused)
+                        session.Pause();
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+                    // This thread only sleeps, so process CPU time is the playback thread idling
+                    int64_t cpuStart = GetProcessCpuTime();
+                    int64_t wallStart = Clock::Now();
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(MEASURE_TIME));
+                    double cpuPercent = 100.0 * (GetProcessCpuTime() - cpuStart) / (Clock::Now() - wallStart);
+
+                    session.Stop();
+
+                    LUMINA_LOG_INFO("Idle CPU | {} {}: {:.2f}%",
+                        GetStrategyName(strategy), paused ? "paused" : "waiting", cpuPercent);
+
+                    // Polling wakes every millisecond by design; everything else should be asleep
+                    if (strategy != TimingStrategy::Poll && cpuPercent > 1.0)
+                        throw std::runtime_error(std::string(GetStrategyName(strategy)) + " used CPU while idle");
+                }
+            }
+        }
+
+        void PlaybackTestSuite::Test_Performance_PlayLatencyBySize()
+        {
+            const size_t SIZES[] = { 1000, 10000, 100000, 1000000 };
+            const int ITERATIONS = 5;
+
+            for (size_t size : SIZES)
+            {
+                RecordingSnapshot recording = MakeTimedRecording(size, Clock::NanosecondsPerMillisecond);
+
+                // What every Play() used to pay to hand the thread its own copy
+                Lumina::Timer copyTimer;
+                Recording copy = *recording;
+                float copyMs = copyTimer.ElapsedMillis();
+
+                LatenessHistogram latency;
+                for (int i = 0; i < ITERATIONS; i++)
+                {
+                    PlaybackSession session(std::make_unique<MockInputPlayback>());
+
+                    int64_t playStart = Clock::Now();
+                    if (!session.Play(recording))
+                        throw std::runtime_error("Play failed");
+                    latency.Add(Clock::Now() - playStart);
+
+                    session.Stop();
+                }
+
+                LUMINA_LOG_INFO("Play() with {} events: p50 {:.1f}us max {:.1f}us | copying the recording: {:.3f}ms",
+                    size, latency.GetPercentile(50.0) / 1000.0, latency.GetMax() / 1000.0, copyMs);
+
+                // Thread start-up only; independent of the recording size
+                if (latency.GetPercentile(50.0) > 5 * Clock::NanosecondsPerMillisecond)
+                    throw std::runtime_error("Play() took longer than 5ms with " + std::to_string(size) + " events");
+            }
+        }
+
+        void PlaybackTestSuite::Test_Performance_EngineHundredsOfPlaybacks()
+        {
+            const int PLAYBACKS = 500;
+            const size_t EVENTS = 20;
+            const int64_t INTERVAL = 10 * Clock::NanosecondsPerMillisecond;
+
+            auto mock = std::make_unique<MockInputPlayback>();
+            MockInputPlayback* injected = mock.get();
+            injected->Reserve(PLAYBACKS * EVENTS);
+
+            PlaybackEngine engine(std::move(mock));
+
+            std::vector<int64_t> startTimes(PLAYBACKS);
+            for (int tag = 0; tag < PLAYBACKS; tag++)
+            {
+                startTimes[tag] = Clock::Now();
+                if (engine.Play(MakeTimedRecording(EVENTS, INTERVAL, tag)) == InvalidPlaybackId)
+                    throw std::runtime_error("Play failed");
+            }
+
+            WaitForEngine(engine, 10 * Clock::NanosecondsPerSecond);
+
+            auto injections = injected->GetInjections();
+            if (injections.size() != PLAYBACKS * EVENTS)
+                throw std::runtime_error("Expected " + std::to_string(PLAYBACKS * EVENTS) + " injections, got " + std::to_string(injections.size()));
+
+            LatenessHistogram histogram;
+            for (const auto& injection : injections)
+                histogram.Add(injection.Time - (startTimes[injection.B] + injection.A * INTERVAL));
+
+            LUMINA_LOG_INFO("{} playbacks x {} events on one timer thread: {}", PLAYBACKS, EVENTS, histogram.ToString());
+
+            if (histogram.GetMin() < 0)
+                throw std::runtime_error("Engine injected an event early");
+        }
+
+        void PlaybackTestSuite::Test_Performance_BatchedInjectionThroughput()
+        {
+            const size_t COUNT = 1000000;
+            const size_t BATCH_SIZE = 64;
+
+            RecordingSnapshot recording = MakeTimedRecording(COUNT, 1000);
+            const EventStore& events = recording->Events;
+
+            auto measure = [&events](Lumina::GlobalInputPlayback& backend, bool batched) {
+                Lumina::Timer timer;
+
+                if (batched)
+                {
+                    InputBatch batch(backend);
+                    for (const EventView& event : events)
+                    {
+                        batch.Add(event);
+                        if (batch.Size() == BATCH_SIZE)
+                            batch.Submit();
+                    }
+                    batch.Submit();
+                }
+                else
+                {
+                    for (const EventView& event : events)
+                        InputBatch::Simulate(backend, InputCommand::FromEvent(event));
+                }
+
+                return COUNT / (timer.ElapsedMillis() / 1000.0);
+            };
+
+            for (bool batched : { false, true })
+            {
+                const char* mode = batched ? "batched" : "unbatched";
+
+                MockInputPlayback mock;
+                mock.Reserve(COUNT);
+                double mockRate = measure(mock, batched);
+                if (mock.GetInjections().size() != COUNT)
+                    throw std::runtime_error("Mock backend lost events");
+
+                CountingInputPlayback counting;
+                double countingRate = measure(counting, batched);
+
+                BatchCountingInputPlayback batchCounting;
+                double batchRate = measure(batchCounting, batched);
+
+                if (counting.GetEvents() != COUNT || batchCounting.GetEvents() != COUNT)
+                    throw std::runtime_error("Counting backend lost events");
+
+                LUMINA_LOG_INFO("{} events {} | Mock: {:.1f}M/s | Counting: {:.1f}M/s ({} calls) | Batch counting: {:.1f}M/s ({} calls)",
+                    COUNT, mode, mockRate / 1e6, countingRate / 1e6, counting.GetCalls(), batchRate / 1e6, batchCounting.GetCalls());
+
+                size_t expectedCalls = batched ? (COUNT + BATCH_SIZE - 1) / BATCH_SIZE : COUNT;
+                if (batchCounting.GetCalls() != expectedCalls)
+                    throw std::runtime_error(std::string("Unexpected backend call count ") + mode);
+            }
+        }
+
+        void PlaybackTestSuite::Test_Performance_SeekCost()
+        {
+            const size_t COUNT = 1000000;
+            const int SEEKS = 10000;
+
+            Recording recording = MakeRandomInputRecording(COUNT, 3);
+
+            Lumina::Timer buildTimer;
+            RecordingIndex index(recording.Events);
+            float buildMs = buildTimer.ElapsedMillis();
+
+            std::mt19937 rng(5);
+            std::uniform_int_distribution<int64_t> time(0, recording.Duration);
+
+            // Find the event for a time, then rebuild held input there
+            size_t checksum = 0;
+            Lumina::Timer seekTimer;
+            for (int i = 0; i < SEEKS; i++)
+            {
+                size_t event = index.FindEvent(time(rng));
+                checksum += index.GetStateAt(event).Keys.count();
+            }
+            double seekUs = seekTimer.ElapsedMillis() * 1000.0 / SEEKS;
+
+            // The same seek without checkpoints replays from the start
+            Lumina::Timer replayTimer;
+            for (int i = 0; i < 10; i++)
+            {
+                size_t event = index.FindEvent(time(rng));
+                HeldInputState state;
+                for (size_t e = 0; e < event; e++)
+                    state.Apply(recording.Events[e]);
+                checksum += state.Keys.count();
+            }
+            double replayUs = replayTimer.ElapsedMillis() * 1000.0 / 10;
+
+            LUMINA_LOG_INFO("{} events | index build {:.2f}ms, {} checkpoints | seek {:.2f}us | replay from start {:.1f}us | checksum {}",
+                COUNT, buildMs, index.GetCheckpointCount(), seekUs, replayUs, checksum);
+
+            if (seekUs > 200.0)
+                throw std::runtime_error("Seeking took " + std::to_string(seekUs) + "us");
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+
+#include "KeyActions/Core/Recording.h"
+#include "KeyActions/Core/PlaybackSession.h"
+#include "KeyActions/Core/PlaybackEngine.h"
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        struct TestResult
+        {
+            std::string TestName;
+            bool Passed;
+            std::string Message;
+            float ElapsedMs;
+        };
+
+        class PlaybackTestSuite
+        {
+        public:
+            PlaybackTestSuite() = default;
+
+            std::vector<TestResult> RunAllTests();
+
+            struct TestSummary
+            {
+                int TotalTests = 0;
+                int PassedTests = 0;
+                int FailedTests = 0;
+                float TotalTimeMs = 0.0f;
+                std::vector<TestResult> Results;
+            };
+
+            TestSummary GetLastSummary() const { return m_LastSummary; }
+
+        private:
+            TestSummary m_LastSummary;
+
+            TestResult RunTest(const std::string& name, std::function<void()> testFunc);
+
+            // Timing Engine Tests
+            void Test_Timing_NeverWakesEarly();
+            void Test_Timing_StopInterruptsWait();
+
+            // Input Batch Tests
+            void Test_Injection_BatchFallsBackToPerEventCalls();
+            void Test_Injection_BatchSubmitsInOneCall();
+
+            // Recording Index Tests
+            void Test_Index_FindsEventsByTime();
+            void Test_Index_HeldStateMatchesReplay();
+
+            // Playback Session Tests
+            void Test_Playback_InjectsAllEventsInOrder();
+            void Test_Playback_PauseHoldsInjection();
+            void Test_Playback_SeekSkipsAhead();
+            void Test_Playback_SessionsShareSnapshot();
+            void Test_Playback_CoalescesSimultaneousEvents();
+            void Test_Playback_SeekRestoresHeldKeys();
+            void Test_Playback_StreamsFromReader();
+
+            // Playback Engine Tests
+            void Test_Engine_InterleavesPlaybacks();
+            void Test_Engine_PerPlaybackControls();
+            void Test_Engine_LoopsUntilStopped();
+            void Test_Engine_ReleasesHeldInput();
+            void Test_Performance_LatenessHistogram();
+            void Test_Performance_StopToJoinLatency();
+            void Test_Performance_IdleCpu();
+            void Test_Performance_PlayLatencyBySize();
+            void Test_Performance_EngineHundredsOfPlaybacks();
+            void Test_Performance_BatchedInjectionThroughput();
+            void Test_Performance_SeekCost();
+        };
+    }
+}
\ No newline at end of file
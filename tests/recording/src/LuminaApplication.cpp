@@ -0,0 +1,17 @@
+#include "Lumina/Core/Application.h"
+#include "Lumina/Core/EntryPoint.h"
+
+#include "RecordingTestLayer.h"
+
+Lumina::Application* Lumina::CreateApplication(int argc, char** argv)
+{
+    Lumina::ApplicationSpecification spec;
+    spec.Name = "Recording Test";
+    spec.Width = 900;
+    spec.Height = 900;
+    
+    Lumina::Application* app = new Lumina::Application(spec);
+    app->PushLayer<RecordingTestLayer>();
+    
+    return app;
+}
\ No newline at end of file
@@ -0,0 +1,1543 @@
+#include "RecordingTestSuite.h"
+#include "SyntheticCaptureSource.h"
+
+#include "KeyActions/Core/ModifierTracker.h"
+#include "KeyActions/Core/HotkeyFilter.h"
+#include "KeyActions/Core/MouseMoveDecimator.h"
+#include "KeyActions/Core/RecordingOptimizer.h"
+#include "KeyActions/Core/RecordingIndex.h"
+
+#include "Lumina/Core/Log.h"
+#include "Lumina/Utils/Timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <tuple>
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        namespace
+        {
+            // Mostly mouse movement with key, button and scroll events mixed in, like a real capture
+            std::vector<RecordedEvent> GenerateEvents(size_t eventCount, uint32_t seed = 1234)
+            {
+                std::vector<RecordedEvent> events;
+                events.reserve(eventCount);
+
+                std::mt19937 rng(seed);
+                std::uniform_int_distribution<int> step(-8, 8);
+                std::uniform_int_distribution<int> kind(0, 99);
+                std::uniform_int_distribution<int> letter(0, 25);
+
+                int64_t time = 0;
+                int x = 960;
+                int y = 540;
+
+                for (size_t i = 0; i < eventCount; i++)
+                {
+                    time += 8 * Clock::NanosecondsPerMillisecond;
+
+                    RecordedEvent event;
+                    event.Timestamp = time;
+
+                    int roll = kind(rng);
+                    if (roll < 80)
+                    {
+                        x += step(rng);
+                        y += step(rng);
+                        event.Action = RecordedAction::MouseMoved;
+                        event.MouseX = x;
+                        event.MouseY = y;
+                    }
+                    else if (roll < 90)
+                    {
+                        event.Action = (i % 2 == 0) ? RecordedAction::KeyPressed : RecordedAction::KeyReleased;
+                        event.Key = static_cast<Lumina::KeyCode>(static_cast<int>(Lumina::KeyCode::A) + letter(rng));
+                        event.Modifiers = (roll % 3 == 0 ? ModifierShift : 0) | (roll % 5 == 0 ? ModifierCapsLock : 0);
+                    }
+                    else if (roll < 96)
+                    {
+                        event.Action = (i % 2 == 0) ? RecordedAction::MousePressed : RecordedAction::MouseReleased;
+                        event.Button = Lumina::MouseCode::Button1;
+                        event.MouseX = x;
+                        event.MouseY = y;
+                    }
+                    else
+                    {
+                        event.Action = RecordedAction::MouseScrolled;
+                        event.ScrollDY = (roll % 2 == 0) ? 1 : -1;
+                    }
+
+                    events.push_back(event);
+                }
+
+                return events;
+            }
+
+            EventStore ToStore(const std::vector<RecordedEvent>& events)
+            {
+                EventStore store;
+                store.Reserve(events.size());
+
+                for (const auto& event : events)
+                {
+                    store.Add(event);
+                }
+
+                return store;
+            }
+
+            void ExpectEqual(const RecordedEvent& expected, const EventView& view, size_t index)
+            {
+                RecordedEvent actual = view.ToEvent();
+
+                bool equal = expected.Action == actual.Action &&
+                    expected.Timestamp == actual.Timestamp &&
+                    expected.Key == actual.Key &&
+                    expected.Modifiers == actual.Modifiers &&
+                    expected.Button == actual.Button &&
+                    expected.MouseX == actual.MouseX &&
+                    expected.MouseY == actual.MouseY &&
+                    expected.ScrollDX == actual.ScrollDX &&
+                    expected.ScrollDY == actual.ScrollDY;
+
+                if (!equal)
+                    throw std::runtime_error("Event mismatch at index " + std::to_string(index));
+            }
+
+            // Every point of the trace against the kept path between the kept points around it
+            float MaxPathDeviation(const std::vector<MousePoint>& trace, const std::vector<MousePoint>& kept)
+            {
+                float maxDeviation = 0.0f;
+                size_t segment = 0;
+
+                for (const MousePoint& point : trace)
+                {
+                    while (segment + 2 < kept.size() && kept[segment + 1].Timestamp < point.Timestamp)
+                        segment++;
+
+                    const MousePoint& a = kept[segment];
+                    const MousePoint& b = kept[std::min(segment + 1, kept.size() - 1)];
+                    maxDeviation = std::max(maxDeviation, MouseMoveDecimator::DistanceToSegment(point, a, b));
+                }
+
+                return maxDeviation;
+            }
+
+            std::vector<MousePoint> Decimate(const std::vector<MousePoint>& trace, float tolerance)
+            {
+                MouseMoveDecimator decimator(tolerance);
+                std::vector<MousePoint> kept;
+
+                MousePoint point;
+                for (const MousePoint& move : trace)
+                {
+                    if (decimator.Add(move, point))
+                        kept.push_back(point);
+                }
+
+                if (decimator.Flush(point))
+                    kept.push_back(point);
+
+                return kept;
+            }
+
+            RecordedEvent MakeKey(RecordedAction action, int64_t time, Lumina::KeyCode key)
+            {
+                RecordedEvent event;
+                event.Action = action;
+                event.Timestamp = time;
+                event.Key = key;
+                return event;
+            }
+
+            RecordedEvent MakeMouse(RecordedAction action, int64_t time, int x, int y)
+            {
+                RecordedEvent event;
+                event.Action = action;
+                event.Timestamp = time;
+                event.MouseX = x;
+                event.MouseY = y;
+                return event;
+            }
+
+            RecordedEvent MakeScroll(int64_t time, int dy)
+            {
+                RecordedEvent event;
+                event.Action = RecordedAction::MouseScrolled;
+                event.Timestamp = time;
+                event.ScrollDY = dy;
+                return event;
+            }
+
+            // A typical saved macro: 1 kHz mouse, typing with held keys auto-repeating, wheel bursts and pauses
+            Recording MakeMacro(int seconds, uint32_t seed = 7)
+            {
+                const int64_t MS = Clock::NanosecondsPerMillisecond;
+
+                Recording recording("Macro", true);
+                std::mt19937 rng(seed);
+                std::uniform_int_distribution<int> activity(0, 9);
+                std::uniform_int_distribution<int> letter(0, 25);
+                std::normal_distribution<float> turn(0.0f, 0.05f);
+
+                int64_t time = 0;
+                float heading = 0.0f, x = 500.0f, y = 500.0f;
+
+                for (int second = 0; second < seconds; second++)
+                {
+                    int kind = activity(rng);
+                    if (kind < 5)
+                    {
+                        // A second of mouse movement ending in a click
+                        for (int i = 0; i < 1000; i++)
+                        {
+                            heading += turn(rng);
+                            x += 1.5f * std::cos(heading);
+                            y += 1.5f * std::sin(heading);
+                            recording.Events.Add(MakeMouse(RecordedAction::MouseMoved, time += MS, static_cast<int>(x), static_cast<int>(y)));
+                        }
+                        recording.Events.Add(MakeMouse(RecordedAction::MousePressed, time += 80 * MS, static_cast<int>(x), static_cast<int>(y)));
+                        recording.Events.Add(MakeMouse(RecordedAction::MouseReleased, time += 90 * MS, static_cast<int>(x), static_cast<int>(y)));
+                    }
+                    else if (kind < 8)
+                    {
+                        // Typing, with one key held long enough to auto-repeat at 30 Hz
+                        for (int i = 0; i < 6; i++)
+                        {
+                            Lumina::KeyCode key = static_cast<Lumina::KeyCode>(static_cast<int>(Lumina::KeyCode::A) + letter(rng));
+                            recording.Events.Add(MakeKey(RecordedAction::KeyPressed, time += 70 * MS, key));
+                            if (i == 3)
+                            {
+                                time += 500 * MS;
+                                for (int repeat = 0; repeat < 15; repeat++)
+                                    recording.Events.Add(MakeKey(RecordedAction::KeyPressed, time += 33 * MS, key));
+                            }
+                            recording.Events.Add(MakeKey(RecordedAction::KeyReleased, time += 60 * MS, key));
+                        }
+                    }
+                    else if (kind < 9)
+                    {
+                        // A wheel flick
+                        for (int i = 0; i < 20; i++)
+                            recording.Events.Add(MakeScroll(time += 12 * MS, -1));
+                    }
+                    else
+                    {
+                        // Stepped away for a while
+                        time += 8000 * MS;
+                    }
+                }
+
+                recording.Duration = time + 3000 * MS;
+                return recording;
+            }
+        }
+
+        std::vector<TestResult> RecordingTestSuite::RunAllTests()
+        {
+            m_LastSummary = TestSummary();
+            m_LastSummary.Results.clear();
+
+            LUMINA_LOG_INFO("========================================");
+            LUMINA_LOG_INFO("Running Recording Test Suite");
+            LUMINA_LOG_INFO("========================================");
+
+            Lumina::Timer totalTimer;
+
+            // Event Store Tests
+            m_LastSummary.Results.push_back(RunTest("EventStore - Round Trip", [this]() { Test_EventStore_RoundTrip(); }));
+            m_LastSummary.Results.push_back(RunTest("EventStore - Erase Front", [this]() { Test_EventStore_EraseFront(); }));
+            m_LastSummary.Results.push_back(RunTest("EventStore - Slice", [this]() { Test_EventStore_Slice(); }));
+            m_LastSummary.Results.push_back(RunTest("EventStore - Segment Boundaries", [this]() { Test_EventStore_SegmentBoundaries(); }));
+            m_LastSummary.Results.push_back(RunTest("CaptureRing - Wraparound", [this]() { Test_CaptureRing_Wraparound(); }));
+            m_LastSummary.Results.push_back(RunTest("CaptureRing - Overflow", [this]() { Test_CaptureRing_Overflow(); }));
+            m_LastSummary.Results.push_back(RunTest("CaptureRing - Concurrent Order", [this]() { Test_CaptureRing_ConcurrentOrder(); }));
+            m_LastSummary.Results.push_back(RunTest("Capture - Hook Timestamps", [this]() { Test_Capture_HookTimestamps(); }));
+            m_LastSummary.Results.push_back(RunTest("Capture - Blocked UI Thread", [this]() { Test_Capture_BlockedUIThread(); }));
+            m_LastSummary.Results.push_back(RunTest("ModifierTracker - Key Stream", [this]() { Test_ModifierTracker_KeyStream(); }));
+            m_LastSummary.Results.push_back(RunTest("MouseMoveDecimator - Path", [this]() { Test_MouseMoveDecimator_Path(); }));
+            m_LastSummary.Results.push_back(RunTest("Capture - Mouse Path Before Click", [this]() { Test_Capture_MousePathBeforeClick(); }));
+            m_LastSummary.Results.push_back(RunTest("HookClock - Ticks", [this]() { Test_HookClock_Ticks(); }));
+            m_LastSummary.Results.push_back(RunTest("Capture - Synthetic Source Timestamps", [this]() { Test_Capture_SyntheticSourceTimestamps(); }));
+            m_LastSummary.Results.push_back(RunTest("Capture - Hook Skips Hotkeys", [this]() { Test_Capture_HookSkipsHotkeys(); }));
+            m_LastSummary.Results.push_back(RunTest("Optimizer - Key Repeats", [this]() { Test_Optimizer_KeyRepeats(); }));
+            m_LastSummary.Results.push_back(RunTest("Optimizer - Scroll Bursts", [this]() { Test_Optimizer_ScrollBursts(); }));
+            m_LastSummary.Results.push_back(RunTest("Optimizer - Idle Gaps", [this]() { Test_Optimizer_IdleGaps(); }));
+            m_LastSummary.Results.push_back(RunTest("Optimizer - Same Final State", [this]() { Test_Optimizer_SameFinalState(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Memory Per Million Events", [this]() { Test_Performance_MemoryPerMillion(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Scan Throughput", [this]() { Test_Performance_ScanThroughput(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Hook To Store Latency", [this]() { Test_Performance_HookToStoreLatency(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Capture Cost Per Event", [this]() { Test_Performance_CaptureCostPerEvent(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Mouse Decimation", [this]() { Test_Performance_MouseDecimation(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Optimize Macro", [this]() { Test_Performance_OptimizeMacro(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Worst Case Push", [this]() { Test_Performance_WorstCasePush(); }));
+
+            m_LastSummary.TotalTimeMs = totalTimer.ElapsedMillis();
+
+            // Calculate summary
+            m_LastSummary.TotalTests = static_cast<int>(m_LastSummary.Results.size());
+            for (const auto& result : m_LastSummary.Results)
+            {
+                if (result.Passed)
+                    m_LastSummary.PassedTests++;
+                else
+                    m_LastSummary.FailedTests++;
+            }
+
+            LUMINA_LOG_INFO("========================================");
+            LUMINA_LOG_INFO("Test Suite Complete");
+            LUMINA_LOG_INFO("Total: {} | Passed: {} | Failed: {}",
+                m_LastSummary.TotalTests,
+                m_LastSummary.PassedTests,
+                m_LastSummary.FailedTests);
+            LUMINA_LOG_INFO("Total Time: {:.3f}ms", m_LastSummary.TotalTimeMs);
+            LUMINA_LOG_INFO("========================================");
+
+            return m_LastSummary.Results;
+        }
+
+        TestResult RecordingTestSuite::RunTest(const std::string& name, std::function<void()> testFunc)
+        {
+            TestResult result;
+            result.TestName = name;
+            result.Passed = false;
+
+            Lumina::Timer timer;
+
+            try
+            {
+                testFunc();
+                result.Passed = true;
+                result.Message = "Passed";
+            }
+            catch (const std::exception& e)
+            {
+                result.Passed = false;
+                result.Message = std::string("Exception: ") + e.what();
+            }
+            catch (...)
+            {
+                result.Passed = false;
+                result.Message = "Unknown exception";
+            }
+
+            result.ElapsedMs = timer.ElapsedMillis();
+
+            if (result.Passed)
+                LUMINA_LOG_INFO("[PASS] {} ({:.3f}ms)", name, result.ElapsedMs);
+            else
+                LUMINA_LOG_ERROR("[FAIL] {} - {} ({:.3f}ms)", name, result.Message, result.ElapsedMs);
+
+            return result;
+        }
+
+        void RecordingTestSuite::Test_EventStore_RoundTrip()
+        {
+            std::vector<RecordedEvent> events = GenerateEvents(5000);
+            EventStore store = ToStore(events);
+
+            if (store.Size() != events.size())
+                throw std::runtime_error("Event count mismatch");
+
+            size_t index = 0;
+            for (const auto& view : store)
+            {
+                ExpectEqual(events[index], view, index);
+                index++;
+            }
+
+            if (index != events.size())
+                throw std::runtime_error("Iterator visited " + std::to_string(index) + " events");
+
+            if (store.Back().GetTimestamp() != events.back().Timestamp)
+                throw std::runtime_error("Back() returned the wrong event");
+        }
+
+        void RecordingTestSuite::Test_EventStore_EraseFront()
+        {
+            std::vector<RecordedEvent> events = GenerateEvents(3000);
+            EventStore store = ToStore(events);
+
+            store.EraseFront(1234);
+
+            if (store.Size() != events.size() - 1234)
+                throw std::runtime_error("Expected " + std::to_string(events.size() - 1234) + " events, got " + std::to_string(store.Size()));
+
+            for (size_t i = 0; i < store.Size(); i++)
+            {
+                ExpectEqual(events[i + 1234], store[i], i);
+            }
+
+            // New events must land after the surviving ones
+            store.Add(events.front());
+            ExpectEqual(events.front(), store.Back(), store.Size() - 1);
+
+            store.EraseFront(store.Size() + 10);
+            if (!store.IsEmpty())
+                throw std::runtime_error("Erasing past the end should empty the store");
+        }
+
+        void RecordingTestSuite::Test_EventStore_Slice()
+        {
+            std::vector<RecordedEvent> events = GenerateEvents(2000);
+            EventStore store = ToStore(events);
+
+            EventStore slice = store.Slice(500, 700);
+            if (slice.Size() != 700)
+                throw std::runtime_error("Slice size mismatch");
+
+            for (size_t i = 0; i < slice.Size(); i++)
+            {
+                ExpectEqual(events[i + 500], slice[i], i);
+            }
+
+            EventStore tail = store.Slice(1900, 500);
+            if (tail.Size() != 100)
+                throw std::runtime_error("Slice past the end should be clamped");
+
+            EventStore joined = store.Slice(0, 1000);
+            joined.Append(store.Slice(1000, 1000));
+            for (size_t i = 0; i < joined.Size(); i++)
+            {
+                ExpectEqual(events[i], joined[i], i);
+            }
+        }
+
+        void RecordingTestSuite::Test_EventStore_SegmentBoundaries()
+        {
+            // Enough events to fill the doubling segments and several full-size ones
+            std::vector<RecordedEvent> events = GenerateEvents(100000);
+            EventStore store;
+
+            store.Add(events[0]);
+            const int64_t* first = &store.GetTimestamps()[0];
+
+            for (size_t i = 1; i < events.size(); i++)
+                store.Add(events[i]);
+
+            if (&store.GetTimestamps()[0] != first)
+                throw std::runtime_error("Growing the store moved existing events");
+
+            for (size_t i = 0; i < store.Size(); i++)
+                ExpectEqual(events[i], store[i], i);
+
+            auto found = std::lower_bound(store.GetTimestamps().begin(), store.GetTimestamps().end(), events[54321].Timestamp);
+            if (*found != events[54321].Timestamp)
+                throw std::runtime_error("Binary search over the timestamp column failed");
+
+            // Erase across segment boundaries in uneven steps, then keep appending
+            size_t erased = 0;
+            for (size_t step : { 63, 1, 4000, 16384, 17000 })
+            {
+                store.EraseFront(step);
+                erased += step;
+
+                for (size_t i = 0; i < store.Size(); i += 97)
+                    ExpectEqual(events[i + erased], store[i], i);
+            }
+
+            size_t before = store.GetMemoryUsage();
+            for (size_t i = 0; i < 20000; i++)
+                store.Add(events[i]);
+
+            ExpectEqual(events[19999], store.Back(), store.Size() - 1);
+            if (store.GetMemoryUsage() <= before)
+                throw std::runtime_error("Appending after an erase should allocate new segments");
+
+            EventStore copy = store;
+            for (size_t i = 0; i < copy.Size(); i += 101)
+                ExpectEqual(store[i].ToEvent(), copy[i], i);
+        }
+
+        void RecordingTestSuite::Test_CaptureRing_Wraparound()
+        {
+            SpscRing<int> ring(6);
+
+            if (ring.GetCapacity() != 8)
+                throw std::runtime_error("Capacity should round up to a power of two");
+
+            // Interleave pushes and pops so the indices wrap many times
+            int next = 0;
+            int expected = 0;
+            for (int round = 0; round < 1000; round++)
+            {
+                for (int i = 0; i < 5; i++)
+                {
+                    if (!ring.TryPush(next++))
+                        throw std::runtime_error("Push failed with free space");
+                }
+
+                int value = 0;
+                for (int i = 0; i < 3; i++)
+                {
+                    if (!ring.TryPop(value) || value != expected++)
+                        throw std::runtime_error("Pop returned the wrong item");
+                }
+
+                ring.Drain([&](const int& item) {
+                    if (item != expected++)
+                        throw std::runtime_error("Drain returned the wrong item");
+                });
+            }
+
+            int value = 0;
+            if (ring.TryPop(value) || !ring.IsEmpty())
+                throw std::runtime_error("Ring should be empty");
+        }
+
+        void RecordingTestSuite::Test_CaptureRing_Overflow()
+        {
+            SpscRing<int> ring(16);
+
+            for (int i = 0; i < 16; i++)
+            {
+                if (!ring.TryPush(i))
+                    throw std::runtime_error("Push failed before the ring was full");
+            }
+
+            if (ring.TryPush(16) || ring.TryPush(17))
+                throw std::runtime_error("Push should fail when the ring is full");
+
+            if (ring.GetDroppedCount() != 2)
+                throw std::runtime_error("Expected 2 dropped items, got " + std::to_string(ring.GetDroppedCount()));
+
+            // Drops lose the newest items, never overwrite queued ones
+            size_t drained = ring.Drain([](const int&) {}, 4);
+            if (drained != 4 || ring.Size() != 12)
+                throw std::runtime_error("Drain should respect its limit");
+
+            int value = 0;
+            ring.TryPop(value);
+            if (value != 4)
+                throw std::runtime_error("Queued items should survive an overflow");
+
+            if (!ring.TryPush(99))
+                throw std::runtime_error("Push should succeed once space is free");
+        }
+
+        void RecordingTestSuite::Test_CaptureRing_ConcurrentOrder()
+        {
+            const uint64_t COUNT = 2000000;
+
+            SpscRing<uint64_t> ring(1024);
+            std::atomic<bool> done{ false };
+
+            std::thread producer([&]() {
+                for (uint64_t i = 0; i < COUNT; )
+                {
+                    if (ring.TryPush(i))
+                        i++;
+                    else
+                        std::this_thread::yield();
+                }
+                done = true;
+            });
+
+            uint64_t expected = 0;
+            bool inOrder = true;
+
+            Lumina::Timer timer;
+            while (!done || !ring.IsEmpty())
+            {
+                size_t drained = ring.Drain([&](const uint64_t& value) {
+                    if (value != expected)
+                        inOrder = false;
+                    expected++;
+                });
+
+                if (drained == 0)
+                    std::this_thread::yield();
+            }
+            float elapsedMs = timer.ElapsedMillis();
+
+            producer.join();
+
+            // Retried pushes count as drops, so only order and completeness are checked
+            if (!inOrder || expected != COUNT)
+                throw std::runtime_error("Consumer saw items out of order or missing");
+
+            LUMINA_LOG_INFO("{} items across threads in {:.2f}ms ({:.1f} M items/s)",
+                COUNT, elapsedMs, COUNT / (elapsedMs * 1000.0));
+        }
+
+        void RecordingTestSuite::Test_Capture_HookTimestamps()
+        {
+            RecordingSession session;
+
+            RecordingSettings settings;
+            settings.Name = "Capture";
+
+            if (!session.Start(settings))
+                throw std::runtime_error("Failed to start recording");
+
+            // Stamped at the hook, then left in the ring through a slow frame
+            int64_t start = Clock::Now();
+            std::vector<int64_t> hookTimes;
+            for (int i = 0; i < 10; i++)
+            {
+                CapturedInput input;
+                input.Action = RecordedAction::MouseScrolled;
+                input.Timestamp = Clock::Now();
+                input.A = i;
+                session.Capture(input);
+                hookTimes.push_back(input.Timestamp);
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            if (session.GetEventCount() != 0)
+                throw std::runtime_error("Captured input should wait for a drain");
+
+            session.Update(0.016f);
+            session.Stop();
+
+            const EventStore& events = session.GetRecording().Events;
+            if (events.Size() != hookTimes.size())
+                throw std::runtime_error("Expected " + std::to_string(hookTimes.size()) + " events, got " + std::to_string(events.Size()));
+
+            // Spacing must match the hook, not the drain which saw everything at once
+            for (size_t i = 1; i < events.Size(); i++)
+            {
+                int64_t recorded = events[i].GetTimestamp() - events[i - 1].GetTimestamp();
+                int64_t hooked = hookTimes[i] - hookTimes[i - 1];
+
+                if (recorded != hooked || events[i].GetScrollDX() != static_cast<int>(i))
+                    throw std::runtime_error("Event " + std::to_string(i) + " lost its hook timestamp");
+            }
+
+            if (events[0].GetTimestamp() < 0 || events[0].GetTimestamp() > hookTimes[0] - start + Clock::NanosecondsPerMillisecond)
+                throw std::runtime_error("First event should be relative to the recording start");
+
+            CapturedInput late;
+            late.Timestamp = Clock::Now();
+            if (session.Capture(late))
+                throw std::runtime_error("Capture should be refused after Stop()");
+        }
+
+        void RecordingTestSuite::Test_Capture_BlockedUIThread()
+        {
+            const int COUNT = 10000;
+            const int64_t INTERVAL = 50000; // 50us apart, 20k inputs/s
+
+            // Same input stream against both modes; the UI thread blocks for the whole burst
+            auto run = [&](bool useCaptureThread, size_t& maxBacklog, size_t& storedWhileBlocked, uint64_t& dropped) {
+                RecordingSession session;
+
+                RecordingSettings settings;
+                settings.Name = "Blocked";
+                settings.UseCaptureThread = useCaptureThread;
+
+                size_t notified = 0;
+                session.SetEventRecordedCallback([&](const RecordedEvent&) { notified++; });
+
+                if (!session.Start(settings))
+                    throw std::runtime_error("Failed to start recording");
+
+                maxBacklog = 0;
+                std::vector<int64_t> hookTimes(COUNT, 0);
+
+                std::thread hook([&]() {
+                    int64_t next = Clock::Now();
+                    for (int i = 0; i < COUNT; i++)
+                    {
+                        while (Clock::Now() < next)
+                            std::this_thread::yield();
+                        next += INTERVAL;
+
+                        CapturedInput input;
+                        input.Action = RecordedAction::MouseScrolled;
+                        input.Timestamp = Clock::Now();
+                        input.A = i;
+                        hookTimes[i] = input.Timestamp;
+                        session.Capture(input);
+
+                        maxBacklog = std::max(maxBacklog, static_cast<size_t>(i + 1) - session.GetEventCount());
+                    }
+                });
+
+                // Blocked frame: no Update() until the hook is done and the capture thread had a tick
+                hook.join();
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                storedWhileBlocked = session.GetEventCount();
+
+                session.Update(0.016f);
+                session.Stop();
+
+                // A ring's worth of input can wait for a blocked Update(), the rest is lost
+                dropped = session.GetDroppedInputCount();
+
+                const EventStore& events = session.GetRecording().Events;
+                if (events.Size() + dropped != COUNT)
+                    throw std::runtime_error("Expected " + std::to_string(COUNT) + " events, got " + std::to_string(events.Size()));
+
+                for (size_t i = 1; i < events.Size(); i++)
+                {
+                    int index = events[i].GetScrollDX();
+                    int previous = events[i - 1].GetScrollDX();
+
+                    if (events[i].GetTimestamp() - events[i - 1].GetTimestamp() != hookTimes[index] - hookTimes[previous])
+                        throw std::runtime_error("Event " + std::to_string(i) + " lost its hook timestamp");
+                }
+
+                if (notified + session.GetDroppedNotificationCount() != events.Size())
+                    throw std::runtime_error("Every stored event should be notified or counted as dropped");
+            };
+
+            size_t threadBacklog = 0, threadStored = 0;
+            uint64_t threadDropped = 0;
+            run(true, threadBacklog, threadStored, threadDropped);
+
+            size_t uiBacklog = 0, uiStored = 0;
+            uint64_t uiDropped = 0;
+            run(false, uiBacklog, uiStored, uiDropped);
+
+            double perMs = static_cast<double>(Clock::NanosecondsPerMillisecond) / INTERVAL;
+            LUMINA_LOG_INFO("Capture thread | stored while blocked: {}/{} | max backlog: {} events ({:.2f}ms) | dropped: {}",
+                threadStored, COUNT, threadBacklog, threadBacklog / perMs, threadDropped);
+            LUMINA_LOG_INFO("Update() drain | stored while blocked: {}/{} | max backlog: {} events ({:.2f}ms) | dropped: {}",
+                uiStored, COUNT, uiBacklog, uiBacklog / perMs, uiDropped);
+
+            if (threadDropped != 0 || threadStored != COUNT)
+                throw std::runtime_error("Capture thread should store everything while the UI is blocked");
+
+            if (uiStored != 0)
+                throw std::runtime_error("Without the capture thread nothing should be stored until Update()");
+        }
+
+        void RecordingTestSuite::Test_ModifierTracker_KeyStream()
+        {
+            using Lumina::KeyCode;
+
+            ModifierTracker tracker;
+            tracker.Reset();
+
+            auto expect = [](uint8_t actual, uint8_t expected, const char* step) {
+                if (actual != expected)
+                    throw std::runtime_error(std::string("Wrong modifiers after ") + step);
+            };
+
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::A), 0, "plain key");
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::LeftShift), ModifierShift, "left shift down");
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::RightShift), ModifierShift, "right shift down");
+            expect(tracker.Apply(RecordedAction::KeyReleased, KeyCode::LeftShift), ModifierShift, "left shift up with right held");
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::RightControl), ModifierShift | ModifierCtrl, "right ctrl down");
+            expect(tracker.Apply(RecordedAction::KeyReleased, KeyCode::RightShift), ModifierCtrl, "right shift up");
+            expect(tracker.Apply(RecordedAction::KeyReleased, KeyCode::RightControl), 0, "right ctrl up");
+
+            // Caps lock toggles on press and ignores its release
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::CapsLock), ModifierCapsLock, "caps lock on");
+            expect(tracker.Apply(RecordedAction::KeyReleased, KeyCode::CapsLock), ModifierCapsLock, "caps lock release");
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::LeftAlt), ModifierCapsLock | ModifierAlt, "alt with caps lock");
+            expect(tracker.Apply(RecordedAction::KeyReleased, KeyCode::LeftAlt), ModifierCapsLock, "alt up");
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::CapsLock), 0, "caps lock off");
+
+            // Auto-repeat while caps lock is held does not toggle it again
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::CapsLock), 0, "caps lock repeat");
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::CapsLock), 0, "caps lock second repeat");
+            expect(tracker.Apply(RecordedAction::KeyReleased, KeyCode::CapsLock), 0, "caps lock held release");
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::CapsLock), ModifierCapsLock, "caps lock on after repeats");
+            expect(tracker.Apply(RecordedAction::KeyReleased, KeyCode::CapsLock), ModifierCapsLock, "caps lock release after repeats");
+
+            // Seeded state carries until the key stream changes it
+            tracker.Reset(ModifierSuper | ModifierCapsLock);
+            expect(tracker.Apply(RecordedAction::KeyPressed, KeyCode::A), ModifierSuper | ModifierCapsLock, "seeded state");
+            expect(tracker.Apply(RecordedAction::KeyReleased, KeyCode::LeftSuper), ModifierCapsLock, "seeded super up");
+        }
+
+        void RecordingTestSuite::Test_MouseMoveDecimator_Path()
+        {
+            // Straight drag within one window keeps only its ends
+            std::vector<MousePoint> line;
+            for (int i = 0; i <= 50; i++)
+                line.push_back({ i, 100 + i * 3, 200 + i });
+
+            std::vector<MousePoint> kept = Decimate(line, 1.0f);
+            if (kept.size() != 2 || kept.back().X != line.back().X || kept.back().Timestamp != line.back().Timestamp)
+                throw std::runtime_error("A straight drag should keep 2 points, kept " + std::to_string(kept.size()));
+
+            // A sharp turn keeps the corner exactly, however short the legs
+            std::vector<MousePoint> corner;
+            for (int i = 0; i <= 5; i++)
+                corner.push_back({ i, i * 4, 0 });
+            for (int i = 1; i <= 5; i++)
+                corner.push_back({ 5 + i, 20, i * 4 });
+
+            kept = Decimate(corner, 1.0f);
+            if (kept.size() != 3 || kept[1].X != 20 || kept[1].Y != 0)
+                throw std::runtime_error("The corner should be kept");
+
+            // Nothing pending until a second point arrives, and a flush with nothing held does nothing
+            MouseMoveDecimator decimator(2.0f);
+            MousePoint point;
+            if (!decimator.Add({ 0, 5, 5 }, point) || decimator.Flush(point))
+                throw std::runtime_error("The first point should be kept immediately");
+
+            // A zero tolerance keeps everything
+            if (Decimate(line, 0.0f).size() != line.size())
+                throw std::runtime_error("Zero tolerance should keep every move");
+        }
+
+        void RecordingTestSuite::Test_Capture_MousePathBeforeClick()
+        {
+            RecordingSession session;
+
+            RecordingSettings settings;
+            settings.Name = "MousePath";
+            settings.MouseMoveTolerance = 2.0f;
+
+            if (!session.Start(settings))
+                throw std::runtime_error("Failed to start recording");
+
+            int64_t start = Clock::Now();
+            auto capture = [&](RecordedAction action, int64_t offset, int x, int y) {
+                CapturedInput input;
+                input.Action = action;
+                input.Timestamp = start + offset;
+                input.A = x;
+                input.B = y;
+                session.Capture(input);
+            };
+
+            // Drag right, click at the end, then drift away
+            for (int i = 0; i < 50; i++)
+                capture(RecordedAction::MouseMoved, i * 1000, i * 2, 10);
+            capture(RecordedAction::MousePressed, 60000, 98, 10);
+            for (int i = 1; i <= 10; i++)
+                capture(RecordedAction::MouseMoved, 60000 + i * 1000, 98, 10 + i);
+
+            session.Update(0.016f);
+            session.Stop();
+
+            const EventStore& events = session.GetRecording().Events;
+            // The drift starts where the drag ended, which already anchors it
+            if (events.Size() != 4)
+                throw std::runtime_error("Expected drag start, drag end, click and drift end, got " + std::to_string(events.Size()));
+
+            // The drag's end must land before the click, not after it
+            if (events[1].GetAction() != RecordedAction::MouseMoved || events[1].GetX() != 98 ||
+                events[2].GetAction() != RecordedAction::MousePressed)
+                throw std::runtime_error("Held back moves should be recorded before the click");
+
+            if (events[3].GetAction() != RecordedAction::MouseMoved || events[3].GetY() != 20)
+                throw std::runtime_error("Stop() should record the held back end of the path");
+        }
+
+        void RecordingTestSuite::Test_HookClock_Ticks()
+        {
+            const int64_t MS = Clock::NanosecondsPerMillisecond;
+            const int64_t BASE = 1000 * Clock::NanosecondsPerSecond;
+
+            HookClock clock;
+            clock.Calibrate(0xFFFFFFF0u, BASE);
+
+            // Delivered late, stamped when it happened
+            if (clock.ToClock(0xFFFFFFFAu, BASE + 40 * MS) != BASE + 10 * MS)
+                throw std::runtime_error("Tick should map onto the calibrated clock");
+
+            // 32-bit wrap, then a slightly older tick from another hook
+            if (clock.ToClock(5u, BASE + 40 * MS) != BASE + 21 * MS)
+                throw std::runtime_error("Tick should unwrap past 2^32");
+
+            if (clock.ToClock(3u, BASE + 40 * MS) != BASE + 19 * MS)
+                throw std::runtime_error("An out of order tick should map before the previous one");
+
+            // A tick that would land in the future tightens the calibration instead
+            if (clock.ToClock(95u, BASE + 100 * MS) != BASE + 100 * MS)
+                throw std::runtime_error("Stamps should never be later than now");
+
+            if (clock.ToClock(105u, BASE + 500 * MS) != BASE + 110 * MS)
+                throw std::runtime_error("Later ticks should use the tightened calibration");
+
+            // Without Calibrate() the first tick calibrates itself
+            HookClock lazy;
+            if (lazy.ToClock(1000u, BASE) != BASE || lazy.ToClock(1250u, BASE + 300 * MS) != BASE + 250 * MS)
+                throw std::runtime_error("Lazy calibration should start at the first tick");
+        }
+
+        void RecordingTestSuite::Test_Capture_SyntheticSourceTimestamps()
+        {
+            const int64_t MS = Clock::NanosecondsPerMillisecond;
+            const int COUNT = 300;
+
+            // Typing with irregular gaps; the tick counter wraps about four seconds in
+            std::vector<SyntheticCaptureSource::ScriptedInput> script;
+            std::mt19937 rng(11);
+            std::uniform_int_distribution<int64_t> gap(2 * MS, 30 * MS);
+
+            int64_t offset = 0;
+            for (int i = 0; i < COUNT; i++)
+            {
+                offset += gap(rng);
+
+                SyntheticCaptureSource::ScriptedInput scripted;
+                scripted.Input.Action = (i % 2 == 0) ? RecordedAction::KeyPressed : RecordedAction::KeyReleased;
+                scripted.Input.Code = static_cast<int>(Lumina::KeyCode::A) + (i / 2) % 26;
+                scripted.Offset = offset;
+                script.push_back(scripted);
+            }
+
+            SyntheticCaptureSource source(script, 0xFFFFF000u, 100 * MS);
+
+            RecordingSession session;
+            session.SetCaptureSource(&source);
+
+            RecordingSettings settings;
+            settings.Name = "SyntheticSource";
+            settings.UseCaptureThread = true;
+
+            if (!session.Start(settings))
+                throw std::runtime_error("Failed to start recording");
+
+            while (!source.IsDone())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                session.Update(0.016f);
+            }
+
+            session.Stop();
+            session.SetCaptureSource(nullptr);
+
+            const EventStore& events = session.GetRecording().Events;
+            if (events.Size() != COUNT)
+                throw std::runtime_error("Expected " + std::to_string(COUNT) + " events, got " + std::to_string(events.Size()));
+
+            // Hook ticks are whole milliseconds, so each delta may be off by up to one
+            const int64_t TOLERANCE = MS;
+            const std::vector<int64_t>& delivered = source.GetDeliveryTimes();
+
+            int64_t maxError = 0;
+            int64_t maxDispatchError = 0;
+            for (size_t i = 1; i < events.Size(); i++)
+            {
+                int64_t actual = script[i].Offset - script[i - 1].Offset;
+                int64_t recorded = events[i].GetTimestamp() - events[i - 1].GetTimestamp();
+                int64_t dispatched = delivered[i] - delivered[i - 1];
+
+                maxError = std::max(maxError, std::abs(recorded - actual));
+                maxDispatchError = std::max(maxDispatchError, std::abs(dispatched - actual));
+            }
+
+            LUMINA_LOG_INFO("{} inputs delivered up to 100ms late in bursts | max delta error: hook stamps {:.3f}ms, dispatch stamps {:.3f}ms",
+                COUNT, static_cast<double>(maxError) / MS, static_cast<double>(maxDispatchError) / MS);
+
+            if (maxError > TOLERANCE)
+                throw std::runtime_error("Recorded deltas should match the hook within 1ms");
+        }
+
+        void RecordingTestSuite::Test_Capture_HookSkipsHotkeys()
+        {
+            using Lumina::KeyCode;
+            const int64_t MS = Clock::NanosecondsPerMillisecond;
+
+            // What a hook sees around a recording started with Ctrl+Shift+R and stopped with
+            // Ctrl+Shift+S: the start combo let go, some typing, then the stop combo
+            std::vector<std::pair<RecordedAction, KeyCode>> keys = {
+                { RecordedAction::KeyPressed, KeyCode::R },         // Auto-repeat while still held
+                { RecordedAction::KeyReleased, KeyCode::R },
+                { RecordedAction::KeyReleased, KeyCode::LeftShift },
+                { RecordedAction::KeyReleased, KeyCode::LeftControl },
+                { RecordedAction::KeyPressed, KeyCode::R },         // Typed, not the combo
+                { RecordedAction::KeyReleased, KeyCode::R },
+                { RecordedAction::KeyPressed, KeyCode::S },
+                { RecordedAction::KeyReleased, KeyCode::S },
+                { RecordedAction::KeyPressed, KeyCode::LeftControl },
+                { RecordedAction::KeyPressed, KeyCode::LeftShift },
+                { RecordedAction::KeyPressed, KeyCode::S },
+            };
+
+            std::vector<SyntheticCaptureSource::ScriptedInput> script;
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                SyntheticCaptureSource::ScriptedInput scripted;
+                scripted.Input.Action = keys[i].first;
+                scripted.Input.Code = static_cast<int>(keys[i].second);
+                scripted.Offset = static_cast<int64_t>(i + 1) * 10 * MS;
+                script.push_back(scripted);
+            }
+
+            SyntheticCaptureSource source(script, 1000u, 5 * MS);
+
+            RecordingSession session;
+            session.SetCaptureSource(&source);
+
+            RecordingSettings settings;
+            settings.Name = "Hotkeys";
+            settings.HeldAtStart = { KeyCode::LeftControl, KeyCode::LeftShift, KeyCode::R };
+            settings.StopHotkey = { KeyCode::LeftControl, KeyCode::LeftShift, KeyCode::S };
+
+            if (!session.Start(settings))
+                throw std::runtime_error("Failed to start recording");
+
+            while (!source.IsDone())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                session.Update(0.005f);
+            }
+
+            session.Stop();
+            session.SetCaptureSource(nullptr);
+
+            std::vector<std::pair<RecordedAction, KeyCode>> expected = {
+                { RecordedAction::KeyPressed, KeyCode::R },
+                { RecordedAction::KeyReleased, KeyCode::R },
+                { RecordedAction::KeyPressed, KeyCode::S },
+                { RecordedAction::KeyReleased, KeyCode::S },
+                { RecordedAction::KeyPressed, KeyCode::LeftControl },
+                { RecordedAction::KeyPressed, KeyCode::LeftShift },
+            };
+
+            const EventStore& events = session.GetRecording().Events;
+            if (events.Size() != expected.size())
+                throw std::runtime_error("Expected " + std::to_string(expected.size()) + " events, got " + std::to_string(events.Size()));
+
+            for (size_t i = 0; i < expected.size(); i++)
+            {
+                if (events[i].GetAction() != expected[i].first || events[i].GetKey() != expected[i].second)
+                    throw std::runtime_error("Unexpected event at index " + std::to_string(i));
+            }
+
+            // The dropped releases still let go of the modifiers
+            if (events[0].GetModifiers() & (ModifierCtrl | ModifierShift))
+                throw std::runtime_error("Typed key should not carry the start combo's modifiers");
+
+            // Started without holding anything, the same keys are all recorded
+            HotkeyFilter filter;
+            filter.Reset({}, settings.StopHotkey);
+            if (!filter.Apply(RecordedAction::KeyPressed, KeyCode::R) || !filter.Apply(RecordedAction::KeyReleased, KeyCode::R))
+                throw std::runtime_error("Keys should pass when nothing was held at the start");
+        }
+
+        void RecordingTestSuite::Test_Optimizer_KeyRepeats()
+        {
+            using Lumina::KeyCode;
+            const int64_t MS = Clock::NanosecondsPerMillisecond;
+
+            Recording recording("Repeats");
+            recording.Events.Add(MakeKey(RecordedAction::KeyPressed, 0, KeyCode::A));
+            for (int i = 1; i <= 10; i++)
+                recording.Events.Add(MakeKey(RecordedAction::KeyPressed, i * 33 * MS, KeyCode::A));
+            recording.Events.Add(MakeKey(RecordedAction::KeyReleased, 400 * MS, KeyCode::A));
+            recording.Events.Add(MakeKey(RecordedAction::KeyPressed, 500 * MS, KeyCode::A));
+            recording.Events.Add(MakeKey(RecordedAction::KeyReleased, 550 * MS, KeyCode::A));
+            recording.Duration = 600 * MS;
+
+            RecordingOptimizer optimizer;
+            Recording optimized = optimizer.Optimize(recording);
+
+            // The press after the release is a real one
+            if (optimized.Events.Size() != 4 || optimizer.GetStats().KeyRepeatsDropped != 10)
+                throw std::runtime_error("Expected 10 repeats dropped, kept " + std::to_string(optimized.Events.Size()) + " events");
+
+            if (optimized.Events[2].GetAction() != RecordedAction::KeyPressed || optimized.Events[2].GetTimestamp() != 500 * MS)
+                throw std::runtime_error("The second real press should be kept");
+
+            OptimizerSettings settings;
+            settings.DropKeyRepeats = false;
+            if (RecordingOptimizer(settings).Optimize(recording).Events.Size() != recording.Events.Size())
+                throw std::runtime_error("Repeats should be kept when disabled");
+        }
+
+        void RecordingTestSuite::Test_Optimizer_ScrollBursts()
+        {
+            const int64_t MS = Clock::NanosecondsPerMillisecond;
+
+            Recording recording("Scrolls");
+            for (int i = 0; i < 10; i++)
+                recording.Events.Add(MakeScroll(i * 10 * MS, -1));
+
+            // Reversing direction, or a pause past the window, starts a new burst
+            recording.Events.Add(MakeScroll(100 * MS, 1));
+            recording.Events.Add(MakeScroll(110 * MS, 1));
+            recording.Events.Add(MakeScroll(300 * MS, 1));
+            recording.Duration = 400 * MS;
+
+            RecordingOptimizer optimizer;
+            Recording optimized = optimizer.Optimize(recording);
+
+            const EventStore& events = optimized.Events;
+            if (events.Size() != 3)
+                throw std::runtime_error("Expected 3 scrolls, got " + std::to_string(events.Size()));
+
+            if (events[0].GetScrollDY() != -10 || events[0].GetTimestamp() != 0 ||
+                events[1].GetScrollDY() != 2 || events[1].GetTimestamp() != 100 * MS ||
+                events[2].GetScrollDY() != 1)
+                throw std::runtime_error("Bursts should sum their deltas at the time of their first scroll");
+        }
+
+        void RecordingTestSuite::Test_Optimizer_IdleGaps()
+        {
+            using Lumina::KeyCode;
+            const int64_t SECOND = Clock::NanosecondsPerSecond;
+
+            Recording recording("Idle");
+            recording.Events.Add(MakeKey(RecordedAction::KeyPressed, 10 * SECOND, KeyCode::A));     // 10s lead-in
+            recording.Events.Add(MakeKey(RecordedAction::KeyReleased, 11 * SECOND, KeyCode::A));
+            recording.Events.Add(MakeKey(RecordedAction::KeyPressed, 20 * SECOND, KeyCode::B));     // 9s idle
+            recording.Events.Add(MakeKey(RecordedAction::KeyReleased, 30 * SECOND, KeyCode::B));    // 10s held, kept
+            recording.Duration = 40 * SECOND;                                                       // 10s tail
+
+            OptimizerSettings settings;
+            settings.MaxIdleGap = 2 * SECOND;
+
+            RecordingOptimizer optimizer(settings);
+            Recording optimized = optimizer.Optimize(recording);
+
+            const EventStore& events = optimized.Events;
+            int64_t expected[] = { 2 * SECOND, 3 * SECOND, 5 * SECOND, 15 * SECOND };
+            for (size_t i = 0; i < events.Size(); i++)
+            {
+                if (events[i].GetTimestamp() != expected[i])
+                    throw std::runtime_error("Event " + std::to_string(i) + " at the wrong time after trimming");
+            }
+
+            if (optimized.Duration != 17 * SECOND || optimizer.GetStats().IdleGapsTrimmed != 3)
+                throw std::runtime_error("Lead-in, idle gap and tail should be trimmed, the held key not");
+        }
+
+        void RecordingTestSuite::Test_Optimizer_SameFinalState()
+        {
+            Recording recording = MakeMacro(120);
+
+            RecordingOptimizer optimizer;
+            Recording optimized = optimizer.Optimize(recording);
+
+            // Clicks happen at the same places, in the same order
+            auto clicks = [](const EventStore& events) {
+                std::vector<std::tuple<RecordedAction, int, int>> result;
+                for (const EventView& event : events)
+                {
+                    if (event.GetAction() == RecordedAction::MousePressed || event.GetAction() == RecordedAction::MouseReleased)
+                        result.emplace_back(event.GetAction(), event.GetX(), event.GetY());
+                }
+                return result;
+            };
+
+            if (clicks(recording.Events) != clicks(optimized.Events))
+                throw std::runtime_error("Clicks changed");
+
+            // Same keys and buttons down at the end, cursor in the same place
+            RecordingIndex before(recording.Events);
+            RecordingIndex after(optimized.Events);
+            HeldInputState a = before.GetStateAt(recording.Events.Size());
+            HeldInputState b = after.GetStateAt(optimized.Events.Size());
+
+            if (a.Keys != b.Keys || a.Buttons != b.Buttons || a.MouseX != b.MouseX || a.MouseY != b.MouseY)
+                throw std::runtime_error("Final input state changed");
+
+            for (size_t i = 1; i < optimized.Events.Size(); i++)
+            {
+                if (optimized.Events[i].GetTimestamp() < optimized.Events[i - 1].GetTimestamp())
+                    throw std::runtime_error("Optimized events out of order");
+            }
+        }
+
+        void RecordingTestSuite::Test_Performance_MemoryPerMillion()
+        {
+            const size_t COUNT = 1000000;
+
+            std::vector<RecordedEvent> events = GenerateEvents(COUNT);
+            EventStore store = ToStore(events);
+
+            size_t vectorBytes = events.capacity() * sizeof(RecordedEvent);
+            size_t storeBytes = store.GetMemoryUsage();
+
+            LUMINA_LOG_INFO("{} events | std::vector<RecordedEvent>: {:.2f} MB ({} bytes/event) | EventStore: {:.2f} MB ({:.2f} bytes/event)",
+                COUNT,
+                vectorBytes / (1024.0 * 1024.0), sizeof(RecordedEvent),
+                storeBytes / (1024.0 * 1024.0), static_cast<double>(storeBytes) / COUNT);
+            LUMINA_LOG_INFO("EventStore uses {:.1f}% of the vector's memory", 100.0 * storeBytes / vectorBytes);
+
+            if (storeBytes >= vectorBytes)
+                throw std::runtime_error("EventStore should use less memory than std::vector<RecordedEvent>");
+        }
+
+        void RecordingTestSuite::Test_Performance_ScanThroughput()
+        {
+            const size_t COUNT = 1000000;
+            const int PASSES = 10;
+
+            std::vector<RecordedEvent> events = GenerateEvents(COUNT);
+            EventStore store = ToStore(events);
+
+            // Mirrors the playback loop: skip mouse moves, read the timestamp of everything else
+            int64_t vectorSum = 0;
+            Lumina::Timer vectorTimer;
+            for (int pass = 0; pass < PASSES; pass++)
+            {
+                for (const auto& event : events)
+                {
+                    if (event.Action == RecordedAction::MouseMoved)
+                        continue;
+
+                    vectorSum += event.Timestamp;
+                }
+            }
+            float vectorMs = vectorTimer.ElapsedMillis();
+
+            int64_t viewSum = 0;
+            Lumina::Timer viewTimer;
+            for (int pass = 0; pass < PASSES; pass++)
+            {
+                for (const auto& event : store)
+                {
+                    if (event.GetAction() == RecordedAction::MouseMoved)
+                        continue;
+
+                    viewSum += event.GetTimestamp();
+                }
+            }
+            float viewMs = viewTimer.ElapsedMillis();
+
+            int64_t columnSum = 0;
+            Lumina::Timer columnTimer;
+            for (int pass = 0; pass < PASSES; pass++)
+            {
+                const auto& timestamps = store.GetTimestamps();
+                const auto& actions = store.GetActions();
+
+                for (size_t i = 0; i < timestamps.size(); i++)
+                {
+                    if (actions[i] == RecordedAction::MouseMoved)
+                        continue;
+
+                    columnSum += timestamps[i];
+                }
+            }
+            float columnMs = columnTimer.ElapsedMillis();
+
+            if (vectorSum != viewSum || vectorSum != columnSum)
+                throw std::runtime_error("Scans disagree on the result");
+
+            double scanned = static_cast<double>(COUNT) * PASSES;
+            LUMINA_LOG_INFO("Scan of {} events x {} | vector: {:.3f}ms ({:.1f} M events/s) | views: {:.3f}ms ({:.1f} M events/s) | columns: {:.3f}ms ({:.1f} M events/s)",
+                COUNT, PASSES,
+                vectorMs, scanned / (vectorMs * 1000.0),
+                viewMs, scanned / (viewMs * 1000.0),
+                columnMs, scanned / (columnMs * 1000.0));
+        }
+
+        void RecordingTestSuite::Test_Performance_HookToStoreLatency()
+        {
+            const int COUNT = 10000;
+            const int64_t INTERVAL = 100000; // 100us apart, 10k inputs/s, a fast mouse plus typing
+
+            RecordingSession session;
+
+            RecordingSettings settings;
+            settings.Name = "Latency";
+
+            std::vector<int64_t> hookTimes(COUNT, 0);
+            std::vector<int64_t> storeTimes(COUNT, 0);
+            std::vector<int64_t> pushCosts(COUNT, 0);
+
+            session.SetEventRecordedCallback([&](const RecordedEvent& event) {
+                storeTimes[event.ScrollDX] = Clock::Now();
+            });
+
+            if (!session.Start(settings))
+                throw std::runtime_error("Failed to start recording");
+
+            std::atomic<bool> done{ false };
+
+            // Stands in for the OS hook: stamp, push, return
+            std::thread hook([&]() {
+                int64_t next = Clock::Now();
+                for (int i = 0; i < COUNT; i++)
+                {
+                    while (Clock::Now() < next) {}
+                    next += INTERVAL;
+
+                    CapturedInput input;
+                    input.Action = RecordedAction::MouseScrolled;
+                    input.Timestamp = Clock::Now();
+                    input.A = i;
+                    hookTimes[i] = input.Timestamp;
+
+                    session.Capture(input);
+                    pushCosts[i] = Clock::Now() - input.Timestamp;
+                }
+                done = true;
+            });
+
+            // UI thread: 60 FPS with every tenth frame stalling for 60ms
+            int frame = 0;
+            while (!done)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(frame % 10 == 9 ? 60 : 16));
+                session.Update(0.016f);
+                frame++;
+            }
+
+            hook.join();
+            session.Stop();
+
+            if (session.GetDroppedInputCount() != 0)
+                throw std::runtime_error(std::to_string(session.GetDroppedInputCount()) + " inputs dropped");
+
+            const EventStore& events = session.GetRecording().Events;
+            if (events.Size() != COUNT)
+                throw std::runtime_error("Expected " + std::to_string(COUNT) + " events, got " + std::to_string(events.Size()));
+
+            // Recorded spacing against the hook's; stamping at drain time would err by the full latency
+            int64_t maxStampError = 0;
+            for (size_t i = 1; i < events.Size(); i++)
+            {
+                int64_t recorded = events[i].GetTimestamp() - events[i - 1].GetTimestamp();
+                int64_t hooked = hookTimes[i] - hookTimes[i - 1];
+                maxStampError = std::max(maxStampError, std::abs(recorded - hooked));
+            }
+
+            std::vector<int64_t> latencies(COUNT);
+            for (int i = 0; i < COUNT; i++)
+                latencies[i] = storeTimes[i] - hookTimes[i];
+
+            std::sort(latencies.begin(), latencies.end());
+            std::sort(pushCosts.begin(), pushCosts.end());
+
+            auto percentile = [](const std::vector<int64_t>& sorted, double p) {
+                return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+            };
+
+            auto toMs = [](int64_t nanoseconds) { return static_cast<double>(nanoseconds) / Clock::NanosecondsPerMillisecond; };
+
+            LUMINA_LOG_INFO("Hook push over {} inputs | p50: {}ns | p99: {}ns | max: {}ns",
+                COUNT, percentile(pushCosts, 0.5), percentile(pushCosts, 0.99), percentile(pushCosts, 1.0));
+            LUMINA_LOG_INFO("Hook to store over {} frames | p50: {:.2f}ms | p99: {:.2f}ms | max: {:.2f}ms | timestamp error: {}ns",
+                frame, toMs(percentile(latencies, 0.5)), toMs(percentile(latencies, 0.99)), toMs(percentile(latencies, 1.0)), maxStampError);
+
+            if (maxStampError != 0)
+                throw std::runtime_error("Recorded timestamps should match the hook exactly");
+        }
+
+        void RecordingTestSuite::Test_Performance_CaptureCostPerEvent()
+        {
+            const int COUNT = 1000000;
+
+            // Typing with shift: a quarter of key events are modifier transitions
+            std::vector<CapturedInput> inputs(COUNT);
+            for (int i = 0; i < COUNT; i++)
+            {
+                int step = i % 8;
+                inputs[i].Action = (step % 2 == 0) ? RecordedAction::KeyPressed : RecordedAction::KeyReleased;
+                inputs[i].Code = static_cast<int>((step == 0 || step == 7) ? Lumina::KeyCode::LeftShift : Lumina::KeyCode::A);
+                inputs[i].Timestamp = i;
+            }
+
+            // Per-event cost of the modifier state alone, old way and new way. Query() costs
+            // whatever the linked Input backend costs; only against the OS does it compare
+            // with the tracker.
+            uint64_t polledSum = 0;
+            Lumina::Timer pollTimer;
+            for (int i = 0; i < COUNT; i++)
+                polledSum += ModifierTracker::Query();
+            float pollMs = pollTimer.ElapsedMillis();
+
+            ModifierTracker tracker;
+            uint64_t trackedSum = 0;
+            Lumina::Timer trackTimer;
+            for (const CapturedInput& input : inputs)
+                trackedSum += tracker.Apply(input.Action, static_cast<Lumina::KeyCode>(input.Code));
+            float trackMs = trackTimer.ElapsedMillis();
+
+            // Whole capture path: push at the hook, drain into the recording
+            RecordingSession session(COUNT);
+
+            RecordingSettings settings;
+            settings.Name = "CaptureCost";
+
+            if (!session.Start(settings))
+                throw std::runtime_error("Failed to start recording");
+
+            int64_t start = Clock::Now();
+            Lumina::Timer captureTimer;
+            for (CapturedInput input : inputs)
+            {
+                input.Timestamp += start;
+                session.Capture(input);
+            }
+            session.DrainCaptured();
+            float captureMs = captureTimer.ElapsedMillis();
+
+            session.Stop();
+
+            if (session.GetEventCount() != COUNT)
+                throw std::runtime_error("Expected " + std::to_string(COUNT) + " events, got " + std::to_string(session.GetEventCount()));
+
+            const EventStore& events = session.GetRecording().Events;
+            if (events[0].GetModifiers() != ModifierShift || events[1].GetModifiers() != ModifierShift || events[7].GetModifiers() != 0)
+                throw std::runtime_error("Recorded modifiers don't follow the key stream");
+
+            LUMINA_LOG_INFO("Modifier state per key event | Input polling (backend dependent): {:.1f}ns | tracker: {:.1f}ns ({} / {})",
+                pollMs * 1e6 / COUNT, trackMs * 1e6 / COUNT, polledSum, trackedSum);
+            LUMINA_LOG_INFO("Capture to store per key event: {:.1f}ns | sizeof(RecordedEvent): {} bytes",
+                captureMs * 1e6 / COUNT, sizeof(RecordedEvent));
+        }
+
+        void RecordingTestSuite::Test_Performance_MouseDecimation()
+        {
+            const int64_t POLL = Clock::NanosecondsPerMillisecond; // 1000 Hz mouse
+            const int POINTS = 5000;
+            const float PI = 3.14159265f;
+
+            struct Trace
+            {
+                const char* Name;
+                std::vector<MousePoint> Points;
+            };
+
+            std::vector<Trace> traces = { { "straight drags", {} }, { "circles", {} }, { "zig-zag", {} }, { "hand-drawn", {} } };
+
+            std::mt19937 rng(99);
+            std::normal_distribution<float> jitter(0.0f, 0.6f);
+            std::normal_distribution<float> turn(0.0f, 0.08f);
+
+            float heading = 0.0f;
+            float hx = 400.0f, hy = 400.0f;
+
+            for (int i = 0; i < POINTS; i++)
+            {
+                int64_t time = i * POLL;
+
+                // Back and forth across the screen, reversing every 500 samples
+                int leg = i % 1000;
+                int position = leg < 500 ? leg : 1000 - leg;
+                traces[0].Points.push_back({ time, 100 + position * 3, 300 + position });
+
+                float angle = i * 2.0f * PI / 720.0f;
+                traces[1].Points.push_back({ time, static_cast<int>(std::lround(960 + 300 * std::cos(angle))), static_cast<int>(std::lround(540 + 300 * std::sin(angle))) });
+
+                // Sharp 90 degree turns every 40 samples, where a time threshold cuts corners
+                int zig = (i / 40) % 2;
+                traces[2].Points.push_back({ time, 200 + i * 2 - zig * (i % 40) * 2, 200 + zig * (i % 40) * 2 + (i / 80) * 80 });
+
+                // Curved strokes with sensor noise
+                heading += turn(rng);
+                hx += 2.5f * std::cos(heading) + jitter(rng);
+                hy += 2.5f * std::sin(heading) + jitter(rng);
+                traces[3].Points.push_back({ time, static_cast<int>(std::lround(hx)), static_cast<int>(std::lround(hy)) });
+            }
+
+            const float tolerances[] = { 1.0f, 2.0f, 4.0f };
+
+            for (const Trace& trace : traces)
+            {
+                // The fixed 20ms threshold this replaces, with the last point kept for fairness
+                std::vector<MousePoint> timed;
+                int64_t lastTime = -Clock::FromSeconds(1.0);
+                for (const MousePoint& point : trace.Points)
+                {
+                    if (point.Timestamp - lastTime >= Clock::FromSeconds(0.02))
+                    {
+                        timed.push_back(point);
+                        lastTime = point.Timestamp;
+                    }
+                }
+                if (timed.back().Timestamp != trace.Points.back().Timestamp)
+                    timed.push_back(trace.Points.back());
+
+                LUMINA_LOG_INFO("{} ({} moves) | 20ms threshold: {:.1f}x, max deviation {:.2f}px",
+                    trace.Name, trace.Points.size(),
+                    static_cast<double>(trace.Points.size()) / timed.size(), MaxPathDeviation(trace.Points, timed));
+
+                for (float tolerance : tolerances)
+                {
+                    Lumina::Timer timer;
+                    std::vector<MousePoint> kept = Decimate(trace.Points, tolerance);
+                    float elapsedMs = timer.ElapsedMillis();
+
+                    float deviation = MaxPathDeviation(trace.Points, kept);
+
+                    LUMINA_LOG_INFO("    {:.0f}px tolerance: {:.1f}x, max deviation {:.2f}px, {:.0f}ns/move",
+                        tolerance, static_cast<double>(trace.Points.size()) / kept.size(), deviation, elapsedMs * 1e6 / trace.Points.size());
+
+                    if (deviation > tolerance + 0.001f)
+                        throw std::runtime_error(std::string(trace.Name) + " strayed past the tolerance");
+                }
+            }
+        }
+
+        void RecordingTestSuite::Test_Performance_OptimizeMacro()
+        {
+            Recording recording = MakeMacro(600);
+
+            RecordingOptimizer optimizer;
+            Lumina::Timer timer;
+            Recording optimized = optimizer.Optimize(recording);
+            float elapsedMs = timer.ElapsedMillis();
+
+            const OptimizerStats& stats = optimizer.GetStats();
+            double ratio = static_cast<double>(stats.EventsBefore) / stats.EventsAfter;
+
+            LUMINA_LOG_INFO("10 minute macro | events: {} -> {} ({:.1f}x) | duration: {:.1f}s -> {:.1f}s | {:.1f}ms",
+                stats.EventsBefore, stats.EventsAfter, ratio,
+                Clock::ToSeconds(stats.DurationBefore), Clock::ToSeconds(stats.DurationAfter), elapsedMs);
+            LUMINA_LOG_INFO("Mouse moves merged: {} | scrolls coalesced: {} | key repeats dropped: {} | idle gaps trimmed: {} | memory: {:.2f} MB -> {:.2f} MB",
+                stats.MouseMovesMerged, stats.ScrollsCoalesced, stats.KeyRepeatsDropped, stats.IdleGapsTrimmed,
+                recording.Events.GetMemoryUsage() / (1024.0 * 1024.0), optimized.Events.GetMemoryUsage() / (1024.0 * 1024.0));
+
+            if (ratio < 3.0)
+                throw std::runtime_error("Expected at least 3x fewer events");
+        }
+
+        void RecordingTestSuite::Test_Performance_WorstCasePush()
+        {
+            const size_t COUNT = 4000000;
+            const int64_t HITCH = 100000; // 100us, a pause the capture path would notice
+
+            std::vector<RecordedEvent> events = GenerateEvents(COUNT);
+
+            // Single stamp around each push so the spikes line up with the push that caused them
+            auto measure = [&](auto&& push, int64_t& worst, size_t& hitches)
+            {
+                worst = 0;
+                hitches = 0;
+
+                Lumina::Timer timer;
+                for (const RecordedEvent& event : events)
+                {
+                    int64_t start = Clock::Now();
+                    push(event);
+                    int64_t elapsed = Clock::Now() - start;
+
+                    worst = std::max(worst, elapsed);
+                    if (elapsed > HITCH)
+                        hitches++;
+                }
+                return timer.ElapsedMillis();
+            };
+
+            // The old layout: one contiguous vector that copies everything when it grows
+            int64_t vectorWorst = 0;
+            size_t vectorHitches = 0;
+            float vectorMs = 0.0f;
+            {
+                std::vector<RecordedEvent> contiguous;
+                vectorMs = measure([&](const RecordedEvent& event) { contiguous.push_back(event); }, vectorWorst, vectorHitches);
+            }
+
+            int64_t storeWorst = 0;
+            size_t storeHitches = 0;
+            EventStore store;
+            float storeMs = measure([&](const RecordedEvent& event) { store.Add(event); }, storeWorst, storeHitches);
+
+            if (store.Size() != COUNT)
+                throw std::runtime_error("Store lost events");
+
+            LUMINA_LOG_INFO("{} pushes | std::vector<RecordedEvent>: {:.1f}ms total, worst {:.3f}ms, {} over 100us | EventStore: {:.1f}ms total, worst {:.3f}ms, {} over 100us",
+                COUNT,
+                vectorMs, vectorWorst / 1e6, vectorHitches,
+                storeMs, storeWorst / 1e6, storeHitches);
+
+            if (storeWorst >= vectorWorst)
+                throw std::runtime_error("EventStore's worst push should beat a reallocating vector");
+        }
+    }
+}
\ No newline at end of file
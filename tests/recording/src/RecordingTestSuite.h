@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+
+#include "KeyActions/Core/Recording.h"
+#include "KeyActions/Core/CaptureRing.h"
+#include "KeyActions/Core/RecordingSession.h"
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        struct TestResult
+        {
+            std::string TestName;
+            bool Passed;
+            std::string Message;
+            float ElapsedMs;
+        };
+
+        class RecordingTestSuite
+        {
+        public:
+            RecordingTestSuite() = default;
+
+            std::vector<TestResult> RunAllTests();
+
+            struct TestSummary
+            {
+                int TotalTests = 0;
+                int PassedTests = 0;
+                int FailedTests = 0;
+                float TotalTimeMs = 0.0f;
+                std::vector<TestResult> Results;
+            };
+
+            TestSummary GetLastSummary() const { return m_LastSummary; }
+
+        private:
+            TestSummary m_LastSummary;
+
+            TestResult RunTest(const std::string& name, std::function<void()> testFunc);
+
+            // Event Store Tests
+            void Test_EventStore_RoundTrip();
+            void Test_EventStore_EraseFront();
+            void Test_EventStore_Slice();
+            void Test_EventStore_SegmentBoundaries();
+
+            // Capture Tests
+            void Test_CaptureRing_Wraparound();
+            void Test_CaptureRing_Overflow();
+            void Test_CaptureRing_ConcurrentOrder();
+            void Test_Capture_HookTimestamps();
+            void Test_Capture_BlockedUIThread();
+            void Test_ModifierTracker_KeyStream();
+            void Test_MouseMoveDecimator_Path();
+            void Test_Capture_MousePathBeforeClick();
+            void Test_HookClock_Ticks();
+            void Test_Capture_SyntheticSourceTimestamps();
+            void Test_Capture_HookSkipsHotkeys();
+
+            // Optimizer Tests
+            void Test_Optimizer_KeyRepeats();
+            void Test_Optimizer_ScrollBursts();
+            void Test_Optimizer_IdleGaps();
+            void Test_Optimizer_SameFinalState();
+
+            void Test_Performance_MemoryPerMillion();
+            void Test_Performance_ScanThroughput();
+            void Test_Performance_HookToStoreLatency();
+            void Test_Performance_CaptureCostPerEvent();
+            void Test_Performance_MouseDecimation();
+            void Test_Performance_OptimizeMacro();
+            void Test_Performance_WorstCasePush();
+        };
+    }
+}
\ No newline at end of file
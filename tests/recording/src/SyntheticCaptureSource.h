@@ -0,0 +1,105 @@
+#pragma once
+
+#include "KeyActions/Core/CaptureSource.h"
+#include "KeyActions/Core/Clock.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        // Plays a script of inputs as an OS hook would see them: each one happens at a known
+        // time and carries a 32-bit millisecond tick, but reaches the callback late and in
+        // bursts, like a hook thread competing with a busy application.
+        class SyntheticCaptureSource : public CaptureSource
+        {
+        public:
+            struct ScriptedInput
+            {
+                CapturedInput Input;    // Timestamp is ignored
+                int64_t Offset = 0;     // Nanoseconds after the script starts
+            };
+
+            SyntheticCaptureSource(std::vector<ScriptedInput> script, uint32_t startTick, int64_t maxDeliveryDelay)
+                : m_Script(std::move(script)), m_StartTick(startTick), m_MaxDeliveryDelay(maxDeliveryDelay)
+            {
+            }
+
+            ~SyntheticCaptureSource() override { Stop(); }
+
+            bool Start(InputCallback callback) override
+            {
+                m_Callback = std::move(callback);
+                m_Stop = false;
+                m_Done = false;
+                m_StartTime = Clock::Now();
+                m_Thread = std::thread(&SyntheticCaptureSource::Run, this);
+                return true;
+            }
+
+            void Stop() override
+            {
+                m_Stop = true;
+                if (m_Thread.joinable())
+                    m_Thread.join();
+            }
+
+            bool IsDone() const { return m_Done; }
+            int64_t GetStartTime() const { return m_StartTime; }
+
+            // When each input was handed to the callback, the moment a dispatch-time stamp would see
+            const std::vector<int64_t>& GetDeliveryTimes() const { return m_DeliveryTimes; }
+
+        private:
+            void Run()
+            {
+                std::mt19937 rng(5);
+                std::uniform_int_distribution<int64_t> delay(0, m_MaxDeliveryDelay);
+
+                HookClock hookClock;
+                hookClock.Calibrate(m_StartTick, m_StartTime);
+                m_DeliveryTimes.assign(m_Script.size(), 0);
+
+                size_t next = 0;
+                while (next < m_Script.size() && !m_Stop)
+                {
+                    // Stalled for a while, then everything that happened meanwhile arrives at once
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(delay(rng)));
+
+                    int64_t elapsed = Clock::Now() - m_StartTime;
+                    while (next < m_Script.size() && m_Script[next].Offset <= elapsed)
+                    {
+                        uint32_t tick = m_StartTick + static_cast<uint32_t>(m_Script[next].Offset / Clock::NanosecondsPerMillisecond);
+
+                        CapturedInput input = m_Script[next].Input;
+                        input.Timestamp = hookClock.ToClock(tick);
+                        m_Callback(input);
+
+                        m_DeliveryTimes[next] = Clock::Now();
+                        next++;
+                    }
+                }
+
+                m_Done = true;
+            }
+
+        private:
+            std::vector<ScriptedInput> m_Script;
+            uint32_t m_StartTick;
+            int64_t m_MaxDeliveryDelay;
+
+            InputCallback m_Callback;
+            std::thread m_Thread;
+            std::atomic<bool> m_Stop{ false };
+            std::atomic<bool> m_Done{ false };
+            int64_t m_StartTime = 0;
+            std::vector<int64_t> m_DeliveryTimes;
+        };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#include "Lumina/Core/Application.h"
+#include "Lumina/Core/EntryPoint.h"
+
+#include "SerializationTestLayer.h"
+
+Lumina::Application* Lumina::CreateApplication(int argc, char** argv)
+{
+    Lumina::ApplicationSpecification spec;
+    spec.Name = "Serialization Test";
+    spec.Width = 900;
+    spec.Height = 900;
+    
+    Lumina::Application* app = new Lumina::Application(spec);
+    app->PushLayer<SerializationTestLayer>();
+    
+    return app;
+}
\ No newline at end of file
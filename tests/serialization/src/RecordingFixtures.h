@@ -0,0 +1,227 @@
+#pragma once
+
+#include "KeyActions/Core/Recording.h"
+
+#include <json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        // Deterministic synthetic recording: mostly mouse movement with key and button events mixed in
+        inline Recording GenerateRecording(const std::string& name, size_t eventCount, uint32_t seed = 1234)
+        {
+            Recording recording(name, true);
+            recording.Events.Reserve(eventCount);
+
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<int> step(-8, 8);
+            std::uniform_int_distribution<int> kind(0, 99);
+            std::uniform_int_distribution<int> letter(0, 25);
+
+            int64_t time = 0;
+            int x = 960;
+            int y = 540;
+
+            for (size_t i = 0; i < eventCount; i++)
+            {
+                time += 8 * Clock::NanosecondsPerMillisecond;
+
+                RecordedEvent event;
+                event.Timestamp = time;
+
+                int roll = kind(rng);
+                if (roll < 80)
+                {
+                    x += step(rng);
+                    y += step(rng);
+                    event.Action = RecordedAction::MouseMoved;
+                    event.MouseX = x;
+                    event.MouseY = y;
+                }
+                else if (roll < 90)
+                {
+                    event.Action = (i % 2 == 0) ? RecordedAction::KeyPressed : RecordedAction::KeyReleased;
+                    event.Key = static_cast<Lumina::KeyCode>(static_cast<int>(Lumina::KeyCode::A) + letter(rng));
+                    event.Modifiers = (roll % 3 == 0) ? ModifierShift : 0;
+                }
+                else if (roll < 96)
+                {
+                    event.Action = (i % 2 == 0) ? RecordedAction::MousePressed : RecordedAction::MouseReleased;
+                    event.Button = Lumina::MouseCode::Button0;
+                    event.MouseX = x;
+                    event.MouseY = y;
+                }
+                else
+                {
+                    event.Action = RecordedAction::MouseScrolled;
+                    event.ScrollDY = (roll % 2 == 0) ? 1 : -1;
+                }
+
+                recording.Events.Add(event);
+            }
+
+            recording.Duration = time;
+            return recording;
+        }
+
+        inline bool EventsEqual(const EventView& viewA, const EventView& viewB)
+        {
+            const RecordedEvent a = viewA.ToEvent();
+            const RecordedEvent b = viewB.ToEvent();
+
+            return a.Action == b.Action &&
+                a.Timestamp == b.Timestamp &&
+                a.Key == b.Key &&
+                a.Modifiers == b.Modifiers &&
+                a.Button == b.Button &&
+                a.MouseX == b.MouseX &&
+                a.MouseY == b.MouseY &&
+                a.ScrollDX == b.ScrollDX &&
+                a.ScrollDY == b.ScrollDY;
+        }
+
+        // Appends part's events after everything already in the recording, as if recorded next
+        inline void AppendRecording(Recording& recording, const Recording& part)
+        {
+            int64_t offset = recording.Duration;
+
+            for (const auto& view : part.Events)
+            {
+                RecordedEvent event = view.ToEvent();
+                event.Timestamp += offset;
+                recording.Events.Add(event);
+            }
+
+            recording.Duration = offset + part.Duration;
+        }
+
+        inline void ExpectSameRecording(const Recording& actual, const Recording& expected)
+        {
+            if (actual.Name != expected.Name || actual.Duration != expected.Duration ||
+                actual.RecordsMouse != expected.RecordsMouse || actual.Events.Size() != expected.Events.Size())
+                throw std::runtime_error("Recording fields mismatch for " + expected.Name);
+
+            for (size_t i = 0; i < expected.Events.Size(); i++)
+            {
+                if (!EventsEqual(actual.Events[i], expected.Events[i]))
+                    throw std::runtime_error("Event mismatch at " + std::to_string(i) + " of " + expected.Name);
+            }
+        }
+
+        // Writes the same text as Serialization::ExportJson, streamed instead of built as one
+        // JSON document, so benchmark files can be larger than the document would fit in memory
+        inline bool WriteExportedJson(const Recording& recording, const std::filesystem::path& path)
+        {
+            std::ofstream file(path, std::ios::binary);
+            if (!file.is_open())
+                return false;
+
+            std::string text;
+            auto field = [&text](const char* indent, const char* name, int64_t value, bool last) {
+                text += indent;
+                text += '"';
+                text += name;
+                text += "\": ";
+                text += std::to_string(value);
+                text += last ? "\n" : ",\n";
+            };
+
+            // Float seconds are formatted by nlohmann itself, as ExportJson's are
+            auto seconds = [&text](const char* indent, const char* name, int64_t nanoseconds, bool last) {
+                text += indent;
+                text += '"';
+                text += name;
+                text += "\": ";
+                text += nlohmann::json(Clock::ToSeconds(nanoseconds)).dump();
+                text += last ? "\n" : ",\n";
+            };
+
+            auto times = [&field, &seconds](const char* indent, int64_t timestamp, bool last) {
+                seconds(indent, "time", timestamp, false);
+                field(indent, "timestamp", timestamp, last);
+            };
+
+            text += "{\n";
+            field("  ", "duration", recording.Duration, false);
+            text += recording.Events.Size() == 0 ? "  \"events\": [],\n" : "  \"events\": [\n";
+
+            // Keys in the order nlohmann sorts them
+            for (size_t i = 0; i < recording.Events.Size(); i++)
+            {
+                const RecordedEvent event = recording.Events[i].ToEvent();
+                const char* indent = "      ";
+
+                text += "    {\n";
+                field(indent, "action", static_cast<int>(event.Action), false);
+
+                switch (event.Action)
+                {
+                case RecordedAction::KeyPressed:
+                case RecordedAction::KeyReleased:
+                    field(indent, "key", static_cast<int>(event.Key), false);
+                    times(indent, event.Timestamp, true);
+                    break;
+                case RecordedAction::MousePressed:
+                case RecordedAction::MouseReleased:
+                    field(indent, "button", static_cast<int>(event.Button), false);
+                    times(indent, event.Timestamp, false);
+                    field(indent, "x", event.MouseX, false);
+                    field(indent, "y", event.MouseY, true);
+                    break;
+                case RecordedAction::MouseMoved:
+                    times(indent, event.Timestamp, false);
+                    field(indent, "x", event.MouseX, false);
+                    field(indent, "y", event.MouseY, true);
+                    break;
+                case RecordedAction::MouseScrolled:
+                    field(indent, "dx", event.ScrollDX, false);
+                    field(indent, "dy", event.ScrollDY, false);
+                    times(indent, event.Timestamp, true);
+                    break;
+                }
+
+                text += i + 1 < recording.Events.Size() ? "    },\n" : "    }\n  ],\n";
+
+                if (text.size() > (1 << 20))
+                {
+                    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+                    text.clear();
+                }
+            }
+
+            text += "  \"name\": \"" + recording.Name + "\",\n";
+            text += recording.RecordsMouse ? "  \"recordsMouse\": true,\n" : "  \"recordsMouse\": false,\n";
+            seconds("  ", "totalDuration", recording.Duration, true);
+            text += "}";
+
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+            return file.good();
+        }
+
+        inline std::filesystem::path GetTestDirectory()
+        {
+            std::filesystem::path directory = std::filesystem::temp_directory_path() / "KeyActionsTests";
+            std::filesystem::create_directories(directory);
+            return directory;
+        }
+
+        inline uint64_t GetFolderSize(const std::filesystem::path& folder)
+        {
+            uint64_t size = 0;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(folder))
+            {
+                if (entry.is_regular_file())
+                    size += entry.file_size();
+            }
+
+            return size;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "Lumina/Core/Layer.h"
+#include "SerializationTestSuite.h"
+
+namespace Lumina
+{
+    class SerializationTestLayer : public Layer
+    {
+    public:
+        SerializationTestLayer()
+            : Layer("SerializationTestLayer")
+        {
+        }
+
+        virtual void OnAttach() override
+        {
+            LUMINA_LOG_INFO("========================================");
+            LUMINA_LOG_INFO("SerializationTestLayer Attached");
+            LUMINA_LOG_INFO("========================================");
+
+            if (m_RunTestsOnStartup)
+            {
+                LUMINA_LOG_INFO("Running tests on startup...");
+                m_TestSuite.RunAllTests();
+            }
+        }
+
+        virtual void OnDetach() override
+        {
+            LUMINA_LOG_INFO("SerializationTestLayer Detached");
+        }
+
+        virtual void OnUpdate(float timestep) override
+        {
+            // Tests don't need to update every frame
+        }
+
+        virtual void OnUIRender() override
+        {
+            RenderTestControlPanel();
+            RenderTestResults();
+        }
+
+    private:
+        void RenderTestControlPanel()
+        {
+            ImGui::Begin("Serialization Test Control", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+            // Title
+            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.4f, 0.8f, 0.4f, 1.0f));
+            ImGui::TextWrapped("Serialization Test Suite");
+            ImGui::PopStyleColor();
+
+            ImGui::Separator();
+
+            // Run Tests Button
+            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.2f, 1.0f));
+            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.7f, 0.3f, 1.0f));
+            ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.1f, 0.5f, 0.1f, 1.0f));
+
+            if (ImGui::Button("Run All Serialization Tests", ImVec2(220, 40)))
+            {
+                LUMINA_LOG_INFO("========================================");
+                LUMINA_LOG_INFO("User triggered serialization test suite execution");
+                LUMINA_LOG_INFO("========================================");
+                m_TestSuite.RunAllTests();
+            }
+
+            ImGui::PopStyleColor(3);
+
+            // Summary Statistics
+            auto summary = m_TestSuite.GetLastSummary();
+            if (summary.TotalTests > 0)
+            {
+                ImGui::Spacing();
+                ImGui::Separator();
+                ImGui::Spacing();
+
+                bool allPassed = summary.FailedTests == 0;
+                ImVec4 statusColor = allPassed
+                    ? ImVec4(0.0f, 1.0f, 0.0f, 1.0f)  // Green
+                    : ImVec4(1.0f, 0.0f, 0.0f, 1.0f); // Red
+
+                ImGui::PushStyleColor(ImGuiCol_Text, statusColor);
+                ImGui::Text("Status: %s", allPassed ? "ALL TESTS PASSED" : "SOME TESTS FAILED");
+                ImGui::PopStyleColor();
+
+                ImGui::Spacing();
+
+                ImGui::Text("Total Tests:    %d", summary.TotalTests);
+
+                ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f),
+                    "Passed:         %d", summary.PassedTests);
+
+                if (summary.FailedTests > 0)
+                {
+                    ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f),
+                        "Failed:         %d", summary.FailedTests);
+                }
+
+                ImGui::Text("Total Time:     %.3f ms", summary.TotalTimeMs);
+            }
+            else
+            {
+                ImGui::Spacing();
+                ImGui::TextWrapped("No tests have been run yet.");
+            }
+
+            ImGui::Spacing();
+            ImGui::Separator();
+
+            // Options
+            ImGui::Text("Options:");
+            ImGui::Checkbox("Run tests on startup", &m_RunTestsOnStartup);
+            ImGui::Checkbox("Show detailed results", &m_ShowDetailedResults);
+            ImGui::Checkbox("Show only failures", &m_ShowOnlyFailures);
+
+            ImGui::End();
+        }
+
+        void RenderTestResults()
+        {
+            auto summary = m_TestSuite.GetLastSummary();
+
+            if (summary.TotalTests == 0 || !m_ShowDetailedResults)
+                return;
+
+            ImGui::Begin("Serialization Test Results", &m_ShowDetailedResults,
+                ImGuiWindowFlags_HorizontalScrollbar);
+
+            if (ImGui::BeginTable("SerializationTestResultsTable", 4,
+                ImGuiTableFlags_Borders |
+                ImGuiTableFlags_RowBg |
+                ImGuiTableFlags_Resizable |
+                ImGuiTableFlags_ScrollY,
+                ImVec2(0.0f, 500.0f)))
+            {
+                ImGui::TableSetupColumn("Test Name", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("Time (ms)", ImGuiTableColumnFlags_WidthFixed, 100.0f);
+                ImGui::TableSetupColumn("Message", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableHeadersRow();
+
+                for (const auto& result : summary.Results)
+                {
+                    if (m_ShowOnlyFailures && result.Passed)
+                        continue;
+
+                    ImGui::TableNextRow();
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextWrapped("%s", result.TestName.c_str());
+
+                    ImGui::TableNextColumn();
+                    if (result.Passed)
+                        ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "PASS");
+                    else
+                        ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "FAIL");
+
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", result.ElapsedMs);
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextWrapped("%s", result.Message.c_str());
+                }
+
+                ImGui::EndTable();
+            }
+
+            ImGui::End();
+        }
+
+    private:
+        KeyActions::Tests::SerializationTestSuite m_TestSuite;
+
+        // UI State
+        bool m_RunTestsOnStartup = false;
+        bool m_ShowDetailedResults = true;
+        bool m_ShowOnlyFailures = false;
+    };
+}
\ No newline at end of file
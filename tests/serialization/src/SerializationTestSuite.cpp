@@ -0,0 +1,2019 @@
+#include "SerializationTestSuite.h"
+
+#include "RecordingFixtures.h"
+
+#include "Lumina/Core/Log.h"
+#include "Lumina/Utils/Timer.h"
+
+#include "KeyActions/Core/RecordingWriter.h"
+#include "KeyActions/Core/RecordingFormat.h"
+#include "KeyActions/Core/AtomicFile.h"
+#include "KeyActions/Core/RecordingLibrary.h"
+#include "KeyActions/Core/RecordingIO.h"
+#include "KeyActions/Core/JsonRecordingReader.h"
+#include "KeyActions/Core/MappedFile.h"
+#include "KeyActions/Core/RecordingReader.h"
+#include "KeyActions/Core/RecordingIndex.h"
+#include "KeyActions/Core/RecordingStore.h"
+#include "KeyActions/Core/TaskPool.h"
+
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        std::vector<TestResult> SerializationTestSuite::RunAllTests()
+        {
+            m_LastSummary = TestSummary();
+            m_LastSummary.Results.clear();
+
+            LUMINA_LOG_INFO("========================================");
+            LUMINA_LOG_INFO("Running Serialization Test Suite");
+            LUMINA_LOG_INFO("========================================");
+
+            Lumina::Timer totalTimer;
+
+            // Binary Format Tests
+            m_LastSummary.Results.push_back(RunTest("Binary - Round Trip", [this]() { Test_Binary_RoundTrip(); }));
+            m_LastSummary.Results.push_back(RunTest("Binary - Empty Recording", [this]() { Test_Binary_EmptyRecording(); }));
+            m_LastSummary.Results.push_back(RunTest("Binary - Is Detected", [this]() { Test_Binary_IsDetected(); }));
+            m_LastSummary.Results.push_back(RunTest("Binary - Rejects Truncated File", [this]() { Test_Binary_RejectsTruncatedFile(); }));
+            m_LastSummary.Results.push_back(RunTest("Binary - Rejects Oversized Name", [this]() { Test_Binary_RejectsOversizedName(); }));
+            m_LastSummary.Results.push_back(RunTest("Binary - Long Gaps Round Trip", [this]() { Test_Binary_LongGapsRoundTrip(); }));
+            m_LastSummary.Results.push_back(RunTest("Binary - Migrates Legacy File", [this]() { Test_Binary_MigratesLegacyFile(); }));
+            m_LastSummary.Results.push_back(RunTest("Binary - Interrupted Save Keeps Old File", [this]() { Test_Binary_InterruptedSaveKeepsOldFile(); }));
+            m_LastSummary.Results.push_back(RunTest("Compressed - Round Trip", [this]() { Test_Compressed_RoundTrip(); }));
+            m_LastSummary.Results.push_back(RunTest("Compressed - Rejects Damaged File", [this]() { Test_Compressed_RejectsDamagedFile(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Compression", [this]() { Test_Performance_Compression(); }));
+            m_LastSummary.Results.push_back(RunTest("Compressed - Parallel Encoding Matches", [this]() { Test_Compressed_ParallelEncodingMatches(); }));
+            m_LastSummary.Results.push_back(RunTest("Json - Export Import", [this]() { Test_Json_ExportImport(); }));
+            m_LastSummary.Results.push_back(RunTest("Json - Imports Legacy Times", [this]() { Test_Json_ImportsLegacyTimes(); }));
+            m_LastSummary.Results.push_back(RunTest("Json - Reader Matches Document Parser", [this]() { Test_Json_ReaderMatchesDocumentParser(); }));
+            m_LastSummary.Results.push_back(RunTest("Json - Reader Falls Back", [this]() { Test_Json_ReaderFallsBack(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Binary vs Json Load", [this]() { Test_Performance_Binary_VsJson_Load(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Json Reader", [this]() { Test_Performance_JsonReader(); }));
+
+            // Streaming Writer Tests
+            m_LastSummary.Results.push_back(RunTest("Writer - Finalize Round Trip", [this]() { Test_Writer_FinalizeRoundTrip(); }));
+            m_LastSummary.Results.push_back(RunTest("Writer - Recover Partial File", [this]() { Test_Writer_RecoverPartialFile(); }));
+            m_LastSummary.Results.push_back(RunTest("Writer - Discard", [this]() { Test_Writer_Discard(); }));
+            m_LastSummary.Results.push_back(RunTest("Writer - Compress Stream", [this]() { Test_Writer_CompressStream(); }));
+
+            // Library Index Tests
+            m_LastSummary.Results.push_back(RunTest("Library - Incremental Refresh", [this]() { Test_Library_IncrementalRefresh(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Library Listing", [this]() { Test_Performance_LibraryListing(); }));
+
+            // Lazy Reader Tests
+            m_LastSummary.Results.push_back(RunTest("Reader - Matches Full Load", [this]() { Test_Reader_MatchesFullLoad(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Reader Time To First Event", [this]() { Test_Performance_ReaderTimeToFirstEvent(); }));
+
+            // Task Pool Tests
+            m_LastSummary.Results.push_back(RunTest("Pool - Runs Nested Work", [this]() { Test_Pool_RunsNestedWork(); }));
+
+            // Deduplicating Store Tests
+            m_LastSummary.Results.push_back(RunTest("Store - Round Trip And Sharing", [this]() { Test_Store_RoundTripAndSharing(); }));
+            m_LastSummary.Results.push_back(RunTest("Store - Chunk Boundaries Follow Content", [this]() { Test_Store_ChunkBoundariesFollowContent(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Store Deduplication", [this]() { Test_Performance_StoreDeduplication(); }));
+
+            // Async IO Tests
+            m_LastSummary.Results.push_back(RunTest("Async - Load Save List", [this]() { Test_Async_LoadSaveList(); }));
+            m_LastSummary.Results.push_back(RunTest("Async - Cancel", [this]() { Test_Async_Cancel(); }));
+            m_LastSummary.Results.push_back(RunTest("Performance - Async Load Frame Times", [this]() { Test_Performance_AsyncLoadFrameTimes(); }));
+
+            m_LastSummary.TotalTimeMs = totalTimer.ElapsedMillis();
+
+            // Calculate summary
+            m_LastSummary.TotalTests = static_cast<int>(m_LastSummary.Results.size());
+            for (const auto& result : m_LastSummary.Results)
+            {
+                if (result.Passed)
+                    m_LastSummary.PassedTests++;
+                else
+                    m_LastSummary.FailedTests++;
+            }
+
+            LUMINA_LOG_INFO("========================================");
+            LUMINA_LOG_INFO("Test Suite Complete");
+            LUMINA_LOG_INFO("Total: {} | Passed: {} | Failed: {}",
+                m_LastSummary.TotalTests,
+                m_LastSummary.PassedTests,
+                m_LastSummary.FailedTests);
+            LUMINA_LOG_INFO("Total Time: {:.3f}ms", m_LastSummary.TotalTimeMs);
+            LUMINA_LOG_INFO("========================================");
+
+            return m_LastSummary.Results;
+        }
+
+        TestResult SerializationTestSuite::RunTest(const std::string& name, std::function<void()> testFunc)
+        {
+            TestResult result;
+            result.TestName = name;
+            result.Passed = false;
+
+            Lumina::Timer timer;
+
+            try
+            {
+                testFunc();
+                result.Passed = true;
+                result.Message = "Passed";
+            }
+            catch (const std::exception& e)
+            {
+                result.Passed = false;
+                result.Message = std::string("Exception: ") + e.what();
+            }
+            catch (...)
+            {
+                result.Passed = false;
+                result.Message = "Unknown exception";
+            }
+
+            result.ElapsedMs = timer.ElapsedMillis();
+
+            if (result.Passed)
+                LUMINA_LOG_INFO("[PASS] {} ({:.3f}ms)", name, result.ElapsedMs);
+            else
+                LUMINA_LOG_ERROR("[FAIL] {} - {} ({:.3f}ms)", name, result.Message, result.ElapsedMs);
+
+            return result;
+        }
+
+        void SerializationTestSuite::Test_Binary_RoundTrip()
+        {
+            Recording original = GenerateRecording("RoundTrip", 5000);
+            std::filesystem::path path = GetTestDirectory() / "RoundTrip.rec";
+
+            if (!Serialization::WriteBinary(original, path))
+                throw std::runtime_error("WriteBinary failed");
+
+            Recording loaded;
+            if (!Serialization::ReadBinary(loaded, path))
+                throw std::runtime_error("ReadBinary failed");
+
+            if (loaded.Name != original.Name)
+                throw std::runtime_error("Name mismatch");
+
+            if (loaded.RecordsMouse != original.RecordsMouse || loaded.Duration != original.Duration)
+                throw std::runtime_error("Header fields mismatch");
+
+            if (loaded.Events.Size() != original.Events.Size())
+                throw std::runtime_error("Event count mismatch");
+
+            for (size_t i = 0; i < original.Events.Size(); i++)
+            {
+                if (!EventsEqual(original.Events[i], loaded.Events[i]))
+                    throw std::runtime_error("Event mismatch at index " + std::to_string(i));
+            }
+        }
+
+        void SerializationTestSuite::Test_Binary_EmptyRecording()
+        {
+            Recording original("Empty");
+            std::filesystem::path path = GetTestDirectory() / "Empty.rec";
+
+            if (!Serialization::WriteBinary(original, path))
+                throw std::runtime_error("WriteBinary failed");
+
+            Recording loaded = GenerateRecording("Stale", 10);
+            if (!Serialization::ReadBinary(loaded, path))
+                throw std::runtime_error("ReadBinary failed");
+
+            if (loaded.Name != "Empty" || !loaded.Events.IsEmpty())
+                throw std::runtime_error("Loaded recording should be empty");
+        }
+
+        void SerializationTestSuite::Test_Binary_IsDetected()
+        {
+            Recording recording = GenerateRecording("Detect", 10);
+            std::filesystem::path binaryPath = GetTestDirectory() / "Detect.rec";
+            std::filesystem::path jsonPath = GetTestDirectory() / "Detect.json";
+
+            Serialization::WriteBinary(recording, binaryPath);
+            Serialization::ExportJson(recording, jsonPath);
+
+            if (!Serialization::IsBinaryRecording(binaryPath))
+                throw std::runtime_error("Binary file not detected as binary");
+
+            if (Serialization::IsBinaryRecording(jsonPath))
+                throw std::runtime_error("JSON file detected as binary");
+        }
+
+        void SerializationTestSuite::Test_Binary_RejectsTruncatedFile()
+        {
+            Recording recording = GenerateRecording("Truncated", 1000);
+            std::filesystem::path path = GetTestDirectory() / "Truncated.rec";
+
+            Serialization::WriteBinary(recording, path);
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+            Recording loaded;
+            if (Serialization::ReadBinary(loaded, path))
+                throw std::runtime_error("Truncated file should fail to load");
+        }
+
+        void SerializationTestSuite::Test_Binary_RejectsOversizedName()
+        {
+            using namespace RecordingFormat;
+
+            // HeaderSize + NameLength wraps in 32 bits to just below EventsOffset
+            for (uint16_t version : { Version, CompressedVersion })
+            {
+                FileHeader header;
+                header.Version = version;
+                header.NameLength = 0xFFFFFFF0u;
+                header.EventsOffset = 64;
+                header.RecordSize = version == Version ? sizeof(EventRecord) : sizeof(BlockEntry);
+
+                std::filesystem::path path = GetTestDirectory() / ("OversizedName" + std::to_string(version) + ".rec");
+                {
+                    std::vector<char> bytes(64, 0);
+                    std::memcpy(bytes.data(), &header, sizeof(header));
+
+                    std::ofstream file(path, std::ios::binary);
+                    file.write(bytes.data(), bytes.size());
+                }
+
+                if (ValidateHeader(header, 64) || ValidateCompressedHeader(header, 64))
+                    throw std::runtime_error("A name running past the file passed validation");
+
+                Recording loaded;
+                if (Serialization::ReadBinary(loaded, path))
+                    throw std::runtime_error("A name running past the file was loaded");
+
+                RecordingReader reader;
+                if (reader.Open(path))
+                    throw std::runtime_error("A name running past the file was opened");
+            }
+        }
+
+        void SerializationTestSuite::Test_Binary_LongGapsRoundTrip()
+        {
+            // Timestamps deep into a long session, with gaps that do not fit a 32-bit delta
+            const int64_t hour = 3600 * Clock::NanosecondsPerSecond;
+            const int64_t timestamps[] = {
+                1,
+                2,
+                5 * Clock::NanosecondsPerSecond + 3,
+                hour + 123456789,
+                10 * hour + 987654321,
+                10 * hour + 987654322,
+                30 * hour + 1
+            };
+
+            Recording original("LongGaps");
+            for (int64_t timestamp : timestamps)
+            {
+                RecordedEvent event;
+                event.Action = RecordedAction::KeyPressed;
+                event.Key = Lumina::KeyCode::A;
+                event.Timestamp = timestamp;
+                original.Events.Add(event);
+            }
+            original.Duration = timestamps[std::size(timestamps) - 1];
+
+            std::filesystem::path path = GetTestDirectory() / "LongGaps.rec";
+            if (!Serialization::WriteBinary(original, path))
+                throw std::runtime_error("WriteBinary failed");
+
+            Recording loaded;
+            if (!Serialization::ReadBinary(loaded, path))
+                throw std::runtime_error("ReadBinary failed");
+
+            if (loaded.Events.Size() != original.Events.Size() || loaded.Duration != original.Duration)
+                throw std::runtime_error("Event count or duration mismatch");
+
+            for (size_t i = 0; i < original.Events.Size(); i++)
+            {
+                if (loaded.Events[i].GetTimestamp() != original.Events[i].GetTimestamp())
+                    throw std::runtime_error("Timestamp mismatch at index " + std::to_string(i));
+            }
+        }
+
+        void SerializationTestSuite::Test_Binary_MigratesLegacyFile()
+        {
+            using namespace RecordingFormat;
+
+            const std::string name = "Legacy";
+            const float times[] = { 0.25f, 1.5f, 61.125f };
+            std::filesystem::path path = GetTestDirectory() / "Legacy.rec";
+
+            // Write a version 1 file by hand
+            {
+                LegacyFileHeader header = {};
+                header.Magic = Magic;
+                header.Version = LegacyVersion;
+                header.HeaderSize = sizeof(LegacyFileHeader);
+                header.NameLength = static_cast<uint32_t>(name.size());
+                header.EventCount = std::size(times);
+                header.EventsOffset = AlignEventsOffset(sizeof(LegacyFileHeader) + name.size());
+                header.TotalDuration = 62.0f;
+                header.RecordSize = sizeof(LegacyEventRecord);
+
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                file.write(name.data(), name.size());
+
+                const char padding[EventAlignment] = {};
+                file.write(padding, header.EventsOffset - sizeof(header) - name.size());
+
+                for (float time : times)
+                {
+                    LegacyEventRecord record = {};
+                    record.Time = time;
+                    record.Action = static_cast<uint8_t>(RecordedAction::MouseMoved);
+                    record.A = 10;
+                    record.B = 20;
+                    file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+                }
+            }
+
+            Recording loaded;
+            if (!Serialization::LoadRecording(loaded, path.string()))
+                throw std::runtime_error("LoadRecording failed");
+
+            if (loaded.Name != name || loaded.Events.Size() != std::size(times) || loaded.Duration != 62 * Clock::NanosecondsPerSecond)
+                throw std::runtime_error("Legacy header fields mismatch");
+
+            for (size_t i = 0; i < std::size(times); i++)
+            {
+                auto event = loaded.Events[i];
+                if (event.GetTimestamp() != Clock::FromSeconds(times[i]) || event.GetX() != 10 || event.GetY() != 20)
+                    throw std::runtime_error("Legacy event mismatch at index " + std::to_string(i));
+            }
+
+            if (Serialization::GetBinaryVersion(path) != CompressedVersion)
+                throw std::runtime_error("Legacy file was not migrated to the current version");
+
+            Recording migrated;
+            if (!Serialization::ReadBinary(migrated, path) || migrated.Events.Size() != loaded.Events.Size())
+                throw std::runtime_error("Migrated file failed to load");
+
+            for (size_t i = 0; i < loaded.Events.Size(); i++)
+            {
+                if (!EventsEqual(loaded.Events[i], migrated.Events[i]))
+                    throw std::runtime_error("Migrated event mismatch at index " + std::to_string(i));
+            }
+
+            // Recordings saved as JSON under a .rec name load, but are left as they are
+            std::filesystem::path jsonPath = GetTestDirectory() / "LegacyJson.rec";
+            if (!Serialization::ExportJson(loaded, jsonPath))
+                throw std::runtime_error("ExportJson failed");
+
+            auto jsonSize = std::filesystem::file_size(jsonPath);
+
+            Recording json;
+            if (!Serialization::LoadRecording(json, jsonPath.string()) || json.Events.Size() != loaded.Events.Size())
+                throw std::runtime_error("JSON .rec failed to load");
+
+            if (Serialization::GetBinaryVersion(jsonPath) != 0 || std::filesystem::file_size(jsonPath) != jsonSize)
+                throw std::runtime_error("JSON .rec was rewritten on load");
+        }
+
+        void SerializationTestSuite::Test_Binary_InterruptedSaveKeepsOldFile()
+        {
+            struct SimulatedCrash {};
+
+            std::filesystem::path folder = GetTestDirectory() / "Interrupted";
+            std::filesystem::remove_all(folder);
+            std::filesystem::create_directories(folder);
+
+            std::filesystem::path path = folder / "Precious.rec";
+
+            auto findTemporaries = [&folder]()
+            {
+                std::vector<std::filesystem::path> temporaries;
+                for (const auto& entry : std::filesystem::directory_iterator(folder))
+                {
+                    if (AtomicFile::IsTemporaryPath(entry.path()))
+                        temporaries.push_back(entry.path());
+                }
+
+                return temporaries;
+            };
+
+            Recording original = GenerateRecording("Precious", 1000);
+            if (!Serialization::WriteBinary(original, path))
+                throw std::runtime_error("WriteBinary failed");
+
+            auto expectOriginal = [&]()
+            {
+                Recording onDisk;
+                if (!Serialization::ReadBinary(onDisk, path) || onDisk.Events.Size() != original.Events.Size())
+                    throw std::runtime_error("The old recording did not survive");
+
+                for (size_t i = 0; i < original.Events.Size(); i++)
+                {
+                    if (!EventsEqual(original.Events[i], onDisk.Events[i]))
+                        throw std::runtime_error("Old recording changed at index " + std::to_string(i));
+                }
+            };
+
+            // Kill the writer halfway through the stream
+            Recording replacement = GenerateRecording("Precious", 200000, 77);
+            bool injected = false;
+
+            auto crash = [&](float progress)
+            {
+                if (progress < 0.5f)
+                    return true;
+
+                // Exactly what a crash at this point would leave on disk
+                expectOriginal();
+                std::vector<std::filesystem::path> temporaries = findTemporaries();
+                if (temporaries.size() != 1)
+                    throw std::runtime_error("New data should go to a temporary file");
+
+                std::filesystem::copy_file(temporaries.front(), folder / "Leftover.bin");
+                injected = true;
+                throw SimulatedCrash();
+            };
+
+            try
+            {
+                Serialization::WriteBinary(replacement, path, crash);
+            }
+            catch (const SimulatedCrash&)
+            {
+            }
+
+            if (!injected)
+                throw std::runtime_error("Fault was not injected");
+
+            expectOriginal();
+            if (!findTemporaries().empty())
+                throw std::runtime_error("An unwound save should remove its temporary");
+
+            // A killed process cannot clean up; its temporary must not look like a recording
+            std::filesystem::path leftover = AtomicFile::GetTemporaryPath(path);
+            std::filesystem::rename(folder / "Leftover.bin", leftover);
+
+            RecordingLibrary library(folder);
+            library.Refresh();
+            if (library.GetRecordings().size() != 1 || library.Find("Precious")->EventCount != original.Events.Size())
+                throw std::runtime_error("A leftover temporary should not show up in the library");
+
+            expectOriginal();
+
+            // The next save replaces the old file and leaves the leftover for crash recovery
+            if (!Serialization::WriteBinary(replacement, path))
+                throw std::runtime_error("Save after a crash failed");
+
+            Recording saved;
+            if (!Serialization::ReadBinary(saved, path) || saved.Events.Size() != replacement.Events.Size())
+                throw std::runtime_error("Save after a crash did not replace the old file");
+
+            if (findTemporaries() != std::vector<std::filesystem::path>{ leftover })
+                throw std::runtime_error("A completed save should leave no temporary of its own");
+
+            std::filesystem::remove(leftover);
+
+            // Only AtomicFile's own names count as temporaries, and only those of exited
+            // processes saving a recording are abandoned
+            std::filesystem::path abandoned = path;
+            abandoned += ".2147483646-1.tmp";
+
+            if (AtomicFile::IsTemporaryPath(folder / "Other.tmp") || AtomicFile::IsTemporaryPath(folder / "Other.1-2.tmp") ||
+                AtomicFile::IsTemporaryPath(folder / "Other.rec.1-x.tmp") || !AtomicFile::IsTemporaryPath(leftover))
+                throw std::runtime_error("Temporary names were misclassified");
+
+            if (Serialization::IsAbandonedSave(leftover) || Serialization::IsAbandonedSave(folder / "Other.tmp") ||
+                Serialization::IsAbandonedSave(folder / "Other.txt.2147483646-1.tmp") ||
+                !Serialization::IsAbandonedSave(abandoned))
+                throw std::runtime_error("Abandoned saves were misclassified");
+
+            // Concurrent saves of one file each write their own temporary; whichever commits last
+            // is on disk whole, never a mix of several
+            const int WRITERS = 4;
+            std::vector<Recording> versions;
+            for (int i = 0; i < WRITERS; i++)
+                versions.push_back(GenerateRecording("Precious", 20000 + 1000 * i, 200 + i));
+
+            std::vector<std::thread> writers;
+            std::atomic<int> failedSaves{ 0 };
+            for (int i = 0; i < WRITERS; i++)
+            {
+                writers.emplace_back([&, i]() {
+                    for (int save = 0; save < 10; save++)
+                    {
+                        if (!Serialization::WriteBinary(versions[i], path))
+                            failedSaves++;
+                    }
+                    });
+            }
+
+            for (std::thread& writer : writers)
+                writer.join();
+
+            Recording winner;
+            if (failedSaves != 0 || !Serialization::ReadBinary(winner, path))
+                throw std::runtime_error("Concurrent saves failed or left an unreadable file");
+
+            auto match = std::find_if(versions.begin(), versions.end(),
+                [&winner](const Recording& version) { return version.Events.Size() == winner.Events.Size(); });
+
+            if (match == versions.end())
+                throw std::runtime_error("Concurrent saves produced a file none of them wrote");
+
+            for (size_t i = 0; i < winner.Events.Size(); i++)
+            {
+                if (!EventsEqual(winner.Events[i], match->Events[i]))
+                    throw std::runtime_error("Concurrent saves interleaved at index " + std::to_string(i));
+            }
+
+            if (!findTemporaries().empty())
+                throw std::runtime_error("Concurrent saves left temporaries behind");
+
+            // A finalized stream replaces the file the same way; a failed replace keeps both
+            std::filesystem::path streamPath = folder / "Precious.rec.part";
+            RecordingWriter writer;
+            if (!writer.Open(streamPath, replacement.Name, replacement.RecordsMouse))
+                throw std::runtime_error("Failed to open writer");
+
+            writer.Submit(replacement.Events);
+            if (!writer.Finalize(replacement.Duration))
+                throw std::runtime_error("Failed to finalize stream");
+
+            if (AtomicFile::Replace(folder / "Missing.rec.part", path) || !Serialization::ReadBinary(saved, path))
+                throw std::runtime_error("A failed replace should leave the target alone");
+
+            if (!AtomicFile::Replace(streamPath, path) || std::filesystem::exists(streamPath))
+                throw std::runtime_error("Replacing with a finalized stream failed");
+
+            if (!Serialization::ReadBinary(saved, path) || saved.Events.Size() != replacement.Events.Size())
+                throw std::runtime_error("The streamed recording did not replace the old file");
+        }
+
+        void SerializationTestSuite::Test_Compressed_RoundTrip()
+        {
+            using namespace RecordingFormat;
+
+            // Several blocks, the last one partial, plus values at the edges of each column
+            Recording original = GenerateRecording("Compressed", 2 * EventsPerBlock + 1234);
+
+            auto add = [&original](RecordedEvent event) {
+                original.Events.Add(event);
+                original.Duration = std::max(original.Duration, event.Timestamp);
+            };
+
+            RecordedEvent edge;
+            edge.Action = RecordedAction::MouseMoved;
+            edge.Timestamp = original.Duration + 10 * Clock::NanosecondsPerSecond;
+            edge.MouseX = std::numeric_limits<int>::min();
+            edge.MouseY = std::numeric_limits<int>::max();
+            add(edge);
+
+            edge.Action = RecordedAction::KeyPressed;
+            edge.Timestamp -= 5;
+            edge.Key = Lumina::KeyCode::Unknown;
+            edge.Modifiers = ModifierCtrl | ModifierCapsLock;
+            add(edge);
+
+            edge = RecordedEvent();
+            edge.Action = RecordedAction::MouseScrolled;
+            edge.Timestamp = original.Duration + 1;
+            edge.ScrollDX = -120000;
+            edge.ScrollDY = std::numeric_limits<int>::max();
+            add(edge);
+
+            std::filesystem::path binaryPath = GetTestDirectory() / "Compressed.raw.rec";
+            if (!Serialization::WriteBinary(original, binaryPath))
+                throw std::runtime_error("WriteBinary failed");
+
+            for (bool entropy : { false, true })
+            {
+                std::filesystem::path path = GetTestDirectory() / "Compressed.rec";
+                if (!Serialization::WriteCompressed(original, path, {}, entropy))
+                    throw std::runtime_error("WriteCompressed failed");
+
+                if (Serialization::GetBinaryVersion(path) != CompressedVersion)
+                    throw std::runtime_error("Wrong format version");
+
+                if (std::filesystem::file_size(path) * 2 > std::filesystem::file_size(binaryPath))
+                    throw std::runtime_error("Compressed file is not meaningfully smaller");
+
+                Recording loaded = GenerateRecording("Stale", 10);
+                if (!Serialization::ReadBinary(loaded, path))
+                    throw std::runtime_error("ReadBinary failed");
+
+                if (loaded.Name != original.Name || loaded.RecordsMouse != original.RecordsMouse || loaded.Duration != original.Duration)
+                    throw std::runtime_error("Header fields mismatch");
+
+                if (loaded.Events.Size() != original.Events.Size())
+                    throw std::runtime_error("Event count mismatch");
+
+                for (size_t i = 0; i < original.Events.Size(); i++)
+                {
+                    if (!EventsEqual(original.Events[i], loaded.Events[i]))
+                        throw std::runtime_error("Event mismatch at index " + std::to_string(i));
+                }
+
+                RecordingInfo info;
+                if (!RecordingLibrary::ReadInfo(path, info) || info.EventCount != original.Events.Size() || info.Duration != original.Duration)
+                    throw std::runtime_error("Library info does not match the compressed file");
+            }
+
+            Recording empty("Empty");
+            std::filesystem::path emptyPath = GetTestDirectory() / "CompressedEmpty.rec";
+
+            Recording loaded = GenerateRecording("Stale", 10);
+            if (!Serialization::WriteCompressed(empty, emptyPath) || !Serialization::ReadBinary(loaded, emptyPath))
+                throw std::runtime_error("Empty compressed recording failed to round trip");
+
+            if (loaded.Name != "Empty" || !loaded.Events.IsEmpty())
+                throw std::runtime_error("Loaded recording should be empty");
+        }
+
+        void SerializationTestSuite::Test_Compressed_RejectsDamagedFile()
+        {
+            using namespace RecordingFormat;
+
+            Recording original = GenerateRecording("Damaged", EventsPerBlock + 500);
+            std::filesystem::path path = GetTestDirectory() / "Damaged.rec";
+
+            if (!Serialization::WriteCompressed(original, path))
+                throw std::runtime_error("WriteCompressed failed");
+
+            std::vector<char> bytes(std::filesystem::file_size(path));
+            {
+                std::ifstream file(path, std::ios::binary);
+                file.read(bytes.data(), bytes.size());
+            }
+
+            std::filesystem::path damagedPath = GetTestDirectory() / "DamagedCopy.rec";
+            auto writeDamaged = [&](const std::vector<char>& data) {
+                std::ofstream file(damagedPath, std::ios::binary | std::ios::trunc);
+                file.write(data.data(), data.size());
+            };
+
+            // Cut off inside the last block
+            writeDamaged(std::vector<char>(bytes.begin(), bytes.end() - 100));
+
+            Recording loaded;
+            if (Serialization::ReadBinary(loaded, damagedPath) || !loaded.Events.IsEmpty())
+                throw std::runtime_error("Truncated compressed file was accepted");
+
+            // Block sizes that do not add up
+            FileHeader header;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+
+            std::vector<char> resized = bytes;
+            BlockEntry block;
+            std::memcpy(&block, resized.data() + header.EventsOffset, sizeof(block));
+            block.Size -= 1;
+            std::memcpy(resized.data() + header.EventsOffset, &block, sizeof(block));
+            writeDamaged(resized);
+
+            if (Serialization::ReadBinary(loaded, damagedPath))
+                throw std::runtime_error("Block with a wrong size was accepted");
+
+            // Flipped bytes must never crash the decoder, whether or not they are detected
+            std::mt19937 rng(99);
+            uint64_t dataStart = header.EventsOffset + header.RecordCount * sizeof(BlockEntry);
+            std::uniform_int_distribution<size_t> position(dataStart, bytes.size() - 1);
+
+            size_t rejected = 0;
+            for (int attempt = 0; attempt < 200; attempt++)
+            {
+                std::vector<char> flipped = bytes;
+                flipped[position(rng)] ^= static_cast<char>(1 << (attempt % 8));
+                writeDamaged(flipped);
+
+                if (!Serialization::ReadBinary(loaded, damagedPath))
+                    rejected++;
+            }
+
+            LUMINA_LOG_INFO("Single bit flips detected: {} of 200", rejected);
+        }
+
+        void SerializationTestSuite::Test_Performance_Compression()
+        {
+            using namespace RecordingFormat;
+
+            const size_t COUNT = 1000000;
+            Recording original = GenerateRecording("Compression", COUNT);
+
+            std::filesystem::path rawPath = GetTestDirectory() / "Compression.raw.rec";
+            std::filesystem::path packedPath = GetTestDirectory() / "Compression.packed.rec";
+            std::filesystem::path entropyPath = GetTestDirectory() / "Compression.rec";
+
+            // Throughput is measured against the uncompressed record size
+            const double rawMB = static_cast<double>(COUNT * sizeof(EventRecord)) / 1e6;
+
+            Lumina::Timer timer;
+            Serialization::WriteBinary(original, rawPath);
+            float rawWriteMs = timer.ElapsedMillis();
+
+            timer.Reset();
+            Serialization::WriteCompressed(original, packedPath, {}, false);
+            float packedWriteMs = timer.ElapsedMillis();
+
+            timer.Reset();
+            Serialization::WriteCompressed(original, entropyPath, {}, true);
+            float entropyWriteMs = timer.ElapsedMillis();
+
+            Recording raw;
+            timer.Reset();
+            bool rawOk = Serialization::ReadBinary(raw, rawPath);
+            float rawReadMs = timer.ElapsedMillis();
+
+            Recording packed;
+            timer.Reset();
+            bool packedOk = Serialization::ReadBinary(packed, packedPath);
+            float packedReadMs = timer.ElapsedMillis();
+
+            Recording entropy;
+            timer.Reset();
+            bool entropyOk = Serialization::ReadBinary(entropy, entropyPath);
+            float entropyReadMs = timer.ElapsedMillis();
+
+            if (!rawOk || !packedOk || !entropyOk || entropy.Events.Size() != COUNT || packed.Events.Size() != COUNT)
+                throw std::runtime_error("Failed to load benchmark recordings");
+
+            uint64_t rawSize = std::filesystem::file_size(rawPath);
+            uint64_t packedSize = std::filesystem::file_size(packedPath);
+            uint64_t entropySize = std::filesystem::file_size(entropyPath);
+
+            auto speed = [rawMB](float ms) { return rawMB / std::max(ms / 1000.0, 1e-6); };
+
+            LUMINA_LOG_INFO("{} events | raw: {} bytes, write {:.0f} MB/s, read {:.0f} MB/s", COUNT, rawSize, speed(rawWriteMs), speed(rawReadMs));
+            LUMINA_LOG_INFO("  delta+varint: {} bytes ({:.1f}x), encode {:.0f} MB/s, decode {:.0f} MB/s",
+                packedSize, static_cast<double>(rawSize) / packedSize, speed(packedWriteMs), speed(packedReadMs));
+            LUMINA_LOG_INFO("  +rANS:        {} bytes ({:.1f}x), encode {:.0f} MB/s, decode {:.0f} MB/s",
+                entropySize, static_cast<double>(rawSize) / entropySize, speed(entropyWriteMs), speed(entropyReadMs));
+
+            // Playback consumes a recording in real time; decoding has to be orders of magnitude faster
+            double recordedSeconds = static_cast<double>(original.Duration) / Clock::NanosecondsPerSecond;
+            double decodeSeconds = entropyReadMs / 1000.0;
+            LUMINA_LOG_INFO("  decode runs {:.0f}x faster than real time", recordedSeconds / std::max(decodeSeconds, 1e-6));
+
+            if (packedSize * 2 > rawSize || entropySize * 5 > rawSize)
+                throw std::runtime_error("Compression ratio regressed");
+
+            if (decodeSeconds * 1000.0 > recordedSeconds)
+                throw std::runtime_error("Decoding is too slow to stream during playback");
+        }
+
+        void SerializationTestSuite::Test_Compressed_ParallelEncodingMatches()
+        {
+            using namespace RecordingFormat;
+
+            Recording original = GenerateRecording("Parallel", 20 * EventsPerBlock + 321);
+            std::filesystem::path serialPath = GetTestDirectory() / "Parallel.serial.rec";
+            std::filesystem::path parallelPath = GetTestDirectory() / "Parallel.rec";
+
+            auto readBytes = [](const std::filesystem::path& path) {
+                std::ifstream file(path, std::ios::binary);
+                return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            };
+
+            if (!Serialization::WriteCompressed(original, serialPath))
+                throw std::runtime_error("WriteCompressed failed");
+
+            // Batches of 2 * threads blocks, so the last batch is partial
+            TaskPool pool(3);
+            float lastProgress = 0.0f;
+            auto progress = [&lastProgress](float fraction) {
+                lastProgress = fraction;
+                return true;
+            };
+
+            if (!Serialization::WriteCompressed(original, parallelPath, progress, true, &pool))
+                throw std::runtime_error("Parallel WriteCompressed failed");
+
+            if (readBytes(serialPath) != readBytes(parallelPath))
+                throw std::runtime_error("Parallel encoding wrote a different file");
+
+            if (lastProgress != 1.0f)
+                throw std::runtime_error("Progress did not reach the end");
+        }
+
+        void SerializationTestSuite::Test_Json_ExportImport()
+        {
+            Recording original = GenerateRecording("Json", 1000);
+            std::filesystem::path path = GetTestDirectory() / "Json.json";
+
+            if (!Serialization::ExportJson(original, path))
+                throw std::runtime_error("ExportJson failed");
+
+            Recording loaded;
+            if (!Serialization::ImportJson(loaded, path))
+                throw std::runtime_error("ImportJson failed");
+
+            if (loaded.Events.Size() != original.Events.Size())
+                throw std::runtime_error("Event count mismatch");
+
+            for (size_t i = 0; i < original.Events.Size(); i++)
+            {
+                const auto a = original.Events[i];
+                const auto b = loaded.Events[i];
+
+                if (a.GetAction() != b.GetAction() || a.GetKey() != b.GetKey() || a.GetX() != b.GetX() || a.GetY() != b.GetY())
+                    throw std::runtime_error("Event mismatch at index " + std::to_string(i));
+            }
+
+            // Older versions only read float seconds, so exports still carry them
+            std::ifstream exported(path);
+            nlohmann::json document = nlohmann::json::parse(exported);
+            if (document["totalDuration"].get<double>() != original.GetDurationSeconds() ||
+                document["events"][1]["time"].get<double>() != Clock::ToSeconds(original.Events[1].GetTimestamp()))
+                throw std::runtime_error("Export is missing the float seconds older versions read");
+
+            // A write that can't happen is reported, not logged as exported
+            if (Serialization::ExportJson(original, GetTestDirectory() / "Missing" / "Folder" / "Json.json"))
+                throw std::runtime_error("Export into a missing folder reported success");
+        }
+
+        void SerializationTestSuite::Test_Json_ImportsLegacyTimes()
+        {
+            std::filesystem::path path = GetTestDirectory() / "LegacyTimes.json";
+
+            {
+                std::ofstream file(path);
+                file << R"({
+                    "name": "LegacyTimes",
+                    "recordsMouse": false,
+                    "totalDuration": 2.5,
+                    "events": [
+                        { "action": 0, "time": 0.5, "key": 65 },
+                        { "action": 1, "time": 2.25, "key": 65 }
+                    ]
+                })";
+            }
+
+            Recording loaded;
+            if (!Serialization::ImportJson(loaded, path))
+                throw std::runtime_error("ImportJson failed");
+
+            if (loaded.Duration != Clock::FromSeconds(2.5) || loaded.Events.Size() != 2)
+                throw std::runtime_error("Legacy header fields mismatch");
+
+            if (loaded.Events[0].GetTimestamp() != Clock::FromSeconds(0.5) || loaded.Events[1].GetTimestamp() != Clock::FromSeconds(2.25))
+                throw std::runtime_error("Legacy float times were not converted");
+        }
+
+        void SerializationTestSuite::Test_Json_ReaderMatchesDocumentParser()
+        {
+            Recording original = GenerateRecording("Reader", 5000);
+            std::filesystem::path path = GetTestDirectory() / "Reader.json";
+
+            if (!Serialization::ExportJson(original, path))
+                throw std::runtime_error("ExportJson failed");
+
+            // The benchmark fixture must be exactly what ExportJson writes
+            std::filesystem::path streamedPath = GetTestDirectory() / "ReaderStreamed.json";
+            if (!WriteExportedJson(original, streamedPath))
+                throw std::runtime_error("WriteExportedJson failed");
+
+            std::ifstream exported(path, std::ios::binary);
+            std::ifstream streamed(streamedPath, std::ios::binary);
+            if (!std::equal(std::istreambuf_iterator<char>(exported), std::istreambuf_iterator<char>(),
+                std::istreambuf_iterator<char>(streamed), std::istreambuf_iterator<char>()))
+                throw std::runtime_error("Streamed fixture differs from ExportJson output");
+
+            MappedFile mapping;
+            if (!mapping.Open(path))
+                throw std::runtime_error("Failed to map exported file");
+
+            Recording fast;
+            auto result = JsonRecordingReader::Read(fast, reinterpret_cast<const char*>(mapping.GetData()), mapping.GetSize());
+            if (result != JsonRecordingReader::Result::Loaded)
+                throw std::runtime_error("Reader did not recognize the exported layout");
+
+            Recording document;
+            if (!Serialization::ImportJsonDocument(document, path))
+                throw std::runtime_error("ImportJsonDocument failed");
+
+            if (fast.Name != document.Name || fast.RecordsMouse != document.RecordsMouse || fast.Duration != document.Duration)
+                throw std::runtime_error("Header fields mismatch");
+
+            if (fast.Events.Size() != document.Events.Size())
+                throw std::runtime_error("Event count mismatch");
+
+            for (size_t i = 0; i < fast.Events.Size(); i++)
+            {
+                if (!EventsEqual(fast.Events[i], document.Events[i]))
+                    throw std::runtime_error("Event mismatch at index " + std::to_string(i));
+            }
+
+            // Legacy float times and escaped names are still within the layout
+            const char* legacy = R"({ "name": "Tab\tName", "recordsMouse": true, "totalDuration": 1.5, "extra": [1, {"a": null}],
+                "events": [ { "action": 4, "time": 0.25, "x": -3, "y": 7 }, { "action": 5, "time": 1.0, "dx": 0, "dy": -1 } ] })";
+
+            Recording legacyLoaded;
+            result = JsonRecordingReader::Read(legacyLoaded, legacy, std::strlen(legacy));
+            if (result != JsonRecordingReader::Result::Loaded)
+                throw std::runtime_error("Reader did not recognize a legacy file");
+
+            if (legacyLoaded.Name != "Tab\tName" || legacyLoaded.Duration != Clock::FromSeconds(1.5) || legacyLoaded.Events.Size() != 2)
+                throw std::runtime_error("Legacy header fields mismatch");
+
+            if (legacyLoaded.Events[0].GetTimestamp() != Clock::FromSeconds(0.25) || legacyLoaded.Events[0].GetX() != -3 || legacyLoaded.Events[1].ToEvent().ScrollDY != -1)
+                throw std::runtime_error("Legacy events mismatch");
+        }
+
+        void SerializationTestSuite::Test_Json_ReaderFallsBack()
+        {
+            // Valid for the document parser but outside what the reader handles
+            const std::vector<std::pair<std::string, std::string>> files = {
+                { "UnicodeName", R"({ "name": "Caf\u00e9", "recordsMouse": false, "duration": 10, "events": [ { "action": 0, "timestamp": 5, "key": 65 } ] })" },
+                { "FloatField", R"({ "name": "FloatField", "recordsMouse": true, "duration": 10, "events": [ { "action": 4, "timestamp": 5, "x": 12.0, "y": 3 } ] })" },
+                { "LegacyBothTimes", R"({ "name": "LegacyBothTimes", "recordsMouse": false, "totalDuration": 10.0, "events": [ { "action": 0, "timestamp": 5, "time": 9.0, "key": 65 } ] })" }
+            };
+
+            for (const auto& [name, text] : files)
+            {
+                std::filesystem::path path = GetTestDirectory() / (name + ".json");
+                {
+                    std::ofstream file(path, std::ios::binary);
+                    file << text;
+                }
+
+                Recording fast;
+                if (JsonRecordingReader::Read(fast, text.data(), text.size()) != JsonRecordingReader::Result::Unrecognized)
+                    throw std::runtime_error(name + ": reader should not accept this file");
+
+                if (fast.Events.Size() != 0)
+                    throw std::runtime_error(name + ": unrecognized file left events behind");
+
+                Recording imported;
+                Recording document;
+                if (!Serialization::ImportJson(imported, path) || !Serialization::ImportJsonDocument(document, path))
+                    throw std::runtime_error(name + ": import failed");
+
+                if (imported.Name != document.Name || imported.Events.Size() != 1 || !EventsEqual(imported.Events[0], document.Events[0]))
+                    throw std::runtime_error(name + ": fallback result differs from the document parser");
+            }
+
+            // Malformed files are still rejected
+            std::filesystem::path brokenPath = GetTestDirectory() / "Broken.json";
+            {
+                std::ofstream file(brokenPath, std::ios::binary);
+                file << R"({ "name": "Broken", "recordsMouse": false, "duration": 10, "events": [ { "action": 0, "timestamp": 5 )";
+            }
+
+            Recording broken;
+            if (Serialization::ImportJson(broken, brokenPath))
+                throw std::runtime_error("Truncated file was accepted");
+
+            // Leading zeros aren't JSON; both parsers refuse them
+            const std::vector<std::pair<std::string, std::string>> leadingZeros = {
+                { "ZeroInteger", R"({ "name": "ZeroInteger", "recordsMouse": false, "duration": 10, "events": [ { "action": 0, "timestamp": 007, "key": 65 } ] })" },
+                { "ZeroNegative", R"({ "name": "ZeroNegative", "recordsMouse": true, "duration": 10, "events": [ { "action": 4, "timestamp": 5, "x": -01, "y": 3 } ] })" },
+                { "ZeroDouble", R"({ "name": "ZeroDouble", "recordsMouse": false, "totalDuration": 1.0, "events": [ { "action": 0, "time": 00.5, "key": 65 } ] })" }
+            };
+
+            for (const auto& [name, text] : leadingZeros)
+            {
+                std::filesystem::path path = GetTestDirectory() / (name + ".json");
+                {
+                    std::ofstream file(path, std::ios::binary);
+                    file << text;
+                }
+
+                Recording fast;
+                if (JsonRecordingReader::Read(fast, text.data(), text.size()) == JsonRecordingReader::Result::Loaded)
+                    throw std::runtime_error(name + ": reader accepted a leading zero");
+
+                Recording imported;
+                if (Serialization::ImportJson(imported, path))
+                    throw std::runtime_error(name + ": import accepted a leading zero");
+            }
+        }
+
+        void SerializationTestSuite::Test_Performance_Binary_VsJson_Load()
+        {
+            const size_t COUNT = 250000;
+            Recording original = GenerateRecording("Benchmark", COUNT);
+
+            std::filesystem::path binaryPath = GetTestDirectory() / "Benchmark.rec";
+            std::filesystem::path jsonPath = GetTestDirectory() / "Benchmark.json";
+
+            Lumina::Timer timer;
+            Serialization::WriteBinary(original, binaryPath);
+            float binarySaveMs = timer.ElapsedMillis();
+
+            timer.Reset();
+            Serialization::ExportJson(original, jsonPath);
+            float jsonSaveMs = timer.ElapsedMillis();
+
+            Recording binaryLoaded;
+            timer.Reset();
+            bool binaryOk = Serialization::ReadBinary(binaryLoaded, binaryPath);
+            float binaryLoadMs = timer.ElapsedMillis();
+
+            Recording jsonLoaded;
+            timer.Reset();
+            bool jsonOk = Serialization::ImportJson(jsonLoaded, jsonPath);
+            float jsonLoadMs = timer.ElapsedMillis();
+
+            if (!binaryOk || !jsonOk)
+                throw std::runtime_error("Failed to load benchmark recording");
+
+            if (binaryLoaded.Events.Size() != COUNT || jsonLoaded.Events.Size() != COUNT)
+                throw std::runtime_error("Event count mismatch");
+
+            LUMINA_LOG_INFO("{} events | binary: {} bytes, save {:.3f}ms, load {:.3f}ms | json: {} bytes, save {:.3f}ms, load {:.3f}ms",
+                COUNT,
+                std::filesystem::file_size(binaryPath), binarySaveMs, binaryLoadMs,
+                std::filesystem::file_size(jsonPath), jsonSaveMs, jsonLoadMs);
+            LUMINA_LOG_INFO("Binary load speedup: {:.1f}x", jsonLoadMs / std::max(binaryLoadMs, 0.001f));
+        }
+
+        void SerializationTestSuite::Test_Performance_JsonReader()
+        {
+            // The document parser needs several gigabytes for 10M events, so it is only timed up to 1M
+            const size_t COUNTS[] = { 10000, 1000000, 10000000 };
+            const size_t DOCUMENT_LIMIT = 1000000;
+
+            for (size_t count : COUNTS)
+            {
+                std::filesystem::path path = GetTestDirectory() / "JsonReader.json";
+
+                {
+                    Recording original = GenerateRecording("JsonReader", count);
+                    if (!WriteExportedJson(original, path))
+                        throw std::runtime_error("Failed to write benchmark file");
+                }
+
+                uint64_t fileSize = std::filesystem::file_size(path);
+
+                Recording fast;
+                Lumina::Timer timer;
+                bool fastOk = Serialization::ImportJson(fast, path);
+                float fastMs = timer.ElapsedMillis();
+
+                if (!fastOk || fast.Events.Size() != count)
+                    throw std::runtime_error("ImportJson failed");
+
+                if (count > DOCUMENT_LIMIT)
+                {
+                    LUMINA_LOG_INFO("{} events, {} bytes | reader: {:.3f}ms ({:.0f} MB/s) | document parser: skipped",
+                        count, fileSize, fastMs, fileSize / 1e3 / std::max(fastMs, 0.001f));
+                }
+                else
+                {
+                    Recording document;
+                    timer.Reset();
+                    bool documentOk = Serialization::ImportJsonDocument(document, path);
+                    float documentMs = timer.ElapsedMillis();
+
+                    if (!documentOk || document.Events.Size() != count)
+                        throw std::runtime_error("ImportJsonDocument failed");
+
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        if (!EventsEqual(fast.Events[i], document.Events[i]))
+                            throw std::runtime_error("Event mismatch at index " + std::to_string(i));
+                    }
+
+                    LUMINA_LOG_INFO("{} events, {} bytes | reader: {:.3f}ms ({:.0f} MB/s) | document parser: {:.3f}ms | speedup {:.1f}x",
+                        count, fileSize, fastMs, fileSize / 1e3 / std::max(fastMs, 0.001f), documentMs, documentMs / std::max(fastMs, 0.001f));
+
+                    if (count == DOCUMENT_LIMIT && fastMs * 2.0f > documentMs)
+                        throw std::runtime_error("Reader is not meaningfully faster than the document parser");
+                }
+
+                std::filesystem::remove(path);
+            }
+        }
+
+        void SerializationTestSuite::Test_Writer_FinalizeRoundTrip()
+        {
+            Recording original = GenerateRecording("Streamed", 10000);
+            std::filesystem::path path = GetTestDirectory() / "Streamed.rec";
+
+            RecordingWriter writer;
+            if (!writer.Open(path, original.Name, original.RecordsMouse))
+                throw std::runtime_error("Failed to open writer");
+
+            const size_t CHUNK = 4096;
+            for (size_t start = 0; start < original.Events.Size(); start += CHUNK)
+            {
+                writer.Submit(original.Events.Slice(start, CHUNK));
+            }
+
+            if (!writer.Finalize(original.Duration))
+                throw std::runtime_error("Finalize failed");
+
+            Recording loaded;
+            if (!Serialization::ReadBinary(loaded, path))
+                throw std::runtime_error("ReadBinary failed");
+
+            if (loaded.Events.Size() != original.Events.Size() || loaded.Duration != original.Duration)
+                throw std::runtime_error("Streamed recording does not match original");
+
+            for (size_t i = 0; i < original.Events.Size(); i++)
+            {
+                if (!EventsEqual(original.Events[i], loaded.Events[i]))
+                    throw std::runtime_error("Event mismatch at index " + std::to_string(i));
+            }
+        }
+
+        void SerializationTestSuite::Test_Writer_RecoverPartialFile()
+        {
+            Recording original = GenerateRecording("Crashed", 3000);
+            std::filesystem::path streamPath = GetTestDirectory() / "Crashed.rec.part";
+            std::filesystem::path snapshotPath = GetTestDirectory() / "CrashedSnapshot.rec.part";
+
+            RecordingWriter writer;
+            if (!writer.Open(streamPath, original.Name, original.RecordsMouse))
+                throw std::runtime_error("Failed to open writer");
+
+            writer.Submit(original.Events.Slice(0, 2000));
+            writer.Flush();
+
+            // Simulate a crash mid-record: copy what is on disk and cut the last record in half
+            std::filesystem::copy_file(streamPath, snapshotPath, std::filesystem::copy_options::overwrite_existing);
+            std::filesystem::resize_file(snapshotPath, std::filesystem::file_size(snapshotPath) - 7);
+            writer.Discard();
+
+            if (!Serialization::RecoverRecording(snapshotPath))
+                throw std::runtime_error("RecoverRecording failed");
+
+            if (std::filesystem::exists(snapshotPath))
+                throw std::runtime_error("Partial file should be removed after recovery");
+
+            Recording recovered;
+            if (!Serialization::ReadBinary(recovered, GetTestDirectory() / "CrashedSnapshot.rec"))
+                throw std::runtime_error("Recovered recording failed to load");
+
+            if (recovered.Events.Size() != 1999)
+                throw std::runtime_error("Expected 1999 whole events, got " + std::to_string(recovered.Events.Size()));
+
+            if (recovered.Duration != original.Events[1998].GetTimestamp())
+                throw std::runtime_error("Recovered duration should end at the last event");
+        }
+
+        void SerializationTestSuite::Test_Writer_Discard()
+        {
+            std::filesystem::path path = GetTestDirectory() / "Discarded.rec.part";
+
+            RecordingWriter writer;
+            if (!writer.Open(path, "Discarded", false))
+                throw std::runtime_error("Failed to open writer");
+
+            writer.Submit(GenerateRecording("Discarded", 100).Events);
+            writer.Discard();
+
+            if (std::filesystem::exists(path))
+                throw std::runtime_error("Discarded stream should be deleted");
+        }
+
+        void SerializationTestSuite::Test_Writer_CompressStream()
+        {
+            // More than two blocks, and a gap long enough to need a gap record in the stream
+            Recording original = GenerateRecording("Compressed", 40000);
+            RecordedEvent late;
+            late.Action = RecordedAction::KeyPressed;
+            late.Key = Lumina::KeyCode::A;
+            late.Timestamp = original.Duration + 10 * Clock::NanosecondsPerSecond;
+            original.Events.Add(late);
+            original.Duration = late.Timestamp;
+
+            std::filesystem::path streamPath = GetTestDirectory() / "Compressed.rec.part";
+            std::filesystem::path path = GetTestDirectory() / "Compressed.rec";
+
+            RecordingWriter writer;
+            if (!writer.Open(streamPath, original.Name, original.RecordsMouse))
+                throw std::runtime_error("Failed to open writer");
+
+            writer.Submit(original.Events);
+            if (!writer.Finalize(original.Duration))
+                throw std::runtime_error("Finalize failed");
+
+            if (!Serialization::CompressStream(streamPath, path))
+                throw std::runtime_error("CompressStream failed");
+
+            if (Serialization::GetBinaryVersion(path) != RecordingFormat::CompressedVersion)
+                throw std::runtime_error("Stream was not saved compressed");
+
+            RecordingReader reader;
+            if (!reader.Open(path))
+                throw std::runtime_error("Lazy reader could not open the saved stream");
+
+            if (reader.GetName() != original.Name || reader.GetDuration() != original.Duration ||
+                reader.GetEventCount() != original.Events.Size() || reader.GetBlockCount() != 3)
+                throw std::runtime_error("Header fields mismatch");
+
+            for (size_t block = 0; block < reader.GetBlockCount(); block++)
+            {
+                RecordingReader::Block events = reader.GetBlock(block);
+                if (!events)
+                    throw std::runtime_error("GetBlock failed");
+
+                for (size_t i = 0; i < events->Size(); i++)
+                {
+                    if (!EventsEqual((*events)[i], original.Events[RecordingReader::GetBlockStart(block) + i]))
+                        throw std::runtime_error("Event mismatch in block " + std::to_string(block));
+                }
+            }
+
+            reader.Close();
+            std::filesystem::remove(streamPath);
+            std::filesystem::remove(path);
+        }
+
+        void SerializationTestSuite::Test_Library_IncrementalRefresh()
+        {
+            std::filesystem::path folder = GetTestDirectory() / "Library";
+            std::filesystem::remove_all(folder);
+            std::filesystem::create_directories(folder);
+
+            Recording mixed = GenerateRecording("Mixed", 1000);
+
+            // Gaps over 4.3 seconds are stored as extra records that must not be counted
+            Recording gaps("Gaps");
+            for (int i = 0; i < 10; i++)
+            {
+                RecordedEvent event;
+                event.Action = RecordedAction::KeyPressed;
+                event.Key = Lumina::KeyCode::A;
+                event.Timestamp = i * 10 * Clock::NanosecondsPerSecond;
+                gaps.Events.Add(event);
+            }
+            gaps.Duration = 95 * Clock::NanosecondsPerSecond;
+
+            Recording legacy = GenerateRecording("Legacy", 200);
+
+            if (!Serialization::WriteBinary(mixed, folder / "Mixed.rec") ||
+                !Serialization::WriteBinary(gaps, folder / "Gaps.rec") ||
+                !Serialization::ExportJson(legacy, folder / "Legacy.rec"))
+                throw std::runtime_error("Failed to write library fixtures");
+
+            RecordingLibrary library(folder);
+            if (library.Refresh() != 3)
+                throw std::runtime_error("First refresh should read every file");
+
+            auto expectInfo = [&](const Recording& recording, const std::string& name)
+            {
+                const RecordingInfo* info = library.Find(name);
+                if (!info)
+                    throw std::runtime_error("Missing library entry: " + name);
+
+                if (info->EventCount != recording.Events.Size() || info->Duration != recording.Duration || info->RecordsMouse != recording.RecordsMouse)
+                    throw std::runtime_error("Library entry does not match the recording: " + name);
+
+                if (info->FileSize != std::filesystem::file_size(folder / (name + ".rec")))
+                    throw std::runtime_error("Library entry has the wrong file size: " + name);
+            };
+
+            expectInfo(mixed, "Mixed");
+            expectInfo(gaps, "Gaps");
+            expectInfo(legacy, "Legacy");
+
+            if (library.GetRecordings().front().Name != "Gaps" || library.GetRecordings().back().Name != "Mixed")
+                throw std::runtime_error("Entries should be sorted by name");
+
+            if (library.Refresh() != 0)
+                throw std::runtime_error("Unchanged files should not be read again");
+
+            RecordingLibrary reloaded(folder);
+            if (!reloaded.Load() || reloaded.GetRecordings().size() != 3)
+                throw std::runtime_error("Index was not persisted");
+
+            if (reloaded.Find("Mixed")->Hash != library.Find("Mixed")->Hash)
+                throw std::runtime_error("Persisted hash mismatch");
+
+            uint64_t oldHash = library.Find("Mixed")->Hash;
+            mixed = GenerateRecording("Mixed", 1500, 99);
+            Serialization::WriteBinary(mixed, folder / "Mixed.rec");
+            std::filesystem::remove(folder / "Gaps.rec");
+
+            if (library.Refresh() != 1)
+                throw std::runtime_error("Only the rewritten file should be read");
+
+            expectInfo(mixed, "Mixed");
+            if (library.Find("Mixed")->Hash == oldHash)
+                throw std::runtime_error("Hash should change with the contents");
+
+            if (library.Find("Gaps") || library.GetRecordings().size() != 2)
+                throw std::runtime_error("Deleted recordings should leave the index");
+
+            // A damaged index is only a cache miss
+            {
+                std::ofstream index(library.GetIndexPath(), std::ios::trunc);
+                index << "{ not json";
+            }
+
+            if (library.Refresh() != 2)
+                throw std::runtime_error("A damaged index should be rebuilt");
+
+            expectInfo(mixed, "Mixed");
+            expectInfo(legacy, "Legacy");
+        }
+
+        void SerializationTestSuite::Test_Performance_LibraryListing()
+        {
+            const int FILES = 1000;
+            const size_t EVENTS = 2000;
+
+            std::filesystem::path folder = GetTestDirectory() / "LibraryListing";
+            std::filesystem::remove_all(folder);
+            std::filesystem::create_directories(folder);
+
+            Recording recording = GenerateRecording("Listing", EVENTS);
+            for (int i = 0; i < FILES; i++)
+            {
+                recording.Name = "Listing" + std::to_string(i);
+                if (!Serialization::WriteBinary(recording, folder / (recording.Name + ".rec")))
+                    throw std::runtime_error("Failed to write " + recording.Name);
+            }
+
+            // What showing event counts took before: parse every file
+            Lumina::Timer timer;
+            size_t parsedEvents = 0;
+            for (const auto& entry : std::filesystem::directory_iterator(folder))
+            {
+                Recording loaded;
+                if (entry.path().extension() == ".rec" && Serialization::ReadBinary(loaded, entry.path()))
+                    parsedEvents += loaded.Events.Size();
+            }
+            float parseMs = timer.ElapsedMillis();
+
+            RecordingLibrary cold(folder);
+            timer.Reset();
+            size_t coldReads = cold.Refresh();
+            float coldMs = timer.ElapsedMillis();
+
+            RecordingLibrary warm(folder);
+            timer.Reset();
+            size_t warmReads = warm.Refresh();
+            float warmMs = timer.ElapsedMillis();
+
+            if (coldReads != FILES || warmReads != 0 || warm.GetRecordings().size() != FILES)
+                throw std::runtime_error("Expected one cold read per file and none warm");
+
+            if (parsedEvents != FILES * EVENTS || warm.GetRecordings().front().EventCount != EVENTS)
+                throw std::runtime_error("Event counts disagree");
+
+            LUMINA_LOG_INFO("{} recordings x {} events | parse every file: {:.3f}ms | index cold: {:.3f}ms | index warm: {:.3f}ms ({:.1f}x faster than parsing)",
+                FILES, EVENTS, parseMs, coldMs, warmMs, parseMs / std::max(warmMs, 0.001f));
+        }
+
+        void SerializationTestSuite::Test_Reader_MatchesFullLoad()
+        {
+            using namespace RecordingFormat;
+
+            Recording original = GenerateRecording("Reader", 5 * EventsPerBlock + 777);
+            std::filesystem::path path = GetTestDirectory() / "Reader.rec";
+
+            if (!Serialization::WriteCompressed(original, path))
+                throw std::runtime_error("WriteCompressed failed");
+
+            RecordingReader reader;
+            if (!reader.Open(path, 2))
+                throw std::runtime_error("Open failed");
+
+            if (reader.GetName() != original.Name || reader.RecordsMouse() != original.RecordsMouse ||
+                reader.GetDuration() != original.Duration || reader.GetEventCount() != original.Events.Size())
+                throw std::runtime_error("Header fields mismatch");
+
+            if (reader.GetCachedBlockCount() != 0)
+                throw std::runtime_error("Open decoded events");
+
+            for (size_t block = 0; block < reader.GetBlockCount(); block++)
+            {
+                RecordingReader::Block events = reader.GetBlock(block);
+                if (!events)
+                    throw std::runtime_error("GetBlock failed");
+
+                for (size_t i = 0; i < events->Size(); i++)
+                {
+                    if (!EventsEqual((*events)[i], original.Events[RecordingReader::GetBlockStart(block) + i]))
+                        throw std::runtime_error("Event mismatch in block " + std::to_string(block));
+                }
+
+                if (reader.GetCachedBlockCount() > 2)
+                    throw std::runtime_error("Cache grew past its limit");
+            }
+
+            if (reader.GetBlock(reader.GetBlockCount()))
+                throw std::runtime_error("Block past the end was returned");
+
+            // Seeks have to agree with the in-memory index, including across block boundaries
+            RecordingIndex index(original.Events);
+            std::mt19937 rng(7);
+            std::uniform_int_distribution<int64_t> time(-1, original.Duration + 1);
+
+            std::vector<int64_t> times = { -1, 0, original.Duration, original.Duration + 1 };
+            for (size_t block = 1; block < reader.GetBlockCount(); block++)
+            {
+                int64_t boundary = original.Events[RecordingReader::GetBlockStart(block)].GetTimestamp();
+                times.insert(times.end(), { boundary - 1, boundary, boundary + 1 });
+            }
+            for (int i = 0; i < 500; i++)
+                times.push_back(time(rng));
+
+            for (int64_t t : times)
+            {
+                if (reader.FindEvent(t) != index.FindEvent(t))
+                    throw std::runtime_error("FindEvent mismatch at " + std::to_string(t));
+            }
+
+            // A fresh reader answers states out of order by decoding up to the block first
+            RecordingReader fresh;
+            if (!fresh.Open(path, 2))
+                throw std::runtime_error("Open failed");
+
+            std::uniform_int_distribution<size_t> position(0, original.Events.Size());
+            std::vector<size_t> indices = { original.Events.Size(), 0, EventsPerBlock, EventsPerBlock - 1 };
+            for (int i = 0; i < 200; i++)
+                indices.push_back(position(rng));
+
+            for (size_t i : indices)
+            {
+                HeldInputState expected = index.GetStateAt(i);
+                HeldInputState actual = fresh.GetStateAt(i);
+
+                if (actual.Keys != expected.Keys || actual.Buttons != expected.Buttons ||
+                    actual.MouseX != expected.MouseX || actual.MouseY != expected.MouseY)
+                    throw std::runtime_error("Held state mismatch at " + std::to_string(i));
+            }
+
+            // Uncompressed recordings are left to a full load
+            std::filesystem::path binaryPath = GetTestDirectory() / "Reader.raw.rec";
+            if (!Serialization::WriteBinary(original, binaryPath))
+                throw std::runtime_error("WriteBinary failed");
+
+            RecordingReader binary;
+            if (binary.Open(binaryPath) || binary.IsOpen())
+                throw std::runtime_error("Uncompressed recording was opened");
+        }
+
+        void SerializationTestSuite::Test_Performance_ReaderTimeToFirstEvent()
+        {
+            const size_t COUNT = 10000000;
+            std::filesystem::path path = GetTestDirectory() / "ReaderLarge.rec";
+
+            {
+                Recording original = GenerateRecording("ReaderLarge", COUNT);
+                if (!Serialization::WriteCompressed(original, path))
+                    throw std::runtime_error("WriteCompressed failed");
+            }
+
+            Lumina::Timer timer;
+            Recording loaded;
+            bool loadedOk = Serialization::ReadBinary(loaded, path);
+            float fullLoadMs = timer.ElapsedMillis();
+
+            if (!loadedOk || loaded.Events.Size() != COUNT)
+                throw std::runtime_error("ReadBinary failed");
+
+            loaded = Recording();
+
+            timer.Reset();
+            RecordingReader reader;
+            bool opened = reader.Open(path);
+            float openMs = timer.ElapsedMillis();
+
+            RecordingReader::Block first = opened ? reader.GetBlock(0) : nullptr;
+            float firstEventMs = timer.ElapsedMillis();
+
+            if (!first || first->IsEmpty())
+                throw std::runtime_error("Failed to read the first block");
+
+            // Sweeping the whole recording never holds more than the cache
+            size_t peakCached = 0;
+            size_t events = 0;
+
+            timer.Reset();
+            for (size_t block = 0; block < reader.GetBlockCount(); block++)
+            {
+                RecordingReader::Block decoded = reader.GetBlock(block);
+                if (!decoded)
+                    throw std::runtime_error("GetBlock failed");
+
+                events += decoded->Size();
+                peakCached = std::max(peakCached, reader.GetCachedBlockCount());
+            }
+            float sweepMs = timer.ElapsedMillis();
+
+            LUMINA_LOG_INFO("{} events, {} bytes | full load {:.2f}ms | open {:.3f}ms, first event {:.3f}ms",
+                COUNT, std::filesystem::file_size(path), fullLoadMs, openMs, firstEventMs);
+            LUMINA_LOG_INFO("  sweep {:.2f}ms, at most {} of {} blocks decoded at once",
+                sweepMs, peakCached, reader.GetBlockCount());
+
+            if (events != COUNT)
+                throw std::runtime_error("Sweep missed events");
+
+            if (peakCached > RecordingReader::DefaultCacheBlocks)
+                throw std::runtime_error("Decoded blocks are not bounded by the cache");
+
+            if (firstEventMs * 10.0f > fullLoadMs)
+                throw std::runtime_error("Opening is not meaningfully faster than loading");
+        }
+
+        void SerializationTestSuite::Test_Pool_RunsNestedWork()
+        {
+            // More outer tasks than threads, each waiting on inner work, must not deadlock
+            TaskPool pool(2);
+
+            const size_t OUTER = 16;
+            const size_t INNER = 64;
+            std::vector<std::atomic<int>> hits(OUTER * INNER);
+
+            pool.ParallelFor(OUTER, [&](size_t outer) {
+                pool.ParallelFor(INNER, [&](size_t inner) { hits[outer * INNER + inner]++; });
+                });
+
+            for (size_t i = 0; i < hits.size(); i++)
+            {
+                if (hits[i] != 1)
+                    throw std::runtime_error("Task " + std::to_string(i) + " ran " + std::to_string(hits[i].load()) + " times");
+            }
+
+            // Uneven tasks submitted from outside the pool get spread over the workers
+            std::vector<std::thread::id> ranOn(64);
+            pool.ParallelFor(ranOn.size(), [&](size_t i) {
+                std::this_thread::sleep_for(std::chrono::microseconds(i % 4 == 0 ? 2000 : 100));
+                ranOn[i] = std::this_thread::get_id();
+                });
+
+            std::sort(ranOn.begin(), ranOn.end());
+            size_t threads = std::unique(ranOn.begin(), ranOn.end()) - ranOn.begin();
+            if (threads < 2)
+                throw std::runtime_error("All tasks ran on one thread");
+
+            if (pool.GetStealCount() == 0)
+                throw std::runtime_error("No work was stolen");
+
+            pool.ParallelFor(0, [](size_t) { throw std::runtime_error("Empty range ran a task"); });
+
+            // A throwing task reaches the caller only after the others have run, wherever it threw
+            std::atomic<size_t> finished = 0;
+            bool rethrown = false;
+            try
+            {
+                pool.ParallelFor(32, [&](size_t i) {
+                    if (i % 8 == 3)
+                        throw std::logic_error("Task failed");
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    finished++;
+                    });
+            }
+            catch (const std::logic_error&)
+            {
+                rethrown = true;
+            }
+
+            if (!rethrown)
+                throw std::runtime_error("Task exception was not rethrown");
+
+            if (finished != 28)
+                throw std::runtime_error(std::to_string(finished.load()) + " of 28 tasks finished before the rethrow");
+
+            // The pool is still usable afterwards
+            std::atomic<size_t> after = 0;
+            pool.ParallelFor(8, [&](size_t) { after++; });
+            if (after != 8)
+                throw std::runtime_error("Pool stopped working after a task threw");
+        }
+
+        void SerializationTestSuite::Test_Store_RoundTripAndSharing()
+        {
+            std::filesystem::path folder = GetTestDirectory() / "Store";
+            std::filesystem::remove_all(folder);
+
+            RecordingStore store(folder);
+            if (!store.Open() || !store.List().empty())
+                throw std::runtime_error("Open failed");
+
+            // The same login, once at the start and once at the end
+            Recording login = GenerateRecording("Login", 6000, 11);
+
+            Recording first("First", true);
+            AppendRecording(first, login);
+            AppendRecording(first, GenerateRecording("", 4000, 21));
+
+            Recording second("Second", true);
+            AppendRecording(second, GenerateRecording("", 4000, 22));
+            AppendRecording(second, login);
+
+            Recording empty("Empty");
+
+            if (!store.Put(first))
+                throw std::runtime_error("Put failed");
+
+            StoreStats alone = store.GetStats();
+
+            if (!store.Put(second) || !store.Put(empty))
+                throw std::runtime_error("Put failed");
+
+            StoreStats both = store.GetStats();
+            uint64_t secondBytes = both.ReferencedBytes - alone.ReferencedBytes;
+            uint64_t addedBytes = both.ChunkBytes - alone.ChunkBytes;
+
+            if (both.Recordings != 3 || both.Events != first.Events.Size() + second.Events.Size())
+                throw std::runtime_error("Stats do not count every recording");
+
+            if (addedBytes * 10 > secondBytes * 8)
+                throw std::runtime_error("The shared login was stored again (" + std::to_string(addedBytes) + " of " + std::to_string(secondBytes) + " bytes)");
+
+            for (const Recording* original : { &first, &second, &empty })
+            {
+                Recording loaded;
+                if (!store.Get(original->Name, loaded))
+                    throw std::runtime_error("Get failed for " + original->Name);
+
+                ExpectSameRecording(loaded, *original);
+            }
+
+            if (store.List() != std::vector<std::string>{ "Empty", "First", "Second" })
+                throw std::runtime_error("List mismatch");
+
+            // Names that would put the manifest anywhere but "manifests/" are refused
+            for (const char* name : { "", ".", "..", "../Escaped", "Sub/Name", "Sub\\Name" })
+            {
+                Recording named(name);
+                if (store.Put(named) || store.Contains(name))
+                    throw std::runtime_error(std::string("Put accepted the name '") + name + "'");
+            }
+
+            if (std::filesystem::exists(folder / "Escaped.manifest") || store.List().size() != 3)
+                throw std::runtime_error("A refused name left a manifest behind");
+
+            // Putting the same events again shares every chunk with the old version
+            if (!store.Put(first) || store.GetStats().ChunkBytes != both.ChunkBytes)
+                throw std::runtime_error("Replacing a recording with itself changed the chunks");
+
+            // Removing one recording deletes only the chunks nothing else uses
+            if (!store.Remove("First") || store.Contains("First") || store.Remove("First"))
+                throw std::runtime_error("Remove failed");
+
+            StoreStats remaining = store.GetStats();
+            if (remaining.ChunkBytes != remaining.ReferencedBytes)
+                throw std::runtime_error("Chunks only the removed recording used were kept");
+
+            size_t chunkFiles = 0;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(folder / "chunks"))
+                chunkFiles += entry.is_regular_file() ? 1 : 0;
+
+            if (chunkFiles != remaining.Chunks)
+                throw std::runtime_error("Chunk files on disk do not match the store");
+
+            Recording loaded;
+            if (!store.Get("Second", loaded))
+                throw std::runtime_error("Removing a recording broke the one sharing its chunks");
+
+            ExpectSameRecording(loaded, second);
+
+            // Reference counts come back from the manifests
+            RecordingStore reopened(folder);
+            if (!reopened.Open() || reopened.List() != std::vector<std::string>{ "Empty", "Second" } ||
+                reopened.GetStats().ChunkBytes != remaining.ChunkBytes)
+                throw std::runtime_error("Reopened store disagrees");
+
+            // Leftovers of interrupted writes are swept, referenced chunks are not
+            RecordingFormat::ChunkHash orphan{ 0x0123456789ABCDEFull, 0xFEDCBA9876543210ull };
+            std::filesystem::create_directories(reopened.GetChunkPath(orphan).parent_path());
+            std::ofstream(reopened.GetChunkPath(orphan), std::ios::binary) << "orphan";
+
+            // Left by a process that has exited: past any pid the system hands out
+            std::filesystem::path abandoned = reopened.GetManifestPath("Third");
+            abandoned += ".2147483646-1.tmp";
+            std::ofstream(abandoned, std::ios::binary) << "partial";
+
+            // This process is still running, so its temporary may be a write in progress
+            std::filesystem::path live = AtomicFile::GetTemporaryPath(reopened.GetManifestPath("Fourth"));
+            std::ofstream(live, std::ios::binary) << "partial";
+
+            if (reopened.CollectGarbage() != 2 || std::filesystem::exists(reopened.GetChunkPath(orphan)) || std::filesystem::exists(abandoned))
+                throw std::runtime_error("Garbage was not collected");
+
+            if (!std::filesystem::exists(live))
+                throw std::runtime_error("Collecting garbage removed a temporary still being written");
+
+            std::filesystem::remove(live);
+
+            if (!reopened.Get("Second", loaded) || reopened.GetStats().Chunks != remaining.Chunks)
+                throw std::runtime_error("Collecting garbage removed a live chunk");
+
+            // A damaged chunk fails the load, and putting the recording again repairs it
+            std::filesystem::path damaged;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(folder / "chunks"))
+            {
+                if (entry.is_regular_file())
+                    damaged = entry.path();
+            }
+
+            std::filesystem::resize_file(damaged, std::filesystem::file_size(damaged) / 2);
+
+            if (reopened.Get("Second", loaded))
+                throw std::runtime_error("Damaged chunk was accepted");
+
+            if (!reopened.Put(second) || !reopened.Get("Second", loaded))
+                throw std::runtime_error("Putting the recording again did not repair it");
+
+            ExpectSameRecording(loaded, second);
+
+            // An unreadable manifest stops collection rather than losing the chunks it lists
+            std::ofstream(reopened.GetManifestPath("Broken"), std::ios::binary) << "not a manifest";
+            std::ofstream(reopened.GetChunkPath(orphan), std::ios::binary) << "orphan";
+
+            if (reopened.CollectGarbage() != 0 || !std::filesystem::exists(reopened.GetChunkPath(orphan)))
+                throw std::runtime_error("Collected garbage without every manifest");
+        }
+
+        void SerializationTestSuite::Test_Store_ChunkBoundariesFollowContent()
+        {
+            // Chunks are addressed by the leading 128 bits of their SHA-256
+            const uint8_t abc[] = { 'a', 'b', 'c' };
+            RecordingFormat::ChunkHash expected{ 0xBA7816BF8F01CFEAull, 0x414140DE5DAE2223ull };
+            if (RecordingStore::HashChunk(abc, sizeof(abc)) != expected)
+                throw std::runtime_error("Chunk hash is not SHA-256");
+
+            Recording content = GenerateRecording("Content", 50000, 31);
+
+            Recording shifted("Shifted", true);
+            AppendRecording(shifted, GenerateRecording("", 1500, 32));
+            AppendRecording(shifted, content);
+
+            std::vector<size_t> ends = RecordingStore::FindChunkEnds(content.Events);
+            std::vector<size_t> shiftedEnds = RecordingStore::FindChunkEnds(shifted.Events);
+
+            size_t start = 0;
+            for (size_t end : ends)
+            {
+                size_t length = end - start;
+                if (length > RecordingStore::MaxChunkEvents || (length < RecordingStore::MinChunkEvents && end != content.Events.Size()))
+                    throw std::runtime_error("Chunk of " + std::to_string(length) + " events is out of bounds");
+
+                start = end;
+            }
+
+            if (ends.empty() || ends.back() != content.Events.Size())
+                throw std::runtime_error("Chunks do not cover the events");
+
+            // Past the first chunk or two, the same events are cut in the same places
+            size_t matched = 0;
+            for (size_t end : shiftedEnds)
+            {
+                if (end > 1500 && std::binary_search(ends.begin(), ends.end(), end - 1500))
+                    matched++;
+            }
+
+            LUMINA_LOG_INFO("{} events in {} chunks, {} of them cut the same way after a 1500 event prefix", content.Events.Size(), ends.size(), matched);
+
+            if (ends.size() < 10 || matched + 2 < ends.size())
+                throw std::runtime_error("Boundaries moved with the events before them");
+        }
+
+        void SerializationTestSuite::Test_Performance_StoreDeduplication()
+        {
+            const int RECORDINGS = 40;
+            const int WORKFLOWS = 4;
+
+            std::filesystem::path folder = GetTestDirectory() / "StoreCorpus";
+            std::filesystem::path filesFolder = folder / "files";
+            std::filesystem::path storeFolder = folder / "store";
+            std::filesystem::remove_all(folder);
+            std::filesystem::create_directories(filesFolder);
+
+            // Every session logs in the same way, follows one of a few workflows, then does something of its own
+            Recording login = GenerateRecording("", 20000, 41);
+            std::vector<Recording> workflows;
+            for (int i = 0; i < WORKFLOWS; i++)
+                workflows.push_back(GenerateRecording("", 30000, 50 + i));
+
+            std::vector<Recording> corpus;
+            for (int i = 0; i < RECORDINGS; i++)
+            {
+                Recording recording("Session" + std::to_string(i), true);
+                AppendRecording(recording, login);
+                AppendRecording(recording, workflows[i % WORKFLOWS]);
+                AppendRecording(recording, GenerateRecording("", 10000, 100 + i));
+                corpus.push_back(std::move(recording));
+            }
+
+            RecordingStore store(storeFolder);
+            if (!store.Open())
+                throw std::runtime_error("Open failed");
+
+            Lumina::Timer timer;
+            for (const Recording& recording : corpus)
+            {
+                if (!Serialization::WriteCompressed(recording, filesFolder / (recording.Name + ".rec")))
+                    throw std::runtime_error("WriteCompressed failed");
+            }
+            float writeFilesMs = timer.ElapsedMillis();
+
+            timer.Reset();
+            for (const Recording& recording : corpus)
+            {
+                if (!store.Put(recording))
+                    throw std::runtime_error("Put failed");
+            }
+            float putMs = timer.ElapsedMillis();
+
+            uint64_t filesBytes = GetFolderSize(filesFolder);
+            uint64_t storeBytes = GetFolderSize(storeFolder);
+            StoreStats stats = store.GetStats();
+
+            timer.Reset();
+            size_t fileEvents = 0;
+            for (const Recording& recording : corpus)
+            {
+                Recording loaded;
+                if (!Serialization::ReadBinary(loaded, filesFolder / (recording.Name + ".rec")))
+                    throw std::runtime_error("ReadBinary failed");
+
+                fileEvents += loaded.Events.Size();
+            }
+            float readFilesMs = timer.ElapsedMillis();
+
+            timer.Reset();
+            size_t storeEvents = 0;
+            for (const Recording& recording : corpus)
+            {
+                Recording loaded;
+                if (!store.Get(recording.Name, loaded))
+                    throw std::runtime_error("Get failed");
+
+                storeEvents += loaded.Events.Size();
+            }
+            float getMs = timer.ElapsedMillis();
+
+            Recording check;
+            if (!store.Get(corpus.back().Name, check))
+                throw std::runtime_error("Get failed");
+
+            ExpectSameRecording(check, corpus.back());
+
+            LUMINA_LOG_INFO("{} recordings, {} events | separate files {} bytes | store {} bytes ({:.1f}% of the files, {} chunks, {} referenced chunk bytes)",
+                RECORDINGS, stats.Events, filesBytes, storeBytes, 100.0 * storeBytes / filesBytes, stats.Chunks, stats.ReferencedBytes);
+            LUMINA_LOG_INFO("  write files {:.2f}ms, put {:.2f}ms | read files {:.2f}ms, get {:.2f}ms ({:.2f}x)",
+                writeFilesMs, putMs, readFilesMs, getMs, getMs / std::max(readFilesMs, 0.001f));
+
+            if (fileEvents != stats.Events || storeEvents != stats.Events)
+                throw std::runtime_error("Event counts disagree");
+
+            if (storeBytes * 2 > filesBytes)
+                throw std::runtime_error("Store did not halve the space used by similar recordings");
+        }
+
+        void SerializationTestSuite::Test_Async_LoadSaveList()
+        {
+            std::filesystem::path folder = GetTestDirectory() / "AsyncIO";
+            std::filesystem::remove_all(folder);
+
+            auto original = std::make_shared<const Recording>(GenerateRecording("Async", 20000));
+
+            RecordingIO io;
+            IOStatus saveStatus = IOStatus::Failed;
+            IORequestId save = io.Save(original, folder, [&](IOStatus status) { saveStatus = status; });
+
+            std::vector<RecordingInfo> listed;
+            IORequestId list = io.List(folder, [&](IOStatus, std::vector<RecordingInfo> recordings) { listed = std::move(recordings); });
+
+            RecordingSnapshot loaded;
+            IORequestId load = io.Load(folder / "Async.rec", [&](IOStatus, RecordingSnapshot recording) { loaded = std::move(recording); });
+
+            io.Wait(load);
+
+            // Nothing is delivered until Update(), and then in submission order
+            if (!io.IsPending(save) || saveStatus == IOStatus::Completed || loaded)
+                throw std::runtime_error("Callbacks must wait for Update()");
+
+            if (io.Update() != 3 || io.IsPending(save) || io.IsPending(list) || io.IsPending(load))
+                throw std::runtime_error("Expected all three callbacks to run");
+
+            if (saveStatus != IOStatus::Completed)
+                throw std::runtime_error("Save failed");
+
+            if (listed.size() != 1 || listed[0].Name != "Async" || listed[0].EventCount != original->Events.Size())
+                throw std::runtime_error("Listing does not show the saved recording");
+
+            if (!loaded || loaded->Events.Size() != original->Events.Size() || loaded->Duration != original->Duration)
+                throw std::runtime_error("Loaded recording does not match");
+
+            for (size_t i = 0; i < original->Events.Size(); i += 97)
+            {
+                if (!EventsEqual(original->Events[i], loaded->Events[i]))
+                    throw std::runtime_error("Event mismatch at index " + std::to_string(i));
+            }
+
+            IOStatus missingStatus = IOStatus::Completed;
+            io.Wait(io.Load(folder / "Missing.rec", [&](IOStatus status, RecordingSnapshot) { missingStatus = status; }));
+            io.Update();
+
+            if (missingStatus != IOStatus::Failed)
+                throw std::runtime_error("Loading a missing file should fail");
+        }
+
+        void SerializationTestSuite::Test_Async_Cancel()
+        {
+            std::filesystem::path folder = GetTestDirectory() / "AsyncCancel";
+            std::filesystem::remove_all(folder);
+
+            auto large = std::make_shared<const Recording>(GenerateRecording("Large", 1000000));
+
+            RecordingIO io;
+            IOStatus saveStatus = IOStatus::Failed;
+            IOStatus queuedStatus = IOStatus::Completed;
+
+            io.Save(large, folder, [&](IOStatus status) { saveStatus = status; });
+            IORequestId queued = io.Load(folder / "Large.rec", [&](IOStatus status, RecordingSnapshot) { queuedStatus = status; });
+
+            if (!io.Cancel(queued))
+                throw std::runtime_error("A queued request should be cancellable");
+
+            // Let the save finish, then cancel a load partway through
+            while (io.IsBusy())
+                std::this_thread::yield();
+
+            IOStatus runningStatus = IOStatus::Completed;
+            RecordingSnapshot runningResult;
+            IORequestId running = io.Load(folder / "Large.rec", [&](IOStatus status, RecordingSnapshot recording) {
+                runningStatus = status;
+                runningResult = std::move(recording);
+                });
+
+            while (io.GetProgress(running) == 0.0f)
+                std::this_thread::yield();
+
+            io.Cancel(running);
+            io.Wait(running);
+            io.Update();
+
+            if (saveStatus != IOStatus::Completed || queuedStatus != IOStatus::Cancelled)
+                throw std::runtime_error("Cancelling a queued load should not affect the save before it");
+
+            if (runningStatus != IOStatus::Cancelled || runningResult)
+                throw std::runtime_error("A running load should stop when cancelled");
+
+            if (io.Cancel(running))
+                throw std::runtime_error("Finished requests cannot be cancelled");
+        }
+
+        void SerializationTestSuite::Test_Performance_AsyncLoadFrameTimes()
+        {
+            const size_t COUNT = 1000000;
+            const int64_t FRAME = Clock::NanosecondsPerSecond / 120;
+
+            Recording original = GenerateRecording("FrameTimes", COUNT);
+            std::filesystem::path path = GetTestDirectory() / "FrameTimes.rec";
+            if (!Serialization::WriteBinary(original, path))
+                throw std::runtime_error("WriteBinary failed");
+
+            // How long the UI thread was frozen before: the whole load inside one frame
+            Recording blocking;
+            Lumina::Timer timer;
+            if (!Serialization::ReadBinary(blocking, path))
+                throw std::runtime_error("ReadBinary failed");
+            float blockingMs = timer.ElapsedMillis();
+
+            RecordingIO io;
+            RecordingSnapshot loaded;
+            IORequestId load = io.Load(path, [&](IOStatus, RecordingSnapshot recording) { loaded = std::move(recording); });
+
+            // Frame loop at 120 Hz: deliver callbacks, read progress, sleep out the rest of the frame
+            std::vector<float> frameMs;
+            int64_t frameStart = Clock::Now();
+            float lastProgress = 0.0f;
+            timer.Reset();
+
+            while (!loaded)
+            {
+                io.Update();
+                float progress = io.GetProgress(load);
+
+                if (progress < lastProgress || progress > 1.0f)
+                    throw std::runtime_error("Progress went from " + std::to_string(lastProgress) + " to " + std::to_string(progress));
+
+                lastProgress = progress;
+
+                int64_t deadline = frameStart + FRAME;
+                std::this_thread::sleep_for(std::chrono::nanoseconds(std::max<int64_t>(deadline - Clock::Now(), 0)));
+
+                int64_t now = Clock::Now();
+                frameMs.push_back(static_cast<float>(now - frameStart) / Clock::NanosecondsPerMillisecond);
+                frameStart = now;
+
+                if (timer.ElapsedMillis() > 30000.0f)
+                    throw std::runtime_error("Async load did not finish");
+            }
+            float asyncMs = timer.ElapsedMillis();
+
+            if (loaded->Events.Size() != COUNT)
+                throw std::runtime_error("Event count mismatch");
+
+            float worstFrame = *std::max_element(frameMs.begin(), frameMs.end());
+
+            LUMINA_LOG_INFO("{} events | blocking load: {:.3f}ms in one frame | async: {:.3f}ms over {} frames, worst frame {:.3f}ms (target {:.3f}ms)",
+                COUNT, blockingMs, asyncMs, frameMs.size(), worstFrame, FRAME / 1e6);
+
+            // A frame may run late by a scheduler slice, never by the whole load
+            if (worstFrame > FRAME / 1e6 + 8.0f)
+                throw std::runtime_error("Frame time was not bounded while loading");
+        }
+    }
+}
\ No newline at end of file
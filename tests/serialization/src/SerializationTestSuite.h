@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+
+#include "KeyActions/Core/Recording.h"
+#include "KeyActions/Core/Serialization.h"
+
+namespace KeyActions
+{
+    namespace Tests
+    {
+        struct TestResult
+        {
+            std::string TestName;
+            bool Passed;
+            std::string Message;
+            float ElapsedMs;
+        };
+
+        class SerializationTestSuite
+        {
+        public:
+            SerializationTestSuite() = default;
+
+            std::vector<TestResult> RunAllTests();
+
+            struct TestSummary
+            {
+                int TotalTests = 0;
+                int PassedTests = 0;
+                int FailedTests = 0;
+                float TotalTimeMs = 0.0f;
+                std::vector<TestResult> Results;
+            };
+
+            TestSummary GetLastSummary() const { return m_LastSummary; }
+
+        private:
+            TestSummary m_LastSummary;
+
+            TestResult RunTest(const std::string& name, std::function<void()> testFunc);
+
+            // Binary Format Tests
+            void Test_Binary_RoundTrip();
+            void Test_Binary_EmptyRecording();
+            void Test_Binary_IsDetected();
+            void Test_Binary_RejectsTruncatedFile();
+            void Test_Binary_RejectsOversizedName();
+            void Test_Binary_LongGapsRoundTrip();
+            void Test_Binary_MigratesLegacyFile();
+            void Test_Binary_InterruptedSaveKeepsOldFile();
+            void Test_Compressed_RoundTrip();
+            void Test_Compressed_RejectsDamagedFile();
+            void Test_Performance_Compression();
+            void Test_Compressed_ParallelEncodingMatches();
+            void Test_Json_ExportImport();
+            void Test_Json_ImportsLegacyTimes();
+            void Test_Json_ReaderMatchesDocumentParser();
+            void Test_Json_ReaderFallsBack();
+            void Test_Performance_Binary_VsJson_Load();
+            void Test_Performance_JsonReader();
+
+            // Streaming Writer Tests
+            void Test_Writer_FinalizeRoundTrip();
+            void Test_Writer_RecoverPartialFile();
+            void Test_Writer_Discard();
+            void Test_Writer_CompressStream();
+
+            // Library Index Tests
+            void Test_Library_IncrementalRefresh();
+            void Test_Performance_LibraryListing();
+
+            // Lazy Reader Tests
+            void Test_Reader_MatchesFullLoad();
+            void Test_Performance_ReaderTimeToFirstEvent();
+
+            // Task Pool Tests
+            void Test_Pool_RunsNestedWork();
+
+            // Deduplicating Store Tests
+            void Test_Store_RoundTripAndSharing();
+            void Test_Store_ChunkBoundariesFollowContent();
+            void Test_Performance_StoreDeduplication();
+
+            // Async IO Tests
+            void Test_Async_LoadSaveList();
+            void Test_Async_Cancel();
+            void Test_Performance_AsyncLoadFrameTimes();
+        };
+    }
+}
\ No newline at end of file